@@ -0,0 +1,142 @@
+#include "art.h"
+#include "hash_table.h"
+#include "sort.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Compares the Adaptive Radix Tree against the Probed_Hash_Table for point lookups, and against a sorted
+// array (sort + binary search) for range scans.
+//
+
+#define KEY_COUNT    1000000
+#define LOOKUP_COUNT 4000000
+#define RANGE_COUNT  100000
+#define RANGE_WIDTH  1000000000ULL
+
+static
+u64 hash_u64(u64 const &key) {
+    return murmur_64a(key);
+}
+
+static
+b8 compare_u64(u64 const &lhs, u64 const &rhs) {
+    return lhs == rhs;
+}
+
+static
+Sort_Comparison_Result sort_u64(u64 *lhs, u64 *rhs) {
+    return *lhs < *rhs ? SORT_Lhs_Is_Smaller : (*lhs > *rhs ? SORT_Lhs_Is_Bigger : SORT_Lhs_Equals_Rhs);
+}
+
+static
+s64 lower_bound(u64 *array, s64 count, u64 value) {
+    s64 low = 0, high = count;
+    while(low < high) {
+        s64 mid = (low + high) / 2;
+        if(array[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static
+void print_result(const char *name, CPU_Time start, CPU_Time end, s64 operations, u64 checksum) {
+    f64 milliseconds = os_convert_cpu_time(end - start, Milliseconds);
+    printf("  %-32s %10.2fms, %8.2fns / op (checksum: %" PRIu64 ")\n", name, milliseconds, milliseconds * 1000000.0 / (f64) operations, checksum);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    u64 *keys = (u64 *) Default_Allocator->allocate(KEY_COUNT * sizeof(u64));
+    for(s64 i = 0; i < KEY_COUNT; ++i) keys[i] = random.random_u64();
+
+    u64 *lookups = (u64 *) Default_Allocator->allocate(LOOKUP_COUNT * sizeof(u64));
+    for(s64 i = 0; i < LOOKUP_COUNT; ++i) lookups[i] = keys[random.random_u64(0, KEY_COUNT - 1)];
+
+    //
+    // Build phase.
+    //
+    printf("Inserting %d random u64 keys:\n", KEY_COUNT);
+
+    Adaptive_Radix_Tree<u64, u64> art;
+    art.create();
+
+    CPU_Time start = os_get_cpu_time();
+    for(s64 i = 0; i < KEY_COUNT; ++i) art.add(keys[i], i);
+    print_result("Adaptive_Radix_Tree::add", start, os_get_cpu_time(), KEY_COUNT, art.count);
+
+    Probed_Hash_Table<u64, u64> table;
+    start = os_get_cpu_time();
+    table.create(KEY_COUNT * 2, hash_u64, compare_u64);
+    for(s64 i = 0; i < KEY_COUNT; ++i) table.add(keys[i], i);
+    print_result("Probed_Hash_Table::add", start, os_get_cpu_time(), KEY_COUNT, table.count);
+
+    u64 *sorted = (u64 *) Default_Allocator->allocate(KEY_COUNT * sizeof(u64));
+    memcpy(sorted, keys, KEY_COUNT * sizeof(u64));
+    start = os_get_cpu_time();
+    sort(sorted, KEY_COUNT, sort_u64);
+    print_result("sort", start, os_get_cpu_time(), KEY_COUNT, sorted[0]);
+
+    //
+    // Point lookups.
+    //
+    printf("Point lookups (%d):\n", LOOKUP_COUNT);
+
+    u64 checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < LOOKUP_COUNT; ++i) checksum += *art.query(lookups[i]);
+    print_result("Adaptive_Radix_Tree::query", start, os_get_cpu_time(), LOOKUP_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < LOOKUP_COUNT; ++i) checksum += *table.query(lookups[i]);
+    print_result("Probed_Hash_Table::query", start, os_get_cpu_time(), LOOKUP_COUNT, checksum);
+
+    //
+    // Range scans.
+    //
+    printf("Range scans (%d, width %" PRIu64 "):\n", RANGE_COUNT, RANGE_WIDTH);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < RANGE_COUNT; ++i) {
+        u64 min = lookups[i], max = min + RANGE_WIDTH < min ? MAX_U64 : min + RANGE_WIDTH;
+        art.iterate_range(min, max, [&](u64 *key, u64 *) { checksum += *key; });
+    }
+    print_result("Adaptive_Radix_Tree::iterate_range", start, os_get_cpu_time(), RANGE_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < RANGE_COUNT; ++i) {
+        u64 min = lookups[i], max = min + RANGE_WIDTH < min ? MAX_U64 : min + RANGE_WIDTH;
+        for(s64 j = lower_bound(sorted, KEY_COUNT, min); j < KEY_COUNT && sorted[j] <= max; ++j) checksum += sorted[j];
+    }
+    print_result("Binary search", start, os_get_cpu_time(), RANGE_COUNT, checksum);
+
+    //
+    // Removal.
+    //
+    printf("Removal:\n");
+
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < KEY_COUNT; ++i) art.remove(keys[i]);
+    print_result("Adaptive_Radix_Tree::remove", start, os_get_cpu_time(), KEY_COUNT, art.count);
+
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < KEY_COUNT; ++i) table.remove(keys[i]);
+    print_result("Probed_Hash_Table::remove", start, os_get_cpu_time(), KEY_COUNT, table.count);
+
+    art.destroy();
+    table.destroy();
+    Default_Allocator->deallocate(sorted);
+    Default_Allocator->deallocate(lookups);
+    Default_Allocator->deallocate(keys);
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "art.h"
+#include "threads.h"
+#include "hash_table.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// A YCSB-style throughput benchmark for the Adaptive Radix Tree in concurrent mode. The tree is preloaded
+// with a fixed set of keys, after which every thread runs a mix of lookups and writes against uniformly
+// distributed keys. Writes alternate between inserting and removing a key, so that the tree size stays
+// roughly stable over the run.
+//   Workload A: 50% reads, 50% writes
+//   Workload B: 95% reads,  5% writes
+//   Workload C: 100% reads
+//
+
+#define PRELOADED_KEYS        1000000
+#define OPERATIONS_PER_THREAD 2000000
+
+struct Workload {
+    const char *name;
+    u64 read_percentage;
+};
+
+struct Benchmark_Thread {
+    Adaptive_Radix_Tree<u64, u64> *tree;
+    Workload workload;
+    u64 seed;
+    u64 checksum;
+};
+
+static
+u64 scramble_key(u64 index) {
+    // Spread the keys over the entire key space, so that the tree does not degenerate into dense nodes.
+    return murmur_64a(index);
+}
+
+static
+u32 benchmark_thread(Benchmark_Thread *thread) {
+    Random_Generator random;
+    random.seed(thread->seed);
+
+    u64 checksum = 0;
+
+    for(s64 i = 0; i < OPERATIONS_PER_THREAD; ++i) {
+        u64 key = scramble_key(random.random_u64(0, PRELOADED_KEYS * 2));
+
+        if(random.random_u64(0, 99) < thread->workload.read_percentage) {
+            u64 value;
+            if(thread->tree->query(key, &value)) checksum += value;
+        } else if(i & 1) {
+            thread->tree->add(key, key);
+        } else {
+            thread->tree->remove(key);
+        }
+    }
+
+    thread->checksum = checksum;
+    return 0;
+}
+
+static
+void run_workload(Workload workload, s64 thread_count) {
+    Adaptive_Radix_Tree<u64, u64> tree;
+    tree.create(Default_Allocator, true);
+
+    for(s64 i = 0; i < PRELOADED_KEYS; ++i) {
+        u64 key = scramble_key(i * 2);
+        tree.add(key, key);
+    }
+
+    Thread threads[ART_MAX_THREADS];
+    Benchmark_Thread thread_data[ART_MAX_THREADS];
+
+    CPU_Time start = os_get_cpu_time();
+
+    for(s64 i = 0; i < thread_count; ++i) {
+        thread_data[i].tree     = &tree;
+        thread_data[i].workload = workload;
+        thread_data[i].seed     = 0x5eed + i;
+        thread_data[i].checksum = 0;
+        threads[i] = create_thread((Thread_Entry_Point) benchmark_thread, &thread_data[i], false);
+    }
+
+    for(s64 i = 0; i < thread_count; ++i) join_thread(&threads[i]);
+
+    CPU_Time end = os_get_cpu_time();
+
+    f64 seconds = os_convert_cpu_time(end - start, Seconds);
+    f64 million_operations = (f64) (thread_count * OPERATIONS_PER_THREAD) / 1000000.0;
+    printf("  Workload %s, %2" PRId64 " threads: %8.2f Mops/s (%" PRId64 " keys left)\n", workload.name, thread_count, million_operations / seconds, tree.count);
+
+    tree.destroy();
+}
+
+int main() {
+    Workload workloads[] = {
+        { "A", 50 },
+        { "B", 95 },
+        { "C", 100 },
+    };
+
+    // Every thread that touches a concurrent tree holds one of the ART_MAX_THREADS slots until it exits, so
+    // keep the number of threads running at the same time below that.
+    s64 max_threads = MIN(os_get_number_of_hardware_threads(), 16);
+
+    printf("Concurrent Adaptive_Radix_Tree, %d preloaded keys, %d operations per thread:\n", PRELOADED_KEYS, OPERATIONS_PER_THREAD);
+
+    for(Workload &workload : workloads) {
+        for(s64 thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+            run_workload(workload, thread_count);
+        }
+    }
+
+    return 0;
+}
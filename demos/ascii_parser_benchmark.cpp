@@ -0,0 +1,122 @@
+#include "fileio.h"
+#include "random.h"
+#include "os_specific.h"
+
+#include <stdlib.h> // For strtof
+
+//
+// Measures how fast an Ascii_Parser reads text-based mesh data: Vertex positions as floats with a few decimal
+// places, and triangle indices as integers. Reading one value at a time is compared against the batch readers,
+// which parse straight into the vertex and index arrays, and against strtof on every token.
+//
+
+#define VERTEX_COUNT (1024 * 1024)
+#define REPETITIONS  5
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, s64 bytes, Procedure procedure) {
+    f64 best = MAX_F64;
+    s64 checksum = 0;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        CPU_Time start = os_get_cpu_time();
+        checksum = procedure();
+        CPU_Time end = os_get_cpu_time();
+        best = MIN(best, os_convert_cpu_time(end - start, Seconds));
+    }
+
+    printf("  %-32s %10.2f MB/s (checksum: %" PRId64 ")\n", name, (f64) bytes / best / (1024.0 * 1024.0), checksum);
+}
+
+static
+string generate_positions(Random_Generator *random) {
+    string text = allocate_string(Default_Allocator, 64 * VERTEX_COUNT);
+    s64 position = 0;
+
+    for(s64 i = 0; i < VERTEX_COUNT; ++i) {
+        char line[128];
+        int length = snprintf(line, sizeof(line), "%.4f %.4f %.4f\n", random->random_f32(-100.f, 100.f), random->random_f32(-100.f, 100.f), random->random_f32(-100.f, 100.f));
+        memcpy(&text.data[position], line, length);
+        position += length;
+    }
+
+    text.count = position;
+    return text;
+}
+
+static
+string generate_indices(Random_Generator *random) {
+    string text = allocate_string(Default_Allocator, 32 * VERTEX_COUNT);
+    s64 position = 0;
+
+    for(s64 i = 0; i < VERTEX_COUNT; ++i) {
+        char line[128];
+        int length = snprintf(line, sizeof(line), "%" PRIu64 " %" PRIu64 " %" PRIu64 "\n", random->random_u64() % VERTEX_COUNT, random->random_u64() % VERTEX_COUNT, random->random_u64() % VERTEX_COUNT);
+        memcpy(&text.data[position], line, length);
+        position += length;
+    }
+
+    text.count = position;
+    return text;
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    string positions = generate_positions(&random);
+    string indices   = generate_indices(&random);
+
+    f32 *vertices  = (f32 *) Default_Allocator->allocate(VERTEX_COUNT * 3 * sizeof(f32));
+    s32 *triangles = (s32 *) Default_Allocator->allocate(VERTEX_COUNT * 3 * sizeof(s32));
+
+    printf("Reading %d vertex positions (%" PRId64 " MB):\n", VERTEX_COUNT, positions.count / (1024 * 1024));
+
+    run_benchmark("read_string and strtof", positions.count, [&]() {
+        Ascii_Parser parser;
+        parser.create_from_string(positions);
+        char token[64];
+        for(s64 i = 0; i < VERTEX_COUNT * 3; ++i) {
+            string view = parser.read_string();
+            memcpy(token, view.data, view.count);
+            token[view.count] = 0;
+            vertices[i] = strtof(token, null);
+        }
+        return (s64) vertices[VERTEX_COUNT * 3 - 1];
+    });
+
+    run_benchmark("read_f32", positions.count, [&]() {
+        Ascii_Parser parser;
+        parser.create_from_string(positions);
+        for(s64 i = 0; i < VERTEX_COUNT * 3; ++i) vertices[i] = parser.read_f32();
+        return (s64) vertices[VERTEX_COUNT * 3 - 1];
+    });
+
+    run_benchmark("read_many_f32", positions.count, [&]() {
+        Ascii_Parser parser;
+        parser.create_from_string(positions);
+        return parser.read_many_f32(VERTEX_COUNT * 3, vertices);
+    });
+
+    printf("Reading %d triangle indices (%" PRId64 " MB):\n", VERTEX_COUNT * 3, indices.count / (1024 * 1024));
+
+    run_benchmark("read_s32", indices.count, [&]() {
+        Ascii_Parser parser;
+        parser.create_from_string(indices);
+        for(s64 i = 0; i < VERTEX_COUNT * 3; ++i) triangles[i] = parser.read_s32();
+        return (s64) triangles[VERTEX_COUNT * 3 - 1];
+    });
+
+    run_benchmark("read_many_s32", indices.count, [&]() {
+        Ascii_Parser parser;
+        parser.create_from_string(indices);
+        return parser.read_many_s32(VERTEX_COUNT * 3, triangles);
+    });
+
+    Default_Allocator->deallocate(triangles);
+    Default_Allocator->deallocate(vertices);
+    deallocate_string(Default_Allocator, &indices);
+    deallocate_string(Default_Allocator, &positions);
+    return 0;
+}
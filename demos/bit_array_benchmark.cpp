@@ -0,0 +1,88 @@
+#include "bit_array.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Compares the SIMD bulk operations of the Bit_Array against plain loops over u64 words, as they were
+// hand-rolled before.
+//
+
+#define BIT_COUNT   (64 * 1024 * 1024)
+#define REPETITIONS 20
+
+static
+void print_result(const char *name, CPU_Time start, CPU_Time end, s64 checksum) {
+    f64 milliseconds = os_convert_cpu_time(end - start, Milliseconds) / REPETITIONS;
+    printf("  %-32s %10.3fms (checksum: %" PRId64 ")\n", name, milliseconds, checksum);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    Bit_Array lhs, rhs;
+    lhs.create(Default_Allocator, BIT_COUNT);
+    rhs.create(Default_Allocator, BIT_COUNT);
+
+    // Sparse bits, like a visibility mask with few visible objects.
+    for(s64 i = 0; i < BIT_COUNT / 1000; ++i) {
+        lhs.set(random.random_u64(0, BIT_COUNT - 1));
+        rhs.set(random.random_u64(0, BIT_COUNT - 1));
+    }
+
+    s64 word_count = BIT_COUNT / 64;
+
+    printf("Operating on %d bits:\n", BIT_COUNT);
+
+    s64 checksum = 0;
+    CPU_Time start = os_get_cpu_time();
+    for(s64 r = 0; r < REPETITIONS; ++r) {
+        for(s64 i = 0; i < word_count; ++i) lhs.bits[i] ^= rhs.bits[i];
+        checksum += lhs.bits[r];
+    }
+    print_result("xor (scalar)", start, os_get_cpu_time(), checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 r = 0; r < REPETITIONS; ++r) {
+        lhs.xor_with(&rhs);
+        checksum += lhs.bits[r];
+    }
+    print_result("xor_with", start, os_get_cpu_time(), checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 r = 0; r < REPETITIONS; ++r) {
+        for(s64 i = 0; i < word_count; ++i) checksum += os_count_bits_set(lhs.bits[i]);
+    }
+    print_result("popcount (scalar)", start, os_get_cpu_time(), checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 r = 0; r < REPETITIONS; ++r) checksum += lhs.count_bits_set();
+    print_result("count_bits_set", start, os_get_cpu_time(), checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 r = 0; r < REPETITIONS; ++r) {
+        for(s64 i = 0; i < word_count; ++i) {
+            u64 word = lhs.bits[i];
+            while(word) {
+                checksum += i * 64 + os_lowest_bit_set(word);
+                word &= word - 1;
+            }
+        }
+    }
+    print_result("iterate set bits (scalar)", start, os_get_cpu_time(), checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 r = 0; r < REPETITIONS; ++r) {
+        for(s64 index : lhs) checksum += index;
+    }
+    print_result("iterate set bits", start, os_get_cpu_time(), checksum);
+
+    lhs.destroy();
+    rhs.destroy();
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "string_type.h"
+#include "hash_table.h"
+#include "random.h"
+#include "os_specific.h"
+
+#include <strings.h> // For strcasecmp, strncasecmp
+
+//
+// Compares case-insensitive string comparisons and hashing against their case-sensitive counterparts, on
+// asset paths with mixed case (as authored on Windows, but looked up on Linux). A case-insensitive hash table
+// should not be noticeably slower than a case-sensitive one.
+//
+
+#define PATH_COUNT 4096
+#define REPEATS    500
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, s64 repeats, s64 bytes_per_repeat, Procedure procedure) {
+    s64 checksum = 0;
+
+    CPU_Time start = os_get_cpu_time();
+    for(s64 i = 0; i < repeats; ++i) checksum += procedure(i);
+    CPU_Time end = os_get_cpu_time();
+
+    f64 seconds = os_convert_cpu_time(end - start, Seconds);
+    printf("  %-36s %10.2f GB/s, %8.2fns / call (checksum: %" PRId64 ")\n", name, (f64) (repeats * bytes_per_repeat) / seconds / 1000000000.0, seconds * 1000000000.0 / (f64) repeats, checksum);
+}
+
+// The comparison one character at a time, as a baseline.
+static
+b8 cstrings_equal_ignore_case_per_character(const char *lhs, const char *rhs) {
+    for(;; ++lhs, ++rhs) {
+        u8 lhs_character = to_lower_character((u8) *lhs);
+        if(lhs_character != to_lower_character((u8) *rhs)) return false;
+        if(lhs_character == 0) return true;
+    }
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    const char *directories[] = { "Data/Textures/", "data/meshes/Characters/", "Data/Sounds/Ambience/Forest/", "DATA/Shaders/" };
+    const char *extensions[]  = { ".PNG", ".png", ".Obj", ".wav", ".glsl" };
+
+    // Every path exists twice: As authored, and in the lower case form it is looked up with.
+    char *paths[PATH_COUNT], *lookups[PATH_COUNT];
+    string path_views[PATH_COUNT], lookup_views[PATH_COUNT];
+    s64 total_length = 0;
+
+    for(s64 i = 0; i < PATH_COUNT; ++i) {
+        char name[32];
+        s64 name_length = 4 + random.random_u64() % 20;
+        for(s64 j = 0; j < name_length; ++j) {
+            char c = (char) ('a' + random.random_u64() % 26);
+            name[j] = (random.random_u64() % 4 == 0) ? (char) to_upper_character(c) : c;
+        }
+        name[name_length] = 0;
+
+        string path = FORMAT(Default_Allocator, "%s%s_%d%s", directories[i % ARRAY_COUNT(directories)], name, i, extensions[i % ARRAY_COUNT(extensions)]);
+        string lookup = copy_string(Default_Allocator, path);
+        to_lower_string(lookup);
+
+        paths[i]   = to_cstring(Default_Allocator, path);
+        lookups[i] = to_cstring(Default_Allocator, lookup);
+        path_views[i]   = string_view(paths[i], path.count);
+        lookup_views[i] = string_view(lookups[i], lookup.count);
+        total_length += path.count;
+
+        deallocate_string(Default_Allocator, &path);
+        deallocate_string(Default_Allocator, &lookup);
+    }
+
+    s64 repeats = REPEATS * PATH_COUNT;
+    s64 average_length = total_length / PATH_COUNT;
+
+    printf("Comparing %d asset paths (%" PRId64 " bytes on average):\n", PATH_COUNT, average_length);
+
+    run_benchmark("strings_equal (same case)", repeats, average_length, [&](s64 i) { return (s64) strings_equal(path_views[i % PATH_COUNT], path_views[i % PATH_COUNT]); });
+    run_benchmark("strings_equal_ignore_case", repeats, average_length, [&](s64 i) { return (s64) strings_equal_ignore_case(path_views[i % PATH_COUNT], lookup_views[i % PATH_COUNT]); });
+    run_benchmark("cstrings_equal_ignore_case", repeats, average_length, [&](s64 i) { return (s64) cstrings_equal_ignore_case(paths[i % PATH_COUNT], lookups[i % PATH_COUNT]); });
+    run_benchmark("per character", repeats, average_length, [&](s64 i) { return (s64) cstrings_equal_ignore_case_per_character(paths[i % PATH_COUNT], lookups[i % PATH_COUNT]); });
+    run_benchmark("strcasecmp", repeats, average_length, [&](s64 i) { return (s64) (strcasecmp(paths[i % PATH_COUNT], lookups[i % PATH_COUNT]) == 0); });
+    run_benchmark("cstring_starts_with_ignore_case", repeats, 14, [&](s64 i) { return (s64) cstring_starts_with_ignore_case(paths[i % PATH_COUNT], "data/textures/"); });
+    run_benchmark("strncasecmp", repeats, 14, [&](s64 i) { return (s64) (strncasecmp(paths[i % PATH_COUNT], "data/textures/", 14) == 0); });
+    run_benchmark("string_ends_with_ignore_case", repeats, 4, [&](s64 i) { return (s64) string_ends_with_ignore_case(path_views[i % PATH_COUNT], ".png"_s); });
+
+    printf("Hashing %d asset paths:\n", PATH_COUNT);
+
+    run_benchmark("string_hash", repeats, average_length, [&](s64 i) { return (s64) (string_hash(path_views[i % PATH_COUNT]) & 0xff); });
+    run_benchmark("string_hash_ignore_case", repeats, average_length, [&](s64 i) { return (s64) (string_hash_ignore_case(path_views[i % PATH_COUNT]) & 0xff); });
+
+    printf("Looking up %d asset paths in a hash table:\n", PATH_COUNT);
+
+    Probed_Hash_Table<string, s64> case_sensitive, case_insensitive;
+    case_sensitive.create(PATH_COUNT * 2, string_hash, strings_equal);
+    case_insensitive.create(PATH_COUNT * 2, string_hash_ignore_case, strings_equal_ignore_case);
+
+    for(s64 i = 0; i < PATH_COUNT; ++i) {
+        case_sensitive.add(lookup_views[i], i);
+        case_insensitive.add(path_views[i], i);
+    }
+
+    run_benchmark("case sensitive", repeats, average_length, [&](s64 i) { return *case_sensitive.query(lookup_views[i % PATH_COUNT]); });
+    run_benchmark("case insensitive", repeats, average_length, [&](s64 i) { return *case_insensitive.query(lookup_views[i % PATH_COUNT]); });
+
+    case_insensitive.destroy();
+    case_sensitive.destroy();
+
+    for(s64 i = 0; i < PATH_COUNT; ++i) {
+        free_cstring(Default_Allocator, paths[i]);
+        free_cstring(Default_Allocator, lookups[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include "memutils.h"
+#include "random.h"
+#include "os_specific.h"
+
+#include <vector>
+#include <algorithm>
+
+//
+// Microbenchmarks comparing Resizable_Array against std::vector for the common container operations.
+//
+
+#define ELEMENT_COUNT  10000000
+#define SHIFT_COUNT    2000 // Inserts and removes in the middle shift half the array, so do fewer of them.
+#define SHIFT_ELEMENTS 100000
+
+struct Entity {
+    f32 position[3];
+    f32 velocity[3];
+    u64 flags;
+};
+
+static
+void print_result(const char *name, CPU_Time start, CPU_Time end, s64 operations, u64 checksum) {
+    f64 milliseconds = os_convert_cpu_time(end - start, Milliseconds);
+    printf("  %-40s %10.2fms, %8.2fns / op (checksum: %" PRIu64 ")\n", name, milliseconds, milliseconds * 1000000.0 / (f64) operations, checksum);
+}
+
+static
+Entity make_entity(s64 index) {
+    Entity entity = {};
+    entity.position[0] = (f32) index;
+    entity.velocity[1] = (f32) index;
+    entity.flags       = index;
+    return entity;
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    printf("Container operations on %d %d-byte entries:\n", ELEMENT_COUNT, (s32) sizeof(Entity));
+
+    //
+    // Appending one entry at a time, growing the array.
+    //
+    CPU_Time start = os_get_cpu_time();
+    Resizable_Array<Entity> array;
+    for(s64 i = 0; i < ELEMENT_COUNT; ++i) array.add(make_entity(i));
+    print_result("Resizable_Array::add", start, os_get_cpu_time(), ELEMENT_COUNT, array.count);
+
+    start = os_get_cpu_time();
+    std::vector<Entity> vector;
+    for(s64 i = 0; i < ELEMENT_COUNT; ++i) vector.push_back(make_entity(i));
+    print_result("std::vector::push_back", start, os_get_cpu_time(), ELEMENT_COUNT, vector.size());
+
+    //
+    // Appending in bulk.
+    //
+    start = os_get_cpu_time();
+    Resizable_Array<Entity> bulk_array;
+    bulk_array.add_many(array.data, array.count);
+    print_result("Resizable_Array::add_many", start, os_get_cpu_time(), ELEMENT_COUNT, bulk_array.count);
+
+    start = os_get_cpu_time();
+    std::vector<Entity> bulk_vector;
+    bulk_vector.insert(bulk_vector.end(), vector.begin(), vector.end());
+    print_result("std::vector::insert (range)", start, os_get_cpu_time(), ELEMENT_COUNT, bulk_vector.size());
+
+    //
+    // Appending into a Memory_Arena, which can neither reallocate nor free, so that growing has to copy into
+    // fresh memory. The block array only copies its block directory, never the entries themselves.
+    //
+    Memory_Arena arena;
+    arena.create(4ULL * ONE_GIGABYTE);
+    Allocator arena_allocator = arena.allocator();
+
+    start = os_get_cpu_time();
+    Resizable_Array<Entity> arena_array;
+    arena_array.allocator = &arena_allocator;
+    for(s64 i = 0; i < ELEMENT_COUNT; ++i) arena_array.add(make_entity(i));
+    print_result("Resizable_Array::add (arena)", start, os_get_cpu_time(), ELEMENT_COUNT, arena_array.count);
+
+    start = os_get_cpu_time();
+    Resizable_Block_Array<Entity, 1024> arena_block_array;
+    arena_block_array.allocator = &arena_allocator;
+    for(s64 i = 0; i < ELEMENT_COUNT; ++i) arena_block_array.add(make_entity(i));
+    print_result("Resizable_Block_Array::add (arena)", start, os_get_cpu_time(), ELEMENT_COUNT, arena_block_array.count);
+
+    //
+    // Copying.
+    //
+    start = os_get_cpu_time();
+    Resizable_Array<Entity> array_copy = array.copy(Default_Allocator);
+    print_result("Resizable_Array::copy", start, os_get_cpu_time(), ELEMENT_COUNT, array_copy.count);
+
+    start = os_get_cpu_time();
+    std::vector<Entity> vector_copy = vector;
+    print_result("std::vector (copy constructor)", start, os_get_cpu_time(), ELEMENT_COUNT, vector_copy.size());
+
+    //
+    // Iteration.
+    //
+    u64 checksum = 0;
+    start = os_get_cpu_time();
+    for(Entity &entity : array) checksum += entity.flags;
+    print_result("Resizable_Array (iteration)", start, os_get_cpu_time(), ELEMENT_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(Entity &entity : vector) checksum += entity.flags;
+    print_result("std::vector (iteration)", start, os_get_cpu_time(), ELEMENT_COUNT, checksum);
+
+    //
+    // Insertion and removal in the middle of a smaller array.
+    //
+    Resizable_Array<Entity> shift_array;
+    shift_array.add_many(array.data, SHIFT_ELEMENTS);
+    std::vector<Entity> shift_vector(vector.begin(), vector.begin() + SHIFT_ELEMENTS);
+
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < SHIFT_COUNT; ++i) shift_array.insert(shift_array.count / 2, make_entity(i));
+    for(s64 i = 0; i < SHIFT_COUNT; ++i) shift_array.remove(shift_array.count / 2);
+    print_result("Resizable_Array::insert + remove", start, os_get_cpu_time(), SHIFT_COUNT * 2, shift_array.count);
+
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < SHIFT_COUNT; ++i) shift_vector.insert(shift_vector.begin() + shift_vector.size() / 2, make_entity(i));
+    for(s64 i = 0; i < SHIFT_COUNT; ++i) shift_vector.erase(shift_vector.begin() + shift_vector.size() / 2);
+    print_result("std::vector::insert + erase", start, os_get_cpu_time(), SHIFT_COUNT * 2, shift_vector.size());
+
+    //
+    // Unordered removal of random entries.
+    //
+    s64 swap_remove_count = ELEMENT_COUNT / 2;
+
+    random.seed(0x5eed);
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < swap_remove_count; ++i) array_copy.swap_remove(random.random_u64(0, array_copy.count - 1));
+    print_result("Resizable_Array::swap_remove", start, os_get_cpu_time(), swap_remove_count, array_copy.count);
+
+    random.seed(0x5eed);
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < swap_remove_count; ++i) {
+        s64 index = random.random_u64(0, vector_copy.size() - 1);
+        vector_copy[index] = vector_copy.back();
+        vector_copy.pop_back();
+    }
+    print_result("std::vector (swap + pop_back)", start, os_get_cpu_time(), swap_remove_count, vector_copy.size());
+
+    //
+    // Ordered removal of every third entry.
+    //
+    start = os_get_cpu_time();
+    s64 removed = bulk_array.remove_if([](Entity *entity) { return entity->flags % 3 == 0; });
+    print_result("Resizable_Array::remove_if", start, os_get_cpu_time(), ELEMENT_COUNT, removed);
+
+    start = os_get_cpu_time();
+    auto new_end = std::remove_if(bulk_vector.begin(), bulk_vector.end(), [](Entity const &entity) { return entity.flags % 3 == 0; });
+    removed = bulk_vector.end() - new_end;
+    bulk_vector.erase(new_end, bulk_vector.end());
+    print_result("std::vector (erase + remove_if)", start, os_get_cpu_time(), ELEMENT_COUNT, removed);
+
+    array.clear();
+    bulk_array.clear();
+    array_copy.clear();
+    shift_array.clear();
+    arena.destroy();
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "data_array.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Compares the array-of-structs Data_Array against the struct-of-arrays Data_Array_SoA for update loops which
+// only touch a subset of the entity fields (here: integrating the position from the velocity), and for a
+// loop which reads a single field.
+//
+
+#define ENTITY_COUNT 1000000
+#define FRAME_COUNT  100
+
+struct Entity_Cold_Data {
+    char name[64];
+    u64 flags;
+    f32 color[4];
+    f32 scale;
+};
+
+struct Entity {
+    f32 x, y, z;
+    f32 velocity_x, velocity_y, velocity_z;
+    f32 health;
+    Entity_Cold_Data cold;
+};
+
+// Position x, y, z, velocity x, y, z, health, cold data.
+typedef Data_Array_SoA<f32, f32, f32, f32, f32, f32, f32, Entity_Cold_Data> Entity_Columns;
+
+static
+void print_result(const char *name, CPU_Time start, CPU_Time end, s64 operations, f64 checksum) {
+    f64 milliseconds = os_convert_cpu_time(end - start, Milliseconds);
+    printf("  %-40s %10.2fms, %8.2fns / entity (checksum: %f)\n", name, milliseconds, milliseconds * 1000000.0 / (f64) operations, checksum);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    Data_Array<Entity> structs;
+    structs.create(Default_Allocator, ENTITY_COUNT);
+
+    Entity_Columns columns;
+    columns.create(Default_Allocator, ENTITY_COUNT);
+
+    for(s64 i = 0; i < ENTITY_COUNT; ++i) {
+        f32 velocity_x = random.random_f32(-1.f, 1.f), velocity_y = random.random_f32(-1.f, 1.f), velocity_z = random.random_f32(-1.f, 1.f);
+
+        Data_Array_Id id = structs.push();
+        Entity *entity = structs.query(id);
+        entity->velocity_x = velocity_x;
+        entity->velocity_y = velocity_y;
+        entity->velocity_z = velocity_z;
+        entity->health     = 100.f;
+
+        id = columns.push();
+        *columns.query<3>(id) = velocity_x;
+        *columns.query<4>(id) = velocity_y;
+        *columns.query<5>(id) = velocity_z;
+        *columns.query<6>(id) = 100.f;
+    }
+
+    // Remove some entities so that the swap-on-remove compaction shuffles the storage a bit.
+    for(s64 i = 0; i < ENTITY_COUNT / 10; ++i) {
+        Data_Array_Id id = (Data_Array_Id) random.random_u64(0, ENTITY_COUNT - 1);
+        if(structs.id_is_valid(id)) structs.remove_by_id(id);
+        if(columns.id_is_valid(id)) columns.remove_by_id(id);
+    }
+
+    const f32 dt = 1.f / 60.f;
+
+    printf("Integrating positions of %" PRId64 " entities over %d frames:\n", structs.count, FRAME_COUNT);
+
+    CPU_Time start = os_get_cpu_time();
+    for(s64 frame = 0; frame < FRAME_COUNT; ++frame) {
+        for(s64 i = 0; i < structs.count; ++i) {
+            Entity *entity = &structs.data[i];
+            entity->x += entity->velocity_x * dt;
+            entity->y += entity->velocity_y * dt;
+            entity->z += entity->velocity_z * dt;
+        }
+    }
+    f64 checksum = 0;
+    for(s64 i = 0; i < structs.count; ++i) checksum += structs.data[i].x;
+    print_result("Data_Array (array of structs)", start, os_get_cpu_time(), structs.count * FRAME_COUNT, checksum);
+
+    start = os_get_cpu_time();
+    for(s64 frame = 0; frame < FRAME_COUNT; ++frame) {
+        f32 *x = columns.column<0>(), *y = columns.column<1>(), *z = columns.column<2>();
+        f32 *velocity_x = columns.column<3>(), *velocity_y = columns.column<4>(), *velocity_z = columns.column<5>();
+
+        for(s64 i = 0; i < columns.count; ++i) {
+            x[i] += velocity_x[i] * dt;
+            y[i] += velocity_y[i] * dt;
+            z[i] += velocity_z[i] * dt;
+        }
+    }
+    checksum = 0;
+    for(s64 i = 0; i < columns.count; ++i) checksum += columns.column<0>()[i];
+    print_result("Data_Array_SoA (struct of arrays)", start, os_get_cpu_time(), columns.count * FRAME_COUNT, checksum);
+
+    printf("Summing the health of %" PRId64 " entities over %d frames:\n", structs.count, FRAME_COUNT);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 frame = 0; frame < FRAME_COUNT; ++frame) {
+        f32 sum = 0;
+        for(s64 i = 0; i < structs.count; ++i) sum += structs.data[i].health;
+        checksum += sum;
+    }
+    print_result("Data_Array (array of structs)", start, os_get_cpu_time(), structs.count * FRAME_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 frame = 0; frame < FRAME_COUNT; ++frame) {
+        f32 sum = 0;
+        f32 *health = columns.column<6>();
+        for(s64 i = 0; i < columns.count; ++i) sum += health[i];
+        checksum += sum;
+    }
+    print_result("Data_Array_SoA (struct of arrays)", start, os_get_cpu_time(), columns.count * FRAME_COUNT, checksum);
+
+    structs.destroy();
+    columns.destroy();
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "data_array.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Simulates loading a level with a large number of entities, whose ids are read from the level file (and
+// therefore arrive in arbitrary order and with gaps from previously deleted entities), and then unloading a
+// part of it again. Compares pushing and removing every entity on its own against the batch operations, and
+// against restoring a memory-mapped snapshot of the level.
+//
+
+#define ENTITY_COUNT 1000000
+#define ID_CAPACITY  (ENTITY_COUNT + ENTITY_COUNT / 4)
+
+struct Entity {
+    f32 x, y, z;
+    f32 health;
+    u64 flags;
+};
+
+static
+void print_result(const char *name, CPU_Time start, CPU_Time end, s64 operations) {
+    f64 milliseconds = os_convert_cpu_time(end - start, Milliseconds);
+    printf("  %-40s %10.2fms, %8.2fns / entity\n", name, milliseconds, milliseconds * 1000000.0 / (f64) operations);
+}
+
+static
+void shuffle(Data_Array_Id *ids, s64 count, Random_Generator *random) {
+    for(s64 i = count - 1; i > 0; --i) {
+        s64 j = random->random_u64(0, i);
+        Data_Array_Id tmp = ids[i];
+        ids[i] = ids[j];
+        ids[j] = tmp;
+    }
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    // Build the ids of the level file: Every fifth id was deleted at some point in the past.
+    Data_Array_Id *level_ids = (Data_Array_Id *) Default_Allocator->allocate(ENTITY_COUNT * sizeof(Data_Array_Id));
+    s64 level_count = 0;
+
+    for(s64 id = 0; id < ID_CAPACITY && level_count < ENTITY_COUNT; ++id) {
+        if(id % 5 != 4) level_ids[level_count++] = (Data_Array_Id) id;
+    }
+
+    shuffle(level_ids, level_count, &random);
+
+    Data_Array_Id *removed_ids = (Data_Array_Id *) Default_Allocator->allocate(level_count / 2 * sizeof(Data_Array_Id));
+    memcpy(removed_ids, level_ids, level_count / 2 * sizeof(Data_Array_Id));
+    shuffle(removed_ids, level_count / 2, &random);
+
+    printf("Loading a level with %" PRId64 " entities:\n", level_count);
+
+    {
+        Data_Array<Entity> entities;
+        entities.create(Default_Allocator, ID_CAPACITY);
+
+        CPU_Time start = os_get_cpu_time();
+        for(s64 i = 0; i < level_count; ++i) {
+            Entity *entity = entities.push_with_id(level_ids[i]);
+            entity->health = 100.f;
+        }
+        print_result("push_with_id", start, os_get_cpu_time(), level_count);
+
+        start = os_get_cpu_time();
+        for(s64 i = 0; i < level_count / 2; ++i) entities.remove_by_id(removed_ids[i]);
+        print_result("remove_by_id (half the level)", start, os_get_cpu_time(), level_count / 2);
+
+        start = os_get_cpu_time();
+        for(s64 i = 0; i < level_count / 2; ++i) entities.push();
+        print_result("push (refill the half)", start, os_get_cpu_time(), level_count / 2);
+
+        entities.destroy();
+    }
+
+    {
+        Data_Array<Entity> entities;
+        entities.create(Default_Allocator, ID_CAPACITY);
+
+        CPU_Time start = os_get_cpu_time();
+        Entity *first = entities.push_many_with_ids(level_ids, level_count);
+        for(s64 i = 0; i < level_count; ++i) first[i].health = 100.f;
+        print_result("push_many_with_ids", start, os_get_cpu_time(), level_count);
+
+        start = os_get_cpu_time();
+        entities.remove_many(removed_ids, level_count / 2);
+        print_result("remove_many (half the level)", start, os_get_cpu_time(), level_count / 2);
+
+        start = os_get_cpu_time();
+        entities.push_many(level_count / 2, removed_ids);
+        print_result("push_many (refill the half)", start, os_get_cpu_time(), level_count / 2);
+
+        entities.destroy();
+    }
+
+    {
+        Data_Array<Entity> entities;
+        entities.create(Default_Allocator, ID_CAPACITY);
+        entities.push_many_with_ids(level_ids, level_count);
+
+        CPU_Time start = os_get_cpu_time();
+        entities.write_snapshot("data_array_level.snapshot"_s);
+        print_result("write_snapshot", start, os_get_cpu_time(), level_count);
+        entities.destroy();
+
+        start = os_get_cpu_time();
+        entities.restore_snapshot("data_array_level.snapshot"_s);
+        print_result("restore_snapshot", start, os_get_cpu_time(), level_count);
+
+        // Touching every entity pages in the whole file, which is what the restore itself gets to skip.
+        start = os_get_cpu_time();
+        f64 checksum = 0;
+        for(s64 i = 0; i < entities.count; ++i) checksum += entities.data[i].health + entities.id[i];
+        print_result("first pass over the restored entities", start, os_get_cpu_time(), level_count);
+        printf("  (checksum: %f)\n", checksum);
+
+        entities.destroy();
+        os_delete_file("data_array_level.snapshot"_s);
+    }
+
+    Default_Allocator->deallocate(removed_ids);
+    Default_Allocator->deallocate(level_ids);
+    return 0;
+}
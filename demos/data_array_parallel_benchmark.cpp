@@ -0,0 +1,111 @@
+#include "data_array.h"
+#include "jobs.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Measures how for_each_parallel scales with the number of job workers for an entity update which does a bit
+// of math per entity, and removes and spawns some entities through the command buffers.
+//
+
+#define ENTITY_COUNT 1000000
+#define FRAME_COUNT  20
+
+struct Entity {
+    f32 x, y, z;
+    f32 velocity_x, velocity_y, velocity_z;
+    f32 lifetime;
+};
+
+static
+void update_entity(Entity *entity, Data_Array_Id id, Data_Array_Command_Buffer<Entity> *commands) {
+    const f32 dt = 1.f / 60.f;
+
+    // Some damped oscillation, so that the update is not completely bound by memory bandwidth.
+    for(s64 i = 0; i < 8; ++i) {
+        entity->velocity_x -= entity->x * dt - entity->velocity_x * 0.01f;
+        entity->velocity_y -= entity->y * dt - entity->velocity_y * 0.01f;
+        entity->velocity_z -= entity->z * dt - entity->velocity_z * 0.01f;
+        entity->x += entity->velocity_x * dt;
+        entity->y += entity->velocity_y * dt;
+        entity->z += entity->velocity_z * dt;
+    }
+
+    entity->lifetime -= dt;
+
+    if(entity->lifetime <= 0.f) {
+        // Respawn the entity somewhere else.
+        commands->remove(id);
+        commands->add(Entity{ entity->y, entity->z, entity->x, 0.f, 0.f, 0.f, 10.f });
+    }
+}
+
+static
+void fill_entities(Data_Array<Entity> *entities, Random_Generator *random) {
+    for(s64 i = 0; i < ENTITY_COUNT; ++i) {
+        Entity *entity = entities->query(entities->push());
+        entity->x = random->random_f32(-1.f, 1.f);
+        entity->y = random->random_f32(-1.f, 1.f);
+        entity->z = random->random_f32(-1.f, 1.f);
+        entity->lifetime = random->random_f32(0.f, 0.5f);
+    }
+}
+
+static
+f64 checksum(Data_Array<Entity> *entities) {
+    f64 sum = 0;
+    for(s64 i = 0; i < entities->count; ++i) sum += entities->data[i].x;
+    return sum;
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    Data_Array<Entity> entities;
+    entities.create(Default_Allocator, ENTITY_COUNT);
+    fill_entities(&entities, &random);
+
+    printf("Updating %d entities over %d frames:\n", ENTITY_COUNT, FRAME_COUNT);
+
+    //
+    // The sequential baseline applies the commands just like for_each_parallel does, but with a single
+    // command buffer.
+    //
+    CPU_Time start = os_get_cpu_time();
+    for(s64 frame = 0; frame < FRAME_COUNT; ++frame) {
+        Data_Array_Command_Buffer<Entity> commands;
+        for(s64 i = 0; i < entities.count; ++i) update_entity(&entities.data[i], entities.id[i], &commands);
+        for(Data_Array_Id id : commands.removals) entities.remove_by_id(id);
+        for(Entity &entity : commands.additions) *entities.query(entities.push()) = entity;
+        commands.removals.clear();
+        commands.additions.clear();
+    }
+    f64 sequential = os_convert_cpu_time(os_get_cpu_time() - start, Milliseconds);
+    printf("  %-24s %10.2fms (checksum: %f)\n", "sequential", sequential, checksum(&entities));
+
+    s64 max_workers = os_get_number_of_hardware_threads();
+
+    for(s64 worker_count = 1; worker_count <= max_workers; worker_count *= 2) {
+        Job_System system;
+        create_job_system(&system, worker_count);
+
+        entities.destroy();
+        entities.create(Default_Allocator, ENTITY_COUNT);
+        random.seed(0x5eed);
+        fill_entities(&entities, &random);
+
+        start = os_get_cpu_time();
+        for(s64 frame = 0; frame < FRAME_COUNT; ++frame) {
+            for_each_parallel(&system, &entities, update_entity);
+        }
+        f64 parallel = os_convert_cpu_time(os_get_cpu_time() - start, Milliseconds);
+
+        printf("  %2" PRId64 " workers: %10.2fms (%5.2fx, checksum: %f)\n", worker_count, parallel, sequential / parallel, checksum(&entities));
+
+        destroy_job_system(&system, JOB_SYSTEM_Wait_On_All_Jobs);
+    }
+
+    entities.destroy();
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "string_type.h"
+#include "random.h"
+#include "os_specific.h"
+#include "math/v3.h"
+
+//
+// Measures the throughput of building short, UI-like strings, comparing mprint (which goes through vsnprintf
+// twice) against format into an Allocator, into a Memory_Arena and into a String_Builder.
+//
+
+#define STRING_COUNT 1000000
+#define REPETITIONS  5
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, Procedure procedure) {
+    f64 best = MAX_F64;
+    s64 checksum = 0;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        CPU_Time start = os_get_cpu_time();
+        checksum = procedure();
+        CPU_Time end = os_get_cpu_time();
+        best = MIN(best, os_convert_cpu_time(end - start, Seconds));
+    }
+
+    printf("  %-32s %10.2f M strings / s, %8.2fns / string (checksum: %" PRId64 ")\n", name, (f64) STRING_COUNT / best / 1000000.0, best * 1000000000.0 / (f64) STRING_COUNT, checksum);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    s32 *integers = (s32 *) Default_Allocator->allocate(STRING_COUNT * sizeof(s32));
+    f32 *floats   = (f32 *) Default_Allocator->allocate(STRING_COUNT * sizeof(f32));
+    for(s64 i = 0; i < STRING_COUNT; ++i) {
+        integers[i] = (s32) (random.random_u64() % 100000);
+        floats[i]   = random.random_f32(0.f, 1000.f);
+    }
+
+    const char *names[] = { "Frame Time", "Frame Rays", "Samples", "Bounces" };
+
+    Memory_Arena arena;
+    arena.create(4ULL * 1024 * 1024 * 1024);
+
+    printf("Formatting %d strings like \"Content: %%d\":\n", STRING_COUNT);
+
+    run_benchmark("mprint", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) {
+            string result = mprint(Default_Allocator, "Content: %d", integers[i]);
+            length += result.count;
+            deallocate_string(Default_Allocator, &result);
+        }
+        return length;
+    });
+
+    run_benchmark("format (Allocator)", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) {
+            string result = FORMAT(Default_Allocator, "Content: %d", integers[i]);
+            length += result.count;
+            deallocate_string(Default_Allocator, &result);
+        }
+        return length;
+    });
+
+    run_benchmark("format (Memory_Arena)", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) length += FORMAT(&arena, "Content: %d", integers[i]).count;
+        arena.reset();
+        return length;
+    });
+
+    printf("Formatting %d strings like \"%%s: %%.1f%%s\":\n", STRING_COUNT);
+
+    run_benchmark("mprint", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) {
+            string result = mprint(Default_Allocator, "%s: %.1f%s", names[i % ARRAY_COUNT(names)], floats[i], "ms");
+            length += result.count;
+            deallocate_string(Default_Allocator, &result);
+        }
+        return length;
+    });
+
+    run_benchmark("format (Allocator)", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) {
+            string result = FORMAT(Default_Allocator, "%s: %.1f%s", names[i % ARRAY_COUNT(names)], floats[i], "ms");
+            length += result.count;
+            deallocate_string(Default_Allocator, &result);
+        }
+        return length;
+    });
+
+    run_benchmark("format (Memory_Arena)", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) length += FORMAT(&arena, "%s: %.1f%s", names[i % ARRAY_COUNT(names)], floats[i], "ms").count;
+        arena.reset();
+        return length;
+    });
+
+    printf("Formatting %d vectors:\n", STRING_COUNT);
+
+    run_benchmark("mprint", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) {
+            v3f position = v3f(floats[i], floats[(i + 1) % STRING_COUNT], floats[(i + 2) % STRING_COUNT]);
+            string result = mprint(Default_Allocator, "Position: (%.2f, %.2f, %.2f)", position.x, position.y, position.z);
+            length += result.count;
+            deallocate_string(Default_Allocator, &result);
+        }
+        return length;
+    });
+
+    run_benchmark("format (Memory_Arena)", [&]() {
+        s64 length = 0;
+        for(s64 i = 0; i < STRING_COUNT; ++i) {
+            v3f position = v3f(floats[i], floats[(i + 1) % STRING_COUNT], floats[(i + 2) % STRING_COUNT]);
+            length += FORMAT(&arena, "Position: %.2f", position).count;
+        }
+        arena.reset();
+        return length;
+    });
+
+    run_benchmark("format (String_Builder)", [&]() {
+        String_Builder builder;
+        builder.create(Default_Allocator);
+        for(s64 i = 0; i < STRING_COUNT; ++i) {
+            v3f position = v3f(floats[i], floats[(i + 1) % STRING_COUNT], floats[(i + 2) % STRING_COUNT]);
+            FORMAT(&builder, "Position: %.2f\n", position);
+        }
+        s64 length = builder.total_count;
+        builder.destroy();
+        return length;
+    });
+
+    arena.destroy();
+    Default_Allocator->deallocate(floats);
+    Default_Allocator->deallocate(integers);
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include "string_type.h"
+#include "random.h"
+#include "os_specific.h"
+
+#include <stdlib.h> // For strtod, strtoll...
+#include <string.h>
+
+//
+// Measures the throughput of parsing and formatting numbers, comparing string_to_double, string_to_int and
+// the String_Builder against the C runtime. Before that, it checks that the parsed values are bit-identical
+// to strtod's, and that the formatted floats parse back to exactly the same value.
+//
+
+#define NUMBER_COUNT 1000000
+#define REPETITIONS  5
+#define TEXT_LENGTH  32
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, Procedure procedure) {
+    f64 best = MAX_F64;
+    s64 checksum = 0;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        CPU_Time start = os_get_cpu_time();
+        checksum = procedure();
+        CPU_Time end = os_get_cpu_time();
+        best = MIN(best, os_convert_cpu_time(end - start, Seconds));
+    }
+
+    printf("  %-32s %10.2f M numbers / s, %8.2fns / number (checksum: %" PRId64 ")\n", name, (f64) NUMBER_COUNT / best / 1000000.0, best * 1000000000.0 / (f64) NUMBER_COUNT, checksum);
+}
+
+static
+s64 bits_of(f64 value) {
+    s64 bits;
+    memcpy(&bits, &value, sizeof(f64));
+    return bits;
+}
+
+static
+f64 random_double(Random_Generator *random) {
+    // Mostly the kind of values found in data files, with the occasional arbitrary bit pattern.
+    if(random->random_u64() % 8 == 0) {
+        u64 bits = random->random_u64();
+        f64 value;
+        memcpy(&value, &bits, sizeof(f64));
+        if(value == value && value - value == 0) return value;
+    }
+
+    return random->random_f64(-1000.0, 1000.0);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    f64 *doubles  = (f64 *) Default_Allocator->allocate(NUMBER_COUNT * sizeof(f64));
+    s64 *integers = (s64 *) Default_Allocator->allocate(NUMBER_COUNT * sizeof(s64));
+    char *double_texts  = (char *) Default_Allocator->allocate(NUMBER_COUNT * TEXT_LENGTH);
+    char *integer_texts = (char *) Default_Allocator->allocate(NUMBER_COUNT * TEXT_LENGTH);
+
+    for(s64 i = 0; i < NUMBER_COUNT; ++i) {
+        doubles[i]  = random_double(&random);
+        integers[i] = (s64) (random.random_u64() >> (random.random_u64() % 64));
+        snprintf(&double_texts[i * TEXT_LENGTH], TEXT_LENGTH, "%.17g", doubles[i]);
+        snprintf(&integer_texts[i * TEXT_LENGTH], TEXT_LENGTH, "%" PRId64, integers[i]);
+    }
+
+    //
+    // Correctness.
+    //
+    s64 parse_mismatches = 0, round_trip_mismatches = 0;
+
+    for(s64 i = 0; i < NUMBER_COUNT; ++i) {
+        char *text = &double_texts[i * TEXT_LENGTH];
+
+        b8 success;
+        f64 parsed   = string_to_double(string_view((u8 *) text, cstring_length(text)), &success);
+        f64 expected = strtod(text, null);
+        if(!success || memcmp(&parsed, &expected, sizeof(f64)) != 0) ++parse_mismatches;
+
+        String_Builder builder;
+        builder.create(Default_Allocator);
+        builder.append_f64(doubles[i]);
+        string formatted = builder.finish();
+
+        f64 round_trip = string_to_double(formatted, &success);
+        if(!success || memcmp(&round_trip, &doubles[i], sizeof(f64)) != 0) ++round_trip_mismatches;
+
+        deallocate_string(Default_Allocator, &formatted);
+    }
+
+    printf("Checked %d numbers: %" PRId64 " differ from strtod, %" PRId64 " do not round trip.\n", NUMBER_COUNT, parse_mismatches, round_trip_mismatches);
+
+    //
+    // Parsing.
+    //
+    printf("Parsing %d doubles:\n", NUMBER_COUNT);
+
+    run_benchmark("strtod", [&]() {
+        s64 checksum = 0;
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) checksum ^= bits_of(strtod(&double_texts[i * TEXT_LENGTH], null));
+        return checksum;
+    });
+
+    run_benchmark("string_to_double", [&]() {
+        s64 checksum = 0;
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) {
+            char *text = &double_texts[i * TEXT_LENGTH];
+            checksum ^= bits_of(string_to_double(string_view((u8 *) text, cstring_length(text)), null));
+        }
+        return checksum;
+    });
+
+    printf("Parsing %d integers:\n", NUMBER_COUNT);
+
+    run_benchmark("strtoll", [&]() {
+        s64 sum = 0;
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) sum += strtoll(&integer_texts[i * TEXT_LENGTH], null, 10);
+        return sum;
+    });
+
+    run_benchmark("string_to_int", [&]() {
+        s64 sum = 0;
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) {
+            char *text = &integer_texts[i * TEXT_LENGTH];
+            sum += string_to_int(string_view((u8 *) text, cstring_length(text)), null);
+        }
+        return sum;
+    });
+
+    //
+    // Formatting.
+    //
+    printf("Formatting %d doubles:\n", NUMBER_COUNT);
+
+    run_benchmark("snprintf %.17g", [&]() {
+        s64 length = 0;
+        char buffer[TEXT_LENGTH];
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) length += snprintf(buffer, sizeof(buffer), "%.17g", doubles[i]);
+        return length;
+    });
+
+    run_benchmark("String_Builder::append_f64", [&]() {
+        String_Builder builder;
+        builder.create(Default_Allocator);
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) builder.append_f64(doubles[i]);
+        s64 length = builder.total_count;
+        builder.destroy();
+        return length;
+    });
+
+    printf("Formatting %d integers:\n", NUMBER_COUNT);
+
+    run_benchmark("snprintf %lld", [&]() {
+        s64 length = 0;
+        char buffer[TEXT_LENGTH];
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) length += snprintf(buffer, sizeof(buffer), "%" PRId64, integers[i]);
+        return length;
+    });
+
+    run_benchmark("String_Builder::append_s64", [&]() {
+        String_Builder builder;
+        builder.create(Default_Allocator);
+        for(s64 i = 0; i < NUMBER_COUNT; ++i) builder.append_s64(integers[i]);
+        s64 length = builder.total_count;
+        builder.destroy();
+        return length;
+    });
+
+    Default_Allocator->deallocate(integer_texts);
+    Default_Allocator->deallocate(double_texts);
+    Default_Allocator->deallocate(integers);
+    Default_Allocator->deallocate(doubles);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "ordered_map.h"
+#include "art.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Compares the BTree_Map, the Flat_Map and the Adaptive_Radix_Tree on random inserts, point lookups and range
+// scans with u64 keys. The Flat_Map gets filled in ascending key order, which is how read-mostly maps are
+// usually built (every insert is then just an append).
+//
+
+#define ENTRY_COUNT  1000000
+#define LOOKUP_COUNT 1000000
+#define RANGE_COUNT  10000
+#define RANGE_WIDTH  1000000000000ULL // Roughly 50 entries per range for random 64-bit keys.
+
+static
+void print_result(const char *name, CPU_Time start, CPU_Time end, s64 operations, u64 checksum) {
+    f64 milliseconds = os_convert_cpu_time(end - start, Milliseconds);
+    printf("  %-24s %10.2fms, %8.2fns / operation (checksum: %" PRIu64 ")\n", name, milliseconds, milliseconds * 1000000.0 / (f64) operations, checksum);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    u64 *keys    = (u64 *) Default_Allocator->allocate(ENTRY_COUNT * sizeof(u64));
+    u64 *lookups = (u64 *) Default_Allocator->allocate(LOOKUP_COUNT * sizeof(u64));
+
+    for(s64 i = 0; i < ENTRY_COUNT; ++i) keys[i] = random.random_u64();
+    for(s64 i = 0; i < LOOKUP_COUNT; ++i) lookups[i] = keys[random.random_u64() % ENTRY_COUNT];
+
+    BTree_Map<u64, u64> btree;
+    btree.create();
+
+    Flat_Map<u64, u64> flat;
+    flat.create(Default_Allocator, ENTRY_COUNT);
+
+    Adaptive_Radix_Tree<u64, u64> art;
+    art.create();
+
+    printf("Inserting %d random keys:\n", ENTRY_COUNT);
+
+    CPU_Time start = os_get_cpu_time();
+    for(s64 i = 0; i < ENTRY_COUNT; ++i) btree.add(keys[i], i);
+    print_result("BTree_Map", start, os_get_cpu_time(), ENTRY_COUNT, btree.count);
+
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < ENTRY_COUNT; ++i) art.add(keys[i], i);
+    print_result("Adaptive_Radix_Tree", start, os_get_cpu_time(), ENTRY_COUNT, art.count);
+
+    start = os_get_cpu_time();
+    btree.iterate([&](u64 *key, u64 *value) { flat.add(*key, *value); });
+    print_result("Flat_Map (ascending)", start, os_get_cpu_time(), ENTRY_COUNT, flat.count);
+
+    printf("Looking up %d random keys:\n", LOOKUP_COUNT);
+
+    u64 checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < LOOKUP_COUNT; ++i) checksum += *btree.query(lookups[i]);
+    print_result("BTree_Map", start, os_get_cpu_time(), LOOKUP_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < LOOKUP_COUNT; ++i) checksum += *flat.query(lookups[i]);
+    print_result("Flat_Map", start, os_get_cpu_time(), LOOKUP_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < LOOKUP_COUNT; ++i) checksum += *art.query(lookups[i]);
+    print_result("Adaptive_Radix_Tree", start, os_get_cpu_time(), LOOKUP_COUNT, checksum);
+
+    printf("Scanning %d random ranges:\n", RANGE_COUNT);
+
+    auto sum_values = [&checksum](u64 *, u64 *value) { checksum += *value; };
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < RANGE_COUNT; ++i) btree.iterate_range(lookups[i], lookups[i] + RANGE_WIDTH, sum_values);
+    print_result("BTree_Map", start, os_get_cpu_time(), RANGE_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < RANGE_COUNT; ++i) flat.iterate_range(lookups[i], lookups[i] + RANGE_WIDTH, sum_values);
+    print_result("Flat_Map", start, os_get_cpu_time(), RANGE_COUNT, checksum);
+
+    checksum = 0;
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < RANGE_COUNT; ++i) art.iterate_range(lookups[i], lookups[i] + RANGE_WIDTH, sum_values);
+    print_result("Adaptive_Radix_Tree", start, os_get_cpu_time(), RANGE_COUNT, checksum);
+
+    printf("Removing %d keys:\n", ENTRY_COUNT);
+
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < ENTRY_COUNT; ++i) btree.remove(keys[i]);
+    print_result("BTree_Map", start, os_get_cpu_time(), ENTRY_COUNT, btree.count);
+
+    start = os_get_cpu_time();
+    for(s64 i = 0; i < ENTRY_COUNT; ++i) art.remove(keys[i]);
+    print_result("Adaptive_Radix_Tree", start, os_get_cpu_time(), ENTRY_COUNT, art.count);
+
+    art.destroy();
+    flat.destroy();
+    btree.destroy();
+
+    Default_Allocator->deallocate(lookups);
+    Default_Allocator->deallocate(keys);
+    return 0;
+}
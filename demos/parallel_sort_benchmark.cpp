@@ -0,0 +1,86 @@
+#include "sort.h"
+#include "jobs.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Measures how parallel_sort and parallel_stable_sort scale with the number of job workers, compared to the
+// single-threaded sort and stable_sort.
+//
+
+#define ELEMENT_COUNT 8000000
+#define REPETITIONS   3
+
+struct Sort_Entry {
+    u64 key;
+    u64 payload;
+};
+
+static
+Sort_Comparison_Result compare_entries(Sort_Entry *lhs, Sort_Entry *rhs) {
+    return lhs->key < rhs->key ? SORT_Lhs_Is_Smaller : (lhs->key > rhs->key ? SORT_Lhs_Is_Bigger : SORT_Lhs_Equals_Rhs);
+}
+
+template<typename Procedure>
+static
+f64 run_benchmark(Sort_Entry *input, Sort_Entry *scratch, s64 count, Procedure procedure) {
+    f64 best = MAX_F64;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        memcpy(scratch, input, count * sizeof(Sort_Entry));
+
+        CPU_Time start = os_get_cpu_time();
+        procedure(scratch, count);
+        CPU_Time end = os_get_cpu_time();
+
+        best = MIN(best, os_convert_cpu_time(end - start, Milliseconds));
+    }
+
+    for(s64 i = 1; i < count; ++i) {
+        if(scratch[i - 1].key > scratch[i].key) {
+            printf("  Error: The output is not sorted.\n");
+            break;
+        }
+    }
+
+    return best;
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    Sort_Entry *input   = (Sort_Entry *) Default_Allocator->allocate(ELEMENT_COUNT * sizeof(Sort_Entry));
+    Sort_Entry *scratch = (Sort_Entry *) Default_Allocator->allocate(ELEMENT_COUNT * sizeof(Sort_Entry));
+
+    for(s64 i = 0; i < ELEMENT_COUNT; ++i) {
+        input[i].key     = random.random_u64();
+        input[i].payload = i;
+    }
+
+    printf("Sorting %d random 16-byte entries:\n", ELEMENT_COUNT);
+
+    f64 sequential = run_benchmark(input, scratch, ELEMENT_COUNT, [](Sort_Entry *array, s64 count) { sort(array, count, compare_entries); });
+    f64 sequential_stable = run_benchmark(input, scratch, ELEMENT_COUNT, [](Sort_Entry *array, s64 count) { stable_sort(array, count, compare_entries); });
+
+    printf("  %-24s %10.2fms\n", "sort", sequential);
+    printf("  %-24s %10.2fms\n", "stable_sort", sequential_stable);
+
+    s64 max_workers = os_get_number_of_hardware_threads();
+
+    for(s64 worker_count = 1; worker_count <= max_workers; worker_count *= 2) {
+        Job_System system;
+        create_job_system(&system, worker_count);
+
+        f64 parallel = run_benchmark(input, scratch, ELEMENT_COUNT, [&](Sort_Entry *array, s64 count) { parallel_sort(&system, array, count, compare_entries); });
+        f64 parallel_stable = run_benchmark(input, scratch, ELEMENT_COUNT, [&](Sort_Entry *array, s64 count) { parallel_stable_sort(&system, array, count, compare_entries); });
+
+        printf("  %2" PRId64 " workers: parallel_sort %10.2fms (%5.2fx), parallel_stable_sort %10.2fms (%5.2fx)\n", worker_count, parallel, sequential / parallel, parallel_stable, sequential_stable / parallel_stable);
+
+        destroy_job_system(&system, JOB_SYSTEM_Wait_On_All_Jobs);
+    }
+
+    Default_Allocator->deallocate(scratch);
+    Default_Allocator->deallocate(input);
+    return 0;
+}
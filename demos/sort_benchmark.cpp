@@ -0,0 +1,110 @@
+#include "sort.h"
+#include "random.h"
+#include "os_specific.h"
+
+#include <stdlib.h> // For qsort
+
+//
+// Compares the pattern-defeating sort (with an inlined lambda and with a function pointer comparator), the
+// radix sort and the C standard library's qsort on different input distributions.
+//
+
+#define ELEMENT_COUNT 1000000
+#define REPETITIONS   5
+
+enum Input_Pattern {
+    INPUT_Random,
+    INPUT_Sorted,
+    INPUT_Reversed,
+    INPUT_Few_Unique,
+    INPUT_Organ_Pipe,
+    INPUT_COUNT,
+};
+
+static const char *input_pattern_names[INPUT_COUNT] = { "random", "sorted", "reversed", "few unique", "organ pipe" };
+
+static
+Sort_Comparison_Result sort_u64(u64 *lhs, u64 *rhs) {
+    return *lhs < *rhs ? SORT_Lhs_Is_Smaller : (*lhs > *rhs ? SORT_Lhs_Is_Bigger : SORT_Lhs_Equals_Rhs);
+}
+
+static
+int qsort_u64(const void *lhs, const void *rhs) {
+    u64 l = *(u64 *) lhs, r = *(u64 *) rhs;
+    return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+static
+void fill_input(u64 *array, s64 count, Input_Pattern pattern, Random_Generator *random) {
+    for(s64 i = 0; i < count; ++i) {
+        switch(pattern) {
+        case INPUT_Random:     array[i] = random->random_u64(); break;
+        case INPUT_Sorted:     array[i] = i; break;
+        case INPUT_Reversed:   array[i] = count - i; break;
+        case INPUT_Few_Unique: array[i] = random->random_u64(0, 15); break;
+        case INPUT_Organ_Pipe: array[i] = i < count / 2 ? i : count - i; break;
+        default: break;
+        }
+    }
+}
+
+static
+b8 is_sorted(u64 *array, s64 count) {
+    for(s64 i = 1; i < count; ++i) {
+        if(array[i - 1] > array[i]) return false;
+    }
+
+    return true;
+}
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, u64 *input, u64 *scratch, s64 count, Procedure procedure) {
+    f64 best = MAX_F64;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        memcpy(scratch, input, count * sizeof(u64));
+
+        CPU_Time start = os_get_cpu_time();
+        procedure(scratch, count);
+        CPU_Time end = os_get_cpu_time();
+
+        best = MIN(best, os_convert_cpu_time(end - start, Milliseconds));
+    }
+
+    printf("  %-24s %10.2fms, %8.2fns / element%s\n", name, best, best * 1000000.0 / (f64) count, is_sorted(scratch, count) ? "" : " (NOT SORTED)");
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    u64 *input   = (u64 *) Default_Allocator->allocate(ELEMENT_COUNT * sizeof(u64));
+    u64 *scratch = (u64 *) Default_Allocator->allocate(ELEMENT_COUNT * sizeof(u64));
+
+    for(s64 pattern = 0; pattern < INPUT_COUNT; ++pattern) {
+        fill_input(input, ELEMENT_COUNT, (Input_Pattern) pattern, &random);
+
+        printf("Sorting %d u64 (%s):\n", ELEMENT_COUNT, input_pattern_names[pattern]);
+
+        run_benchmark("sort (lambda)", input, scratch, ELEMENT_COUNT, [](u64 *array, s64 count) {
+            sort(array, count, [](u64 *lhs, u64 *rhs) { return *lhs < *rhs ? SORT_Lhs_Is_Smaller : (*lhs > *rhs ? SORT_Lhs_Is_Bigger : SORT_Lhs_Equals_Rhs); });
+        });
+
+        run_benchmark("sort (function pointer)", input, scratch, ELEMENT_COUNT, [](u64 *array, s64 count) {
+            sort(array, count, sort_u64);
+        });
+
+        run_benchmark("radix_sort", input, scratch, ELEMENT_COUNT, [](u64 *array, s64 count) {
+            radix_sort(array, count);
+        });
+
+        run_benchmark("qsort", input, scratch, ELEMENT_COUNT, [](u64 *array, s64 count) {
+            qsort(array, count, sizeof(u64), qsort_u64);
+        });
+    }
+
+    Default_Allocator->deallocate(scratch);
+    Default_Allocator->deallocate(input);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "string_type.h"
+#include "random.h"
+#include "os_specific.h"
+
+#include <string.h> // For memchr, memmem...
+
+//
+// Compares the string primitives against their glibc counterparts, on short strings (like tweak variable
+// names and asset paths) and on a long text buffer (like a whole file being parsed).
+//
+
+#define SHORT_COUNT     64
+#define SHORT_LENGTH    24
+#define LONG_LENGTH     (16 * 1024 * 1024)
+#define SHORT_REPEATS   200000
+#define LONG_REPEATS    20
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, s64 repeats, s64 bytes_per_repeat, Procedure procedure) {
+    s64 checksum = 0;
+
+    CPU_Time start = os_get_cpu_time();
+    for(s64 i = 0; i < repeats; ++i) checksum += procedure(i);
+    CPU_Time end = os_get_cpu_time();
+
+    f64 seconds = os_convert_cpu_time(end - start, Seconds);
+    printf("  %-32s %10.2f GB/s (checksum: %" PRId64 ")\n", name, (f64) (repeats * bytes_per_repeat) / seconds / 1000000000.0, checksum);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    // Lower case text with spaces, the interesting characters only appear at the very end.
+    char *text = (char *) Default_Allocator->allocate(LONG_LENGTH + 1);
+    for(s64 i = 0; i < LONG_LENGTH; ++i) text[i] = (random.random_u64() % 6 == 0) ? ' ' : (char) ('a' + random.random_u64() % 26);
+    text[LONG_LENGTH - 1] = '#';
+    text[LONG_LENGTH] = 0;
+
+    char *copy = (char *) Default_Allocator->allocate(LONG_LENGTH + 1);
+    memcpy(copy, text, LONG_LENGTH + 1);
+
+    string needle = "needle in the haystack#"_s;
+    memcpy(&text[LONG_LENGTH - needle.count], needle.data, needle.count);
+    memcpy(&copy[LONG_LENGTH - needle.count], needle.data, needle.count);
+
+    char short_strings[SHORT_COUNT][SHORT_LENGTH + 1];
+    string short_views[SHORT_COUNT];
+    for(s64 i = 0; i < SHORT_COUNT; ++i) {
+        memcpy(short_strings[i], "data/textures/xxxxxxxxx/", SHORT_LENGTH);
+        for(s64 j = 14; j < 23; ++j) short_strings[i][j] = (char) ('a' + random.random_u64() % 26);
+        short_strings[i][SHORT_LENGTH] = 0;
+        short_views[i] = string_view(short_strings[i], SHORT_LENGTH);
+    }
+
+    // Read the inputs through volatile pointers, so that the compiler cannot hoist calls to the (pure) C
+    // runtime functions out of the benchmark loop.
+    char *volatile long_text = text;
+    char *volatile long_text_copy = copy;
+
+    printf("Searching a %d MB buffer:\n", LONG_LENGTH / (1024 * 1024));
+
+    run_benchmark("search_string", LONG_REPEATS, LONG_LENGTH, [&](s64) { return search_string(string_view(long_text, LONG_LENGTH), '#'); });
+    run_benchmark("memchr", LONG_REPEATS, LONG_LENGTH, [&](s64) { return (s64) ((char *) memchr(long_text, '#', LONG_LENGTH) != null); });
+    run_benchmark("search_string_reverse", LONG_REPEATS, LONG_LENGTH, [&](s64) { return search_string_reverse(string_view(long_text, LONG_LENGTH), '$'); });
+    run_benchmark("memrchr", LONG_REPEATS, LONG_LENGTH, [&](s64) { return (s64) (memrchr(long_text, '$', LONG_LENGTH) != null); });
+    run_benchmark("cstring_length", LONG_REPEATS, LONG_LENGTH, [&](s64) { return cstring_length(long_text); });
+    run_benchmark("strlen", LONG_REPEATS, LONG_LENGTH, [&](s64) { return (s64) strlen(long_text); });
+    run_benchmark("strings_equal", LONG_REPEATS, LONG_LENGTH, [&](s64) { return (s64) strings_equal(string_view(long_text, LONG_LENGTH), string_view(long_text_copy, LONG_LENGTH)); });
+    run_benchmark("memcmp", LONG_REPEATS, LONG_LENGTH, [&](s64) { return (s64) (memcmp(long_text, long_text_copy, LONG_LENGTH) == 0); });
+    run_benchmark("search_substring", LONG_REPEATS, LONG_LENGTH, [&](s64) { return search_substring(string_view(long_text, LONG_LENGTH), needle); });
+    run_benchmark("memmem", LONG_REPEATS, LONG_LENGTH, [&](s64) { return (s64) (memmem(long_text, LONG_LENGTH, needle.data, needle.count) != null); });
+    run_benchmark("strstr", LONG_REPEATS, LONG_LENGTH, [&](s64) { return (s64) (strstr(long_text, (char *) needle.data) != null); });
+
+    printf("Working on %d byte strings:\n", SHORT_LENGTH);
+
+    s64 short_repeats = SHORT_REPEATS * SHORT_COUNT;
+
+    run_benchmark("search_string", short_repeats, SHORT_LENGTH, [&](s64 i) { return search_string(short_views[i % SHORT_COUNT], '/'); });
+    run_benchmark("memchr", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) (memchr(short_strings[i % SHORT_COUNT], '/', SHORT_LENGTH) != null); });
+    run_benchmark("search_string_reverse", short_repeats, SHORT_LENGTH, [&](s64 i) { return search_string_reverse(short_views[i % SHORT_COUNT], 'q'); });
+    run_benchmark("memrchr", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) (memrchr(short_strings[i % SHORT_COUNT], 'q', SHORT_LENGTH) != null); });
+    run_benchmark("cstring_length", short_repeats, SHORT_LENGTH, [&](s64 i) { return cstring_length(short_strings[i % SHORT_COUNT]); });
+    run_benchmark("strlen", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) strlen(short_strings[i % SHORT_COUNT]); });
+    run_benchmark("strings_equal", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) strings_equal(short_views[i % SHORT_COUNT], short_views[(i + 1) % SHORT_COUNT]); });
+    run_benchmark("memcmp", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) (memcmp(short_strings[i % SHORT_COUNT], short_strings[(i + 1) % SHORT_COUNT], SHORT_LENGTH) == 0); });
+    run_benchmark("string_starts_with", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) string_starts_with(short_views[i % SHORT_COUNT], "data/textures/"_s); });
+    run_benchmark("strncmp", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) (strncmp(short_strings[i % SHORT_COUNT], "data/textures/", 14) == 0); });
+    run_benchmark("search_substring", short_repeats, SHORT_LENGTH, [&](s64 i) { return search_substring(short_views[i % SHORT_COUNT], "xyz"_s); });
+    run_benchmark("memmem", short_repeats, SHORT_LENGTH, [&](s64 i) { return (s64) (memmem(short_strings[i % SHORT_COUNT], SHORT_LENGTH, "xyz", 3) != null); });
+
+    Default_Allocator->deallocate(copy);
+    Default_Allocator->deallocate(text);
+    return 0;
+}
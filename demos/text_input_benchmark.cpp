@@ -0,0 +1,136 @@
+#include "text_input.h"
+#include "window.h"
+#include "font.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Measures editing a large text (like a log pasted into the in-game console) through a Text_Input, against
+// a flat buffer which moves the whole tail on every edit. The edits happen in the middle of the text, where
+// a flat buffer is at its worst. If a font file is passed as the first argument, this also measures how long
+// update_text_input takes to find the cursor position in pixels after an edit (which only measures the
+// cursor's line), against measuring all the text in front of the cursor.
+//
+
+#define TEXT_SIZE   (4 * 1024 * 1024)
+#define EDIT_COUNT  20000
+#define REPETITIONS 5
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, s64 operations, Procedure procedure) {
+    f64 best = MAX_F64;
+    s64 checksum = 0;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        CPU_Time start = os_get_cpu_time();
+        checksum = procedure();
+        CPU_Time end = os_get_cpu_time();
+        best = MIN(best, os_convert_cpu_time(end - start, Seconds));
+    }
+
+    printf("  %-32s %12.2fns / operation (checksum: %" PRId64 ")\n", name, best * 1000000000.0 / (f64) operations, checksum);
+}
+
+struct Flat_Buffer {
+    u8 *data;
+    s64 count;
+};
+
+static
+void flat_buffer_insert(Flat_Buffer *buffer, s64 position, string text) {
+    memmove(&buffer->data[position + text.count], &buffer->data[position], buffer->count - position);
+    memcpy(&buffer->data[position], text.data, text.count);
+    buffer->count += text.count;
+}
+
+static
+void flat_buffer_remove(Flat_Buffer *buffer, s64 first_to_remove, s64 last_to_remove) {
+    memmove(&buffer->data[first_to_remove], &buffer->data[last_to_remove + 1], buffer->count - (last_to_remove + 1));
+    buffer->count -= (last_to_remove - first_to_remove) + 1;
+}
+
+int main(int argc, char **argv) {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    // A log with lines of 80 characters on average.
+    string log = allocate_string(Default_Allocator, TEXT_SIZE);
+    for(s64 i = 0; i < log.count; ++i) log.data[i] = (random.random_u64() % 80 == 0) ? '\n' : (u8) ('a' + random.random_u64() % 26);
+
+    string character = "x"_s;
+    s64 middle = TEXT_SIZE / 2;
+
+    printf("Editing in the middle of a %d MB text:\n", TEXT_SIZE / (1024 * 1024));
+
+    Text_Input input;
+    create_text_input(&input, TEXT_INPUT_Everything);
+
+    run_benchmark("Text_Input paste", 1, [&]() {
+        clear_text_input(&input);
+        insert_text_input_string(&input, log);
+        return text_input_line_count(&input);
+    });
+
+    run_benchmark("Text_Input type and delete", EDIT_COUNT * 2, [&]() {
+        input.cursor = middle;
+        for(s64 i = 0; i < EDIT_COUNT; ++i) insert_text_input_string(&input, character);
+        for(s64 i = 0; i < EDIT_COUNT; ++i) remove_text_input_range(&input, input.cursor - 1, input.cursor - 1);
+        return input.count;
+    });
+
+    Flat_Buffer flat = { (u8 *) Default_Allocator->allocate(TEXT_SIZE + EDIT_COUNT), 0 };
+    flat_buffer_insert(&flat, 0, log);
+
+    run_benchmark("flat buffer type and delete", EDIT_COUNT * 2, [&]() {
+        s64 cursor = middle;
+        for(s64 i = 0; i < EDIT_COUNT; ++i) flat_buffer_insert(&flat, cursor++, character);
+        for(s64 i = 0; i < EDIT_COUNT; ++i) flat_buffer_remove(&flat, cursor - 1, cursor - 1), --cursor;
+        return flat.count;
+    });
+
+    if(argc > 1) {
+        Font font;
+        Error_Code error = create_font_from_file(&font, cstring_view(argv[1]), 12, FONT_FILTER_Mono, GLYPH_SET_Extended_Ascii);
+
+        if(error == Success) {
+            printf("Finding the cursor position in pixels after every edit:\n");
+
+            // No events are ever pushed into this window, it only provides the frame time to update_text_input.
+            Window window = {};
+            window.frame_time = 1.f / 60.f;
+
+            run_benchmark("update_text_input", EDIT_COUNT, [&]() {
+                s64 width = 0;
+                input.cursor = middle;
+                for(s64 i = 0; i < EDIT_COUNT; ++i) {
+                    insert_text_input_string(&input, character);
+                    remove_text_input_range(&input, input.cursor - 1, input.cursor - 1);
+                    update_text_input(&input, &window, &font);
+                    width += (s64) input.target_cursor_x;
+                }
+                return width;
+            });
+
+            run_benchmark("measuring until the cursor", EDIT_COUNT / 100, [&]() {
+                s64 width = 0;
+                input.cursor = middle;
+                for(s64 i = 0; i < EDIT_COUNT / 100; ++i) {
+                    insert_text_input_string(&input, character);
+                    remove_text_input_range(&input, input.cursor - 1, input.cursor - 1);
+                    width += get_string_width_in_pixels(&font, text_input_string_view_until_cursor(&input));
+                }
+                return width;
+            });
+
+            destroy_font(&font);
+        } else {
+            printf("Failed to load the font '%s'.\n", argv[1]);
+        }
+    }
+
+    Default_Allocator->deallocate(flat.data);
+    destroy_text_input(&input);
+    deallocate_string(Default_Allocator, &log);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "string_type.h"
+#include "font.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Measures UTF-8 validation and decoding throughput, and the text layout throughput of a font on mixed-script
+// text (English, German, Greek and Cyrillic words with typographic punctuation), the kind of text a localized
+// UI has to lay out every frame. The layout part needs a font file with Greek and Cyrillic glyphs, which is
+// passed as the first argument.
+//
+
+#define TEXT_SIZE   (16 * 1024 * 1024)
+#define LINE_LENGTH 80
+#define REPETITIONS 5
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, s64 bytes, Procedure procedure) {
+    f64 best = MAX_F64;
+    s64 checksum = 0;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        CPU_Time start = os_get_cpu_time();
+        checksum = procedure();
+        CPU_Time end = os_get_cpu_time();
+        best = MIN(best, os_convert_cpu_time(end - start, Seconds));
+    }
+
+    printf("  %-32s %10.2f MB/s (checksum: %" PRId64 ")\n", name, (f64) bytes / best / (1024.0 * 1024.0), checksum);
+}
+
+static
+string generate_mixed_text(Random_Generator *random) {
+    string words[] = {
+        "the"_s, "quick"_s, "brown"_s, "fox"_s, "settings"_s, "volume"_s,
+        "Größe"_s, "Einstellungen"_s, "schließen"_s, "Übersicht"_s,
+        "Ρυθμίσεις"_s, "ένταση"_s, "κλείσιμο"_s,
+        "Настройки"_s, "громкость"_s, "закрыть"_s, "Сохранить"_s,
+        "“quoted”"_s, "—"_s, "…"_s, "42"_s, "3.5"_s,
+    };
+
+    string text = allocate_string(Default_Allocator, TEXT_SIZE);
+    s64 position = 0, line_start = 0;
+
+    while(true) {
+        string word = words[random->random_u64() % ARRAY_COUNT(words)];
+        if(position + word.count + 1 > TEXT_SIZE) break;
+
+        memcpy(&text.data[position], word.data, word.count);
+        position += word.count;
+
+        if(position - line_start >= LINE_LENGTH) {
+            text.data[position++] = '\n';
+            line_start = position;
+        } else {
+            text.data[position++] = ' ';
+        }
+    }
+
+    text.count = position;
+    return text;
+}
+
+int main(int argc, char **argv) {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    string text = generate_mixed_text(&random);
+    u32 *code_points = (u32 *) Default_Allocator->allocate(text.count * sizeof(u32));
+
+    printf("Validating %" PRId64 " MB of mixed-script UTF-8:\n", text.count / (1024 * 1024));
+
+    run_benchmark("sequence by sequence", text.count, [&]() {
+        s64 valid = 0;
+        s64 index = 0;
+        while(index < text.count) valid += utf8_decode_next(text, &index) != UNICODE_REPLACEMENT_CHARACTER;
+        return valid;
+    });
+
+    run_benchmark("is_valid_utf8", text.count, [&]() { return (s64) is_valid_utf8(text); });
+
+    printf("Decoding %" PRId64 " MB of mixed-script UTF-8:\n", text.count / (1024 * 1024));
+
+    run_benchmark("utf8_decode_next", text.count, [&]() {
+        s64 count = 0;
+        s64 index = 0;
+        while(index < text.count) code_points[count++] = utf8_decode_next(text, &index);
+        return count;
+    });
+
+    run_benchmark("utf8_to_code_points", text.count, [&]() { return utf8_to_code_points(text, code_points); });
+
+    if(argc > 1) {
+        Font font;
+        Error_Code error = create_font_from_file(&font, cstring_view(argv[1]), 12, FONT_FILTER_Mono, GLYPH_SET_Extended_Ascii | GLYPH_SET_Greek | GLYPH_SET_Cyrillic | GLYPH_SET_Punctuation);
+
+        if(error == Success) {
+            printf("Laying out %" PRId64 " MB of mixed-script UTF-8 in lines of %d characters:\n", text.count / (1024 * 1024), LINE_LENGTH);
+
+            run_benchmark("get_string_width_in_pixels", text.count, [&]() {
+                s64 width = 0;
+                Line_Iterator iterator;
+                iterator.create(text);
+                string line;
+                while(iterator.next(&line)) width += get_string_width_in_pixels(&font, line);
+                return width;
+            });
+
+            run_benchmark("build_text_mesh", text.count, [&]() {
+                s64 glyphs = 0;
+                Line_Iterator iterator;
+                iterator.create(text);
+                string line;
+                while(iterator.next(&line)) {
+                    Text_Mesh mesh = build_text_mesh(&font, line, 0, 0, TEXT_ALIGNMENT_Left | TEXT_ALIGNMENT_Top, Default_Allocator);
+                    glyphs += mesh.glyph_count;
+                    deallocate_text_mesh(&mesh, Default_Allocator);
+                }
+                return glyphs;
+            });
+
+            destroy_font(&font);
+        } else {
+            printf("Failed to load the font '%s'.\n", argv[1]);
+        }
+    } else {
+        printf("Pass a font file to also benchmark the text layout.\n");
+    }
+
+    Default_Allocator->deallocate(code_points);
+    deallocate_string(Default_Allocator, &text);
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "string_type.h"
+#include "fileio.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Measures the parse throughput of splitting big text files into lines and whitespace-separated tokens,
+// comparing the block-classifying Line_Iterator and Ascii_Parser against byte-by-byte loops. The first file
+// looks like level data (short tokens, mostly numbers), the second like an asset list (long paths).
+//
+
+#define TEXT_SIZE   (32 * 1024 * 1024)
+#define REPETITIONS 5
+
+static
+void print_result(const char *name, f64 seconds, s64 checksum) {
+    printf("  %-32s %10.2f MB/s (checksum: %" PRId64 ")\n", name, (f64) TEXT_SIZE / seconds / (1024.0 * 1024.0), checksum);
+}
+
+template<typename Procedure>
+static
+void run_benchmark(const char *name, Procedure procedure) {
+    f64 best = MAX_F64;
+    s64 checksum = 0;
+
+    for(s64 i = 0; i < REPETITIONS; ++i) {
+        CPU_Time start = os_get_cpu_time();
+        checksum = procedure();
+        CPU_Time end = os_get_cpu_time();
+        best = MIN(best, os_convert_cpu_time(end - start, Seconds));
+    }
+
+    print_result(name, best, checksum);
+}
+
+static
+string generate_level_text(Random_Generator *random) {
+    string text = allocate_string(Default_Allocator, TEXT_SIZE);
+    s64 position = 0;
+
+    while(position < TEXT_SIZE) {
+        char line[128];
+        int length = snprintf(line, sizeof(line), "entity_%" PRIu64 " %.3f %.3f %.3f\t%" PRIu64 "\n", random->random_u64() % 100000, random->random_f32(-100.f, 100.f), random->random_f32(-100.f, 100.f), random->random_f32(-100.f, 100.f), random->random_u64() % 16);
+        length = (int) MIN(length, TEXT_SIZE - position);
+        memcpy(&text.data[position], line, length);
+        position += length;
+    }
+
+    return text;
+}
+
+static
+string generate_asset_text(Random_Generator *random) {
+    string text = allocate_string(Default_Allocator, TEXT_SIZE);
+    s64 position = 0;
+
+    while(position < TEXT_SIZE) {
+        char line[192];
+        int length = snprintf(line, sizeof(line), "data/textures/environment/set_%02" PRIu64 "/material_%06" PRIu64 "_albedo_roughness_metallic.png %016" PRIx64 "\n", random->random_u64() % 100, random->random_u64() % 1000000, random->random_u64());
+        length = (int) MIN(length, TEXT_SIZE - position);
+        memcpy(&text.data[position], line, length);
+        position += length;
+    }
+
+    return text;
+}
+
+static
+void benchmark_text(const char *description, string text) {
+    printf("Splitting %d MB of %s into lines:\n", TEXT_SIZE / (1024 * 1024), description);
+
+    run_benchmark("byte by byte", [&]() {
+        s64 lines = 0;
+        s64 start = 0;
+        for(s64 i = 0; i < text.count; ++i) {
+            if(text.data[i] == '\n') {
+                lines += i - start;
+                start  = i + 1;
+            }
+        }
+        return lines;
+    });
+
+    run_benchmark("read_next_line", [&]() {
+        s64 lines = 0;
+        string remaining = text;
+        while(remaining.count) lines += read_next_line(&remaining).count;
+        return lines;
+    });
+
+    run_benchmark("Line_Iterator", [&]() {
+        s64 lines = 0;
+        string line;
+        Line_Iterator iterator;
+        iterator.create(text);
+        while(iterator.next(&line)) lines += line.count;
+        return lines;
+    });
+
+    printf("Splitting %d MB of %s into tokens:\n", TEXT_SIZE / (1024 * 1024), description);
+
+    run_benchmark("byte by byte", [&]() {
+        s64 tokens = 0;
+        s64 i = 0;
+        while(true) {
+            while(i < text.count && text.data[i] <= 32) ++i;
+            if(i == text.count) break;
+            s64 start = i;
+            while(i < text.count && text.data[i] > 32) ++i;
+            tokens += i - start;
+        }
+        return tokens;
+    });
+
+    run_benchmark("Ascii_Parser::read_string", [&]() {
+        s64 tokens = 0;
+        Ascii_Parser parser;
+        parser.create_from_string(text);
+        while(!parser.finished()) tokens += parser.read_string().count;
+        return tokens;
+    });
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    string level_text = generate_level_text(&random);
+    string asset_text = generate_asset_text(&random);
+
+    benchmark_text("level data", level_text);
+    benchmark_text("asset paths", asset_text);
+
+    deallocate_string(Default_Allocator, &asset_text);
+    deallocate_string(Default_Allocator, &level_text);
+    return 0;
+}
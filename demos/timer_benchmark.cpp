@@ -0,0 +1,147 @@
+#include "priority_queue.h"
+#include "timer_wheel.h"
+#include "random.h"
+#include "os_specific.h"
+
+//
+// Compares the Priority_Queue and the Timer_Wheel with millions of timers: Once by scheduling all timers up
+// front and then firing them all, and once with a workload similar to packet retransmission, where a timer is
+// scheduled for every sent packet, and most of them get cancelled (acked) before they expire.
+//
+
+#define TIMER_COUNT       4000000
+#define TICK_COUNT        100000
+#define TIMERS_PER_TICK   (TIMER_COUNT / TICK_COUNT)
+#define CANCEL_PERCENTAGE 90
+
+static s64 fired_timers = 0;
+
+static
+void fire_timer(void *user_pointer) {
+    ++fired_timers;
+}
+
+static
+void print_result(const char *name, CPU_Time start, CPU_Time end, s64 operations) {
+    f64 milliseconds = os_convert_cpu_time(end - start, Milliseconds);
+    printf("  %-40s %10.2fms, %8.2fns / timer\n", name, milliseconds, milliseconds * 1000000.0 / (f64) operations);
+}
+
+int main() {
+    Random_Generator random;
+    random.seed(0x5eed);
+
+    u64 *deadlines = (u64 *) Default_Allocator->allocate(TIMER_COUNT * sizeof(u64));
+    for(s64 i = 0; i < TIMER_COUNT; ++i) deadlines[i] = random.random_u64(1, TICK_COUNT);
+
+    printf("Scheduling and firing %d timers over %d ticks:\n", TIMER_COUNT, TICK_COUNT);
+
+    {
+        Priority_Queue<void *, u64> queue;
+        queue.create(Default_Allocator);
+
+        CPU_Time start = os_get_cpu_time();
+        for(s64 i = 0; i < TIMER_COUNT; ++i) queue.push(null, deadlines[i]);
+        print_result("Priority_Queue push", start, os_get_cpu_time(), TIMER_COUNT);
+
+        fired_timers = 0;
+        start = os_get_cpu_time();
+        while(queue.count) {
+            queue.pop();
+            fire_timer(null);
+        }
+        print_result("Priority_Queue pop", start, os_get_cpu_time(), fired_timers);
+
+        queue.destroy();
+    }
+
+    {
+        Timer_Wheel wheel;
+        wheel.create(Default_Allocator, 0);
+
+        CPU_Time start = os_get_cpu_time();
+        for(s64 i = 0; i < TIMER_COUNT; ++i) wheel.add(deadlines[i], fire_timer, null);
+        print_result("Timer_Wheel add", start, os_get_cpu_time(), TIMER_COUNT);
+
+        fired_timers = 0;
+        start = os_get_cpu_time();
+        wheel.advance(TICK_COUNT);
+        print_result("Timer_Wheel advance", start, os_get_cpu_time(), fired_timers);
+
+        wheel.destroy();
+    }
+
+    printf("Retransmission workload (%d timers, %d%% cancelled before expiring):\n", TIMER_COUNT, CANCEL_PERCENTAGE);
+
+    // Every tick, send TIMERS_PER_TICK packets with a timeout of 200 ticks, and receive the acks for packets
+    // sent 50 ticks ago.
+    const s64 timeout = 200, ack_delay = 50;
+
+    {
+        Priority_Queue<void *, u64> queue;
+        queue.create(Default_Allocator);
+
+        Priority_Queue_Handle *handles = (Priority_Queue_Handle *) Default_Allocator->allocate(TIMER_COUNT * sizeof(Priority_Queue_Handle));
+
+        fired_timers = 0;
+        random.seed(0x5eed);
+        CPU_Time start = os_get_cpu_time();
+
+        for(s64 tick = 0; tick < TICK_COUNT + timeout; ++tick) {
+            if(tick < TICK_COUNT) {
+                for(s64 i = 0; i < TIMERS_PER_TICK; ++i) handles[tick * TIMERS_PER_TICK + i] = queue.push(null, tick + timeout);
+            }
+
+            if(tick >= ack_delay && tick - ack_delay < TICK_COUNT) {
+                for(s64 i = 0; i < TIMERS_PER_TICK; ++i) {
+                    if(random.random_u64(0, 100) < CANCEL_PERCENTAGE) queue.remove(handles[(tick - ack_delay) * TIMERS_PER_TICK + i]);
+                }
+            }
+
+            while(queue.count && queue.peek()->priority <= (u64) tick) {
+                queue.pop();
+                fire_timer(null);
+            }
+        }
+
+        print_result("Priority_Queue", start, os_get_cpu_time(), TIMER_COUNT);
+        printf("    (%" PRId64 " timers expired)\n", fired_timers);
+
+        Default_Allocator->deallocate(handles);
+        queue.destroy();
+    }
+
+    {
+        Timer_Wheel wheel;
+        wheel.create(Default_Allocator, 0);
+
+        Timer_Handle *handles = (Timer_Handle *) Default_Allocator->allocate(TIMER_COUNT * sizeof(Timer_Handle));
+
+        fired_timers = 0;
+        random.seed(0x5eed);
+        CPU_Time start = os_get_cpu_time();
+
+        for(s64 tick = 0; tick < TICK_COUNT + timeout; ++tick) {
+            if(tick < TICK_COUNT) {
+                for(s64 i = 0; i < TIMERS_PER_TICK; ++i) handles[tick * TIMERS_PER_TICK + i] = wheel.add(tick + timeout, fire_timer, null);
+            }
+
+            if(tick >= ack_delay && tick - ack_delay < TICK_COUNT) {
+                for(s64 i = 0; i < TIMERS_PER_TICK; ++i) {
+                    if(random.random_u64(0, 100) < CANCEL_PERCENTAGE) wheel.cancel(handles[(tick - ack_delay) * TIMERS_PER_TICK + i]);
+                }
+            }
+
+            wheel.advance(tick);
+        }
+
+        print_result("Timer_Wheel", start, os_get_cpu_time(), TIMER_COUNT);
+        printf("    (%" PRId64 " timers expired)\n", fired_timers);
+
+        Default_Allocator->deallocate(handles);
+        wheel.destroy();
+    }
+
+    Default_Allocator->deallocate(deadlines);
+    return 0;
+}
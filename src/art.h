@@ -1,67 +1,179 @@
 #pragma once
 
 #include "foundation.h"
-
-enum Art_Node_Kind {
+#include "memutils.h"
+#include "string_type.h"
+#include "threads.h"
+
+//
+// The Adaptive Radix Tree (ART) is an ordered index which stores its keys byte by byte (so called spans) in
+// a trie, but adapts the size of its inner nodes to the number of children they actually have (4, 16, 48 or
+// 256). Compared to a hash table, the ART supports ordered iteration, range and prefix scans while still
+// having very fast point lookups.
+//
+// Two optimizations keep the tree shallow:
+//   1. Lazy expansion: A leaf stores its complete key, so that a path only gets expanded into inner nodes
+//      once two keys actually diverge.
+//   2. Path compression: Inner nodes which would only have a single child get collapsed into the prefix of
+//      their child. The first ART_MAX_PREFIX_LENGTH bytes of that prefix are stored pessimistically in the
+//      node itself, any longer prefix is skipped optimistically and verified against the leaf key.
+// When keys get removed, inner nodes shrink again (Node256 -> Node48 -> Node16 -> Node4), and a Node4 with a
+// single child gets merged into that child.
+//
+// Keys are compared as byte strings. Integer keys are converted into big-endian (and sign-flipped) bytes so
+// that the iteration order matches the numerical order. Strings are used as they are, but since every key
+// is implicitly terminated by a zero byte (so that no key is a prefix of another one), string keys must not
+// contain zero bytes themselves.
+//
+// The tree can also be created in concurrent mode, in which case add, query (by copy) and remove may be
+// called from any number of threads at the same time, using optimistic lock coupling:
+//   Every inner node has a version counter with a lock and an obsolete bit. Readers never take a lock, they
+//   remember the version of a node, read it, and then validate that the version has not changed. If it did,
+//   the operation restarts from the root. Writers only lock the (at most three) nodes they actually modify.
+//   Nodes which get replaced (by growing, shrinking or path compression) are marked obsolete and are freed
+//   through epoch-based reclamation, once no thread can still be reading them.
+//   Every thread claims one of ART_MAX_THREADS slots the first time it accesses any concurrent tree, and keeps
+//   it until the thread exits. An exited thread's slot (including the nodes it retired but did not free yet)
+//   is then taken over by the next thread that needs one, so only the number of threads that are alive at the
+//   same time is limited, not the number of threads that ever existed.
+// The root is always a Node256 in concurrent mode, so that it never needs to be replaced. Iterating, push
+// and the pointer-returning query are not synchronized, and must only be used while no other thread is
+// modifying the tree.
+//
+
+#define ART_MAX_PREFIX_LENGTH 10
+#define ART_MAX_THREADS       128 // The maximum number of live threads that may access concurrent trees, a multiple of 64.
+#define ART_RECLAMATION_BATCH 64  // The number of retired nodes per thread before trying to free them.
+
+#define ART_VERSION_OBSOLETE 0x1
+#define ART_VERSION_LOCKED   0x2
+#define ART_EPOCH_QUIESCENT  MAX_U64
+
+enum Art_Node_Kind : u8 {
     ART_Leaf,
     ART_Node4,
     ART_Node16,
     ART_Node48,
     ART_Node256,
 };
-    
+
+struct Art_Key {
+    const u8 *external; // Points to the key bytes for variable-length keys. Null if the bytes are stored inline.
+    u8 inline_bytes[8];
+    s64 count;
+
+    u8 operator[](s64 index) const { return index < this->count ? (this->external ? this->external[index] : this->inline_bytes[index]) : 0; }
+};
+
 struct Art_Node {
     Art_Node_Kind kind;
 };
-    
+
+struct Art_Inner_Node : Art_Node {
+    volatile u64 version; // Only used in concurrent mode.
+    u16 count;
+    u32 prefix_length;
+    u8 prefix[ART_MAX_PREFIX_LENGTH];
+};
+
+template<typename K, typename V>
 struct Art_Leaf : Art_Node {
-    Art_Leaf() { kind = ART_Leaf; };
+    Art_Leaf() : key(), value() { kind = ART_Leaf; };
+
+    K key;
+    V value;
 };
 
-struct Art_Node4 : Art_Node {        
-    Art_Node4() { kind = ART_Node4; count = 0; };
+struct Art_Node4 : Art_Inner_Node {
+    Art_Node4() { kind = ART_Node4; version = 0; count = 0; prefix_length = 0; };
 
-    u8 count;
     u8 keys[4];
     Art_Node *children[4];
 };
 
-struct Art_Node16 : Art_Node {
-    Art_Node16() { kind = ART_Node16; count = 0; };
+struct Art_Node16 : Art_Inner_Node {
+    Art_Node16() { kind = ART_Node16; version = 0; count = 0; prefix_length = 0; };
 
-    u8 count;
-    u8 keys[16];
+    u8 keys[16]; // Stored with a flipped sign bit, see art_flip_sign.
     Art_Node *children[16];
 };
 
-struct Art_Node48 : Art_Node {
-    Art_Node48() { kind = ART_Node48; count = 0; };
+struct Art_Node48 : Art_Inner_Node {
+    Art_Node48() { kind = ART_Node48; version = 0; count = 0; prefix_length = 0; memset(indirection, 0xff, sizeof(indirection)); memset(children, 0, sizeof(children)); };
 
-    u8 count;
-    u8 indirection[256];
+    u8 indirection[256]; // 0xff marks an empty slot.
     Art_Node *children[48];
 };
 
-struct Art_Node256 : Art_Node {
-    Art_Node256() { kind = ART_Node256; };
+struct Art_Node256 : Art_Inner_Node {
+    Art_Node256() { kind = ART_Node256; version = 0; count = 0; prefix_length = 0; memset(children, 0, sizeof(children)); };
 
     Art_Node *children[256];
 };
 
+struct Art_Retired_Node {
+    Art_Node *node;
+    u64 epoch; // The global epoch at the time this node got unlinked from the tree.
+};
+
+struct Art_Thread_Epoch {
+    volatile u64 epoch; // The global epoch when this thread entered the tree, or ART_EPOCH_QUIESCENT.
+    Resizable_Array<Art_Retired_Node> retired; // Only ever accessed by the owning thread.
+    u8 padding[64 - sizeof(u64) - sizeof(Resizable_Array<Art_Retired_Node>)]; // Avoid false sharing between threads.
+};
+
+template<typename K, typename V>
+struct Adaptive_Radix_Tree {
+    typedef Art_Leaf<K, V> Leaf;
 
-template<typename T>
-struct Adaptive_Radix_Tree {   
     Allocator *allocator = Default_Allocator;
     Art_Node *root = null;
+    s64 count = 0;
+
+    b8 concurrent = false;
+    volatile u64 global_epoch = 0;
+    Art_Thread_Epoch *thread_epochs = null; // ART_MAX_THREADS entries, only allocated in concurrent mode.
 
-    void create();
+    void create(Allocator *allocator = Default_Allocator, b8 concurrent = false);
     void destroy();
-    b8 add(T const &key); // Returns false if the key already exists or if the key is a prefix to an existing key
-    b8 query(T const &key);
 
-    Art_Node *destroy_recursive(Art_Node *node);
-    u8 span(T const &key, u8 span_index);
-    u8 span_count();
+    b8 add(K const &key, V const &value); // Returns false if the key already exists, in which case the existing value is left untouched.
+    V *push(K const &key); // Returns the value for this key, inserting a zero-initialized value if the key does not exist yet. Not in concurrent mode.
+    V *query(K const &key); // Not in concurrent mode.
+    b8 query(K const &key, V *value); // Copies the value out of the tree, returns false if the key does not exist.
+    b8 remove(K const &key); // Returns false if the key did not exist.
+
+    Leaf *minimum();
+    Leaf *maximum();
+
+    // The procedure gets called as procedure(K *key, V *value) for each entry in ascending key order.
+    template<typename Procedure> void iterate(Procedure procedure);
+    template<typename Procedure> void iterate_range(K const &min, K const &max, Procedure procedure); // Both bounds are inclusive.
+    template<typename Procedure> void iterate_prefix(K const &prefix, Procedure procedure); // Ignores the implicit terminator of the prefix.
+
+    Leaf *make_leaf(K const &key);
+    void release_node(Art_Node *node);
+    void destroy_recursive(Art_Node *node);
+    Leaf *minimum_leaf(Art_Node *node);
+    Leaf *maximum_leaf(Art_Node *node);
+    u8 prefix_span(Art_Inner_Node *node, s64 depth, s64 index);
+    s64 prefix_mismatch(Art_Inner_Node *node, Art_Key const &key, s64 depth);
+    s64 check_stored_prefix(Art_Inner_Node *node, Art_Key const &key, s64 depth);
+    Art_Node **find_child(Art_Node *node, u8 span);
+    void add_child(Art_Node **node_ptr, Art_Node *node, u8 span, Art_Node *child);
+    void remove_child(Art_Node **node_ptr, Art_Node *node, u8 span, Art_Node **child_ptr);
+    void split_leaf(Art_Node **node_ptr, Leaf *existing, Art_Key const &key, s64 depth, Leaf *leaf);
+    void split_prefix(Art_Node **node_ptr, Art_Inner_Node *inner, Art_Key const &key, s64 depth, s64 mismatch, Leaf *leaf);
+
+    b8 add_concurrent(K const &key, V const &value);
+    b8 query_concurrent(K const &key, V *value);
+    b8 remove_concurrent(K const &key);
+    Art_Thread_Epoch *enter_epoch();
+    void exit_epoch(Art_Thread_Epoch *thread_epoch);
+    void reclaim_nodes(Art_Thread_Epoch *thread_epoch);
+
+    template<typename Procedure> void iterate_recursive(Art_Node *node, Procedure &procedure);
+    template<typename Procedure> b8 iterate_range_recursive(Art_Node *node, s64 depth, Art_Key const &min, Art_Key const &max, b8 bounded_below, b8 bounded_above, Procedure &procedure);
 
     template<typename Node>
     Node *allocate_node() {
@@ -1,11 +1,77 @@
 #include "os_specific.h"
 
 #if FOUNDATION_WIN32
-# include <intrin.h> // For _addcarry_u64...
+# include <intrin.h> // For _mm_cmpeq_epi8...
 #elif FOUNDATION_LINUX
-# include <immintrin.h> // For _addcarry_u64...
+# include <immintrin.h> // For _mm_cmpeq_epi8...
 #endif
 
+/* ------------------------------------------------- Art Keys ------------------------------------------------- */
+
+static inline
+Art_Key art_key_big_endian(u64 value, s64 count) {
+    Art_Key key;
+    key.external = null;
+    key.count    = count;
+
+    for(s64 i = 0; i < count; ++i) {
+        key.inline_bytes[i] = (u8) (value >> ((count - i - 1) * 8));
+    }
+
+    return key;
+}
+
+static inline Art_Key art_key(u8  value) { return art_key_big_endian(value, 1); }
+static inline Art_Key art_key(u16 value) { return art_key_big_endian(value, 2); }
+static inline Art_Key art_key(u32 value) { return art_key_big_endian(value, 4); }
+static inline Art_Key art_key(u64 value) { return art_key_big_endian(value, 8); }
+
+// Flip the sign bit so that negative values come before positive ones in the byte order.
+static inline Art_Key art_key(s8  value) { return art_key_big_endian((u8)  value ^ 0x80, 1); }
+static inline Art_Key art_key(s16 value) { return art_key_big_endian((u16) value ^ 0x8000, 2); }
+static inline Art_Key art_key(s32 value) { return art_key_big_endian((u32) value ^ 0x80000000, 4); }
+static inline Art_Key art_key(s64 value) { return art_key_big_endian((u64) value ^ 0x8000000000000000, 8); }
+
+static inline
+Art_Key art_key(string const &value) {
+    Art_Key key;
+    key.external = value.data;
+    key.count    = value.count;
+    return key;
+}
+
+template<typename T>
+static inline
+Art_Key art_key(T const &value) {
+    // Fallback for all other types: Just use the raw bytes of the value. This works for lookups, but the
+    // iteration order is probably not what one would expect.
+    Art_Key key;
+    key.external = (const u8 *) &value;
+    key.count    = sizeof(T);
+    return key;
+}
+
+static inline
+const u8 *art_key_bytes(Art_Key const &key) {
+    return key.external ? key.external : key.inline_bytes;
+}
+
+static inline
+b8 art_keys_equal(Art_Key const &lhs, Art_Key const &rhs) {
+    return lhs.count == rhs.count && memcmp(art_key_bytes(lhs), art_key_bytes(rhs), lhs.count) == 0;
+}
+
+static inline
+s64 art_compare_keys(Art_Key const &lhs, Art_Key const &rhs) {
+    int result = memcmp(art_key_bytes(lhs), art_key_bytes(rhs), MIN(lhs.count, rhs.count));
+    if(result != 0) return result;
+    return lhs.count - rhs.count; // The shorter key is a prefix of the longer one, and the implicit terminator sorts first.
+}
+
+
+
+/* ---------------------------------------------- Node Helpers ---------------------------------------------- */
+
 static inline
 u8 art_flip_sign(u8 span) {
     return span ^ 0x80;
@@ -31,7 +97,7 @@ u8 art_node16_lookup_lower_bound(Art_Node16 *node16, u8 span) {
     result = _mm_cmpeq_epi8(lhs, rhs);
 
     int bitmask = _mm_movemask_epi8(result) & (0xffff >> (16 - node16->count));
-    return bitmask != 0 ? (u8) os_highest_bit_set(bitmask) : node16->count;
+    return bitmask != 0 ? (u8) os_lowest_bit_set(bitmask) : node16->count;
 }
 
 static inline
@@ -39,276 +105,1254 @@ u8 art_node16_insert_lower_bound(Art_Node16 *node16, u8 span) {
     __m128i lhs, rhs, result;
     lhs    = _mm_set1_epi8(span);
     rhs    = _mm_loadu_si128((__m128i *) node16->keys);
-    result = _mm_cmplt_epi8(lhs, rhs);
+    result = _mm_cmplt_epi8(lhs, rhs); // All keys which are bigger than the span.
 
     int bitmask = _mm_movemask_epi8(result) & (0xffff >> (16 - node16->count));
-    return bitmask != 0 ? (u8) os_highest_bit_set(bitmask) : node16->count;
+    return bitmask != 0 ? (u8) os_lowest_bit_set(bitmask) : node16->count;
 }
 
-template<typename T>
-void Adaptive_Radix_Tree<T>::create() {
-    this->root = this->allocate_node<Art_Leaf>();
+static inline
+void art_copy_header(Art_Inner_Node *dst, Art_Inner_Node *src) {
+    dst->count         = src->count;
+    dst->prefix_length = src->prefix_length;
+    memcpy(dst->prefix, src->prefix, MIN(src->prefix_length, ART_MAX_PREFIX_LENGTH));
 }
 
-template<typename T>
-void Adaptive_Radix_Tree<T>::destroy() {
-    this->root = this->destroy_recursive(this->root);
-}
 
-template<typename T>
-b8 Adaptive_Radix_Tree<T>::add(T const &key) {
-    Art_Node **node_ptr = &this->root;
-    Art_Node *node;
-    u8 span_index = 0;
-    const u8 span_count = this->span_count();
-    
-    while(span_index < span_count && (node = *node_ptr) != null) {
-        u8 span = this->span(key, span_index);
-        b8 is_last_span = span_index + 1 == span_count;
-        
-        switch(node->kind) {
-        case ART_Leaf: {
-            // Replace this leaf node with a node4 and then continue inserting into that new node.
-            Art_Leaf *leaf = (Art_Leaf *) node;
-            Art_Node4 *node4 = this->allocate_node<Art_Node4>();
-            this->allocator->deallocate(leaf);
-            *node_ptr = node4;
-        } break;
-            
-        case ART_Node4: {
-            Art_Node4 *node4 = (Art_Node4 *) node;
 
-            // Find the child index that is the smallest element not smaller than the span
-            u8 child_index = art_node4_lower_bound(node4, span);
-            
-            // If the child already exists for exactly this span, then just continue inserting into there.
-            if(child_index < node4->count && node4->keys[child_index] == span) {
-                node_ptr = &node4->children[child_index];
-                ++span_index;
-                break;
-            }
+/* --------------------------------------------- Concurrency Helpers --------------------------------------------- */
 
-            // If the node has no more capacity, resize it to a node16 and continue inserting into that new node.
-            if(node4->count == 4) {
-                Art_Node16 *node16 = this->allocate_node<Art_Node16>();
-                node16->count = node4->count;
-                for(u8 i = 0; i < node4->count; ++i) {
-                    node16->keys[i]     = art_flip_sign(node4->keys[i]);
-                    node16->children[i] = node4->children[i];
-                }
+// These are intentionally not static, so that all translation units share the same slot bitmap and the same
+// thread-local slot.
+inline
+u64 volatile *art_thread_slot_bitmap() {
+    static u64 volatile bitmap[ART_MAX_THREADS / 64] = {};
+    return bitmap;
+}
 
-                this->allocator->deallocate(node4);
-                *node_ptr = node16;
-                break;
-            }           
-            
-            // Insert into the sorted node4
-            assert(child_index >= 0 && child_index <= 3);
-            memmove(&node4->keys[child_index + 1], &node4->keys[child_index], (4 - child_index - 1) * sizeof(u8));
-            memmove(&node4->children[child_index + 1], &node4->children[child_index], (4 - child_index - 1) * sizeof(Art_Node *));
-            node4->keys[child_index] = span;
-            node4->children[child_index] = is_last_span ? (Art_Node *) this->allocate_node<Art_Leaf>() : (Art_Node *) this->allocate_node<Art_Node4>();
-            node_ptr = &node4->children[child_index];
-            ++node4->count;
-            ++span_index;
-        } break;
+// Owns the slot of one thread, and gives it back to the bitmap when the thread exits.
+struct Art_Thread_Slot {
+    s64 index = -1;
 
-        case ART_Node16: {
-            Art_Node16 *node16 = (Art_Node16 *) node;
+    ~Art_Thread_Slot() {
+        if(this->index == -1) return;
 
-            span = art_flip_sign(span); // For the SIMD lower_bound implementation to work correctly, we must assume signed (instead of unsigned) integers in this node, therefore flip the signs...
-            
-            // Find the child index that is the smallest element not smaller than the span
-            u8 child_index = art_node16_insert_lower_bound(node16, span);
+        u64 volatile *word = &art_thread_slot_bitmap()[this->index / 64];
+        u64 bit = 1ULL << (this->index % 64);
+        u64 expected;
+        do {
+            expected = atomic_load(word);
+        } while(atomic_compare_exchange(word, expected & ~bit, expected) != expected);
+    }
+};
 
-            // If the child already exists for exactly this span, then just continue inserting into there.
-            if(child_index < node16->count && node16->keys[child_index] == span) {
-                node_ptr = &node16->children[child_index];
-                ++span_index;
-                break;
-            }
+inline
+s64 art_thread_slot() {
+    static thread_local Art_Thread_Slot slot;
 
-            // If the node has no more capacity, resize it to a node48 and continue inserting into that new node.
-            if(node16->count == 16) {
-                Art_Node48 *node48 = this->allocate_node<Art_Node48>();
-                memset(node48->indirection, 0xff, sizeof(node48->indirection));
-                node48->count = node16->count;
-                for(u8 i = 0; i < node16->count; ++i) {
-                    node48->indirection[art_flip_sign(node16->keys[i])] = i;
-                    node48->children[i] = node16->children[i];
+    if(slot.index == -1) {
+        u64 volatile *bitmap = art_thread_slot_bitmap();
+
+        for(s64 i = 0; i < ART_MAX_THREADS / 64 && slot.index == -1; ++i) {
+            u64 expected = atomic_load(&bitmap[i]);
+            while(expected != MAX_U64) {
+                u64 bit = os_lowest_bit_set(~expected);
+                if(atomic_compare_exchange(&bitmap[i], expected | (1ULL << bit), expected) == expected) {
+                    slot.index = i * 64 + bit;
+                    break;
                 }
-                
-                this->allocator->deallocate(node16);
-                *node_ptr = node48;
-                break;
+
+                expected = atomic_load(&bitmap[i]);
             }
+        }
 
-            // Insert into the sorted node16
-            assert(child_index >= 0 && child_index <= 15);
-            memmove(&node16->keys[child_index + 1], &node16->keys[child_index], (16 - child_index - 1) * sizeof(u8));
-            memmove(&node16->children[child_index + 1], &node16->children[child_index], (16 - child_index - 1) * sizeof(Art_Node *));
-            node16->keys[child_index] = span;
-            node16->children[child_index] = is_last_span ? (Art_Node *) this->allocate_node<Art_Leaf>() : (Art_Node *) this->allocate_node<Art_Node4>();
-            node_ptr = &node16->children[child_index];
-            ++node16->count;
-            ++span_index;
-        } break;
-            
-        case ART_Node48: {
-            Art_Node48 *node48 = (Art_Node48 *) node;
+        assert(slot.index != -1, "Too many threads are accessing concurrent Adaptive_Radix_Trees at the same time.");
+    }
 
-            // If the child already exists for exactly this span, then just continue inserting into there.
-            if(node48->indirection[span] != 0xff) {
-                node_ptr = &node48->children[node48->indirection[span]];
-                ++span_index;
-                break;
-            }
+    return slot.index;
+}
 
-            // If the node has no more capacity, resize it to a node256 and continue inserting into that new node.
-            if(node48->count == 48) {
-                Art_Node256 *node256 = this->allocate_node<Art_Node256>();
-                for(u16 i = 0; i < 256; ++i) {
-                    if(node48->indirection[i] != 0xff)
-                        node256->children[i] = node48->children[node48->indirection[i]];
-                    else
-                        node256->children[i] = null;
-                }
+static inline
+u64 art_read_lock(Art_Inner_Node *node, b8 *restart) {
+    u64 version = atomic_load(&node->version);
+    while(version & ART_VERSION_LOCKED) {
+        _mm_pause();
+        version = atomic_load(&node->version);
+    }
 
-                this->allocator->deallocate(node48);
-                *node_ptr = node256;
-                break;
-            }
+    if(version & ART_VERSION_OBSOLETE) *restart = true;
+    return version;
+}
 
-            // Insert into the node48
-            node48->indirection[span] = node48->count;
-            node48->children[node48->count] = is_last_span ? (Art_Node *) this->allocate_node<Art_Leaf>() : (Art_Node *) this->allocate_node<Art_Node4>();
-            node_ptr = &node48->children[node48->count];
-            ++node48->count;
-            ++span_index;
-        } break;
-            
-        case ART_Node256: {
-            Art_Node256 *node256 = (Art_Node256 *) node;
-            if(node256->children[span] == null) {
-                node256->children[span] = is_last_span ? (Art_Node *) this->allocate_node<Art_Leaf>() : (Art_Node *) this->allocate_node<Art_Node4>();
+static inline
+void art_read_unlock(Art_Inner_Node *node, u64 version, b8 *restart) {
+    // Validates that nothing changed in this node since the version was read.
+    if(atomic_load(&node->version) != version) *restart = true;
+}
+
+static inline
+void art_upgrade_to_write_lock(Art_Inner_Node *node, u64 version, b8 *restart) {
+    if(atomic_compare_exchange(&node->version, version + ART_VERSION_LOCKED, version) != version) *restart = true;
+}
+
+static inline
+void art_write_unlock(Art_Inner_Node *node) {
+    atomic_add(&node->version, ART_VERSION_LOCKED); // Clears the lock bit and increments the version counter.
+}
+
+static inline
+void art_write_unlock_obsolete(Art_Inner_Node *node) {
+    atomic_add(&node->version, ART_VERSION_LOCKED + ART_VERSION_OBSOLETE);
+}
+
+static inline
+b8 art_node_is_full(Art_Inner_Node *node) {
+    switch(node->kind) {
+    case ART_Node4:  return node->count == 4;
+    case ART_Node16: return node->count == 16;
+    case ART_Node48: return node->count == 48;
+    default:         return false;
+    }
+}
+
+static inline
+b8 art_node_shrinks_on_remove(Art_Inner_Node *node) {
+    // Must match the thresholds in Adaptive_Radix_Tree::remove_child.
+    switch(node->kind) {
+    case ART_Node4:   return node->count == 2;
+    case ART_Node16:  return node->count == 4;
+    case ART_Node48:  return node->count == 13;
+    case ART_Node256: return node->count == 38;
+    default:          return false;
+    }
+}
+
+/* ------------------------------------------------ Public API ------------------------------------------------ */
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::create(Allocator *allocator, b8 concurrent) {
+    this->allocator    = allocator;
+    this->root         = null;
+    this->count        = 0;
+    this->concurrent   = concurrent;
+    this->global_epoch = 0;
+
+    if(this->concurrent) {
+        this->root          = this->allocate_node<Art_Node256>();
+        this->thread_epochs = (Art_Thread_Epoch *) this->allocator->allocate(ART_MAX_THREADS * sizeof(Art_Thread_Epoch));
+        for(s64 i = 0; i < ART_MAX_THREADS; ++i) {
+            this->thread_epochs[i].epoch = ART_EPOCH_QUIESCENT;
+            this->thread_epochs[i].retired = Resizable_Array<Art_Retired_Node>();
+            this->thread_epochs[i].retired.allocator = this->allocator;
+        }
+    }
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::destroy() {
+    if(this->concurrent) {
+        // No thread may be using the tree anymore at this point, so all retired nodes can be freed.
+        for(s64 i = 0; i < ART_MAX_THREADS; ++i) {
+            for(Art_Retired_Node &retired : this->thread_epochs[i].retired) this->allocator->deallocate(retired.node);
+            this->thread_epochs[i].retired.clear();
+        }
+
+        this->allocator->deallocate(this->thread_epochs);
+        this->thread_epochs = null;
+    }
+
+    this->destroy_recursive(this->root);
+    this->root  = null;
+    this->count = 0;
+}
+
+template<typename K, typename V>
+b8 Adaptive_Radix_Tree<K, V>::add(K const &key, V const &value) {
+    if(this->concurrent) return this->add_concurrent(key, value);
+
+    s64 previous_count = this->count;
+    V *pointer = this->push(key);
+    if(this->count == previous_count) return false;
+
+    *pointer = value;
+    return true;
+}
+
+template<typename K, typename V>
+V *Adaptive_Radix_Tree<K, V>::push(K const &key) {
+    assert(!this->concurrent, "Adaptive_Radix_Tree::push is not supported in concurrent mode.");
+
+    Art_Key span_key = art_key(key);
+    Art_Node **node_ptr = &this->root;
+    s64 depth = 0;
+
+    while(true) {
+        Art_Node *node = *node_ptr;
+
+        if(node == null) {
+            // Lazy expansion: Just store the leaf in the empty slot.
+            Leaf *leaf = this->make_leaf(key);
+            *node_ptr = leaf;
+            return &leaf->value;
+        }
+
+        if(node->kind == ART_Leaf) {
+            Leaf *existing = (Leaf *) node;
+            Art_Key existing_key = art_key(existing->key);
+            if(art_keys_equal(existing_key, span_key)) return &existing->value;
+
+            Leaf *leaf = this->make_leaf(key);
+            this->split_leaf(node_ptr, existing, span_key, depth, leaf);
+            return &leaf->value;
+        }
+
+        Art_Inner_Node *inner = (Art_Inner_Node *) node;
+
+        if(inner->prefix_length > 0) {
+            s64 mismatch = this->prefix_mismatch(inner, span_key, depth);
+
+            if(mismatch < inner->prefix_length) {
+                Leaf *leaf = this->make_leaf(key);
+                this->split_prefix(node_ptr, inner, span_key, depth, mismatch, leaf);
+                return &leaf->value;
             }
 
-            node_ptr = &node256->children[span];
-            ++span_index;
-        } break;
+            depth += inner->prefix_length;
+        }
 
-        default:
-            foundation_error("Encountered an invalid node kind in the ART.");
-            node = null;
-            break;
+        Art_Node **child_ptr = this->find_child(inner, span_key[depth]);
+        if(child_ptr) {
+            node_ptr = child_ptr;
+            ++depth;
+            continue;
+        }
+
+        Leaf *leaf = this->make_leaf(key);
+        this->add_child(node_ptr, inner, span_key[depth], leaf);
+        return &leaf->value;
+    }
+}
+
+template<typename K, typename V>
+V *Adaptive_Radix_Tree<K, V>::query(K const &key) {
+    assert(!this->concurrent, "Adaptive_Radix_Tree::query without a value output is not supported in concurrent mode.");
+
+    Art_Key span_key = art_key(key);
+    Art_Node *node = this->root;
+    s64 depth = 0;
+
+    while(node != null) {
+        if(node->kind == ART_Leaf) {
+            // The optimistically skipped parts of prefixes get verified here.
+            Leaf *leaf = (Leaf *) node;
+            return art_keys_equal(art_key(leaf->key), span_key) ? &leaf->value : null;
+        }
+
+        Art_Inner_Node *inner = (Art_Inner_Node *) node;
+        if(inner->prefix_length > 0) {
+            if(this->check_stored_prefix(inner, span_key, depth) != MIN(inner->prefix_length, ART_MAX_PREFIX_LENGTH)) return null;
+            depth += inner->prefix_length;
+        }
+
+        Art_Node **child_ptr = this->find_child(inner, span_key[depth]);
+        node = child_ptr ? *child_ptr : null;
+        ++depth;
+    }
+
+    return null;
+}
+
+template<typename K, typename V>
+b8 Adaptive_Radix_Tree<K, V>::query(K const &key, V *value) {
+    if(this->concurrent) return this->query_concurrent(key, value);
+
+    V *pointer = this->query(key);
+    if(!pointer) return false;
+
+    *value = *pointer;
+    return true;
+}
+
+template<typename K, typename V>
+b8 Adaptive_Radix_Tree<K, V>::remove(K const &key) {
+    if(this->concurrent) return this->remove_concurrent(key);
+
+    Art_Key span_key = art_key(key);
+    Art_Node **node_ptr = &this->root;
+    s64 depth = 0;
+
+    while(*node_ptr != null) {
+        Art_Node *node = *node_ptr;
+
+        if(node->kind == ART_Leaf) {
+            // This can only happen if the root itself is a leaf.
+            Leaf *leaf = (Leaf *) node;
+            if(!art_keys_equal(art_key(leaf->key), span_key)) return false;
+
+            this->release_node(leaf);
+            *node_ptr = null;
+            --this->count;
+            return true;
+        }
+
+        Art_Inner_Node *inner = (Art_Inner_Node *) node;
+        if(inner->prefix_length > 0) {
+            if(this->check_stored_prefix(inner, span_key, depth) != MIN(inner->prefix_length, ART_MAX_PREFIX_LENGTH)) return false;
+            depth += inner->prefix_length;
+        }
+
+        u8 span = span_key[depth];
+        Art_Node **child_ptr = this->find_child(inner, span);
+        if(!child_ptr) return false;
+
+        if((*child_ptr)->kind == ART_Leaf) {
+            Leaf *leaf = (Leaf *) *child_ptr;
+            if(!art_keys_equal(art_key(leaf->key), span_key)) return false;
+
+            this->remove_child(node_ptr, inner, span, child_ptr);
+            this->release_node(leaf);
+            --this->count;
+            return true;
         }
+
+        node_ptr = child_ptr;
+        ++depth;
     }
 
     return false;
 }
 
-template<typename T>
-b8 Adaptive_Radix_Tree<T>::query(T const &key) {
+template<typename K, typename V>
+typename Adaptive_Radix_Tree<K, V>::Leaf *Adaptive_Radix_Tree<K, V>::minimum() {
+    return this->minimum_leaf(this->root);
+}
+
+template<typename K, typename V>
+typename Adaptive_Radix_Tree<K, V>::Leaf *Adaptive_Radix_Tree<K, V>::maximum() {
+    return this->maximum_leaf(this->root);
+}
+
+template<typename K, typename V>
+template<typename Procedure>
+void Adaptive_Radix_Tree<K, V>::iterate(Procedure procedure) {
+    this->iterate_recursive(this->root, procedure);
+}
+
+template<typename K, typename V>
+template<typename Procedure>
+void Adaptive_Radix_Tree<K, V>::iterate_range(K const &min, K const &max, Procedure procedure) {
+    Art_Key min_key = art_key(min);
+    Art_Key max_key = art_key(max);
+    if(art_compare_keys(min_key, max_key) > 0) return;
+
+    this->iterate_range_recursive(this->root, 0, min_key, max_key, true, true, procedure);
+}
+
+template<typename K, typename V>
+template<typename Procedure>
+void Adaptive_Radix_Tree<K, V>::iterate_prefix(K const &prefix, Procedure procedure) {
+    Art_Key prefix_key = art_key(prefix);
     Art_Node *node = this->root;
-    u8 span_index = 0;
-    const u8 span_count = this->span_count();
-    
-    while(span_index < span_count && node != null) {
-        u8 span = this->span(key, span_index);
+    s64 depth = 0;
+
+    while(node != null) {
+        if(node->kind == ART_Leaf) {
+            Leaf *leaf = (Leaf *) node;
+            Art_Key leaf_key = art_key(leaf->key);
+            if(leaf_key.count >= prefix_key.count && memcmp(art_key_bytes(leaf_key), art_key_bytes(prefix_key), prefix_key.count) == 0) {
+                procedure(&leaf->key, &leaf->value);
+            }
+            return;
+        }
+
+        if(depth >= prefix_key.count) {
+            // All keys in this subtree start with the prefix.
+            this->iterate_recursive(node, procedure);
+            return;
+        }
+
+        Art_Inner_Node *inner = (Art_Inner_Node *) node;
+        if(inner->prefix_length > 0) {
+            s64 compared = MIN(inner->prefix_length, prefix_key.count - depth);
+            for(s64 i = 0; i < compared; ++i) {
+                if(this->prefix_span(inner, depth, i) != prefix_key[depth + i]) return;
+            }
+
+            depth += inner->prefix_length;
+            if(depth >= prefix_key.count) {
+                this->iterate_recursive(node, procedure);
+                return;
+            }
+        }
+
+        Art_Node **child_ptr = this->find_child(inner, prefix_key[depth]);
+        node = child_ptr ? *child_ptr : null;
+        ++depth;
+    }
+}
+
+
+
+/* ---------------------------------------------- Internal Helpers ---------------------------------------------- */
+
+template<typename K, typename V>
+typename Adaptive_Radix_Tree<K, V>::Leaf *Adaptive_Radix_Tree<K, V>::make_leaf(K const &key) {
+    Leaf *leaf = this->allocate_node<Leaf>();
+    leaf->key = key;
+    ++this->count;
+    return leaf;
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::release_node(Art_Node *node) {
+    if(!this->concurrent) {
+        this->allocator->deallocate(node);
+        return;
+    }
 
+    // Other threads may still be reading this node, so only retire it for now. It gets freed once all
+    // threads have left the epoch in which it was unlinked.
+    Art_Thread_Epoch *thread_epoch = &this->thread_epochs[art_thread_slot()];
+    thread_epoch->retired.add({ node, atomic_load(&this->global_epoch) });
+    if(thread_epoch->retired.count >= ART_RECLAMATION_BATCH) this->reclaim_nodes(thread_epoch);
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::destroy_recursive(Art_Node *node) {
+    if(!node) return;
+
+    switch(node->kind) {
+    case ART_Node4: {
+        Art_Node4 *node4 = (Art_Node4 *) node;
+        for(u16 i = 0; i < node4->count; ++i) this->destroy_recursive(node4->children[i]);
+    } break;
+
+    case ART_Node16: {
+        Art_Node16 *node16 = (Art_Node16 *) node;
+        for(u16 i = 0; i < node16->count; ++i) this->destroy_recursive(node16->children[i]);
+    } break;
+
+    case ART_Node48: {
+        Art_Node48 *node48 = (Art_Node48 *) node;
+        for(u16 i = 0; i < 48; ++i) this->destroy_recursive(node48->children[i]);
+    } break;
+
+    case ART_Node256: {
+        Art_Node256 *node256 = (Art_Node256 *) node;
+        for(u16 i = 0; i < 256; ++i) this->destroy_recursive(node256->children[i]);
+    } break;
+
+    default: break;
+    }
+
+    this->allocator->deallocate(node);
+}
+
+template<typename K, typename V>
+typename Adaptive_Radix_Tree<K, V>::Leaf *Adaptive_Radix_Tree<K, V>::minimum_leaf(Art_Node *node) {
+    while(node != null) {
         switch(node->kind) {
-        case ART_Leaf:
-            node = null;
-            break;
+        case ART_Leaf: return (Leaf *) node;
+        case ART_Node4:  node = ((Art_Node4 *) node)->children[0]; break;
+        case ART_Node16: node = ((Art_Node16 *) node)->children[0]; break;
 
-        case ART_Node4: {
-            Art_Node4 *node4 = (Art_Node4 *) node;
-            u8 child_index = art_node4_lower_bound(node4, span);
-            if(child_index < node4->count && node4->keys[child_index] == span) {
-                node = node4->children[child_index];
-                ++span_index;
-            } else {
-                node = null;
+        // In concurrent mode, this may race with a writer, so don't rely on the node not changing under us.
+        case ART_Node48: {
+            Art_Node48 *node48 = (Art_Node48 *) node;
+            Art_Node *next = null;
+            for(u16 span = 0; span < 256 && next == null; ++span) {
+                u8 slot = node48->indirection[span];
+                if(slot != 0xff) next = node48->children[slot];
             }
+            node = next;
         } break;
 
-        case ART_Node16: {
-            Art_Node16 *node16 = (Art_Node16 *) node;
-            span = art_flip_sign(span);
-            u8 child_index = art_node16_lookup_lower_bound(node16, span);
-            if(child_index < node16->count && node16->keys[child_index] == span) {
-                node = node16->children[child_index];
-                ++span_index;
-            } else {
-                node = null;
-            }
+        case ART_Node256: {
+            Art_Node256 *node256 = (Art_Node256 *) node;
+            Art_Node *next = null;
+            for(u16 span = 0; span < 256 && next == null; ++span) next = node256->children[span];
+            node = next;
         } break;
+        }
+    }
+
+    return null;
+}
+
+template<typename K, typename V>
+typename Adaptive_Radix_Tree<K, V>::Leaf *Adaptive_Radix_Tree<K, V>::maximum_leaf(Art_Node *node) {
+    while(node != null) {
+        switch(node->kind) {
+        case ART_Leaf: return (Leaf *) node;
+        case ART_Node4:  node = ((Art_Node4 *) node)->children[((Art_Node4 *) node)->count - 1]; break;
+        case ART_Node16: node = ((Art_Node16 *) node)->children[((Art_Node16 *) node)->count - 1]; break;
 
         case ART_Node48: {
             Art_Node48 *node48 = (Art_Node48 *) node;
-            if(node48->indirection[span] != 0xff) {
-                node = node48->children[node48->indirection[span]];
-                ++span_index;
-            } else {
-                node = null;
-            }
+            s16 span = 255;
+            while(node48->indirection[span] == 0xff) --span;
+            node = node48->children[node48->indirection[span]];
         } break;
 
         case ART_Node256: {
             Art_Node256 *node256 = (Art_Node256 *) node;
+            s16 span = 255;
+            while(node256->children[span] == null) --span;
             node = node256->children[span];
-            ++span_index;
         } break;
         }
     }
 
-    return node != null;
+    return null;
 }
-    
-template<typename T>
-Art_Node *Adaptive_Radix_Tree<T>::destroy_recursive(Art_Node *node) {
-    if(!node) return null;
 
+template<typename K, typename V>
+u8 Adaptive_Radix_Tree<K, V>::prefix_span(Art_Inner_Node *node, s64 depth, s64 index) {
+    // Returns the span at the given index in the (potentially only partially stored) prefix of this node.
+    if(index < ART_MAX_PREFIX_LENGTH) return node->prefix[index];
+    return art_key(this->minimum_leaf(node)->key)[depth + index];
+}
+
+template<typename K, typename V>
+s64 Adaptive_Radix_Tree<K, V>::prefix_mismatch(Art_Inner_Node *node, Art_Key const &key, s64 depth) {
+    // Returns the index of the first span in the full prefix of this node that does not match the key.
+    s64 index = this->check_stored_prefix(node, key, depth);
+    if(index < ART_MAX_PREFIX_LENGTH || node->prefix_length <= ART_MAX_PREFIX_LENGTH) return index;
+
+    Art_Key leaf_key = art_key(this->minimum_leaf(node)->key);
+    while(index < node->prefix_length && leaf_key[depth + index] == key[depth + index]) ++index;
+    return index;
+}
+
+template<typename K, typename V>
+s64 Adaptive_Radix_Tree<K, V>::check_stored_prefix(Art_Inner_Node *node, Art_Key const &key, s64 depth) {
+    // Only compares the pessimistically stored part of the prefix.
+    s64 stored = MIN(node->prefix_length, ART_MAX_PREFIX_LENGTH);
+    s64 index;
+    for(index = 0; index < stored; ++index) {
+        if(node->prefix[index] != key[depth + index]) break;
+    }
+
+    return index;
+}
+
+template<typename K, typename V>
+Art_Node **Adaptive_Radix_Tree<K, V>::find_child(Art_Node *node, u8 span) {
+    switch(node->kind) {
+    case ART_Node4: {
+        Art_Node4 *node4 = (Art_Node4 *) node;
+        u8 child_index = art_node4_lower_bound(node4, span);
+        if(child_index < node4->count && node4->keys[child_index] == span) return &node4->children[child_index];
+    } break;
+
+    case ART_Node16: {
+        Art_Node16 *node16 = (Art_Node16 *) node;
+        u8 child_index = art_node16_lookup_lower_bound(node16, art_flip_sign(span));
+        if(child_index < node16->count) return &node16->children[child_index];
+    } break;
+
+    case ART_Node48: {
+        Art_Node48 *node48 = (Art_Node48 *) node;
+        if(node48->indirection[span] != 0xff) return &node48->children[node48->indirection[span]];
+    } break;
+
+    case ART_Node256: {
+        Art_Node256 *node256 = (Art_Node256 *) node;
+        if(node256->children[span] != null) return &node256->children[span];
+    } break;
+
+    default:
+        foundation_error("Encountered an invalid node kind in the ART.");
+        break;
+    }
+
+    return null;
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::add_child(Art_Node **node_ptr, Art_Node *node, u8 span, Art_Node *child) {
+    // Inserts the child into the node, growing the node if it has no more capacity. The node_ptr gets
+    // updated to point to the new node in that case. The node_ptr may be null if the caller made sure that
+    // the node has enough capacity.
+    switch(node->kind) {
+    case ART_Node4: {
+        Art_Node4 *node4 = (Art_Node4 *) node;
+
+        if(node4->count < 4) {
+            u8 child_index = art_node4_lower_bound(node4, span);
+            memmove(&node4->keys[child_index + 1], &node4->keys[child_index], (node4->count - child_index) * sizeof(u8));
+            memmove(&node4->children[child_index + 1], &node4->children[child_index], (node4->count - child_index) * sizeof(Art_Node *));
+            node4->keys[child_index]     = span;
+            node4->children[child_index] = child;
+            ++node4->count;
+        } else {
+            Art_Node16 *node16 = this->allocate_node<Art_Node16>();
+            art_copy_header(node16, node4);
+            for(u8 i = 0; i < node4->count; ++i) {
+                node16->keys[i]     = art_flip_sign(node4->keys[i]); // For the SIMD lower_bound implementation to work correctly, we must assume signed (instead of unsigned) integers in this node, therefore flip the signs...
+                node16->children[i] = node4->children[i];
+            }
+
+            *node_ptr = node16;
+            this->release_node(node4);
+            this->add_child(node_ptr, node16, span, child);
+        }
+    } break;
+
+    case ART_Node16: {
+        Art_Node16 *node16 = (Art_Node16 *) node;
+
+        if(node16->count < 16) {
+            u8 flipped = art_flip_sign(span);
+            u8 child_index = art_node16_insert_lower_bound(node16, flipped);
+            memmove(&node16->keys[child_index + 1], &node16->keys[child_index], (node16->count - child_index) * sizeof(u8));
+            memmove(&node16->children[child_index + 1], &node16->children[child_index], (node16->count - child_index) * sizeof(Art_Node *));
+            node16->keys[child_index]     = flipped;
+            node16->children[child_index] = child;
+            ++node16->count;
+        } else {
+            Art_Node48 *node48 = this->allocate_node<Art_Node48>();
+            art_copy_header(node48, node16);
+            for(u8 i = 0; i < node16->count; ++i) {
+                node48->indirection[art_flip_sign(node16->keys[i])] = i;
+                node48->children[i] = node16->children[i];
+            }
+
+            *node_ptr = node48;
+            this->release_node(node16);
+            this->add_child(node_ptr, node48, span, child);
+        }
+    } break;
+
+    case ART_Node48: {
+        Art_Node48 *node48 = (Art_Node48 *) node;
+
+        if(node48->count < 48) {
+            // Slots may be freed in any order on removal, so look for the first free one.
+            u8 slot = 0;
+            while(node48->children[slot] != null) ++slot;
+            node48->indirection[span] = slot;
+            node48->children[slot]    = child;
+            ++node48->count;
+        } else {
+            Art_Node256 *node256 = this->allocate_node<Art_Node256>();
+            art_copy_header(node256, node48);
+            for(u16 i = 0; i < 256; ++i) {
+                if(node48->indirection[i] != 0xff) node256->children[i] = node48->children[node48->indirection[i]];
+            }
+
+            *node_ptr = node256;
+            this->release_node(node48);
+            this->add_child(node_ptr, node256, span, child);
+        }
+    } break;
+
+    case ART_Node256: {
+        Art_Node256 *node256 = (Art_Node256 *) node;
+        node256->children[span] = child;
+        ++node256->count;
+    } break;
+
+    default:
+        foundation_error("Encountered an invalid node kind in the ART.");
+        break;
+    }
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::remove_child(Art_Node **node_ptr, Art_Node *node, u8 span, Art_Node **child_ptr) {
+    // Removes the child from the node, shrinking the node if it falls below the capacity of the next smaller
+    // node kind. The thresholds are a bit lower than the capacities to avoid thrashing between two kinds.
+    // The node_ptr may be null if the node must stay in place, in which case it never shrinks.
     switch(node->kind) {
     case ART_Node4: {
         Art_Node4 *node4 = (Art_Node4 *) node;
-        for(u8 i = 0; i < node4->count; ++i) {
-            node4->children[i] = this->destroy_recursive(node4->children[i]);
+        s64 child_index = child_ptr - node4->children;
+        memmove(&node4->keys[child_index], &node4->keys[child_index + 1], (node4->count - child_index - 1) * sizeof(u8));
+        memmove(&node4->children[child_index], &node4->children[child_index + 1], (node4->count - child_index - 1) * sizeof(Art_Node *));
+        --node4->count;
+
+        if(node4->count == 1 && node_ptr) {
+            // Path compression: Merge this node into its only child.
+            Art_Node *only_child = node4->children[0];
+
+            if(only_child->kind != ART_Leaf) {
+                Art_Inner_Node *inner = (Art_Inner_Node *) only_child;
+
+                s64 prefix_length = node4->prefix_length;
+                if(prefix_length < ART_MAX_PREFIX_LENGTH) {
+                    node4->prefix[prefix_length] = node4->keys[0];
+                    ++prefix_length;
+                }
+
+                if(prefix_length < ART_MAX_PREFIX_LENGTH) {
+                    s64 sub_prefix_length = MIN(inner->prefix_length, ART_MAX_PREFIX_LENGTH - prefix_length);
+                    memcpy(node4->prefix + prefix_length, inner->prefix, sub_prefix_length);
+                    prefix_length += sub_prefix_length;
+                }
+
+                memcpy(inner->prefix, node4->prefix, MIN(prefix_length, ART_MAX_PREFIX_LENGTH));
+                inner->prefix_length += node4->prefix_length + 1;
+            }
+
+            *node_ptr = only_child;
+            this->release_node(node4);
         }
     } break;
 
     case ART_Node16: {
         Art_Node16 *node16 = (Art_Node16 *) node;
-        for(u8 i = 0; i < node16->count; ++i) {
-            node16->children[i] = this->destroy_recursive(node16->children[i]);
+        s64 child_index = child_ptr - node16->children;
+        memmove(&node16->keys[child_index], &node16->keys[child_index + 1], (node16->count - child_index - 1) * sizeof(u8));
+        memmove(&node16->children[child_index], &node16->children[child_index + 1], (node16->count - child_index - 1) * sizeof(Art_Node *));
+        --node16->count;
+
+        if(node16->count == 3 && node_ptr) {
+            Art_Node4 *node4 = this->allocate_node<Art_Node4>();
+            art_copy_header(node4, node16);
+            for(u8 i = 0; i < node16->count; ++i) {
+                node4->keys[i]     = art_flip_sign(node16->keys[i]);
+                node4->children[i] = node16->children[i];
+            }
+
+            *node_ptr = node4;
+            this->release_node(node16);
         }
     } break;
 
     case ART_Node48: {
         Art_Node48 *node48 = (Art_Node48 *) node;
-        for(u8 i = 0; i < node48->count; ++i) {
-            node48->children[i] = this->destroy_recursive(node48->children[i]);
+        node48->children[node48->indirection[span]] = null;
+        node48->indirection[span] = 0xff;
+        --node48->count;
+
+        if(node48->count == 12 && node_ptr) {
+            Art_Node16 *node16 = this->allocate_node<Art_Node16>();
+            art_copy_header(node16, node48);
+            node16->count = 0;
+            for(u16 i = 0; i < 256; ++i) {
+                if(node48->indirection[i] == 0xff) continue;
+                node16->keys[node16->count]     = art_flip_sign((u8) i);
+                node16->children[node16->count] = node48->children[node48->indirection[i]];
+                ++node16->count;
+            }
+
+            *node_ptr = node16;
+            this->release_node(node48);
         }
     } break;
 
     case ART_Node256: {
         Art_Node256 *node256 = (Art_Node256 *) node;
+        node256->children[span] = null;
+        --node256->count;
+
+        if(node256->count == 37 && node_ptr) {
+            Art_Node48 *node48 = this->allocate_node<Art_Node48>();
+            art_copy_header(node48, node256);
+            node48->count = 0;
+            for(u16 i = 0; i < 256; ++i) {
+                if(node256->children[i] == null) continue;
+                node48->indirection[i] = (u8) node48->count;
+                node48->children[node48->count] = node256->children[i];
+                ++node48->count;
+            }
+
+            *node_ptr = node48;
+            this->release_node(node256);
+        }
+    } break;
+
+    default:
+        foundation_error("Encountered an invalid node kind in the ART.");
+        break;
+    }
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::split_leaf(Art_Node **node_ptr, Leaf *existing, Art_Key const &key, s64 depth, Leaf *leaf) {
+    // Replaces the existing leaf with a node4, which contains the common prefix of both keys and the two
+    // leaves as children.
+    Art_Key existing_key = art_key(existing->key);
+
+    s64 common = 0;
+    s64 max_common = MAX(existing_key.count, key.count) - depth;
+    while(common < max_common && existing_key[depth + common] == key[depth + common]) ++common;
+    assert(existing_key[depth + common] != key[depth + common], "String keys in the ART must not contain zero bytes.");
+
+    Art_Node4 *node4 = this->allocate_node<Art_Node4>();
+    node4->prefix_length = (u32) common;
+    for(s64 i = 0; i < MIN(common, ART_MAX_PREFIX_LENGTH); ++i) node4->prefix[i] = key[depth + i];
+
+    this->add_child(node_ptr, node4, existing_key[depth + common], existing);
+    this->add_child(node_ptr, node4, key[depth + common], leaf);
+    *node_ptr = node4;
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::split_prefix(Art_Node **node_ptr, Art_Inner_Node *inner, Art_Key const &key, s64 depth, s64 mismatch, Leaf *leaf) {
+    // The key diverges inside of the compressed path, so we need to split the prefix by inserting a new node4
+    // above this node.
+    Art_Node4 *node4 = this->allocate_node<Art_Node4>();
+    node4->prefix_length = (u32) mismatch;
+    memcpy(node4->prefix, inner->prefix, MIN(mismatch, ART_MAX_PREFIX_LENGTH));
+
+    if(inner->prefix_length <= ART_MAX_PREFIX_LENGTH) {
+        this->add_child(node_ptr, node4, inner->prefix[mismatch], inner);
+        inner->prefix_length -= (u32) (mismatch + 1);
+        memmove(inner->prefix, inner->prefix + mismatch + 1, MIN(inner->prefix_length, ART_MAX_PREFIX_LENGTH));
+    } else {
+        // Not all of the prefix is stored in this node, recover the rest from any leaf.
+        Art_Key leaf_key = art_key(this->minimum_leaf(inner)->key);
+        this->add_child(node_ptr, node4, leaf_key[depth + mismatch], inner);
+        inner->prefix_length -= (u32) (mismatch + 1);
+        for(s64 i = 0; i < MIN(inner->prefix_length, ART_MAX_PREFIX_LENGTH); ++i) inner->prefix[i] = leaf_key[depth + mismatch + 1 + i];
+    }
+
+    this->add_child(node_ptr, node4, key[depth + mismatch], leaf);
+    *node_ptr = node4;
+}
+
+template<typename K, typename V>
+template<typename Procedure>
+void Adaptive_Radix_Tree<K, V>::iterate_recursive(Art_Node *node, Procedure &procedure) {
+    if(!node) return;
+
+    switch(node->kind) {
+    case ART_Leaf: {
+        Leaf *leaf = (Leaf *) node;
+        procedure(&leaf->key, &leaf->value);
+    } break;
+
+    case ART_Node4: {
+        Art_Node4 *node4 = (Art_Node4 *) node;
+        for(u16 i = 0; i < node4->count; ++i) this->iterate_recursive(node4->children[i], procedure);
+    } break;
+
+    case ART_Node16: {
+        Art_Node16 *node16 = (Art_Node16 *) node;
+        for(u16 i = 0; i < node16->count; ++i) this->iterate_recursive(node16->children[i], procedure);
+    } break;
+
+    case ART_Node48: {
+        Art_Node48 *node48 = (Art_Node48 *) node;
         for(u16 i = 0; i < 256; ++i) {
-            node256->children[i] = this->destroy_recursive(node256->children[i]);
+            if(node48->indirection[i] != 0xff) this->iterate_recursive(node48->children[node48->indirection[i]], procedure);
         }
     } break;
+
+    case ART_Node256: {
+        Art_Node256 *node256 = (Art_Node256 *) node;
+        for(u16 i = 0; i < 256; ++i) this->iterate_recursive(node256->children[i], procedure);
+    } break;
     }
+}
 
-    this->allocator->deallocate(node);
-    return null;
+template<typename K, typename V>
+template<typename Procedure>
+b8 Adaptive_Radix_Tree<K, V>::iterate_range_recursive(Art_Node *node, s64 depth, Art_Key const &min, Art_Key const &max, b8 bounded_below, b8 bounded_above, Procedure &procedure) {
+    //
+    // bounded_below / bounded_above are true as long as the path to this node is equal to the prefix of the
+    // min / max key, meaning we still need to compare spans against that bound. As soon as the path is
+    // strictly bigger than min (or smaller than max), the entire subtree is within that bound.
+    // Returns false once a key bigger than max was encountered, to stop the iteration.
+    //
+    if(!node) return true;
+
+    if(!bounded_below && !bounded_above) {
+        this->iterate_recursive(node, procedure);
+        return true;
+    }
+
+    if(node->kind == ART_Leaf) {
+        Leaf *leaf = (Leaf *) node;
+        Art_Key leaf_key = art_key(leaf->key);
+        if(bounded_below && art_compare_keys(leaf_key, min) < 0) return true;
+        if(bounded_above && art_compare_keys(leaf_key, max) > 0) return false;
+        procedure(&leaf->key, &leaf->value);
+        return true;
+    }
+
+    Art_Inner_Node *inner = (Art_Inner_Node *) node;
+    for(s64 i = 0; i < inner->prefix_length && (bounded_below || bounded_above); ++i) {
+        u8 span = this->prefix_span(inner, depth, i);
+
+        if(bounded_below) {
+            if(span < min[depth + i]) return true; // The entire subtree is smaller than min.
+            if(span > min[depth + i]) bounded_below = false;
+        }
+
+        if(bounded_above) {
+            if(span > max[depth + i]) return false; // The entire subtree is bigger than max.
+            if(span < max[depth + i]) bounded_above = false;
+        }
+    }
+
+    depth += inner->prefix_length;
+
+    u8 min_span = min[depth], max_span = max[depth];
+
+#define ART_VISIT_CHILD(span, child)                                    \
+    {                                                                   \
+        u8 __span = (span);                                             \
+        if(!(bounded_below && __span < min_span)) {                     \
+            if(bounded_above && __span > max_span) return false;        \
+            if(!this->iterate_range_recursive(child, depth + 1, min, max, bounded_below && __span == min_span, bounded_above && __span == max_span, procedure)) return false; \
+        }                                                               \
+    }
+
+    switch(node->kind) {
+    case ART_Node4: {
+        Art_Node4 *node4 = (Art_Node4 *) node;
+        for(u16 i = 0; i < node4->count; ++i) ART_VISIT_CHILD(node4->keys[i], node4->children[i]);
+    } break;
+
+    case ART_Node16: {
+        Art_Node16 *node16 = (Art_Node16 *) node;
+        for(u16 i = 0; i < node16->count; ++i) ART_VISIT_CHILD(art_flip_sign(node16->keys[i]), node16->children[i]);
+    } break;
+
+    case ART_Node48: {
+        Art_Node48 *node48 = (Art_Node48 *) node;
+        for(u16 i = 0; i < 256; ++i) {
+            if(node48->indirection[i] != 0xff) ART_VISIT_CHILD((u8) i, node48->children[node48->indirection[i]]);
+        }
+    } break;
+
+    case ART_Node256: {
+        Art_Node256 *node256 = (Art_Node256 *) node;
+        for(u16 i = 0; i < 256; ++i) {
+            if(node256->children[i] != null) ART_VISIT_CHILD((u8) i, node256->children[i]);
+        }
+    } break;
+
+    default: break;
+    }
+
+#undef ART_VISIT_CHILD
+
+    return true;
 }
 
-template<typename T>
-u8 Adaptive_Radix_Tree<T>::span(T const &key, u8 span_index) {
-    return ((u8 *) &key)[span_index];
+
+
+/* ---------------------------------------------- Concurrent Mode ---------------------------------------------- */
+
+template<typename K, typename V>
+Art_Thread_Epoch *Adaptive_Radix_Tree<K, V>::enter_epoch() {
+    Art_Thread_Epoch *thread_epoch = &this->thread_epochs[art_thread_slot()];
+    atomic_store(&thread_epoch->epoch, atomic_load(&this->global_epoch));
+    return thread_epoch;
 }
 
-template<typename T>
-u8 Adaptive_Radix_Tree<T>::span_count() {
-    return sizeof(T) / sizeof(u8);
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::exit_epoch(Art_Thread_Epoch *thread_epoch) {
+    atomic_store(&thread_epoch->epoch, ART_EPOCH_QUIESCENT);
+}
+
+template<typename K, typename V>
+void Adaptive_Radix_Tree<K, V>::reclaim_nodes(Art_Thread_Epoch *thread_epoch) {
+    //
+    // Advance the global epoch, so that threads entering from now on cannot see any of the retired nodes.
+    // Then free all nodes which were retired before the oldest epoch any thread is still in.
+    //
+    atomic_add(&this->global_epoch, 1);
+
+    u64 oldest_epoch = ART_EPOCH_QUIESCENT;
+    for(s64 i = 0; i < ART_MAX_THREADS; ++i) {
+        oldest_epoch = MIN(oldest_epoch, atomic_load(&this->thread_epochs[i].epoch));
+    }
+
+    s64 kept = 0;
+    for(s64 i = 0; i < thread_epoch->retired.count; ++i) {
+        Art_Retired_Node retired = thread_epoch->retired.data[i];
+        if(retired.epoch < oldest_epoch) {
+            this->allocator->deallocate(retired.node);
+        } else {
+            thread_epoch->retired.data[kept] = retired;
+            ++kept;
+        }
+    }
+
+    thread_epoch->retired.count = kept;
+}
+
+template<typename K, typename V>
+b8 Adaptive_Radix_Tree<K, V>::add_concurrent(K const &key, V const &value) {
+    Art_Key span_key = art_key(key);
+    Art_Thread_Epoch *thread_epoch = this->enter_epoch();
+    defer { this->exit_epoch(thread_epoch); };
+
+    Leaf *leaf = this->allocate_node<Leaf>();
+    leaf->key   = key;
+    leaf->value = value;
+
+restart:
+    b8 needs_restart = false;
+
+    Art_Inner_Node *parent = null;
+    u64 parent_version = 0;
+    u8 parent_span = 0;
+
+    Art_Inner_Node *node = (Art_Inner_Node *) this->root;
+    u64 version = art_read_lock(node, &needs_restart);
+    if(needs_restart) goto restart;
+
+    s64 depth = 0;
+
+    while(true) {
+        u32 prefix_length = node->prefix_length;
+
+        if(prefix_length > 0) {
+            s64 mismatch = this->prefix_mismatch(node, span_key, depth);
+            art_read_unlock(node, version, &needs_restart);
+            if(needs_restart) goto restart;
+
+            if(mismatch < prefix_length) {
+                // The root never has a prefix, so there always is a parent here.
+                art_upgrade_to_write_lock(parent, parent_version, &needs_restart);
+                if(needs_restart) goto restart;
+
+                art_upgrade_to_write_lock(node, version, &needs_restart);
+                if(needs_restart) {
+                    art_write_unlock(parent);
+                    goto restart;
+                }
+
+                this->split_prefix(this->find_child(parent, parent_span), node, span_key, depth, mismatch, leaf);
+                art_write_unlock(node);
+                art_write_unlock(parent);
+                break;
+            }
+
+            depth += prefix_length;
+        }
+
+        u8 span = span_key[depth];
+        Art_Node **child_ptr = this->find_child(node, span);
+        Art_Node *child = child_ptr ? *child_ptr : null;
+        art_read_unlock(node, version, &needs_restart);
+        if(needs_restart) goto restart;
+
+        if(child == null) {
+            if(art_node_is_full(node)) {
+                // The node needs to grow, which replaces it in the parent.
+                art_upgrade_to_write_lock(parent, parent_version, &needs_restart);
+                if(needs_restart) goto restart;
+
+                art_upgrade_to_write_lock(node, version, &needs_restart);
+                if(needs_restart) {
+                    art_write_unlock(parent);
+                    goto restart;
+                }
+
+                this->add_child(this->find_child(parent, parent_span), node, span, leaf);
+                art_write_unlock_obsolete(node);
+                art_write_unlock(parent);
+            } else {
+                art_upgrade_to_write_lock(node, version, &needs_restart);
+                if(needs_restart) goto restart;
+
+                this->add_child(null, node, span, leaf);
+                art_write_unlock(node);
+            }
+
+            break;
+        }
+
+        if(child->kind == ART_Leaf) {
+            art_upgrade_to_write_lock(node, version, &needs_restart);
+            if(needs_restart) goto restart;
+
+            Leaf *existing = (Leaf *) child;
+            if(art_keys_equal(art_key(existing->key), span_key)) {
+                art_write_unlock(node);
+                this->allocator->deallocate(leaf); // The leaf was never visible to other threads.
+                return false;
+            }
+
+            this->split_leaf(child_ptr, existing, span_key, depth + 1, leaf);
+            art_write_unlock(node);
+            break;
+        }
+
+        parent         = node;
+        parent_version = version;
+        parent_span    = span;
+
+        node    = (Art_Inner_Node *) child;
+        version = art_read_lock(node, &needs_restart);
+        if(needs_restart) goto restart;
+
+        // Make sure that the child was not moved (e.g. by path compression) before we read its version.
+        art_read_unlock(parent, parent_version, &needs_restart);
+        if(needs_restart) goto restart;
+
+        ++depth;
+    }
+
+    atomic_add(&this->count, 1);
+    return true;
+}
+
+template<typename K, typename V>
+b8 Adaptive_Radix_Tree<K, V>::query_concurrent(K const &key, V *value) {
+    Art_Key span_key = art_key(key);
+    Art_Thread_Epoch *thread_epoch = this->enter_epoch();
+    defer { this->exit_epoch(thread_epoch); };
+
+restart:
+    b8 needs_restart = false;
+
+    Art_Inner_Node *node = (Art_Inner_Node *) this->root;
+    u64 version = art_read_lock(node, &needs_restart);
+    if(needs_restart) goto restart;
+
+    s64 depth = 0;
+
+    while(true) {
+        u32 prefix_length = node->prefix_length;
+
+        if(prefix_length > 0) {
+            b8 prefix_matches = this->check_stored_prefix(node, span_key, depth) == MIN(prefix_length, ART_MAX_PREFIX_LENGTH);
+            art_read_unlock(node, version, &needs_restart);
+            if(needs_restart) goto restart;
+            if(!prefix_matches) return false;
+
+            depth += prefix_length;
+        }
+
+        Art_Node **child_ptr = this->find_child(node, span_key[depth]);
+        Art_Node *child = child_ptr ? *child_ptr : null;
+        art_read_unlock(node, version, &needs_restart);
+        if(needs_restart) goto restart;
+
+        if(child == null) return false;
+
+        if(child->kind == ART_Leaf) {
+            // Leaves are never modified once they are in the tree, and the epoch keeps them alive.
+            Leaf *leaf = (Leaf *) child;
+            if(!art_keys_equal(art_key(leaf->key), span_key)) return false;
+
+            *value = leaf->value;
+            return true;
+        }
+
+        Art_Inner_Node *parent = node;
+        u64 parent_version = version;
+
+        node    = (Art_Inner_Node *) child;
+        version = art_read_lock(node, &needs_restart);
+        if(needs_restart) goto restart;
+
+        art_read_unlock(parent, parent_version, &needs_restart);
+        if(needs_restart) goto restart;
+
+        ++depth;
+    }
+}
+
+template<typename K, typename V>
+b8 Adaptive_Radix_Tree<K, V>::remove_concurrent(K const &key) {
+    Art_Key span_key = art_key(key);
+    Art_Thread_Epoch *thread_epoch = this->enter_epoch();
+    defer { this->exit_epoch(thread_epoch); };
+
+restart:
+    b8 needs_restart = false;
+
+    Art_Inner_Node *parent = null;
+    u64 parent_version = 0;
+    u8 parent_span = 0;
+
+    Art_Inner_Node *node = (Art_Inner_Node *) this->root;
+    u64 version = art_read_lock(node, &needs_restart);
+    if(needs_restart) goto restart;
+
+    s64 depth = 0;
+
+    while(true) {
+        u32 prefix_length = node->prefix_length;
+
+        if(prefix_length > 0) {
+            b8 prefix_matches = this->check_stored_prefix(node, span_key, depth) == MIN(prefix_length, ART_MAX_PREFIX_LENGTH);
+            art_read_unlock(node, version, &needs_restart);
+            if(needs_restart) goto restart;
+            if(!prefix_matches) return false;
+
+            depth += prefix_length;
+        }
+
+        u8 span = span_key[depth];
+        Art_Node **child_ptr = this->find_child(node, span);
+        Art_Node *child = child_ptr ? *child_ptr : null;
+        art_read_unlock(node, version, &needs_restart);
+        if(needs_restart) goto restart;
+
+        if(child == null) return false;
+
+        if(child->kind == ART_Leaf) {
+            Leaf *leaf = (Leaf *) child;
+            if(!art_keys_equal(art_key(leaf->key), span_key)) return false;
+
+            if(node != this->root && art_node_shrinks_on_remove(node)) {
+                // The node gets replaced in the parent.
+                art_upgrade_to_write_lock(parent, parent_version, &needs_restart);
+                if(needs_restart) goto restart;
+
+                art_upgrade_to_write_lock(node, version, &needs_restart);
+                if(needs_restart) {
+                    art_write_unlock(parent);
+                    goto restart;
+                }
+
+                // If a node4 gets merged into its remaining child, that child's prefix changes, so it must
+                // be locked as well.
+                Art_Inner_Node *remaining = null;
+                if(node->kind == ART_Node4) {
+                    Art_Node4 *node4 = (Art_Node4 *) node;
+                    Art_Node *other = node4->children[(child_ptr - node4->children) ^ 1];
+
+                    if(other->kind != ART_Leaf) {
+                        remaining = (Art_Inner_Node *) other;
+                        u64 remaining_version = art_read_lock(remaining, &needs_restart);
+                        if(!needs_restart) art_upgrade_to_write_lock(remaining, remaining_version, &needs_restart);
+                        if(needs_restart) {
+                            art_write_unlock(node);
+                            art_write_unlock(parent);
+                            goto restart;
+                        }
+                    }
+                }
+
+                this->remove_child(this->find_child(parent, parent_span), node, span, child_ptr);
+                if(remaining) art_write_unlock(remaining);
+                art_write_unlock_obsolete(node);
+                art_write_unlock(parent);
+            } else {
+                art_upgrade_to_write_lock(node, version, &needs_restart);
+                if(needs_restart) goto restart;
+
+                this->remove_child(null, node, span, child_ptr);
+                art_write_unlock(node);
+            }
+
+            this->release_node(leaf);
+            atomic_add(&this->count, -1);
+            return true;
+        }
+
+        parent         = node;
+        parent_version = version;
+        parent_span    = span;
+
+        node    = (Art_Inner_Node *) child;
+        version = art_read_lock(node, &needs_restart);
+        if(needs_restart) goto restart;
+
+        art_read_unlock(parent, parent_version, &needs_restart);
+        if(needs_restart) goto restart;
+
+        ++depth;
+    }
 }
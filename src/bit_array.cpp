@@ -0,0 +1,252 @@
+#include "bit_array.h"
+#include "os_specific.h"
+
+#if FOUNDATION_WIN32
+# include <intrin.h>
+#elif FOUNDATION_LINUX
+# include <immintrin.h>
+#endif
+
+#if defined(__AVX2__)
+# define BIT_ARRAY_AVX2 true
+# define BIT_ARRAY_WORDS_PER_REGISTER 4
+#else
+# define BIT_ARRAY_AVX2 false
+# define BIT_ARRAY_WORDS_PER_REGISTER 2
+#endif
+
+static_assert(BIT_ARRAY_WORDS_PER_LINE % BIT_ARRAY_WORDS_PER_REGISTER == 0, "The Bit Array padding must cover whole SIMD registers.");
+
+#if BIT_ARRAY_AVX2
+# define BIT_ARRAY_BINARY_OPERATION(lhs, rhs, count, intrinsic) \
+    for(s64 i = 0; i < count; i += 4) { \
+        __m256i a = _mm256_load_si256((__m256i *) &lhs[i]); \
+        __m256i b = _mm256_load_si256((__m256i *) &rhs[i]); \
+        _mm256_store_si256((__m256i *) &lhs[i], intrinsic); \
+    }
+#else
+# define BIT_ARRAY_BINARY_OPERATION(lhs, rhs, count, intrinsic) \
+    for(s64 i = 0; i < count; i += 2) { \
+        __m128i a = _mm_load_si128((__m128i *) &lhs[i]); \
+        __m128i b = _mm_load_si128((__m128i *) &rhs[i]); \
+        _mm_store_si128((__m128i *) &lhs[i], intrinsic); \
+    }
+#endif
+
+// Returns true if all words in [first, first + BIT_ARRAY_WORDS_PER_REGISTER) are equal to 'skip' (all zeroes
+// or all ones).
+static inline
+b8 bit_array_register_equals(u64 *words, u64 skip) {
+#if BIT_ARRAY_AVX2
+    __m256i value = _mm256_load_si256((__m256i *) words);
+    return skip ? _mm256_testc_si256(value, _mm256_set1_epi64x(-1)) : _mm256_testz_si256(value, value);
+#else
+    __m128i value = _mm_load_si128((__m128i *) words);
+    __m128i equal = _mm_cmpeq_epi32(value, _mm_set1_epi64x((s64) skip));
+    return _mm_movemask_epi8(equal) == 0xffff;
+#endif
+}
+
+// Finds the first word in [first_word, end_word) which is not equal to 'skip', returns end_word if there is
+// none. Words which consist only of the skipped pattern are checked a whole register at a time.
+static
+s64 bit_array_find_word(u64 *words, s64 first_word, s64 end_word, u64 skip) {
+    s64 word = first_word;
+
+    while(word < end_word && word % BIT_ARRAY_WORDS_PER_REGISTER) {
+        if(words[word] != skip) return word;
+        ++word;
+    }
+
+    while(word + BIT_ARRAY_WORDS_PER_REGISTER <= end_word && bit_array_register_equals(&words[word], skip)) {
+        word += BIT_ARRAY_WORDS_PER_REGISTER;
+    }
+
+    while(word < end_word) {
+        if(words[word] != skip) return word;
+        ++word;
+    }
+
+    return end_word;
+}
+
+static
+s64 bit_array_find_next(Bit_Array *array, s64 first, s64 end, b8 set) {
+    if(end == -1) end = array->count;
+    assert(first >= 0 && end <= array->count);
+    if(first >= end) return BIT_ARRAY_INVALID_INDEX;
+
+    u64 skip = set ? 0 : MAX_U64; // The words we are not interested in.
+    s64 word = first / 64;
+    s64 end_word = (end + 63) / 64;
+
+    // Ignore the bits before 'first' in the first word.
+    u64 bits = (array->bits[word] ^ skip) & (MAX_U64 << (first % 64));
+
+    if(!bits) {
+        word = bit_array_find_word(array->bits, word + 1, end_word, skip);
+        if(word == end_word) return BIT_ARRAY_INVALID_INDEX;
+        bits = array->bits[word] ^ skip;
+    }
+
+    s64 index = word * 64 + os_lowest_bit_set(bits);
+    return index < end ? index : BIT_ARRAY_INVALID_INDEX;
+}
+
+void Bit_Array::create(Allocator *allocator, s64 count) {
+    assert(count >= 0);
+
+    this->allocator  = allocator;
+    this->count      = count;
+    this->word_count = MAX((count + 511) / 512, 1) * BIT_ARRAY_WORDS_PER_LINE;
+    this->memory     = this->allocator->allocate(this->word_count * sizeof(u64) + BIT_ARRAY_ALIGNMENT - 1);
+    this->bits       = (u64 *) (((u64) this->memory + BIT_ARRAY_ALIGNMENT - 1) & ~((u64) BIT_ARRAY_ALIGNMENT - 1));
+
+    this->clear_all();
+}
+
+void Bit_Array::destroy() {
+    if(this->memory) this->allocator->deallocate(this->memory);
+    this->memory     = null;
+    this->bits       = null;
+    this->count      = 0;
+    this->word_count = 0;
+}
+
+void Bit_Array::set_all() {
+    memset(this->bits, 0xff, this->word_count * sizeof(u64));
+    this->clear_padding();
+}
+
+void Bit_Array::clear_all() {
+    memset(this->bits, 0, this->word_count * sizeof(u64));
+}
+
+void Bit_Array::set_range(s64 first, s64 end) {
+    assert(first >= 0 && first <= end && end <= this->count);
+    if(first == end) return;
+
+    s64 first_word = first / 64, last_word = (end - 1) / 64;
+    u64 first_mask = MAX_U64 << (first % 64);
+    u64 last_mask  = MAX_U64 >> (63 - (end - 1) % 64);
+
+    if(first_word == last_word) {
+        this->bits[first_word] |= first_mask & last_mask;
+    } else {
+        this->bits[first_word] |= first_mask;
+        memset(&this->bits[first_word + 1], 0xff, (last_word - first_word - 1) * sizeof(u64));
+        this->bits[last_word] |= last_mask;
+    }
+}
+
+void Bit_Array::clear_range(s64 first, s64 end) {
+    assert(first >= 0 && first <= end && end <= this->count);
+    if(first == end) return;
+
+    s64 first_word = first / 64, last_word = (end - 1) / 64;
+    u64 first_mask = MAX_U64 << (first % 64);
+    u64 last_mask  = MAX_U64 >> (63 - (end - 1) % 64);
+
+    if(first_word == last_word) {
+        this->bits[first_word] &= ~(first_mask & last_mask);
+    } else {
+        this->bits[first_word] &= ~first_mask;
+        memset(&this->bits[first_word + 1], 0, (last_word - first_word - 1) * sizeof(u64));
+        this->bits[last_word] &= ~last_mask;
+    }
+}
+
+void Bit_Array::and_with(Bit_Array *other) {
+    assert(this->count == other->count, "Bit Arrays must have the same size.");
+#if BIT_ARRAY_AVX2
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm256_and_si256(a, b));
+#else
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm_and_si128(a, b));
+#endif
+}
+
+void Bit_Array::or_with(Bit_Array *other) {
+    assert(this->count == other->count, "Bit Arrays must have the same size.");
+#if BIT_ARRAY_AVX2
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm256_or_si256(a, b));
+#else
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm_or_si128(a, b));
+#endif
+}
+
+void Bit_Array::xor_with(Bit_Array *other) {
+    assert(this->count == other->count, "Bit Arrays must have the same size.");
+#if BIT_ARRAY_AVX2
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm256_xor_si256(a, b));
+#else
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm_xor_si128(a, b));
+#endif
+}
+
+void Bit_Array::and_not_with(Bit_Array *other) {
+    assert(this->count == other->count, "Bit Arrays must have the same size.");
+    // The andnot intrinsics negate their first operand.
+#if BIT_ARRAY_AVX2
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm256_andnot_si256(b, a));
+#else
+    BIT_ARRAY_BINARY_OPERATION(this->bits, other->bits, this->word_count, _mm_andnot_si128(b, a));
+#endif
+}
+
+void Bit_Array::invert() {
+    for(s64 i = 0; i < this->word_count; ++i) this->bits[i] = ~this->bits[i];
+    this->clear_padding();
+}
+
+s64 Bit_Array::count_bits_set() {
+    s64 result = 0;
+
+#if BIT_ARRAY_AVX2
+    //
+    // Count the bits of every nibble through a lookup table in a shuffle, and sum the byte counts up with
+    // the sum of absolute differences against zero. A byte can count at most 8 bits, so the per-byte counts
+    // can be accumulated for a while before they need to be widened.
+    //
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+
+    for(s64 i = 0; i < this->word_count; ) {
+        __m256i bytes = _mm256_setzero_si256();
+        s64 end = MIN(i + 31 * 4, this->word_count); // At most 31 iterations, so that a byte count never exceeds 248.
+
+        for(; i < end; i += 4) {
+            __m256i value = _mm256_load_si256((__m256i *) &this->bits[i]);
+            __m256i low   = _mm256_shuffle_epi8(lookup, _mm256_and_si256(value, low_mask));
+            __m256i high  = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask));
+            bytes = _mm256_add_epi8(bytes, _mm256_add_epi8(low, high));
+        }
+
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+
+    result = _mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) + _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3);
+#else
+    for(s64 i = 0; i < this->word_count; ++i) result += os_count_bits_set(this->bits[i]);
+#endif
+
+    return result;
+}
+
+b8 Bit_Array::any_bit_set() {
+    return bit_array_find_word(this->bits, 0, this->word_count, 0) != this->word_count;
+}
+
+s64 Bit_Array::find_next_set(s64 first, s64 end) {
+    return bit_array_find_next(this, first, end, true);
+}
+
+s64 Bit_Array::find_next_clear(s64 first, s64 end) {
+    return bit_array_find_next(this, first, end, false);
+}
+
+void Bit_Array::clear_padding() {
+    s64 used_words = (this->count + 63) / 64;
+    if(this->count % 64) this->bits[used_words - 1] &= MAX_U64 >> (64 - this->count % 64);
+    memset(&this->bits[used_words], 0, (this->word_count - used_words) * sizeof(u64));
+}
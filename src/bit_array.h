@@ -0,0 +1,80 @@
+#pragma once
+
+#include "foundation.h"
+#include "memutils.h"
+#include "os_specific.h" // For os_lowest_bit_set
+
+//
+// A fixed-size array of bits, e.g. for visibility masks or free lists. The bits are stored in u64 words,
+// starting at a cache line boundary and padded to a full cache line, so that the bulk operations (and, or,
+// xor, counting and searching) can always work on whole SIMD registers without any scalar tail. The padding
+// bits past 'count' are always zero.
+// The bulk operations use AVX2 if the compiler targets it, and SSE2 otherwise.
+//
+
+#define BIT_ARRAY_ALIGNMENT        64
+#define BIT_ARRAY_WORDS_PER_LINE   (BIT_ARRAY_ALIGNMENT / sizeof(u64))
+#define BIT_ARRAY_INVALID_INDEX    ((s64) -1)
+
+struct Bit_Array {
+    struct Iterator {
+        Bit_Array *array;
+        s64 index; // The current set bit, or BIT_ARRAY_INVALID_INDEX at the end.
+        u64 remaining; // The set bits of the current word after 'index', so that only empty words need a search.
+
+        b8 operator!=(Iterator const &it) const { return this->index != it.index; }
+        s64 operator*() { return this->index; }
+
+        Iterator &operator++() {
+            if(this->remaining) {
+                this->index = (this->index & ~63LL) + os_lowest_bit_set(this->remaining);
+                this->remaining &= this->remaining - 1;
+            } else {
+                this->load(this->array->find_next_set(MIN((this->index | 63) + 1, this->array->count)));
+            }
+
+            return *this;
+        }
+
+        void load(s64 index) {
+            this->index     = index;
+            this->remaining = index != BIT_ARRAY_INVALID_INDEX ? this->array->bits[index / 64] & ~(MAX_U64 >> (63 - index % 64)) : 0;
+        }
+    };
+
+    Allocator *allocator = Default_Allocator;
+    void *memory = null; // The unaligned allocation.
+    u64 *bits    = null;
+    s64 count      = 0; // The number of bits.
+    s64 word_count = 0; // The number of words, including the padding.
+
+    void create(Allocator *allocator, s64 count); // All bits are initially cleared.
+    void destroy();
+
+    void set(s64 index)    { assert(index >= 0 && index < this->count); this->bits[index / 64] |= 1ULL << (index % 64); }
+    void clear(s64 index)  { assert(index >= 0 && index < this->count); this->bits[index / 64] &= ~(1ULL << (index % 64)); }
+    void toggle(s64 index) { assert(index >= 0 && index < this->count); this->bits[index / 64] ^= 1ULL << (index % 64); }
+    b8 test(s64 index)     { assert(index >= 0 && index < this->count); return (this->bits[index / 64] >> (index % 64)) & 1; }
+
+    void set_all();
+    void clear_all();
+    void set_range(s64 first, s64 end); // Sets all bits in [first, end).
+    void clear_range(s64 first, s64 end);
+
+    // Combine this array with another one of the same size, storing the result in this array.
+    void and_with(Bit_Array *other);
+    void or_with(Bit_Array *other);
+    void xor_with(Bit_Array *other);
+    void and_not_with(Bit_Array *other); // this = this & ~other
+    void invert();
+
+    s64 count_bits_set();
+    b8 any_bit_set();
+    s64 find_next_set(s64 first, s64 end = -1);   // Searches [first, end), end defaults to count. Returns BIT_ARRAY_INVALID_INDEX if no bit is set.
+    s64 find_next_clear(s64 first, s64 end = -1); // Searches [first, end), end defaults to count. Returns BIT_ARRAY_INVALID_INDEX if no bit is cleared.
+
+    void clear_padding();
+
+    Iterator begin() { Iterator it = { this, 0, 0 }; it.load(this->find_next_set(0)); return it; } // Iterates over the indices of all set bits.
+    Iterator end()   { return Iterator { this, BIT_ARRAY_INVALID_INDEX, 0 }; }
+};
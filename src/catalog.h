@@ -5,6 +5,7 @@
 #include "memutils.h"
 #include "package.h"
 #include "file_watcher.h"
+#include "interned_string.h"
 
 #define INITIAL_CATALOG_SIZE 128
 
@@ -20,7 +21,8 @@ template<typename Asset, typename Asset_Parameters = u8> // Asset_Parameters can
 struct Catalog {
     struct Handle {
         Asset asset;
-        string name;
+        Interned_String interned_name;
+        string name; // A view into the global interned string table, which owns the text.
 
 #if FOUNDATION_DEVELOPER
         // For hot-loading
@@ -44,7 +46,7 @@ struct Catalog {
     // For a nice API we need stable pointers to the underlying Asset, as well as fast indirections to get the
     // handle from both the name and the asset pointer.
     Linked_List<Handle> handles;
-    Probed_Hash_Table<string,  Handle *> name_table;
+    Probed_Hash_Table<Interned_String, Handle *> name_table;
     Probed_Hash_Table<Asset *, Handle *> pointer_table;
 
 #if FOUNDATION_DEVELOPER
@@ -9,7 +9,7 @@ void Catalog<Asset, Asset_Parameters>::create_from_package(Package *package, str
     this->name_table.allocator    = this->allocator;
     this->pointer_table.allocator = this->allocator;
     this->file_watcher.allocator  = this->allocator;
-    this->name_table.create(INITIAL_CATALOG_SIZE, string_hash, strings_equal);
+    this->name_table.create(INITIAL_CATALOG_SIZE, interned_string_hash, interned_strings_equal);
     this->pointer_table.create(INITIAL_CATALOG_SIZE, [](Asset * const &key) -> u64 { return murmur_64a((u64) key); }, [](Asset * const &lhs, Asset * const &rhs) -> b8 { return lhs == rhs; });
     this->file_watcher.create();
 }
@@ -23,7 +23,7 @@ void Catalog<Asset, Asset_Parameters>::create_from_file_system(string directory,
     this->name_table.allocator    = this->allocator;
     this->pointer_table.allocator = this->allocator;
     this->file_watcher.allocator  = this->allocator;
-    this->name_table.create(INITIAL_CATALOG_SIZE, string_hash, strings_equal);
+    this->name_table.create(INITIAL_CATALOG_SIZE, interned_string_hash, interned_strings_equal);
     this->pointer_table.create(INITIAL_CATALOG_SIZE, [](Asset * const &key) -> u64 { return murmur_64a((u64) key); }, [](Asset * const &lhs, Asset * const &rhs) -> b8 { return lhs == rhs; });
     this->file_watcher.create();
 }
@@ -41,8 +41,6 @@ void Catalog<Asset, Asset_Parameters>::destroy() {
         
         Hardware_Time end_time = os_get_hardware_time();
         CATALOG_LOG_INFO("Unloaded asset '%.*s' (%.1fms).", (u32) all.name.count, all.name.data, os_convert_hardware_time(end_time - start_time, Milliseconds));
-
-        deallocate_string(this->allocator, &all.name);
     }
 
     this->name_table.destroy();
@@ -101,8 +99,9 @@ void Catalog<Asset, Asset_Parameters>::check_for_reloads() {
 template<typename Asset, typename Asset_Parameters>
 Asset *Catalog<Asset, Asset_Parameters>::internal_query(string name, Asset_Parameters parameters) {
     string complete_name = this->make_complete_name(name, parameters);
+    Interned_String interned_name = intern_string(complete_name);
 
-    Handle **handle_ptr = this->name_table.query(complete_name);
+    Handle **handle_ptr = this->name_table.query(interned_name);
     if(handle_ptr != null) return &(*handle_ptr)->asset;
 
     Hardware_Time start_time = os_get_hardware_time();
@@ -116,14 +115,15 @@ Asset *Catalog<Asset, Asset_Parameters>::internal_query(string name, Asset_Param
         error = ERROR_File_Not_Found;
     }
 
-    handle->name       = copy_string(this->allocator, complete_name);
-    handle->references = 1;
-    handle->valid      = error == Success;
-    handle->parameters = parameters;
+    handle->interned_name = interned_name;
+    handle->name          = interned_string_view(interned_name);
+    handle->references    = 1;
+    handle->valid         = error == Success;
+    handle->parameters    = parameters;
 
     this->release_file_content(&file_content);
     
-    this->name_table.add(handle->name, handle);
+    this->name_table.add(handle->interned_name, handle);
     this->pointer_table.add(&handle->asset, handle);
 
 #if FOUNDATION_DEVELOPER
@@ -166,14 +166,13 @@ void Catalog<Asset, Asset_Parameters>::release(Asset *asset) {
         
         string name = handle->name;
         this->destroy_proc(&handle->asset);
-        this->name_table.remove(handle->name);
+        this->name_table.remove(handle->interned_name);
         this->pointer_table.remove(&handle->asset);
         this->handles.remove_value_pointer(handle);
 
         Hardware_Time end_time = os_get_hardware_time();
         
         CATALOG_LOG_INFO("Unloaded asset '%.*s' (%.1fms).", (u32) name.count, name.data, os_convert_hardware_time(end_time - start_time, Milliseconds));
-        deallocate_string(this->allocator, &name);
     }
 }
 
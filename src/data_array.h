@@ -2,6 +2,9 @@
 
 #include "foundation.h"
 #include "memutils.h" // For Default_Allocator
+#include "os_specific.h" // For os_map_file
+#include "bit_array.h"
+#include "jobs.h"
 
 //
 // The so called Data Array is the data structure used in this engine to store entities of levels.
@@ -27,8 +30,10 @@
 // of mapping an ID (which is an index into the indirection array) to a data index (which is, well, an index
 // into the data blob). This mapping will be adapted if the underlying entity moves around in the data array.
 //     When an entity gets removed, we remember the now-free id (index into the indirection table) in a free-list,
-// so that we can re-use that ID for the next created entity. This keeps the indirection table as tight as
-// possible, but we cannot (and really need not) guarantee that it is gap-less.
+// so that we can re-use that ID for the next created entity. The free-list is a bitset with one bit per id, so
+// that finding the lowest free id is a scan for the first non-zero word, and claiming a specific id (e.g. when
+// loading a level) is a single bit operation. Always re-using the lowest free id keeps the indirection table as
+// tight as possible, but we cannot (and really need not) guarantee that it is gap-less.
 //     To support different users, each user gets its own indirection array (to keep it as simple as possible).
 // This means that we first extract the user out of a passed ID, then look at the index stored in the indirection
 // table for that user, and then we find our raw data in the blob. The free-list also needs to be stored per-user,
@@ -40,6 +45,50 @@ typedef u32 Data_Array_Id;
 #define INVALID_DATA_ARRAY_ID ((u32) -1)
 #define INVALID_DATA_ARRAY_INDEX ((s64) -1)
 
+struct Data_Array_Free_List {
+    Bit_Array bits; // One bit per id, set if that id is currently not in use.
+    s64 first_candidate; // All bits before this one are known to be zero, so the search can start here.
+
+    void create(Allocator *allocator, s64 capacity); // Initially, all ids are free.
+    void destroy();
+
+    void mark_free(Data_Array_Id id);
+    void mark_used(Data_Array_Id id);
+    b8 is_free(Data_Array_Id id);
+    Data_Array_Id find_first_free(); // Returns INVALID_DATA_ARRAY_ID if no id is free.
+    void rebuild(s64 *indirection, s64 capacity); // Marks every id without an index as free.
+};
+
+//
+// A snapshot stores all arrays of a Data_Array in a single binary blob, so that loading a level does not need
+// to parse and push every entity. Restoring a snapshot maps the file copy-on-write and points the arrays into
+// that mapping, which makes it independent of the entity count, since the OS only pages in what is actually
+// touched. The restored array can be modified as usual, but it can never grow past the capacity it had when
+// the snapshot was written.
+// This only works for trivially copyable entities (they are restored without running any constructors), and
+// a snapshot is only valid for the same struct layout and endianness it was written with.
+//
+
+#define DATA_ARRAY_SNAPSHOT_MAGIC     0x50414e53 // 'SNAP'
+#define DATA_ARRAY_SNAPSHOT_VERSION   2
+#define DATA_ARRAY_SNAPSHOT_ALIGNMENT 64
+
+struct Data_Array_Snapshot_Header {
+    u32 magic;
+    u32 version;
+    s64 entry_size; // sizeof(T) of the array which wrote this snapshot, to catch obvious mismatches.
+    s64 capacity;
+    s64 count;
+    s64 free_list_word_count;
+    
+    // All offsets are relative to the start of the snapshot, and aligned to DATA_ARRAY_SNAPSHOT_ALIGNMENT.
+    s64 indirection_offset;
+    s64 id_offset;
+    s64 data_offset;
+    s64 free_list_offset;
+    s64 total_size;
+};
+
 template<typename T>
 struct Data_Array {
     Allocator *allocator = Default_Allocator;
@@ -51,29 +100,137 @@ struct Data_Array {
     Data_Array_Id *id; // Stores the id of the data element at this index.
     T *data; // The actual continuous storage.
 
-    Data_Array_Id *free_list; // A dynamic array of ids that are currently not used (and smaller than the highest id in use).
-    s64 free_list_count;
-    s64 free_list_capacity;
+    Data_Array_Free_List free_list; // The ids that are currently not in use.
+
+    string snapshot = { 0 }; // If this array was restored from a snapshot, the file mapping which holds all of the above arrays.
     
     void create(Allocator *allocator, s64 capacity);
     void destroy();
 
+    b8 write_snapshot(string file_path);
+    b8 restore_snapshot(string file_path); // Use this instead of create(). Returns false if the file does not hold a snapshot of this type.
+
     Data_Array_Id push();
     T *push_with_id(Data_Array_Id id);
+    T *push_many(s64 count, Data_Array_Id *ids); // Pushes count entries and writes their ids. Returns the first of the (contiguous) new entries.
+    T *push_many_with_ids(Data_Array_Id *ids, s64 count); // Returns the first of the (contiguous) new entries.
 
     void remove_by_id(Data_Array_Id id);
     void remove_by_index(s64 index);
+    void remove_many(Data_Array_Id *ids, s64 count);
 
     T *index(s64 index);
     T *query(Data_Array_Id id);
 
     b8 id_is_valid(Data_Array_Id id);
 
-    void clear_free_list();
-    void push_free_list(Data_Array_Id id);
-    Data_Array_Id pop_free_list(s64 index = 0);
     void rebuild_free_list();
-    void remove_from_free_list_if_exists(Data_Array_Id id);
+};
+
+//
+// Structural changes to a Data_Array (adding or removing entities) move other entities around in the data
+// blob, so they cannot be made while the array is iterated in parallel. Instead, the iteration hands a command
+// buffer to the procedure, which records these changes, and all command buffers are applied once every worker
+// is done. Every chunk of the iteration has its own command buffer (so no synchronization is required), and
+// the buffers are applied in chunk order, so that the result does not depend on the scheduling of the jobs.
+// All removals are applied before all additions. Removing the same id more than once is fine.
+//
+// Usage:
+//     for_each_parallel(&jobs, &entities, [](Entity *entity, Data_Array_Id id, Data_Array_Command_Buffer<Entity> *commands) {
+//         entity->health -= 1;
+//         if(entity->health <= 0) commands->remove(id);
+//     });
+//
+
+#define DATA_ARRAY_DEFAULT_GRAIN 4096 // The number of entries a worker processes at once.
+
+template<typename T>
+struct Data_Array_Command_Buffer {
+    Resizable_Array<Data_Array_Id> removals;
+    Resizable_Array<T> additions;
+
+    void remove(Data_Array_Id id);
+    void add(T const &entry);
+};
+
+template<typename T, typename Procedure>
+void for_each_parallel(Job_System *system, Data_Array<T> *array, Procedure procedure, s64 grain = DATA_ARRAY_DEFAULT_GRAIN);
+
+//
+// The struct-of-arrays variant of the Data_Array. It uses the same stable id indirection, swap-on-remove
+// compaction and free-list as the Data_Array, but instead of storing whole entities contiguously, every field
+// lives in its own column. Update loops which only touch a few fields then only pull those columns through
+// the cache, instead of every entity's full struct.
+// The fields are addressed by their index in the template parameter list, e.g.:
+//     Data_Array_SoA<v3f, v3f, Entity_Flags> entities; // Position, velocity, flags
+//     v3f *positions = entities.column<0>();
+// Every column starts at a DATA_ARRAY_COLUMN_ALIGNMENT boundary, so that loops over the first 'count' entries
+// of a column can use aligned SIMD loads and stores.
+//
+
+#define DATA_ARRAY_COLUMN_ALIGNMENT 64
+
+template<s64 Index, typename... Fields>
+struct Data_Array_Field;
+
+template<typename Head, typename... Tail>
+struct Data_Array_Field<0, Head, Tail...> {
+    typedef Head Type;
+};
+
+template<s64 Index, typename Head, typename... Tail>
+struct Data_Array_Field<Index, Head, Tail...> {
+    typedef typename Data_Array_Field<Index - 1, Tail...>::Type Type;
+};
+
+template<typename... Fields>
+struct Data_Array_SoA {
+    static const s64 COLUMN_COUNT = sizeof...(Fields);
+
+    template<s64 Column>
+    using Field = typename Data_Array_Field<Column, Fields...>::Type;
+
+    template<s64 Column>
+    struct Column_Tag {};
+
+    Allocator *allocator = Default_Allocator;
+
+    s64 capacity; // Max capacity of items in this data array.
+    s64 count; // Current number of valid items in this data array. They are stored at column[0] - column[count - 1]
+
+    s64 *indirection; // Maps an id into the columns.
+    Data_Array_Id *id; // Stores the id of the data element at this index.
+    void *column_memory; // The single allocation holding all columns.
+    void *columns[COLUMN_COUNT]; // Pointers to the (aligned) start of each column.
+
+    Data_Array_Free_List free_list; // The ids that are currently not in use.
+    
+    void create(Allocator *allocator, s64 capacity);
+    void destroy();
+
+    Data_Array_Id push();
+    s64 push_with_id(Data_Array_Id id); // Returns the index of the new entry.
+    s64 push_many(s64 count, Data_Array_Id *ids); // Pushes count entries and writes their ids. Returns the index of the first new entry.
+    s64 push_many_with_ids(Data_Array_Id *ids, s64 count); // Returns the index of the first new entry.
+
+    void remove_by_id(Data_Array_Id id);
+    void remove_by_index(s64 index);
+    void remove_many(Data_Array_Id *ids, s64 count);
+
+    s64 index_of(Data_Array_Id id);
+    b8 id_is_valid(Data_Array_Id id);
+
+    template<s64 Column> Field<Column> *column();
+    template<s64 Column> Field<Column> *index(s64 index);
+    template<s64 Column> Field<Column> *query(Data_Array_Id id);
+
+    void rebuild_free_list();
+
+    // Recursively handles every column, since C++14 cannot expand the field pack into statements.
+    void construct_entry(s64 index, Column_Tag<COLUMN_COUNT>) {}
+    template<s64 Column> void construct_entry(s64 index, Column_Tag<Column>);
+    void move_entry(s64 dst, s64 src, Column_Tag<COLUMN_COUNT>) {}
+    template<s64 Column> void move_entry(s64 dst, s64 src, Column_Tag<Column>);
 };
 
 // Because C++ is a terrible language, we need to supply the template definitions in the header file for
@@ -1,3 +1,62 @@
+/* ---------------------------------------------- Free List ---------------------------------------------- */
+
+inline
+void Data_Array_Free_List::create(Allocator *allocator, s64 capacity) {
+    this->bits.create(allocator, capacity);
+    this->bits.set_all();
+    this->first_candidate = 0;
+}
+
+inline
+void Data_Array_Free_List::destroy() {
+    this->bits.destroy();
+    this->first_candidate = 0;
+}
+
+inline
+void Data_Array_Free_List::mark_free(Data_Array_Id id) {
+    this->bits.set(id);
+    if(id < this->first_candidate) this->first_candidate = id;
+}
+
+inline
+void Data_Array_Free_List::mark_used(Data_Array_Id id) {
+    this->bits.clear(id);
+}
+
+inline
+b8 Data_Array_Free_List::is_free(Data_Array_Id id) {
+    return this->bits.test(id);
+}
+
+inline
+Data_Array_Id Data_Array_Free_List::find_first_free() {
+    s64 index = this->bits.find_next_set(this->first_candidate);
+
+    if(index == BIT_ARRAY_INVALID_INDEX) {
+        this->first_candidate = this->bits.count;
+        return INVALID_DATA_ARRAY_ID;
+    }
+
+    this->first_candidate = index;
+    return (Data_Array_Id) index;
+}
+
+inline
+void Data_Array_Free_List::rebuild(s64 *indirection, s64 capacity) {
+    this->bits.clear_all();
+
+    for(s64 i = 0; i < capacity; ++i) {
+        if(indirection[i] == INVALID_DATA_ARRAY_INDEX) this->bits.set(i);
+    }
+
+    this->first_candidate = 0;
+}
+
+
+
+/* ---------------------------------------------- Data Array ---------------------------------------------- */
+
 template<typename T>
 void Data_Array<T>::create(Allocator *allocator, s64 capacity) {
     this->allocator = allocator;
@@ -8,8 +67,8 @@ void Data_Array<T>::create(Allocator *allocator, s64 capacity) {
     this->id          = (Data_Array_Id *) this->allocator->allocate(this->capacity * sizeof(Data_Array_Id));
     this->data        = (T *) this->allocator->allocate(this->capacity * sizeof(T));
 
-    this->free_list_count = 0;
-    this->free_list = null;
+    this->free_list.create(this->allocator, this->capacity);
+    this->snapshot = { 0 };
 
     for(s64 i = 0; i < this->capacity; ++i) this->indirection[i] = INVALID_DATA_ARRAY_INDEX;
 }
@@ -18,33 +77,95 @@ template<typename T>
 void Data_Array<T>::destroy() {
     this->count              = 0;
     this->capacity           = 0;
-    this->free_list_count    = 0;
-    this->free_list_capacity = 0;
-    this->allocator->deallocate(this->id);
-    this->allocator->deallocate(this->data);
-    this->allocator->deallocate(this->indirection);
-    this->allocator->deallocate(this->free_list);
+
+    if(this->snapshot.data) {
+        // All arrays live inside the mapped snapshot.
+        os_unmap_file(&this->snapshot);
+        this->free_list = Data_Array_Free_List();
+    } else {
+        this->allocator->deallocate(this->id);
+        this->allocator->deallocate(this->data);
+        this->allocator->deallocate(this->indirection);
+        this->free_list.destroy();
+    }
 
     this->id          = null;
     this->data        = null;
     this->indirection = null;
-    this->free_list   = null;
+}
+
+template<typename T>
+b8 Data_Array<T>::write_snapshot(string file_path) {
+    static_assert(Is_Trivially_Relocatable<T>::value, "Data Array snapshots require a trivially copyable type.");
+
+    Data_Array_Snapshot_Header header;
+    header.magic                = DATA_ARRAY_SNAPSHOT_MAGIC;
+    header.version              = DATA_ARRAY_SNAPSHOT_VERSION;
+    header.entry_size           = sizeof(T);
+    header.capacity             = this->capacity;
+    header.count                = this->count;
+    header.free_list_word_count = this->free_list.bits.word_count;
+    header.indirection_offset   = ALIGN_TO(sizeof(Data_Array_Snapshot_Header), DATA_ARRAY_SNAPSHOT_ALIGNMENT, s64);
+    header.id_offset            = ALIGN_TO(header.indirection_offset + this->capacity * sizeof(s64), DATA_ARRAY_SNAPSHOT_ALIGNMENT, s64);
+    header.data_offset          = ALIGN_TO(header.id_offset + this->capacity * sizeof(Data_Array_Id), DATA_ARRAY_SNAPSHOT_ALIGNMENT, s64);
+    header.free_list_offset     = ALIGN_TO(header.data_offset + this->capacity * sizeof(T), DATA_ARRAY_SNAPSHOT_ALIGNMENT, s64);
+    header.total_size           = header.free_list_offset + this->free_list.bits.word_count * sizeof(u64);
+
+    //
+    // The full capacity is stored so that the restored array can be used just like this one. Only the first
+    // 'count' entries of the id and data arrays are valid, the rest is zeroed out to keep the file deterministic.
+    //
+    u8 *blob = (u8 *) Default_Allocator->allocate(header.total_size);
+    memset(blob, 0, header.total_size);
+    memcpy(blob, &header, sizeof(Data_Array_Snapshot_Header));
+    memcpy(blob + header.indirection_offset, this->indirection, this->capacity * sizeof(s64));
+    memcpy(blob + header.id_offset, this->id, this->count * sizeof(Data_Array_Id));
+    memcpy(blob + header.data_offset, this->data, this->count * sizeof(T));
+    memcpy(blob + header.free_list_offset, this->free_list.bits.bits, this->free_list.bits.word_count * sizeof(u64));
+
+    b8 success = os_write_file(file_path, string { header.total_size, blob }, false);
+
+    Default_Allocator->deallocate(blob);
+    return success;
+}
+
+template<typename T>
+b8 Data_Array<T>::restore_snapshot(string file_path) {
+    static_assert(Is_Trivially_Relocatable<T>::value, "Data Array snapshots require a trivially copyable type.");
+
+    string file = os_map_file(file_path);
+    Data_Array_Snapshot_Header *header = (Data_Array_Snapshot_Header *) file.data;
+
+    if(file.count < (s64) sizeof(Data_Array_Snapshot_Header) || header->magic != DATA_ARRAY_SNAPSHOT_MAGIC || header->version != DATA_ARRAY_SNAPSHOT_VERSION || header->entry_size != sizeof(T) || header->total_size != file.count) {
+        os_unmap_file(&file);
+        return false;
+    }
+
+    // The arrays live inside the mapping, so only the pointers need to be patched up.
+    this->allocator   = Default_Allocator;
+    this->capacity    = header->capacity;
+    this->count       = header->count;
+    this->indirection = (s64 *) (file.data + header->indirection_offset);
+    this->id          = (Data_Array_Id *) (file.data + header->id_offset);
+    this->data        = (T *) (file.data + header->data_offset);
+    this->snapshot    = file;
+
+    this->free_list.bits            = Bit_Array();
+    this->free_list.bits.bits       = (u64 *) (file.data + header->free_list_offset);
+    this->free_list.bits.count      = header->capacity;
+    this->free_list.bits.word_count = header->free_list_word_count;
+    this->free_list.first_candidate = 0;
+
+    return true;
 }
 
 template<typename T>
 Data_Array_Id Data_Array<T>::push() {
     assert(this->count < this->capacity, "Data Array reached its capacity.");
 
-    Data_Array_Id id;
-    
-    if(this->free_list_count) {
-        id = this->pop_free_list();
-    } else {
-        // This means that all ids between 0 and the highest id are used. Since we only have 'count' active
-        // ids, it means that all active ids are 0 to count.
-        id = (Data_Array_Id) this->count;
-        assert(!this->id_is_valid(id), "This id was expected to be unused.");
-    }
+    Data_Array_Id id = this->free_list.find_first_free();
+    assert(!this->id_is_valid(id), "This id was expected to be unused.");
+    this->free_list.mark_used(id);
 
     this->indirection[id]   = this->count;
     this->id[this->count]   = id;
@@ -67,11 +188,55 @@ T *Data_Array<T>::push_with_id(Data_Array_Id id) {
     
     ++this->count;
 
-    this->remove_from_free_list_if_exists(id);
+    this->free_list.mark_used(id);
     
     return ptr;
 }
 
+template<typename T>
+T *Data_Array<T>::push_many(s64 count, Data_Array_Id *ids) {
+    assert(this->count + count <= this->capacity, "Data Array reached its capacity.");
+
+    s64 first_index = this->count;
+
+    for(s64 i = 0; i < count; ++i) {
+        Data_Array_Id id = this->free_list.find_first_free();
+        this->free_list.mark_used(id);
+
+        s64 index = first_index + i;
+        this->indirection[id] = index;
+        this->id[index]       = id;
+        this->data[index]     = T();
+        ids[i] = id;
+    }
+
+    this->count += count;
+
+    return &this->data[first_index];
+}
+
+template<typename T>
+T *Data_Array<T>::push_many_with_ids(Data_Array_Id *ids, s64 count) {
+    assert(this->count + count <= this->capacity, "Data Array reached its capacity.");
+
+    s64 first_index = this->count;
+
+    for(s64 i = 0; i < count; ++i) {
+        Data_Array_Id id = ids[i];
+        assert(!this->id_is_valid(id), "The supplied Data Array Id is already in use.");
+        this->free_list.mark_used(id);
+
+        s64 index = first_index + i;
+        this->indirection[id] = index;
+        this->id[index]       = id;
+        this->data[index]     = T();
+    }
+
+    this->count += count;
+
+    return &this->data[first_index];
+}
+
 template<typename T>
 void Data_Array<T>::remove_by_id(Data_Array_Id id) {
     assert(this->id_is_valid(id), "Tried to remove an invalid Data Array Id.");
@@ -96,11 +261,48 @@ void Data_Array<T>::remove_by_index(s64 removed_index) {
     this->indirection[last_id]    = removed_index;
     this->indirection[removed_id] = INVALID_DATA_ARRAY_INDEX;
     
-    this->push_free_list(removed_id);
+    this->free_list.mark_free(removed_id);
     
     --this->count;
 }
 
+template<typename T>
+void Data_Array<T>::remove_many(Data_Array_Id *ids, s64 count) {
+    //
+    // Instead of swapping every removed entry with the current last one (which may itself be removed later on),
+    // first mark all removed entries, and then fill the holes below the new count with surviving entries from
+    // the end of the array. This moves every surviving entry at most once. The ids must be unique.
+    //
+    for(s64 i = 0; i < count; ++i) {
+        assert(this->id_is_valid(ids[i]), "Tried to remove an invalid Data Array Id.");
+        this->id[this->indirection[ids[i]]] = INVALID_DATA_ARRAY_ID;
+    }
+
+    s64 new_count = this->count - count;
+    s64 tail      = this->count - 1;
+
+    for(s64 i = 0; i < count; ++i) {
+        Data_Array_Id removed_id = ids[i];
+        s64 removed_index = this->indirection[removed_id];
+
+        if(removed_index < new_count) {
+            while(this->id[tail] == INVALID_DATA_ARRAY_ID) --tail;
+
+            Data_Array_Id moved_id = this->id[tail];
+            this->data[removed_index] = this->data[tail];
+            this->id[removed_index]   = moved_id;
+            this->id[tail]            = INVALID_DATA_ARRAY_ID;
+            this->indirection[moved_id] = removed_index;
+            --tail;
+        }
+
+        this->indirection[removed_id] = INVALID_DATA_ARRAY_INDEX;
+        this->free_list.mark_free(removed_id);
+    }
+
+    this->count = new_count;
+}
+
 template<typename T>
 T *Data_Array<T>::index(s64 index) {
     assert(index >= 0 && index < this->count, "Data Array Index is out of bounds.");
@@ -121,78 +323,366 @@ b8 Data_Array<T>::id_is_valid(Data_Array_Id id) {
 }
 
 template<typename T>
-void Data_Array<T>::clear_free_list() {
-    this->allocator->deallocate(this->free_list);
-    this->free_list          = null;
-    this->free_list_count    = 0;
-    this->free_list_capacity = 0;
+void Data_Array<T>::rebuild_free_list() {
+    //
+    // When deserializing a data array from disk the IDs are often restored (to guarantee ID consistency betweeen
+    // saves / loads). When doing this, potential gaps in the used ID's may be opened (e.g. if an entity was
+    // deleted), and these gaps must be represented in the free-list, or we would generate duplicate IDs when
+    // pushing the data array.
+    // push_with_id already keeps the free-list up to date, so this is only required if the indirection table
+    // was restored manually.
+    //
+    this->free_list.rebuild(this->indirection, this->capacity);
 }
 
-template<typename T>
-void Data_Array<T>::push_free_list(Data_Array_Id id) {
-    if(this->free_list_capacity == 0) {
-        this->free_list_capacity = 8;
-        this->free_list = (Data_Array_Id *) this->allocator->allocate(this->free_list_capacity * sizeof(Data_Array_Id));
-    }
 
-    if(this->free_list_count == this->free_list_capacity) {
-        this->free_list_capacity *= 2;
-        this->free_list = (Data_Array_Id *) this->allocator->reallocate(this->free_list, this->free_list_capacity * sizeof(Data_Array_Id));
+/* ---------------------------------------------- Data Array SoA ---------------------------------------------- */
+
+template<typename... Fields>
+void Data_Array_SoA<Fields...>::create(Allocator *allocator, s64 capacity) {
+    this->allocator = allocator;
+    this->capacity  = capacity;
+    this->count     = 0;
+
+    this->indirection = (s64 *) this->allocator->allocate(this->capacity * sizeof(s64));
+    this->id          = (Data_Array_Id *) this->allocator->allocate(this->capacity * sizeof(Data_Array_Id));
+
+    //
+    // Allocate all columns in one block, each one starting at an aligned offset. The allocators don't
+    // guarantee that alignment, so over-allocate and align the base manually.
+    //
+    const s64 field_sizes[] = { (s64) sizeof(Fields)... };
+
+    s64 total_size = DATA_ARRAY_COLUMN_ALIGNMENT;
+    for(s64 i = 0; i < COLUMN_COUNT; ++i) total_size += ALIGN_TO(field_sizes[i] * this->capacity, DATA_ARRAY_COLUMN_ALIGNMENT, s64);
+
+    this->column_memory = this->allocator->allocate(total_size);
+
+    u64 column_base = ALIGN_TO((u64) this->column_memory, DATA_ARRAY_COLUMN_ALIGNMENT, u64);
+    for(s64 i = 0; i < COLUMN_COUNT; ++i) {
+        this->columns[i] = (void *) column_base;
+        column_base += ALIGN_TO(field_sizes[i] * this->capacity, DATA_ARRAY_COLUMN_ALIGNMENT, u64);
     }
+
+    this->free_list.create(this->allocator, this->capacity);
+
+    for(s64 i = 0; i < this->capacity; ++i) this->indirection[i] = INVALID_DATA_ARRAY_INDEX;
+}
+
+template<typename... Fields>
+void Data_Array_SoA<Fields...>::destroy() {
+    this->count              = 0;
+    this->capacity           = 0;
+    this->allocator->deallocate(this->id);
+    this->allocator->deallocate(this->column_memory);
+    this->allocator->deallocate(this->indirection);
+    this->free_list.destroy();
+
+    this->id            = null;
+    this->column_memory = null;
+    this->indirection   = null;
+
+    for(s64 i = 0; i < COLUMN_COUNT; ++i) this->columns[i] = null;
+}
+
+template<typename... Fields>
+Data_Array_Id Data_Array_SoA<Fields...>::push() {
+    assert(this->count < this->capacity, "Data Array reached its capacity.");
+
+    Data_Array_Id id = this->free_list.find_first_free();
+    assert(!this->id_is_valid(id), "This id was expected to be unused.");
+    this->free_list.mark_used(id);
+
+    this->indirection[id] = this->count;
+    this->id[this->count] = id;
+    this->construct_entry(this->count, Column_Tag<0>());
+
+    ++this->count;
+
+    return id;
+}
+
+template<typename... Fields>
+s64 Data_Array_SoA<Fields...>::push_with_id(Data_Array_Id id) {
+    assert(this->count < this->capacity, "Data Array reached its capacity.");
+    assert(!this->id_is_valid(id), "The supplied Data Array Id is already in use.");
+
+    s64 index = this->count;
+
+    this->indirection[id] = index;
+    this->id[index]       = id;
+    this->construct_entry(index, Column_Tag<0>());
     
-    this->free_list[this->free_list_count] = id;
-    ++this->free_list_count;
+    ++this->count;
+
+    this->free_list.mark_used(id);
+    
+    return index;
 }
 
-template<typename T>
-Data_Array_Id Data_Array<T>::pop_free_list(s64 index) {
-    assert(this->free_list_count > index);
-    Data_Array_Id id = this->free_list[index];
+template<typename... Fields>
+s64 Data_Array_SoA<Fields...>::push_many(s64 count, Data_Array_Id *ids) {
+    assert(this->count + count <= this->capacity, "Data Array reached its capacity.");
+
+    s64 first_index = this->count;
 
-    memmove(&this->free_list[index], &this->free_list[index + 1], (this->free_list_count - index - 1) * sizeof(Data_Array_Id));
-    --this->free_list_count;
+    for(s64 i = 0; i < count; ++i) {
+        Data_Array_Id id = this->free_list.find_first_free();
+        this->free_list.mark_used(id);
 
-    if(this->free_list_count == 0) {
-        this->clear_free_list();
-    } else if(this->free_list_count < this->free_list_capacity / 3 && this->free_list_capacity >= 8) {
-        this->free_list_capacity /= 2;
-        assert(this->free_list_count <= this->free_list_capacity);
-        this->free_list = (Data_Array_Id *) this->allocator->reallocate(this->free_list, this->free_list_capacity * sizeof(Data_Array_Id));
+        s64 index = first_index + i;
+        this->indirection[id] = index;
+        this->id[index]       = id;
+        this->construct_entry(index, Column_Tag<0>());
+        ids[i] = id;
     }
+
+    this->count += count;
+
+    return first_index;
+}
+
+template<typename... Fields>
+s64 Data_Array_SoA<Fields...>::push_many_with_ids(Data_Array_Id *ids, s64 count) {
+    assert(this->count + count <= this->capacity, "Data Array reached its capacity.");
+
+    s64 first_index = this->count;
+
+    for(s64 i = 0; i < count; ++i) {
+        Data_Array_Id id = ids[i];
+        assert(!this->id_is_valid(id), "The supplied Data Array Id is already in use.");
+        this->free_list.mark_used(id);
+
+        s64 index = first_index + i;
+        this->indirection[id] = index;
+        this->id[index]       = id;
+        this->construct_entry(index, Column_Tag<0>());
+    }
+
+    this->count += count;
+
+    return first_index;
+}
+
+template<typename... Fields>
+void Data_Array_SoA<Fields...>::remove_by_id(Data_Array_Id id) {
+    assert(this->id_is_valid(id), "Tried to remove an invalid Data Array Id.");
+    s64 index = this->indirection[id];
+    if(index != INVALID_DATA_ARRAY_INDEX) this->remove_by_index(index);
+}
+
+template<typename... Fields>
+void Data_Array_SoA<Fields...>::remove_by_index(s64 removed_index) {
+    assert(removed_index >= 0 && removed_index < this->count, "Tried to remove an invalid Data Array Index.");
+
+    s64 last_index = this->count - 1;
     
-    return id;
+    Data_Array_Id last_id    = this->id[last_index];
+    Data_Array_Id removed_id = this->id[removed_index];
+
+    if(removed_index != last_index) this->move_entry(removed_index, last_index, Column_Tag<0>());
+
+    this->id[removed_index] = last_id;
+    this->id[last_index]    = INVALID_DATA_ARRAY_ID;
+
+    this->indirection[last_id]    = removed_index;
+    this->indirection[removed_id] = INVALID_DATA_ARRAY_INDEX;
+    
+    this->free_list.mark_free(removed_id);
+    
+    --this->count;
 }
 
+template<typename... Fields>
+void Data_Array_SoA<Fields...>::remove_many(Data_Array_Id *ids, s64 count) {
+    // See Data_Array::remove_many.
+    for(s64 i = 0; i < count; ++i) {
+        assert(this->id_is_valid(ids[i]), "Tried to remove an invalid Data Array Id.");
+        this->id[this->indirection[ids[i]]] = INVALID_DATA_ARRAY_ID;
+    }
+
+    s64 new_count = this->count - count;
+    s64 tail      = this->count - 1;
+
+    for(s64 i = 0; i < count; ++i) {
+        Data_Array_Id removed_id = ids[i];
+        s64 removed_index = this->indirection[removed_id];
+
+        if(removed_index < new_count) {
+            while(this->id[tail] == INVALID_DATA_ARRAY_ID) --tail;
+
+            Data_Array_Id moved_id = this->id[tail];
+            this->move_entry(removed_index, tail, Column_Tag<0>());
+            this->id[removed_index] = moved_id;
+            this->id[tail]          = INVALID_DATA_ARRAY_ID;
+            this->indirection[moved_id] = removed_index;
+            --tail;
+        }
+
+        this->indirection[removed_id] = INVALID_DATA_ARRAY_INDEX;
+        this->free_list.mark_free(removed_id);
+    }
+
+    this->count = new_count;
+}
+
+template<typename... Fields>
+s64 Data_Array_SoA<Fields...>::index_of(Data_Array_Id id) {
+    assert(this->id_is_valid(id), "Tried to query an invalid Data Array Id.");
+    return this->indirection[id];
+}
+
+template<typename... Fields>
+b8 Data_Array_SoA<Fields...>::id_is_valid(Data_Array_Id id) {
+    if(id >= this->capacity) return false;
+    return this->indirection[id] != INVALID_DATA_ARRAY_INDEX;
+}
+
+template<typename... Fields>
+template<s64 Column>
+typename Data_Array_SoA<Fields...>::template Field<Column> *Data_Array_SoA<Fields...>::column() {
+    static_assert(Column >= 0 && Column < COLUMN_COUNT, "Data Array Column is out of bounds.");
+    return (Field<Column> *) this->columns[Column];
+}
+
+template<typename... Fields>
+template<s64 Column>
+typename Data_Array_SoA<Fields...>::template Field<Column> *Data_Array_SoA<Fields...>::index(s64 index) {
+    assert(index >= 0 && index < this->count, "Data Array Index is out of bounds.");
+    return &this->column<Column>()[index];
+}
+
+template<typename... Fields>
+template<s64 Column>
+typename Data_Array_SoA<Fields...>::template Field<Column> *Data_Array_SoA<Fields...>::query(Data_Array_Id id) {
+    assert(this->id_is_valid(id), "Tried to query an invalid Data Array Id.");
+    return &this->column<Column>()[this->indirection[id]];
+}
+
+template<typename... Fields>
+void Data_Array_SoA<Fields...>::rebuild_free_list() {
+    // See Data_Array::rebuild_free_list.
+    this->free_list.rebuild(this->indirection, this->capacity);
+}
+
+template<typename... Fields>
+template<s64 Column>
+void Data_Array_SoA<Fields...>::construct_entry(s64 index, Column_Tag<Column>) {
+    this->column<Column>()[index] = Field<Column>();
+    this->construct_entry(index, Column_Tag<Column + 1>());
+}
+
+template<typename... Fields>
+template<s64 Column>
+void Data_Array_SoA<Fields...>::move_entry(s64 dst, s64 src, Column_Tag<Column>) {
+    Field<Column> *column = this->column<Column>();
+    column[dst] = column[src];
+    this->move_entry(dst, src, Column_Tag<Column + 1>());
+}
+
+
+
+/* ------------------------------------------- Parallel Iteration ------------------------------------------- */
+
 template<typename T>
-void Data_Array<T>::rebuild_free_list() {
-    //
-    // When deserializing a data array from disk the IDs are often restored (to guarantee ID consistency betweeen
-    // saves / loads). When doing this, potential gaps in the used ID's may be opened (e.g. if an entity was
-    // deleted), and this gap must be represented in the free-list.
-    // If we don't do this, then array.count would be smaller than the highest used ID, which will lead to
-    // duplicate IDs when pushing the data array.
+void Data_Array_Command_Buffer<T>::remove(Data_Array_Id id) {
+    this->removals.add(id);
+}
+
+template<typename T>
+void Data_Array_Command_Buffer<T>::add(T const &entry) {
+    this->additions.add(entry);
+}
+
+template<typename T, typename Procedure>
+struct Data_Array_Parallel_Context {
+    Data_Array<T> *array;
+    Procedure *procedure;
+    s64 grain;
+    s64 chunk_count;
+    Data_Array_Command_Buffer<T> *command_buffers; // One per chunk.
+
+    Atomic<s64> next_chunk;
+    Atomic<s64> remaining_jobs;
+};
+
+template<typename T, typename Procedure>
+static
+void internal_for_each_parallel_worker(Data_Array_Parallel_Context<T, Procedure> *context) {
     //
-    // In short: The free list must contain all unused IDs between zero and the highest active ID.
+    // Workers keep claiming the next unprocessed chunk until there are none left, so that a worker which
+    // got stuck with expensive entities does not hold up the others.
     //
-    this->clear_free_list();
+    while(true) {
+        s64 chunk = context->next_chunk.load();
+        if(chunk >= context->chunk_count) break;
+        if(context->next_chunk.compare_exchange(chunk + 1, chunk) != chunk) continue;
 
-    Data_Array_Id highest_used_id = 0;
+        Data_Array_Command_Buffer<T> *commands = &context->command_buffers[chunk];
+        s64 begin = chunk * context->grain;
+        s64 end   = MIN(begin + context->grain, context->array->count);
 
-    for(s64 i = 0; i < this->allocated; ++i) {
-        if(this->indirection[i] != INVALID_DATA_ARRAY_INDEX) highest_used_id = i;
-    }
-        
-    for(s64 i = 0; i < this->allocated; ++i) {
-        if(this->indirection[i] == INVALID_DATA_ARRAY_INDEX) this->add_to_free_list(i);
+        for(s64 i = begin; i < end; ++i) {
+            (*context->procedure)(&context->array->data[i], context->array->id[i], commands);
+        }
     }
 }
 
-template<typename T>
-void Data_Array<T>::remove_from_free_list_if_exists(Data_Array_Id id) {
-    for(s64 i = 0; i < this->free_list_count; ++i) {
-        if(this->free_list[i] == id) {
-            this->pop_free_list(i);
-            break;
+template<typename T, typename Procedure>
+static
+void internal_for_each_parallel_job(Data_Array_Parallel_Context<T, Procedure> *context) {
+    internal_for_each_parallel_worker(context);
+    context->remaining_jobs.add(-1);
+}
+
+template<typename T, typename Procedure>
+void for_each_parallel(Job_System *system, Data_Array<T> *array, Procedure procedure, s64 grain) {
+    assert(grain > 0, "The grain of a parallel iteration must be positive.");
+
+    Data_Array_Parallel_Context<T, Procedure> context;
+    context.array       = array;
+    context.procedure   = &procedure;
+    context.grain       = grain;
+    context.chunk_count = (array->count + grain - 1) / grain;
+    context.command_buffers = (Data_Array_Command_Buffer<T> *) Default_Allocator->allocate(context.chunk_count * sizeof(Data_Array_Command_Buffer<T>));
+    context.next_chunk.store(0);
+
+    for(s64 i = 0; i < context.chunk_count; ++i) context.command_buffers[i] = Data_Array_Command_Buffer<T>();
+
+    s64 job_count = MIN(system->worker_count, context.chunk_count - 1);
+    context.remaining_jobs.store(job_count);
+
+    for(s64 i = 0; i < job_count; ++i) {
+        spawn_job(system, { (Job_Procedure) internal_for_each_parallel_job<T, Procedure>, &context });
+    }
+
+    // The calling thread works on the chunks itself instead of just waiting around.
+    internal_for_each_parallel_worker(&context);
+
+    while(context.remaining_jobs.load() > 0) {}
+
+    //
+    // Apply the recorded changes now that nobody is looking at the data anymore.
+    //
+    for(s64 i = 0; i < context.chunk_count; ++i) {
+        Data_Array_Command_Buffer<T> *commands = &context.command_buffers[i];
+
+        for(Data_Array_Id id : commands->removals) {
+            if(array->id_is_valid(id)) array->remove_by_id(id);
         }
     }
+
+    for(s64 i = 0; i < context.chunk_count; ++i) {
+        Data_Array_Command_Buffer<T> *commands = &context.command_buffers[i];
+
+        for(T &entry : commands->additions) {
+            Data_Array_Id id = array->push();
+            *array->query(id) = entry;
+        }
+
+        commands->removals.clear();
+        commands->additions.clear();
+    }
+
+    Default_Allocator->deallocate(context.command_buffers);
 }
@@ -40,8 +40,8 @@ void File_Watcher::remove_file_to_watch(string file_path) {
     }
 }
 
-Resizable_Array<string> File_Watcher::update(Allocator *result_allocator) {
-    Resizable_Array<string> result{};
+Small_Array<string, 8> File_Watcher::update(Allocator *result_allocator) {
+    Small_Array<string, 8> result{};
     result.allocator = result_allocator;
     
     CPU_Time now = os_get_cpu_time();
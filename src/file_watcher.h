@@ -22,7 +22,7 @@ struct File_Watcher {
     
     void add_file_to_watch(string file_path);
     void remove_file_to_watch(string file_path);
-    Resizable_Array<string> update(Allocator *result_allocator);
+    Small_Array<string, 8> update(Allocator *result_allocator); // Returns the paths of all files that changed since the last check.
     
     // Sometimes user code knows about file changes and does not want notifications about these changes,
     // so this forces updates to the internal file times without notifications.
@@ -4,33 +4,67 @@
 
 
 
-/* -------------------------------------------- Helper Procedures -------------------------------------------- */
+/* ----------------------------------------------- Ascii_Parser ----------------------------------------------- */
 
 static
-b8 is_string_character(u8 c) {
-    return (c >= 'a' && c <= 'z') || 
-		(c >= 'A' && c <= 'Z') ||
-        (c >= '0' && c <= '9') ||
-		(c == '_' || c == '\\' || c == '/' || c == '.');
-}
-
-
+void initialize_ascii_parser(Ascii_Parser *parser, string data) {
+    parser->data                       = data;
+    parser->position                   = 0;
+    parser->block_start                = -1;
+    parser->whitespace_mask            = 0;
+    parser->error_position             = -1;
+    parser->line_block_start           = 0;
+    parser->line_newlines_before_block = 0;
+}
+
+// Remembers the position of the token if it could not be parsed. An empty token means that the parser ran out
+// of data. Only the first error is kept, since everything after it is usually just a consequence of it.
+static inline
+void check_parsed_token(Ascii_Parser *parser, string token, b8 success) {
+    if(success || parser->error_position != -1) return;
+    parser->error_position = token.count ? token.data - parser->data.data : parser->data.count;
+}
+
+// The token boundaries are found just like in read_string, but the tokens are parsed straight into the output
+// array without going through the single value read procedures.
+template<typename Type, typename Procedure>
+static
+s64 read_many_tokens(Ascii_Parser *parser, s64 count, Type *out, Procedure parse) {
+    s64 read = 0;
+
+    while(read < count) {
+        s64 token_start = parser->find_token_boundary(parser->position, false);
+        if(token_start == parser->data.count) {
+            parser->position = token_start;
+            check_parsed_token(parser, ""_s, false);
+            break;
+        }
+
+        parser->position = parser->find_token_boundary(token_start, true);
+
+        string token = string_view(&parser->data.data[token_start], parser->position - token_start);
+        b8 success;
+        Type value = parse(token, &success);
+        check_parsed_token(parser, token, success);
+        if(!success) break;
+
+        out[read] = value;
+        ++read;
+    }
 
-/* ----------------------------------------------- Ascii_Parser ----------------------------------------------- */
+    return read;
+}
 
 void Ascii_Parser::create_from_string(string data) {
-    this->data = data;
-    this->position = 0;
+    initialize_ascii_parser(this, data);
 }
 
 void Ascii_Parser::create_from_buffer(u8 *data, s64 size) {
-    this->data = string_view(data, size);
-    this->position = 0;
+    initialize_ascii_parser(this, string_view(data, size));
 }
 
 b8 Ascii_Parser::create_from_file(string file_path) {
-    this->data = os_read_file(Default_Allocator, file_path);
-    this->position = 0;
+    initialize_ascii_parser(this, os_read_file(Default_Allocator, file_path));
 	return this->data.count > 0;
 }
 
@@ -44,30 +78,27 @@ b8 Ascii_Parser::finished() {
 
 string Ascii_Parser::read_string() {
     //
-    // Skip empty characters.
+    // Skip empty characters, then read in the string until the next empty character.
     //
-    while(this->position < this->data.count && this->data[this->position] >= 0 && this->data[this->position] <= 32) {
-        ++this->position;
+    s64 string_start = this->find_token_boundary(this->position, false);
+    if(string_start == this->data.count) {
+        this->position = string_start;
+        return ""_s;
     }
 
-    //
-    // Read in the string.
-    //
-    if(this->position == this->data.count) return ""_s;
-
-    s64 string_start = this->position;
+    this->position = this->find_token_boundary(string_start, true);
 
-    while(this->position < this->data.count && is_string_character(this->data[this->position])) {
-        ++this->position;
-    }
-
-    return string_view(&this->data[string_start], this->position - string_start);
+    string result;
+    result.count = this->position - string_start;
+    result.data  = &this->data.data[string_start];
+    return result;
 }
 
 u8 Ascii_Parser::read_u8() {
     string _string = this->read_string();
     b8 success;
 	u8 value = (u8) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
 	return value;
 }
 
@@ -75,6 +106,7 @@ u16 Ascii_Parser::read_u16() {
     string _string = this->read_string();
     b8 success;
     u16 value = (u16) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -82,6 +114,7 @@ u32 Ascii_Parser::read_u32() {
     string _string = this->read_string();
     b8 success;
     u32 value = (u32) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -89,6 +122,7 @@ u64 Ascii_Parser::read_u64() {
     string _string = this->read_string();
     b8 success;
     u64 value = (u64) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -96,6 +130,7 @@ s8 Ascii_Parser::read_s8() {
     string _string = this->read_string();
     b8 success;
     s8 value = (s8) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -103,6 +138,7 @@ s16 Ascii_Parser::read_s16() {
     string _string = this->read_string();
     b8 success;
     s16 value = (s16) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -110,6 +146,7 @@ s32 Ascii_Parser::read_s32() {
     string _string = this->read_string();
     b8 success;
     s32 value = (s32) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -117,6 +154,7 @@ s64 Ascii_Parser::read_s64() {
     string _string = this->read_string();
     b8 success;
     s64 value = (s64) string_to_int(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -124,6 +162,7 @@ f32 Ascii_Parser::read_f32() {
     string _string = this->read_string();
     b8 success;
     f32 value = string_to_float(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
@@ -131,33 +170,97 @@ f64 Ascii_Parser::read_f64() {
     string _string = this->read_string();
     b8 success;
     f64 value = string_to_double(_string, &success);
+    check_parsed_token(this, _string, success);
     return value;
 }
 
+s64 Ascii_Parser::read_many_s32(s64 count, s32 *out) {
+    return read_many_tokens(this, count, out, [](string token, b8 *success) { return (s32) string_to_int(token, success); });
+}
+
+s64 Ascii_Parser::read_many_f32(s64 count, f32 *out) {
+    return read_many_tokens(this, count, out, string_to_float);
+}
+
+s64 Ascii_Parser::read_many_f64(s64 count, f64 *out) {
+    return read_many_tokens(this, count, out, string_to_double);
+}
+
+b8 Ascii_Parser::failed() {
+    return this->error_position != -1;
+}
+
+void Ascii_Parser::get_line_and_column(s64 position, s64 *line, s64 *column) {
+    assert(position >= 0 && position <= this->data.count);
+
+    s64 block = position & ~(s64) (CHARACTER_BLOCK_SIZE - 1);
+
+    if(block < this->line_block_start) {
+        // Looking backwards, start counting from the beginning again.
+        this->line_block_start = 0;
+        this->line_newlines_before_block = 0;
+    }
+
+    while(this->line_block_start < block) {
+        this->line_newlines_before_block += os_count_bits_set(classify_characters(this->data, this->line_block_start).newlines);
+        this->line_block_start += CHARACTER_BLOCK_SIZE;
+    }
+
+    u64 newlines_in_block = classify_characters(this->data, block).newlines & ((1ULL << (position - block)) - 1);
+    *line = this->line_newlines_before_block + os_count_bits_set(newlines_in_block) + 1;
+
+    s64 line_start = search_string_reverse(string_view(this->data.data, position), '\n') + 1;
+    *column = position - line_start + 1;
+}
+
+s64 Ascii_Parser::find_token_boundary(s64 from, b8 whitespace) {
+    while(from < this->data.count) {
+        s64 block = from & ~(s64) (CHARACTER_BLOCK_SIZE - 1);
+
+        if(block != this->block_start) {
+            this->block_start     = block;
+            this->whitespace_mask = classify_characters(this->data, block).whitespace;
+        }
+
+        // Only look at the bytes at or after 'from' in this block.
+        u64 mask = (whitespace ? this->whitespace_mask : ~this->whitespace_mask) & (MAX_U64 << (from - block));
+        if(mask) {
+            s64 boundary = block + os_lowest_bit_set(mask);
+            return MIN(boundary, this->data.count); // Bytes past the end count as whitespace.
+        }
+
+        from = block + CHARACTER_BLOCK_SIZE;
+    }
+
+    return this->data.count;
+}
+
 
 
 /* ----------------------------------------------- Ascii_Writer ----------------------------------------------- */
 
-void Ascii_Writer::create(string file_path, s64 /*buffer_size*/) {
-    this->file_path = copy_string(Default_Allocator, file_path);
-	this->builder.create(Default_Allocator);
+b8 Ascii_Writer::create(string file_path, s64 buffer_size) {
+    s64 directory_end = os_search_path_for_directory_slash_reverse(file_path);
+	if(directory_end != -1) os_create_directory(substring_view(file_path, 0, directory_end));
+
+    this->file = os_open_file_for_writing(file_path, false);
+    if(this->file == INVALID_FILE_HANDLE) return false;
+
+	this->builder.create(Default_Allocator, this->file);
+    this->builder.reserve(MIN(buffer_size, String_Builder::MAX_BLOCK_SIZE));
+    return true;
 }
 
-void Ascii_Writer::destroy() {
-    this->flush();
-    deallocate_string(Default_Allocator, &this->file_path);
+b8 Ascii_Writer::destroy() {
+    b8 success = this->flush();
     this->builder.destroy();
+    os_close_file(this->file);
+    this->file = INVALID_FILE_HANDLE;
+    return success;
 }
 
-void Ascii_Writer::flush() {
-    s64 directory_end = os_search_path_for_directory_slash_reverse(this->file_path);
-	if(directory_end != -1) os_create_directory(substring_view(this->file_path, 0, directory_end));
-
-	b8 append = false;
-	for(String_Builder::Block *block = &this->builder.first; block != null; block = block->next) {
-		os_write_file(this->file_path, string_view(block->data, block->count), append);
-		append = true;
-	}
+b8 Ascii_Writer::flush() {
+    return this->builder.flush();
 }
 
 void Ascii_Writer::write_string(string data) {
@@ -10,6 +10,20 @@ struct Ascii_Parser {
     string data;
     s64 position;
 
+    // Tokens are separated by whitespace. To find their boundaries, the data is classified in blocks of
+    // CHARACTER_BLOCK_SIZE bytes, and the whitespace mask of the most recent block is cached here.
+    s64 block_start;
+    u64 whitespace_mask;
+
+    // The start of the first token which could not be parsed as a number, or -1. Reading past the end of the
+    // data also counts as an error (at data.count). get_line_and_column turns this into a readable location.
+    s64 error_position;
+
+    // get_line_and_column counts newlines block by block, and remembers how far it got, so that looking up
+    // increasing positions only ever classifies every block once.
+    s64 line_block_start;
+    s64 line_newlines_before_block;
+
     void create_from_string(string data);
     void create_from_buffer(u8 *data, s64 size);
     b8 create_from_file(string file_path);
@@ -28,15 +42,30 @@ struct Ascii_Parser {
     s64 read_s64();
     f32 read_f32();
     f64 read_f64();
+
+    // Parse up to count tokens straight into the caller's array, returning how many values were read. These
+    // stop early at the end of the data, or at the first token which is not a number. That token is consumed
+    // (like in read_f32), and its position is stored in error_position.
+    s64 read_many_s32(s64 count, s32 *out);
+    s64 read_many_f32(s64 count, f32 *out);
+    s64 read_many_f64(s64 count, f64 *out);
+
+    b8 failed(); // Returns true if any number could not be parsed since creation.
+    void get_line_and_column(s64 position, s64 *line, s64 *column); // Both are one-based, the column is in bytes.
+
+    s64 find_token_boundary(s64 from, b8 whitespace); // Returns the first position at or after 'from' which is (or is not) whitespace, or data.count.
 };
 
+// Streams its output into the file through a String_Builder, which writes out its buffered data whenever
+// it has collected roughly String_Builder::MAX_BLOCK_SIZE bytes. Big files therefore never need to be fully
+// held in memory.
 struct Ascii_Writer {
-    string file_path;
+    File_Handle file;
 	String_Builder builder;
 
-    void create(string file_path, s64 buffer_size);
-    void destroy();
-    void flush();
+    b8 create(string file_path, s64 buffer_size); // Creates (or truncates) the file. The buffer size is only the initial size of the builder's buffer.
+    b8 destroy(); // Flushes the remaining data and closes the file. Returns false if any write failed.
+    b8 flush();
 
     void write_string(string data);
     void write_char(char c);
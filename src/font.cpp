@@ -7,6 +7,7 @@
 
 #define INVALID_ATLAS_INDEX 255 // Since we are using u8 for this.
 #define FONT_ATLAS_SIZE 512
+#define FONT_STACK_CODE_POINTS 256 // Texts up to this many bytes are decoded into a stack buffer.
 
 struct Font_Creation_Helper {
     FT_Face face;
@@ -35,12 +36,25 @@ Font_Glyph *find_default_glyph(Font *font) {
 }
 
 static
-Font_Glyph *find_glyph(Font *font, s64 character) {
-    if(character >= 0 && character <= 255) {
-        return font->glyphs + font->extended_ascii_hot_path[character];
+u64 hash_code_point(u32 const &code_point) {
+    return murmur_64a(code_point);
+}
+
+static
+b8 code_points_equal(u32 const &lhs, u32 const &rhs) {
+    return lhs == rhs;
+}
+
+// Returns null if no glyph was loaded for this code point.
+static
+Font_Glyph *find_glyph(Font *font, u32 code_point) {
+    if(code_point <= 255) {
+        return font->glyphs + font->extended_ascii_hot_path[code_point];
     }
 
-    foundation_error("The character value '%u' is not supported in the font.", character);
+    u32 *index = font->code_point_table.query(code_point);
+    if(index) return font->glyphs + *index;
+
     return null;
 }
 
@@ -188,11 +202,13 @@ u32 load_glyph(Font *font, FT_ULong character, Font_Creation_Helper *helper) {
 
     s16 unkerned_advance = (s16) freetype_unit_to_horizontal_pixels(helper->face, helper->face->glyph->advance.x);
 
-    const s64 advance_count = 256; // We only support kerning between Ascii characters (for now).
+    const s64 advance_count = 256; // We only support kerning between extended Ascii characters (for now).
     glyph->advances = (s16 *) Default_Allocator->allocate(advance_count * sizeof(s16));
 
+    // Fill in all advances, even for characters which have not been loaded (yet), since glyph sets can be
+    // loaded in any order.
     if(helper->apply_kerning) {
-        for(s64 i = 0; i < font->glyphs_allocated; ++i) {
+        for(s64 i = 0; i < advance_count; ++i) {
             s64 advance_index = find_glyph_index_in_advance_table(i);
             if(advance_index == -1) continue;
             
@@ -204,7 +220,7 @@ u32 load_glyph(Font *font, FT_ULong character, Font_Creation_Helper *helper) {
             glyph->advances[advance_index] = unkerned_advance + (s16) freetype_unit_to_horizontal_pixels(helper->face, kerning_value.x);
         }
     } else {
-        for(s64 i = 0; i < font->glyphs_allocated; ++i) {
+        for(s64 i = 0; i < advance_count; ++i) {
             s64 advance_index = find_glyph_index_in_advance_table(i);
             if(advance_index == -1) continue;
 
@@ -236,10 +252,39 @@ void allocate_additional_glyphs(Font *font, s64 count) {
     }
 }
 
+struct Unicode_Glyph_Set {
+    Glyph_Set set;
+    u32 first_code_point;
+    u32 last_code_point;
+};
+
+static const Unicode_Glyph_Set unicode_glyph_sets[] = {
+    { GLYPH_SET_Latin_Extended, 0x0100, 0x024F },
+    { GLYPH_SET_Greek,          0x0370, 0x03FF },
+    { GLYPH_SET_Cyrillic,       0x0400, 0x04FF },
+    { GLYPH_SET_Punctuation,    0x2000, 0x206F },
+};
+
 static
 void load_glyph_set(Font *font, Glyph_Set glyphs_to_load, Font_Creation_Helper *helper) {
     if(font->loaded_glyph_sets & glyphs_to_load) return;
 
+    for(const Unicode_Glyph_Set &unicode_set : unicode_glyph_sets) {
+        if(unicode_set.set != glyphs_to_load) continue;
+
+        load_glyph_set(font, GLYPH_SET_Ascii, helper); // For the default glyph.
+        allocate_additional_glyphs(font, unicode_set.last_code_point - unicode_set.first_code_point + 1);
+
+        for(u32 code_point = unicode_set.first_code_point; code_point <= unicode_set.last_code_point; ++code_point) {
+            // Code points which the font does not have fall back to the default glyph, without a table entry.
+            u32 index = load_glyph(font, code_point, helper);
+            if(index != 0) font->code_point_table.add(code_point, index);
+        }
+
+        font->loaded_glyph_sets |= glyphs_to_load;
+        return;
+    }
+
     switch(glyphs_to_load) {
     case GLYPH_SET_Ascii: {
         allocate_additional_glyphs(font, 128);
@@ -280,9 +325,10 @@ Error_Code create_font_from_file(Font *font, string file_path, s16 size, Font_Fi
 }
     
 Error_Code create_font_from_memory(Font *font, string _data, s16 size, Font_Filter filter, Glyph_Set glyphs_to_load) {
-    memset(font, 0, sizeof(Font)); // Make sure we don't have any uninitialized data in here.
+    *font = Font(); // Make sure we don't have any uninitialized data in here.
 
     font->filter = filter;
+    font->code_point_table.create(64, hash_code_point, code_points_equal);
 
     FT_Library library;
     if(FT_Init_FreeType(&library)) {
@@ -333,7 +379,9 @@ Error_Code create_font_from_memory(Font *font, string _data, s16 size, Font_Filt
         break;
     }
 
-    load_glyph_set(font, glyphs_to_load, &creation_helper);
+    for(u8 set = GLYPH_SET_Ascii; set != 0 && set <= glyphs_to_load; set <<= 1) {
+        if(glyphs_to_load & set) load_glyph_set(font, (Glyph_Set) set, &creation_helper);
+    }
     
     return Success;
 }
@@ -357,6 +405,7 @@ void destroy_font(Font *font) {
     }
 
     Default_Allocator->deallocate(font->glyphs);
+    font->code_point_table.destroy();
     font->loaded_glyph_sets = GLYPH_SET_None;
     font->glyphs            = null;
     font->glyph_count       = 0;
@@ -365,12 +414,51 @@ void destroy_font(Font *font) {
 
 
 
+// Decodes the whole text at once, which is a lot faster than decoding it code point by code point while laying
+// it out. Short texts are decoded into the stack buffer, which needs room for FONT_STACK_CODE_POINTS.
+static
+u32 *decode_text(string text, u32 *stack_buffer, s64 *count) {
+    u32 *code_points = text.count <= FONT_STACK_CODE_POINTS ? stack_buffer : (u32 *) Default_Allocator->allocate(text.count * sizeof(u32));
+    *count = utf8_to_code_points(text, code_points);
+    return code_points;
+}
+
+static
+void release_decoded_text(u32 *code_points, u32 *stack_buffer) {
+    if(code_points != stack_buffer) Default_Allocator->deallocate(code_points);
+}
+
+static
+s32 get_code_points_width_in_pixels(Font *font, u32 *code_points, s64 count) {
+    s32 width = 0;
+
+    for(s64 i = 0; i < count; ++i) {
+        Font_Glyph *glyph = find_glyph(font, code_points[i]);
+        if(!glyph) glyph = find_default_glyph(font);
+        
+        if(i == 0 && glyph->cursor_offset_x < 0) width -= glyph->cursor_offset_x;
+
+        if(i + 1 < count) {
+            width += find_glyph_advance(glyph, code_points[i + 1]);
+        } else {
+            width += find_glyph_advance(glyph, code_points[i]); // This should work as a heuristic also for glyphs without a bitmap, e.g. the space character
+        }
+    }
+
+    return width;
+}
+
 Text_Mesh build_text_mesh(Font *font, string text, s32 x, s32 y, Text_Alignment alignment, Allocator *allocator) {
     if(!font->glyph_count) return {};
 
+    u32 stack_buffer[FONT_STACK_CODE_POINTS];
+    s64 code_point_count;
+    u32 *code_points = decode_text(text, stack_buffer, &code_point_count);
+    defer { release_decoded_text(code_points, stack_buffer); };
+
     s64 non_empty_glyph_count = 0;
-    for(s64 i = 0; i < text.count; ++i) {
-        Font_Glyph *glyph = find_glyph(font, text[i]);
+    for(s64 i = 0; i < code_point_count; ++i) {
+        Font_Glyph *glyph = find_glyph(font, code_points[i]);
         if(!glyph) glyph = find_default_glyph(font);
 
         if(glyph->atlas_index != INVALID_ATLAS_INDEX) ++non_empty_glyph_count;
@@ -385,10 +473,10 @@ Text_Mesh build_text_mesh(Font *font, string text, s32 x, s32 y, Text_Alignment
     s32 cx = x, cy = y;
 
     if(alignment & TEXT_ALIGNMENT_Centered) {
-        s32 width = get_string_width_in_pixels(font, text);
+        s32 width = get_code_points_width_in_pixels(font, code_points, code_point_count);
         cx -= width / 2;
     } else if(alignment & TEXT_ALIGNMENT_Right) {
-        s32 width = get_string_width_in_pixels(font, text);
+        s32 width = get_code_points_width_in_pixels(font, code_points, code_point_count);
         cx -= width;
     }
 
@@ -400,8 +488,8 @@ Text_Mesh build_text_mesh(Font *font, string text, s32 x, s32 y, Text_Alignment
 
     s64 non_empty_glyph_index = 0;
 
-    for(s64 i = 0; i < text.count; ++i) {
-        Font_Glyph *glyph = find_glyph(font, text[i]);
+    for(s64 i = 0; i < code_point_count; ++i) {
+        Font_Glyph *glyph = find_glyph(font, code_points[i]);
         if(!glyph) glyph = find_default_glyph(font);
 
         if(glyph->atlas_index != INVALID_ATLAS_INDEX) {
@@ -451,7 +539,7 @@ Text_Mesh build_text_mesh(Font *font, string text, s32 x, s32 y, Text_Alignment
             ++non_empty_glyph_index;
         }
 
-        if(i + 1 < text.count) cx += find_glyph_advance(glyph, text[i + 1]);
+        if(i + 1 < code_point_count) cx += find_glyph_advance(glyph, code_points[i + 1]);
     }
 
     return text_mesh;
@@ -469,19 +557,19 @@ void deallocate_text_mesh(Text_Mesh *text_mesh, Allocator *allocator) {
 }
 
 
-s32 get_character_height_in_pixels(Font *font, u8 character) {
+s32 get_character_height_in_pixels(Font *font, u32 code_point) {
     if(!font->glyph_count) return 0;
     
-    Font_Glyph *glyph = find_glyph(font, character);
+    Font_Glyph *glyph = find_glyph(font, code_point);
     if(!glyph) return 0;
 
     return glyph->bitmap_height;
 }
 
-s32 get_character_width_in_pixels(Font *font, u8 character) {
+s32 get_character_width_in_pixels(Font *font, u32 code_point) {
     if(!font->glyph_count) return 0;
 
-    Font_Glyph *glyph = find_glyph(font, character);
+    Font_Glyph *glyph = find_glyph(font, code_point);
     if(!glyph) return 0;
 
     return glyph->bitmap_width;
@@ -490,20 +578,11 @@ s32 get_character_width_in_pixels(Font *font, u8 character) {
 s32 get_string_width_in_pixels(Font *font, string text) {
     if(!font->glyph_count) return 0;
 
-    s32 width = 0;
-
-    for(s64 i = 0; i < text.count; ++i) {
-        Font_Glyph *glyph = find_glyph(font, text[i]);
-        if(!glyph) glyph = find_default_glyph(font);
-        
-        if(i == 0 && glyph->cursor_offset_x < 0) width -= glyph->cursor_offset_x;
-
-        if(i + 1 < text.count) {
-            width += find_glyph_advance(glyph, text[i + 1]);
-        } else {
-            width += find_glyph_advance(glyph, text[i]); // This should work as a heuristic also for glyphs without a bitmap, e.g. the space character
-        }
-    }
+    u32 stack_buffer[FONT_STACK_CODE_POINTS];
+    s64 code_point_count;
+    u32 *code_points = decode_text(text, stack_buffer, &code_point_count);
 
+    s32 width = get_code_points_width_in_pixels(font, code_points, code_point_count);
+    release_decoded_text(code_points, stack_buffer);
     return width;
 }
@@ -2,6 +2,7 @@
 
 #include "foundation.h"
 #include "string_type.h"
+#include "hash_table.h"
 #include "error.h"
 
 enum Text_Alignment : u8 {
@@ -22,6 +23,10 @@ enum Glyph_Set : u8 {
     GLYPH_SET_None  = 0x0,
     GLYPH_SET_Ascii = 0x1,
     GLYPH_SET_Extended_Ascii = 0x2,
+    GLYPH_SET_Latin_Extended = 0x4, // U+0100 - U+024F
+    GLYPH_SET_Greek          = 0x8, // U+0370 - U+03FF
+    GLYPH_SET_Cyrillic       = 0x10, // U+0400 - U+04FF
+    GLYPH_SET_Punctuation    = 0x20, // U+2000 - U+206F (General Punctuation, e.g. quotation marks and dashes)
 };
 
 BITWISE(Glyph_Set);
@@ -80,6 +85,7 @@ struct Font {
     // Internal layout information.
     Glyph_Set loaded_glyph_sets;
     u32 extended_ascii_hot_path[256]; // Indices into the glyph array as a shortcut so that we don't have to actually search for it. We use indices here since the glyphs array may grow.
+    Probed_Hash_Table<u32, u32> code_point_table; // Indices into the glyph array for all loaded code points above the extended ascii range.
 
     Font_Glyph *glyphs;
     s64 glyph_count;
@@ -97,9 +103,10 @@ Error_Code create_font_from_file(Font *font, string file_path, s16 size, Font_Fi
 Error_Code create_font_from_memory(Font *font, string _data, s16 size, Font_Filter filter, Glyph_Set glyphs_to_load);
 void destroy_font(Font *font);
 
+// Text is decoded as UTF-8. Code points without a loaded glyph use the default glyph.
 Text_Mesh build_text_mesh(Font *font, string text, s32 x, s32 y, Text_Alignment alignment, Allocator *allocator);
 void deallocate_text_mesh(Text_Mesh *text_mesh, Allocator *allocator);
 
-s32 get_character_height_in_pixels(Font *font, u8 character);
-s32 get_character_width_in_pixels(Font *font, u8 character);
+s32 get_character_height_in_pixels(Font *font, u32 code_point);
+s32 get_character_width_in_pixels(Font *font, u32 code_point);
 s32 get_string_width_in_pixels(Font *font, string text);
@@ -56,6 +56,9 @@ typedef bool b8;
 #define null 0
 
 typedef s64 CPU_Time;
+typedef s64 File_Handle; // A file descriptor on linux, a HANDLE on windows.
+
+#define INVALID_FILE_HANDLE ((File_Handle) -1)
 
 constexpr s64 MAX_S64 =  9223372036854775807LL;
 constexpr s64 MIN_S64 = -9223372036854775807LL - 1LL;
@@ -0,0 +1,191 @@
+#include "interned_string.h"
+#include "hash_table.h" // For murmur_64a
+
+static inline
+u32 interned_string_tag(string text) {
+    u64 hash = string_hash(text);
+    return (u32) (hash ^ (hash >> 32));
+}
+
+static inline
+u64 make_interned_string_slot(u32 tag, u32 id) {
+    return ((u64) tag << 32) | id;
+}
+
+// Probes the given slot array for the text. The tag doubles as the bucket index, so that the slots can be
+// rehashed when growing without looking at the text again.
+static
+b8 probe_interned_string_slots(Interned_String_Table *table, Interned_String_Slots *slots, string text, u32 tag, Interned_String *result, u64 *empty_index) {
+    for(u64 index = tag & slots->mask; ; index = (index + 1) & slots->mask) {
+        u64 slot = atomic_load(&slots->slots[index]);
+
+        if(slot == 0) {
+            if(empty_index) *empty_index = index;
+            return false;
+        }
+
+        if((u32) (slot >> 32) == tag && strings_equal(table->entries[(u32) slot], text)) {
+            result->id = (u32) slot;
+            return true;
+        }
+    }
+}
+
+static
+void allocate_interned_string_slots(Interned_String_Table *table, Interned_String_Slots *slots, u64 count) {
+    slots->slots = (u64 volatile *) table->allocator->allocate(count * sizeof(u64));
+    slots->mask  = count - 1;
+    memset((void *) slots->slots, 0, count * sizeof(u64));
+}
+
+u64 interned_string_hash(Interned_String const &input) {
+    return murmur_64a(input.id);
+}
+
+b8 interned_strings_equal(Interned_String const &lhs, Interned_String const &rhs) {
+    return lhs.id == rhs.id;
+}
+
+void Interned_String_Table::create(u64 max_text_size, u32 max_count) {
+    this->text_arena.create(max_text_size);
+    this->entry_arena.create((u64) max_count * sizeof(string));
+    this->entries = (string *) this->entry_arena.base;
+
+    // The empty string always has the id 0, and is never stored in the slots.
+    string *empty = (string *) this->entry_arena.push(sizeof(string));
+    *empty = { 0, (u8 *) this->text_arena.push(1) };
+
+    memset(this->generations, 0, sizeof(this->generations));
+    allocate_interned_string_slots(this, &this->generations[0], INTERNED_STRING_INITIAL_SLOTS);
+
+    this->generation = 0;
+    this->count      = 1;
+    create_mutex(&this->mutex);
+}
+
+void Interned_String_Table::destroy() {
+    for(s64 i = 0; i < INTERNED_STRING_TABLE_GENERATIONS; ++i) {
+        if(this->generations[i].slots) this->allocator->deallocate((void *) this->generations[i].slots);
+    }
+
+    memset(this->generations, 0, sizeof(this->generations));
+    this->text_arena.destroy();
+    this->entry_arena.destroy();
+    this->entries    = null;
+    this->generation = 0;
+    this->count      = 0;
+    destroy_mutex(&this->mutex);
+}
+
+Interned_String Interned_String_Table::intern(string text) {
+    Interned_String result = { 0 };
+    if(text.count == 0) return result;
+
+    u32 tag = interned_string_tag(text);
+
+    // Fast path: The string has already been interned, which is by far the most common case.
+    Interned_String_Slots *slots = &this->generations[atomic_load(&this->generation)];
+    if(probe_interned_string_slots(this, slots, text, tag, &result, null)) return result;
+
+    lock(&this->mutex);
+    defer { unlock(&this->mutex); };
+
+    // While holding the mutex, the generation cannot change and nothing can be inserted, so this decides.
+    slots = &this->generations[this->generation];
+    u64 empty_index;
+    if(probe_interned_string_slots(this, slots, text, tag, &result, &empty_index)) return result;
+
+    u32 id = this->count;
+    assert(this->entry_arena.size + sizeof(string) <= this->entry_arena.reserved, "The Interned_String_Table ran out of ids.");
+
+    //
+    // Grow the slot array to keep the load factor below 3/4. The old array must stay alive for readers
+    // which might still be probing it.
+    //
+    if((u64) id * 4 >= (slots->mask + 1) * 3) {
+        assert(this->generation + 1 < INTERNED_STRING_TABLE_GENERATIONS, "The Interned_String_Table ran out of generations.");
+
+        Interned_String_Slots *grown = &this->generations[this->generation + 1];
+        allocate_interned_string_slots(this, grown, (slots->mask + 1) * 2);
+
+        for(u64 i = 0; i <= slots->mask; ++i) {
+            u64 slot = slots->slots[i];
+            if(slot == 0) continue;
+
+            u64 index = (slot >> 32) & grown->mask;
+            while(grown->slots[index] != 0) index = (index + 1) & grown->mask;
+            grown->slots[index] = slot;
+        }
+
+        atomic_store(&this->generation, this->generation + 1);
+        slots = grown;
+
+        empty_index = tag & slots->mask;
+        while(slots->slots[empty_index] != 0) empty_index = (empty_index + 1) & slots->mask;
+    }
+
+    // Write the text and the entry before publishing the slot, so that readers which see the id can rely on it.
+    u8 *data = (u8 *) this->text_arena.push(text.count + 1);
+    memcpy(data, text.data, text.count);
+    data[text.count] = 0;
+
+    string *entry = (string *) this->entry_arena.push(sizeof(string));
+    *entry = { text.count, data };
+
+    atomic_store(&this->count, id + 1);
+    atomic_store(&slots->slots[empty_index], make_interned_string_slot(tag, id));
+
+    result.id = id;
+    return result;
+}
+
+b8 Interned_String_Table::find(string text, Interned_String *result) {
+    result->id = 0;
+    if(text.count == 0) return true;
+
+    u32 tag = interned_string_tag(text);
+
+    while(true) {
+        u32 generation = atomic_load(&this->generation);
+        if(probe_interned_string_slots(this, &this->generations[generation], text, tag, result, null)) return true;
+
+        // The string might have been inserted into a newer slot array while probing an older one.
+        if(atomic_load(&this->generation) == generation) return false;
+    }
+}
+
+string Interned_String_Table::view(Interned_String interned) {
+    assert(interned.id < atomic_load(&this->count), "Invalid Interned_String.");
+    return this->entries[interned.id];
+}
+
+s64 Interned_String_Table::get_count() {
+    return atomic_load(&this->count);
+}
+
+Interned_String_Table *global_interned_string_table() {
+    // Function-local statics are initialized exactly once, even if multiple threads get here at the same time.
+    static Interned_String_Table *table = []() {
+        static Interned_String_Table instance;
+        instance.create();
+        return &instance;
+    }();
+
+    return table;
+}
+
+Interned_String intern_string(string text) {
+    return global_interned_string_table()->intern(text);
+}
+
+Interned_String intern_string(const char *text) {
+    return global_interned_string_table()->intern(cstring_view(text));
+}
+
+b8 find_interned_string(string text, Interned_String *result) {
+    return global_interned_string_table()->find(text, result);
+}
+
+string interned_string_view(Interned_String interned) {
+    return global_interned_string_table()->view(interned);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "foundation.h"
+#include "memutils.h"
+#include "string_type.h"
+#include "threads.h"
+
+//
+// Interning maps every distinct string to a unique 32-bit id ("atom"), so that names which are looked up over
+// and over again (asset names, tweak variables, UI labels, profiler zones...) only need to be hashed and
+// compared once, when they are interned. After that, equality and hashing are O(1) on the id, and the text
+// can always be retrieved from the table.
+//     The text of all interned strings lives in a Memory_Arena, and the ids index into a second arena of
+// string views. Since arenas reserve their address space up front, neither ever moves, so views returned by
+// the table stay valid until the table is destroyed. Interned strings are never removed.
+//     Lookups are lock-free: The hash table stores each id together with a 32-bit tag of the string's hash in
+// a single u64 slot, which is published atomically after the text has been written. Only inserting a new
+// string takes the mutex. When the hash table grows, the old slot array is kept alive (they add up to less
+// than the current one), so that concurrent readers never touch freed memory. A reader still working on an
+// old slot array might not see the newest strings, in which case it falls back to the locked path.
+//     The id 0 is reserved for the empty string, so that a zero-initialized Interned_String is valid.
+//
+
+#define INTERNED_STRING_TABLE_GENERATIONS 32
+#define INTERNED_STRING_INITIAL_SLOTS     1024
+
+struct Interned_String {
+    u32 id;
+};
+
+inline b8 operator==(Interned_String lhs, Interned_String rhs) { return lhs.id == rhs.id; }
+inline b8 operator!=(Interned_String lhs, Interned_String rhs) { return lhs.id != rhs.id; }
+
+u64 interned_string_hash(Interned_String const &input);
+b8 interned_strings_equal(Interned_String const &lhs, Interned_String const &rhs);
+
+struct Interned_String_Slots {
+    u64 volatile *slots; // The hash tag in the upper 32 bits, the id in the lower 32 bits. 0 means empty.
+    u64 mask;
+};
+
+struct Interned_String_Table {
+    Allocator *allocator = Default_Allocator; // For the slot arrays.
+    Memory_Arena text_arena;  // The null-terminated text of all strings.
+    Memory_Arena entry_arena; // One string view per id.
+    string *entries;
+
+    Interned_String_Slots generations[INTERNED_STRING_TABLE_GENERATIONS];
+    volatile u32 generation; // The index of the slot array currently in use.
+    volatile u32 count; // The number of ids handed out, including the empty string.
+    Mutex mutex; // Taken for inserting new strings.
+
+    void create(u64 max_text_size = 256 * ONE_MEGABYTE, u32 max_count = 16 * 1024 * 1024);
+    void destroy();
+
+    Interned_String intern(string text);
+    b8 find(string text, Interned_String *result); // Does not insert, returns false if the string was never interned.
+    string view(Interned_String interned); // The returned view is null-terminated.
+    s64 get_count();
+};
+
+// The global table is created on first use, so interned strings can be used anywhere without any setup.
+Interned_String_Table *global_interned_string_table();
+
+Interned_String intern_string(string text);
+Interned_String intern_string(const char *text);
+b8 find_interned_string(string text, Interned_String *result);
+string interned_string_view(Interned_String interned);
@@ -7,6 +7,7 @@
 #include <sys/mman.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <sys/uio.h>
 #include <sys/resource.h>
 #include <unistd.h>
@@ -344,6 +345,36 @@ void os_free_file_content(Allocator *allocator, string *file_content) {
     deallocate_string(allocator, file_content);
 }
 
+string os_map_file(string file_path) {
+    char *cstring = to_cstring(Default_Allocator, file_path);
+    defer { free_cstring(Default_Allocator, cstring); };
+
+    string result = { 0 };
+
+    int file = open(cstring, O_RDONLY);
+    if(file == -1) return result;
+
+    struct stat file_status;
+    if(fstat(file, &file_status) == 0 && file_status.st_size > 0) {
+        void *pointer = mmap(null, file_status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if(pointer != MAP_FAILED) {
+            result.data  = (u8 *) pointer;
+            result.count = file_status.st_size;
+        }
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(file);
+
+    return result;
+}
+
+void os_unmap_file(string *file_content) {
+    if(file_content->data) munmap(file_content->data, file_content->count);
+    file_content->count = 0;
+    file_content->data  = null;
+}
+
 b8 os_write_file(string file_path, string file_content, b8 append) {
     char *cstring = to_cstring(Default_Allocator, file_path);
     defer { free_cstring(Default_Allocator, cstring); };
@@ -363,6 +394,58 @@ b8 os_write_file(string file_path, string file_content, b8 append) {
     return success;
 }
 
+File_Handle os_open_file_for_writing(string file_path, b8 append) {
+    char *cstring = to_cstring(Default_Allocator, file_path);
+    defer { free_cstring(Default_Allocator, cstring); };
+
+    int file = open(cstring, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    return file != -1 ? (File_Handle) file : INVALID_FILE_HANDLE;
+}
+
+b8 os_write_file_chunks(File_Handle file, string *chunks, s64 count) {
+    struct iovec vectors[64];
+
+    while(count > 0) {
+        s64 batch = MIN(count, (s64) ARRAY_COUNT(vectors));
+        for(s64 i = 0; i < batch; ++i) vectors[i] = { chunks[i].data, (size_t) chunks[i].count };
+
+        struct iovec *vector = vectors;
+        s64 vector_count = batch;
+
+        while(vector_count > 0) {
+            ssize_t written = writev((int) file, vector, (int) vector_count);
+            if(written < 0) {
+                if(errno == EINTR) continue;
+                return false;
+            }
+
+            //
+            // writev may stop after any number of bytes, so skip everything that has been written and continue
+            // in the middle of a chunk if necessary.
+            //
+            while(vector_count > 0 && (size_t) written >= vector->iov_len) {
+                written -= vector->iov_len;
+                ++vector;
+                --vector_count;
+            }
+
+            if(vector_count > 0) {
+                vector->iov_base = (u8 *) vector->iov_base + written;
+                vector->iov_len -= written;
+            }
+        }
+
+        chunks += batch;
+        count  -= batch;
+    }
+
+    return true;
+}
+
+void os_close_file(File_Handle file) {
+    close((int) file);
+}
+
 b8 os_create_directory(string file_path) {
     s64 parent_folder_end = os_search_path_for_directory_slash_reverse(file_path);
     if(parent_folder_end != -1) {
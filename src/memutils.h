@@ -2,6 +2,8 @@
 
 #include "foundation.h"
 
+#include <new> // For placement new
+
 #define ONE_GIGABYTE (ONE_MEGABYTE * ONE_KILOBYTE)
 #define ONE_MEGABYTE (ONE_KILOBYTE * ONE_KILOBYTE)
 #define ONE_KILOBYTE (1024ULL)
@@ -232,6 +234,22 @@ Slice<T> allocate_slice(Allocator *allocator, s64 count) {
     return result;
 }
 
+// Types which are trivially copyable can be moved around in memory with memcpy / memmove. All other types
+// get move-constructed into their new place entry by entry, and the old entry is destroyed.
+template<typename T>
+struct Is_Trivially_Relocatable {
+    static const b8 value = __is_trivially_copyable(T);
+};
+
+// Moves count entries from src into the uninitialized memory at dst, leaving src uninitialized. The two ranges
+// may overlap (e.g. to shift entries inside an array), as long as the part of dst outside of src is uninitialized.
+template<typename T>
+void relocate_entries(T *dst, T *src, s64 count);
+
+// Calls the destructor of count entries, if T has one.
+template<typename T>
+void destroy_entries(T *entries, s64 count);
+
 template<typename T>
 struct Resizable_Array {
 	static const s64 INITIAL_SIZE = 128;
@@ -254,16 +272,21 @@ struct Resizable_Array {
 	
 	void maybe_grow(b8 force = false);
 	void maybe_shrink();
+    void reallocate_data(); // Resizes the data to this->allocated entries.
 
 	void clear();
 	void clear_without_deallocation(); // If using this on a temp arena, etc.
     void reserve(s64 count);
     void reserve_exact(s64 count);
     void add(T const &data);
+    void add(T &&data);
+    void add_many(T const *data, s64 count);
     void add_all(const Resizable_Array<T> &src);
     void insert(s64 index, T const &data);
 	void remove(s64 index);
 	void remove_range(s64 first_to_remove, s64 last_to_remove);
+    void swap_remove(s64 index); // Fills the gap with the last entry instead of shifting, so this does not preserve the order.
+    template<typename Predicate> s64 remove_if(Predicate predicate); // Removes all entries for which predicate(T *) returns true in a single pass, preserving the order. Returns the number of removed entries.
     void remove_value(T const &value);
     void remove_value_pointer(T *pointer);
     s64 index_of(T const &value);
@@ -279,47 +302,115 @@ struct Resizable_Array {
 	Iterator end()   { return Iterator { this->data + this->count }; }
 };
 
+//
+// A Small_Array stores up to N entries inline and only spills to the allocator once it grows past that, which
+// avoids heap allocations for the common case of short-lived lists with a handful of entries. It has the same
+// API as the Resizable_Array, except that the entries are accessed through get_data(), since the data pointer
+// depends on whether the array has spilled.
+// The inline storage makes Small_Arrays safe to copy and return by value (like Resizable_Arrays, copies share
+// the spilled heap data). Zero-initialized Small_Arrays are valid empty arrays, which use the Default_Allocator.
+//
+template<typename T, s64 N>
+struct Small_Array {
+    static_assert(N > 0, "The inline capacity must be positive.");
+
+	struct Iterator {
+        T *pointer;
+        
+		b8 operator==(Iterator const &it) const { return this->pointer == it.pointer; }
+		b8 operator!=(Iterator const &it) const { return this->pointer != it.pointer; }    
+        Iterator &operator++() { ++this->pointer; return *this; }
+        
+        T &operator*()  { return *this->pointer; }
+		T *operator->() { return this->pointer; }
+    };
+
+	Allocator *allocator = Default_Allocator;
+    T *heap_data  = null; // Null while the entries are stored inline.
+	s64 count     = 0;
+	s64 allocated = 0; // The capacity of heap_data, only valid once the array has spilled.
+    alignas(T) u8 inline_storage[N * sizeof(T)]; // Raw memory, so that entries only get constructed once they are added.
+
+    T *inline_data() { return (T *) this->inline_storage; }
+    T *get_data() { return this->heap_data ? this->heap_data : this->inline_data(); }
+    s64 capacity() { return this->heap_data ? this->allocated : N; }
+    b8 spilled()   { return this->heap_data != null; }
+
+    void resize_storage(s64 new_capacity); // Moves the entries into storage for new_capacity entries, which may be the inline storage.
+	void maybe_grow(b8 force = false);
+	void maybe_shrink();
+
+	void clear();
+	void clear_without_deallocation(); // If using this on a temp arena, etc.
+    void reserve(s64 count);
+    void reserve_exact(s64 count);
+    void add(T const &data);
+    void add(T &&data);
+    void add_many(T const *data, s64 count);
+    void add_all(Small_Array<T, N> &src);
+    void insert(s64 index, T const &data);
+	void remove(s64 index);
+	void remove_range(s64 first_to_remove, s64 last_to_remove);
+    void swap_remove(s64 index); // Fills the gap with the last entry instead of shifting, so this does not preserve the order.
+    template<typename Predicate> s64 remove_if(Predicate predicate); // Removes all entries for which predicate(T *) returns true in a single pass, preserving the order. Returns the number of removed entries.
+    void remove_value(T const &value);
+    void remove_value_pointer(T *pointer);
+    s64 index_of(T const &value);
+    b8 contains(T const &value);
+    T *push();
+	T pop();
+    T pop_first();
+    Small_Array<T, N> copy(Allocator *allocator);
+    
+	T &operator[](s64 index);
+
+    Iterator begin() { return Iterator { this->get_data() }; }
+	Iterator end()   { return Iterator { this->get_data() + this->count }; }
+};
+
 template<typename T, s64 block_capacity>
 struct Resizable_Block_Array {
+    static_assert(block_capacity > 0, "The block capacity must be positive.");
+
+    // Entries never move between blocks when adding, so pointers into this array stay valid until the entry
+    // (or an entry before it) gets removed. The directory of block pointers makes random access a division
+    // (or shift and mask, if the block capacity is a power of two) and a single indirection.
     struct Block {
-        Block *next;
         T data[block_capacity];
     };
 
     struct Iterator {
         Resizable_Block_Array<T, block_capacity> *array;
-        Block *block;
-        s64 index_in_block;
+        s64 index;
+        T *pointer;   // Points at the current entry.
+        T *block_end; // Points one past the last entry of the current block.
 
-        b8 operator==(Iterator const &it) { return this->block == it.block && this->index_in_block == it.index_in_block; }
-        b8 operator!=(Iterator const &it) { return this->block != it.block || this->index_in_block != it.index_in_block; }
+        b8 operator==(Iterator const &it) { return this->index == it.index; }
+        b8 operator!=(Iterator const &it) { return this->index != it.index; }
         Iterator &operator++() {
-            ++this->index_in_block;
+            ++this->index;
+            ++this->pointer;
 
-            s64 entry_count = array->calculate_block_entry_count(this->block);
-            if(this->index_in_block == entry_count && this->block->next) {
-                this->block = this->block->next;
-                this->index_in_block = 0;
+            if(this->pointer == this->block_end && this->index < this->array->count) {
+                this->pointer   = this->array->blocks[this->index / block_capacity]->data;
+                this->block_end = this->pointer + block_capacity;
             }
 
             return *this;
         }
         
-        T &operator*()  { return this->block->data[this->index_in_block]; }
-        T *operator->() { return this->block->data[this->index_in_block]; }
+        T &operator*()  { return *this->pointer; }
+        T *operator->() { return this->pointer; }
     };
     
     Allocator *allocator = Default_Allocator;
-    Block *first    = null;
-    Block *last     = null;
-	s64 block_count = 0;
-    s64 count       = 0;
-
-    s64 calculate_block_entry_count(Block *block);
-    Block *find_previous_to_block(Block *block);
-    Block *find_block(s64 index, s64 *index_in_block);
-    void move_entries(Block *src_block, s64 src_index_in_block, s64 dst_index_in_block);
-    void maybe_grow(b8 force = false);
+    Block **blocks            = null; // The block directory.
+    s64 block_count           = 0;
+    s64 block_directory_count = 0; // The number of block pointers the directory has space for.
+    s64 count                 = 0;
+
+    s64 calculate_block_entry_count(s64 block_index);
+    void maybe_grow();
     void maybe_shrink();
 
     void clear();
@@ -336,16 +427,25 @@ struct Resizable_Block_Array {
     void pop_first();
     Resizable_Block_Array<T, block_capacity> copy();
 
+    // The procedure gets called as procedure(T *entry) for each entry, in a tight loop per block.
+    template<typename Procedure> void iterate(Procedure procedure);
+
     T &operator[](s64 index);
 
-	Iterator begin() { return Iterator{ this, this->first, 0 }; }
-	Iterator end()   { return Iterator{ this, this->last,  this->count > 0 ? this->count - (this->block_count - 1) * block_capacity : 0 }; }
+	Iterator begin() { return Iterator{ this, 0, this->count > 0 ? this->blocks[0]->data : null, this->count > 0 ? this->blocks[0]->data + block_capacity : null }; }
+	Iterator end()   { return Iterator{ this, this->count, null, null }; }
 };
 
+//
+// A doubly-linked list. Removed nodes are kept in a per-list free list and reused by the next add, so that
+// lists which constantly churn entries (e.g. audio sources, unacked packets) don't hit the allocator every
+// time. clear() releases all nodes, including the pooled ones, back to the allocator.
+//
 template<typename T>
 struct Linked_List_Node {
+    T data; // Must be the first member, so that a pointer to the data is also a pointer to its node.
+    Linked_List_Node<T> *previous;
     Linked_List_Node<T> *next;
-    T data;    
 };
 
 template<typename T>
@@ -365,14 +465,17 @@ struct Linked_List {
 	Linked_List_Node<T> *tail = null;
 	s64 count  = 0;
 
+    Linked_List_Node<T> *free_nodes = null; // Singly-linked through 'next'.
+
 	Linked_List_Node<T> *make_node(T const &value);
+    void free_node(Linked_List_Node<T> *node);
 
     void clear();
 	void add(T const &value);
     void add_first(T const &value);
-	void remove_node(Linked_List_Node<T> *node);
+	void remove_node(Linked_List_Node<T> *node); // O(1).
 	void remove_value(T const &value);
-	void remove_value_pointer(T *value_pointer);
+	void remove_value_pointer(T *value_pointer); // O(1), value_pointer must point into this list.
 	void remove(s64 index);
     b8 contains(T const &value);
 	T *push();
@@ -388,6 +491,51 @@ struct Linked_List {
 	Iterator end()   { return Iterator { null }; }
 };
 
+//
+// A doubly-linked list which does not allocate anything: The links live inside the entries themselves, e.g.:
+//     struct Audio_Source { ...; Intrusive_List_Link<Audio_Source> link; };
+//     Intrusive_List<Audio_Source, &Audio_Source::link> sources;
+// The list never owns its entries, so they need to outlive their membership. An entry can only be part of one
+// list per link member at a time.
+//
+template<typename T>
+struct Intrusive_List_Link {
+    T *previous = null;
+    T *next     = null;
+};
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+struct Intrusive_List {
+	struct Iterator {
+        T *pointer;
+        
+		b8 operator!=(Iterator const &it) const { return this->pointer != it.pointer; }    
+        Iterator &operator++() { this->pointer = (this->pointer->*Link).next; return *this; }
+        
+        T &operator*()  { return *this->pointer; }
+		T *operator->() { return this->pointer; }
+    };
+
+    T *head   = null;
+    T *tail   = null;
+    s64 count = 0;
+
+    void clear(); // Only unlinks the entries.
+    void add(T *entry);
+    void add_first(T *entry);
+    void insert_after(T *position, T *entry);
+    void remove(T *entry); // O(1).
+    b8 contains(T *entry);
+    T *pop();
+    T *pop_first();
+
+    T *first() { return this->head; }
+    T *last()  { return this->tail; }
+
+    Iterator begin() { return Iterator { this->head }; }
+	Iterator end()   { return Iterator { null }; }
+};
+
 
 
 /* ---------------------------------------------- Temp Allocator ---------------------------------------------- */
@@ -7,6 +7,30 @@
 
 /* --------------------------------------------- Resizable Array --------------------------------------------- */
 
+template<typename T>
+void relocate_entries(T *dst, T *src, s64 count) {
+    if(Is_Trivially_Relocatable<T>::value) {
+        memmove(dst, src, count * sizeof(T));
+    } else if(dst < src) {
+        // Every destination entry is either outside of src, or has already been moved away and destroyed.
+        for(s64 i = 0; i < count; ++i) {
+            new (&dst[i]) T((T &&) src[i]);
+            src[i].~T();
+        }
+    } else if(dst > src) {
+        for(s64 i = count - 1; i >= 0; --i) {
+            new (&dst[i]) T((T &&) src[i]);
+            src[i].~T();
+        }
+    }
+}
+
+template<typename T>
+void destroy_entries(T *entries, s64 count) {
+    if(Is_Trivially_Relocatable<T>::value) return;
+    for(s64 i = 0; i < count; ++i) entries[i].~T();
+}
+
 template<typename T>
 void Resizable_Array<T>::maybe_grow(b8 force) {
     if(!this->data) {
@@ -14,20 +38,7 @@ void Resizable_Array<T>::maybe_grow(b8 force) {
         this->data      = (T *) this->allocator->allocate(this->allocated * sizeof(T));
     } else if(force || this->count == this->allocated) {
         if(!force) this->allocated *= 2;
-		
-        if(!this->allocator->_reallocate_procedure) {
-            // Not all allocators actually provide a reallocation strategy (e.g. Memory Arenas). In that case,
-            // allocate new memory manually, copy the existing data and if the allocator does have a
-            // deallocation strategy, free the previous pointer. If the allocator does not have a
-            // deallocation, then it is most likely some sort of scratch allocator that frees all memory at
-            // once.
-            T *new_pointer = (T *) this->allocator->allocate(this->allocated * sizeof(T));
-            memmove(new_pointer, this->data, this->count * sizeof(T));
-            if(this->allocator->_deallocate_procedure) this->allocator->deallocate(this->data);
-            this->data = new_pointer;	
-        } else {
-            this->data = (T *) this->allocator->reallocate(this->data, this->allocated * sizeof(T));
-        }
+        this->reallocate_data();
     }
 }
 
@@ -36,26 +47,32 @@ void Resizable_Array<T>::maybe_shrink() {
     if(this->count < this->allocated / 2 - 1 && this->allocated >= Resizable_Array::INITIAL_SIZE * 2) {
         // If the array is less-than-half full, shrink the array
         this->allocated /= 2;
-        assert(this->count > 0 && this->count <= this->allocated);
-
-        if(!this->allocator->_reallocate_procedure) {
-            // Not all allocators actually provide a reallocation strategy (e.g. Memory Arenas). In that case,
-            // allocate new memory manually, copy the existing data and if the allocator does have a
-            // deallocation strategy, free the previous pointer. If the allocator does not have a
-            // deallocation, then it is most likely some sort of scratch allocator that frees all memory at
-            // once.
-            T *new_pointer = (T *) this->allocator->allocate(this->allocated * sizeof(T));
-            memmove(new_pointer, this->data, this->count * sizeof(T));
-            if(this->allocator->_deallocate_procedure) this->allocator->deallocate(this->data);
-            this->data = new_pointer;	
-        } else {
-            this->data = (T *) this->allocator->reallocate(this->data, this->allocated * sizeof(T));
-        }
+        assert(this->count >= 0 && this->count <= this->allocated);
+        this->reallocate_data();
+    }
+}
+
+template<typename T>
+void Resizable_Array<T>::reallocate_data() {
+    if(Is_Trivially_Relocatable<T>::value && this->allocator->_reallocate_procedure) {
+        // Trivial types can just be grown (or shrunk) in place by the allocator.
+        this->data = (T *) this->allocator->reallocate(this->data, this->allocated * sizeof(T));
+    } else {
+        // Not all allocators actually provide a reallocation strategy (e.g. Memory Arenas), and non-trivial
+        // types need to be moved through their move constructor. In that case, allocate new memory
+        // manually, move the existing data and if the allocator does have a deallocation strategy, free the
+        // previous pointer. If the allocator does not have a deallocation, then it is most likely some sort
+        // of scratch allocator that frees all memory at once.
+        T *new_pointer = (T *) this->allocator->allocate(this->allocated * sizeof(T));
+        relocate_entries(new_pointer, this->data, this->count);
+        if(this->allocator->_deallocate_procedure) this->allocator->deallocate(this->data);
+        this->data = new_pointer;
     }
 }
 
 template<typename T>
 void Resizable_Array<T>::clear() {
+    destroy_entries(this->data, this->count);
     this->allocator->deallocate(this->data);
     this->count     = 0;
     this->allocated = 0;
@@ -91,31 +108,51 @@ void Resizable_Array<T>::reserve_exact(s64 count) {
 template<typename T>
 void Resizable_Array<T>::add(T const &data) {
     this->maybe_grow();
-    this->data[this->count] = data;
+    new (&this->data[this->count]) T(data);
     ++this->count;
 }
 
 template<typename T>
-void Resizable_Array<T>::add_all(const Resizable_Array<T> &src) {
-    this->reserve(src.count);
-    for(s64 i = 0; i < src.count; ++i) {
-        this->add(src.data[i]);
+void Resizable_Array<T>::add(T &&data) {
+    this->maybe_grow();
+    new (&this->data[this->count]) T((T &&) data);
+    ++this->count;
+}
+
+template<typename T>
+void Resizable_Array<T>::add_many(T const *data, s64 count) {
+    if(count <= 0) return;
+
+    if(this->count + count > this->allocated) this->reserve(count);
+    
+    if(Is_Trivially_Relocatable<T>::value) {
+        memcpy(&this->data[this->count], data, count * sizeof(T));
+    } else {
+        for(s64 i = 0; i < count; ++i) new (&this->data[this->count + i]) T(data[i]);
     }
+
+    this->count += count;
+}
+
+template<typename T>
+void Resizable_Array<T>::add_all(const Resizable_Array<T> &src) {
+    this->add_many(src.data, src.count);
 }
 
 template<typename T>
 void Resizable_Array<T>::insert(s64 index, T const &data) {
     assert(index >= 0 && index <= this->count);
     this->maybe_grow();
-    if(index < this->count) memmove(&this->data[index + 1], &this->data[index], (this->count - index) * sizeof(T));
-    this->data[index] = data;
+    if(index < this->count) relocate_entries(&this->data[index + 1], &this->data[index], this->count - index);
+    new (&this->data[index]) T(data);
     ++this->count;
 }
 
 template<typename T>
 void Resizable_Array<T>::remove(s64 index) {
     assert(index >= 0 && index < this->count);
-    memmove(&this->data[index], &this->data[index + 1], (this->count - index - 1) * sizeof(T));
+    destroy_entries(&this->data[index], 1);
+    relocate_entries(&this->data[index], &this->data[index + 1], this->count - index - 1);
     --this->count;
     this->maybe_shrink();
 }
@@ -125,11 +162,39 @@ void Resizable_Array<T>::remove_range(s64 first_to_remove, s64 last_to_remove) {
     assert(first_to_remove >= 0 && first_to_remove < this->count);
     assert(last_to_remove >= 0 && last_to_remove < this->count);
     assert(last_to_remove >= first_to_remove);
-    memmove(&this->data[first_to_remove], &this->data[last_to_remove + 1], (this->count - last_to_remove - 1) * sizeof(T));
+    destroy_entries(&this->data[first_to_remove], last_to_remove - first_to_remove + 1);
+    relocate_entries(&this->data[first_to_remove], &this->data[last_to_remove + 1], this->count - last_to_remove - 1);
     this->count -= (last_to_remove - first_to_remove) + 1;
     this->maybe_shrink();
 }
 
+template<typename T>
+void Resizable_Array<T>::swap_remove(s64 index) {
+    assert(index >= 0 && index < this->count);
+    if(index != this->count - 1) this->data[index] = (T &&) this->data[this->count - 1];
+    destroy_entries(&this->data[this->count - 1], 1);
+    --this->count;
+    this->maybe_shrink();
+}
+
+template<typename T>
+template<typename Predicate>
+s64 Resizable_Array<T>::remove_if(Predicate predicate) {
+    s64 kept = 0;
+
+    for(s64 i = 0; i < this->count; ++i) {
+        if(predicate(&this->data[i])) continue;
+        if(kept != i) this->data[kept] = (T &&) this->data[i];
+        ++kept;
+    }
+
+    destroy_entries(&this->data[kept], this->count - kept);
+    s64 removed = this->count - kept;
+    this->count = kept;
+    if(removed) this->maybe_shrink();
+    return removed;
+}
+
 template<typename T>
 void Resizable_Array<T>::remove_value(T const &value) {
     for(s64 i = 0; i < this->count; ++i) {
@@ -171,8 +236,7 @@ b8 Resizable_Array<T>::contains(T const &value) {
 template<typename T>
 T *Resizable_Array<T>::push() {
     this->maybe_grow();
-    T *pointer = &this->data[this->count];
-    *pointer = T();
+    T *pointer = new (&this->data[this->count]) T();
     ++this->count;
     return pointer;
 }
@@ -180,7 +244,8 @@ T *Resizable_Array<T>::push() {
 template<typename T>
 T Resizable_Array<T>::pop() {
     assert(this->count > 0);
-    T value = this->data[this->count - 1];
+    T value = (T &&) this->data[this->count - 1];
+    destroy_entries(&this->data[this->count - 1], 1);
     --this->count;
     this->maybe_shrink();
     return value;
@@ -189,7 +254,7 @@ T Resizable_Array<T>::pop() {
 template<typename T>
 T Resizable_Array<T>::pop_first() {
     assert(this->count > 0);
-    T value = this->data[0];
+    T value = (T &&) this->data[0];
     this->remove(0);
     return value;
 }
@@ -199,7 +264,7 @@ Resizable_Array<T> Resizable_Array<T>::copy(Allocator *allocator) {
     Resizable_Array<T> result;
     result.allocator = allocator;
     result.reserve_exact(this->count);
-    for(s64 i = 0; i < this->count; ++i) result.add(this->data[i]);
+    result.add_many(this->data, this->count);
     return result;
 }
 
@@ -211,138 +276,309 @@ T &Resizable_Array<T>::operator[](s64 index) {
 
 
 
-/* ------------------------------------------ Resizable Block Array ------------------------------------------ */
+/* ----------------------------------------------- Small Array ----------------------------------------------- */
 
-template<typename T, s64 block_capacity>
-s64 Resizable_Block_Array<T, block_capacity>::calculate_block_entry_count(Block *block) {
-    if(block == this->last) return this->count - (this->block_count - 1) * block_capacity;
-    return block_capacity;
+template<typename T, s64 N>
+void Small_Array<T, N>::resize_storage(s64 new_capacity) {
+    assert(new_capacity >= this->count);
+
+    if(!this->allocator) this->allocator = Default_Allocator; // Zero-initialized arrays.
+
+    T *old_data = this->heap_data;
+
+    if(new_capacity <= N) {
+        // Move the entries back into the inline storage.
+        if(!old_data) return;
+
+        relocate_entries(this->inline_data(), old_data, this->count);
+        if(this->allocator->_deallocate_procedure) this->allocator->deallocate(old_data);
+        this->heap_data = null;
+        this->allocated = 0;
+    } else if(old_data && Is_Trivially_Relocatable<T>::value && this->allocator->_reallocate_procedure) {
+        this->heap_data = (T *) this->allocator->reallocate(old_data, new_capacity * sizeof(T));
+        this->allocated = new_capacity;
+    } else {
+        T *new_data = (T *) this->allocator->allocate(new_capacity * sizeof(T));
+        relocate_entries(new_data, this->get_data(), this->count);
+        if(old_data && this->allocator->_deallocate_procedure) this->allocator->deallocate(old_data);
+        this->heap_data = new_data;
+        this->allocated = new_capacity;
+    }
 }
 
-template<typename T, s64 block_capacity>
-typename Resizable_Block_Array<T, block_capacity>::Block *Resizable_Block_Array<T, block_capacity>::find_previous_to_block(Block *block) {
-    if(block == this->first) return null;
+template<typename T, s64 N>
+void Small_Array<T, N>::maybe_grow(b8 force) {
+    if(force || this->count == this->capacity()) this->resize_storage(this->capacity() * 2);
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::maybe_shrink() {
+    // Like the Resizable_Array, only shrink once the array is less than half full, and move back into the
+    // inline storage once everything fits in there again.
+    if(this->heap_data && this->count < this->allocated / 2 - 1) this->resize_storage(MAX(this->allocated / 2, N));
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::clear() {
+    destroy_entries(this->get_data(), this->count);
+    if(this->heap_data) this->allocator->deallocate(this->heap_data);
+    this->heap_data = null;
+    this->count     = 0;
+    this->allocated = 0;
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::clear_without_deallocation() {
+    this->heap_data = null;
+    this->count     = 0;
+    this->allocated = 0;
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::reserve(s64 count) {
+    assert(count >= 0);
+
+    s64 least_capacity = this->count + count;
+    s64 new_capacity   = this->capacity();
+    while(new_capacity < least_capacity) new_capacity *= 2;
 
-    Block *previous = this->first;
-    while(previous->next != block) {
-        previous = previous->next;
+    if(new_capacity != this->capacity()) this->resize_storage(new_capacity);
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::reserve_exact(s64 count) {
+    assert(count >= 0);
+    if(this->count + count > this->capacity()) this->resize_storage(this->count + count);
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::add(T const &data) {
+    this->maybe_grow();
+    new (&this->get_data()[this->count]) T(data);
+    ++this->count;
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::add(T &&data) {
+    this->maybe_grow();
+    new (&this->get_data()[this->count]) T((T &&) data);
+    ++this->count;
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::add_many(T const *data, s64 count) {
+    if(count <= 0) return;
+
+    this->reserve(count);
+    
+    T *destination = this->get_data() + this->count;
+    if(Is_Trivially_Relocatable<T>::value) {
+        memcpy(destination, data, count * sizeof(T));
+    } else {
+        for(s64 i = 0; i < count; ++i) new (&destination[i]) T(data[i]);
     }
 
-    return previous;
+    this->count += count;
 }
 
-template<typename T, s64 block_capacity>
-typename Resizable_Block_Array<T, block_capacity>::Block *Resizable_Block_Array<T, block_capacity>::find_block(s64 index, s64 *index_in_block) {
-    s64 block_index = index / block_capacity;
-    *index_in_block = index - block_index * block_capacity;
+template<typename T, s64 N>
+void Small_Array<T, N>::add_all(Small_Array<T, N> &src) {
+    this->add_many(src.get_data(), src.count);
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::insert(s64 index, T const &data) {
+    assert(index >= 0 && index <= this->count);
+    this->maybe_grow();
+    T *entries = this->get_data();
+    if(index < this->count) relocate_entries(&entries[index + 1], &entries[index], this->count - index);
+    new (&entries[index]) T(data);
+    ++this->count;
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::remove(s64 index) {
+    assert(index >= 0 && index < this->count);
+    T *entries = this->get_data();
+    destroy_entries(&entries[index], 1);
+    relocate_entries(&entries[index], &entries[index + 1], this->count - index - 1);
+    --this->count;
+    this->maybe_shrink();
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::remove_range(s64 first_to_remove, s64 last_to_remove) {
+    assert(first_to_remove >= 0 && first_to_remove < this->count);
+    assert(last_to_remove >= 0 && last_to_remove < this->count);
+    assert(last_to_remove >= first_to_remove);
+    T *entries = this->get_data();
+    destroy_entries(&entries[first_to_remove], last_to_remove - first_to_remove + 1);
+    relocate_entries(&entries[first_to_remove], &entries[last_to_remove + 1], this->count - last_to_remove - 1);
+    this->count -= (last_to_remove - first_to_remove) + 1;
+    this->maybe_shrink();
+}
 
-    Block *block = this->first;
-    while(block_index > 0) {
-        block = block->next;
-        --block_index;
+template<typename T, s64 N>
+void Small_Array<T, N>::swap_remove(s64 index) {
+    assert(index >= 0 && index < this->count);
+    T *entries = this->get_data();
+    if(index != this->count - 1) entries[index] = (T &&) entries[this->count - 1];
+    destroy_entries(&entries[this->count - 1], 1);
+    --this->count;
+    this->maybe_shrink();
+}
+
+template<typename T, s64 N>
+template<typename Predicate>
+s64 Small_Array<T, N>::remove_if(Predicate predicate) {
+    T *entries = this->get_data();
+    s64 kept = 0;
+
+    for(s64 i = 0; i < this->count; ++i) {
+        if(predicate(&entries[i])) continue;
+        if(kept != i) entries[kept] = (T &&) entries[i];
+        ++kept;
     }
-    
-    return block;
+
+    destroy_entries(&entries[kept], this->count - kept);
+    s64 removed = this->count - kept;
+    this->count = kept;
+    if(removed) this->maybe_shrink();
+    return removed;
 }
 
-template<typename T, s64 block_capacity>
-void Resizable_Block_Array<T, block_capacity>::move_entries(Block *src_block, s64 src_index_in_block, s64 dst_index_in_block) {
-    if(dst_index_in_block > src_index_in_block) {
-        if(src_block->next) this->move_entries(src_block->next, src_index_in_block, dst_index_in_block);
-
-        s64 entries_in_block              = this->calculate_block_entry_count(src_block);
-        s64 entries_moved_in_block        = dst_index_in_block - src_index_in_block;
-        s64 entries_staying_in_this_block = block_capacity - dst_index_in_block;
-        
-        b8 needs_to_move_stuff_to_next_block = src_block->next != null || dst_index_in_block + entries_moved_in_block > block_capacity; // We can maybe save us moving stuff to the next block if we are the very last, and the moved data still fits into this block.
-        if(needs_to_move_stuff_to_next_block) {
-            if(src_block->next == null) this->maybe_grow(true);
-
-            s64 entries_moving_to_next_block = entries_in_block - entries_staying_in_this_block;
-            Block *dst_block = src_block->next;
-            memmove(&dst_block->data[0], &src_block->data[entries_staying_in_this_block], entries_moving_to_next_block * sizeof(T));
-        }
-        
-        memmove(&src_block->data[dst_index_in_block], &src_block->data[src_index_in_block], entries_staying_in_this_block * sizeof(T));
-    } else if(dst_index_in_block < src_index_in_block) {
-        s64 entries_coming_from_this_block = block_capacity - src_index_in_block;
-        
-        memmove(&src_block->data[dst_index_in_block], &src_block->data[src_index_in_block], entries_coming_from_this_block * sizeof(T));
-
-        b8 needs_to_take_stuff_from_next_block = src_block->next != null;
-        if(needs_to_take_stuff_from_next_block) {
-            s64 entries_coming_from_next_block = src_index_in_block - dst_index_in_block;
-            Block *dst_block = src_block->next;
-            memmove(&src_block->data[dst_index_in_block + entries_coming_from_this_block], &dst_block->data[0], entries_coming_from_next_block * sizeof(T));
-        }
-        
-        if(src_block->next) this->move_entries(src_block->next, src_index_in_block, dst_index_in_block);
+template<typename T, s64 N>
+void Small_Array<T, N>::remove_value(T const &value) {
+    s64 index = this->index_of(value);
+    if(index != -1) this->remove(index);
+}
+
+template<typename T, s64 N>
+void Small_Array<T, N>::remove_value_pointer(T *pointer) {
+    T *entries = this->get_data();
+    if(pointer >= entries && pointer < entries + this->count) this->remove(pointer - entries);
+}
+
+template<typename T, s64 N>
+s64 Small_Array<T, N>::index_of(T const &value) {
+    T *entries = this->get_data();
+    for(s64 i = 0; i < this->count; ++i) {
+        if(entries[i] == value) return i;
     }
+
+    return -1;
+}
+
+template<typename T, s64 N>
+b8 Small_Array<T, N>::contains(T const &value) {
+    return this->index_of(value) != -1;
+}
+
+template<typename T, s64 N>
+T *Small_Array<T, N>::push() {
+    this->maybe_grow();
+    T *pointer = new (&this->get_data()[this->count]) T();
+    ++this->count;
+    return pointer;
+}
+
+template<typename T, s64 N>
+T Small_Array<T, N>::pop() {
+    assert(this->count > 0);
+    T value = (T &&) this->get_data()[this->count - 1];
+    destroy_entries(&this->get_data()[this->count - 1], 1);
+    --this->count;
+    this->maybe_shrink();
+    return value;
+}
+
+template<typename T, s64 N>
+T Small_Array<T, N>::pop_first() {
+    assert(this->count > 0);
+    T value = (T &&) this->get_data()[0];
+    this->remove(0);
+    return value;
+}
+
+template<typename T, s64 N>
+Small_Array<T, N> Small_Array<T, N>::copy(Allocator *allocator) {
+    Small_Array<T, N> result;
+    result.allocator = allocator;
+    result.reserve_exact(this->count);
+    result.add_many(this->get_data(), this->count);
+    return result;
+}
+
+template<typename T, s64 N>
+T &Small_Array<T, N>::operator[](s64 index) {
+    assert(index >= 0 && index < this->count);
+    return this->get_data()[index];
+}
+
+
+
+/* ------------------------------------------ Resizable Block Array ------------------------------------------ */
+
+template<typename T, s64 block_capacity>
+s64 Resizable_Block_Array<T, block_capacity>::calculate_block_entry_count(s64 block_index) {
+    return MIN(this->count - block_index * block_capacity, block_capacity);
 }
 
 template<typename T, s64 block_capacity>
-void Resizable_Block_Array<T, block_capacity>::maybe_grow(b8 force) {
-    if(!this->first) {
-        Block *block = (Block *) this->allocator->allocate(sizeof(Block));
-        block->next  = null;
+void Resizable_Block_Array<T, block_capacity>::maybe_grow() {
+    if(this->count < this->block_count * block_capacity) return;
 
-        this->first = this->last = block;
-        ++this->block_count;
-    } else if(force || this->count % block_capacity == 0) {
-        Block *block = (Block *) this->allocator->allocate(sizeof(Block));
-        block->next  = null;
+    if(this->block_count == this->block_directory_count) {
+        this->block_directory_count = this->block_directory_count ? this->block_directory_count * 2 : 8;
 
-        this->last->next = block;
-        this->last = block;
-        ++this->block_count;
+        if(this->allocator->_reallocate_procedure) {
+            this->blocks = (Block **) this->allocator->reallocate(this->blocks, this->block_directory_count * sizeof(Block *));
+        } else {
+            // Same as in Resizable_Array::reallocate_data, not every allocator can reallocate (e.g. Memory Arenas).
+            Block **new_blocks = (Block **) this->allocator->allocate(this->block_directory_count * sizeof(Block *));
+            if(this->block_count) memcpy(new_blocks, this->blocks, this->block_count * sizeof(Block *));
+            if(this->allocator->_deallocate_procedure) this->allocator->deallocate(this->blocks);
+            this->blocks = new_blocks;
+        }
     }
+
+    this->blocks[this->block_count] = (Block *) this->allocator->allocate(sizeof(Block));
+    ++this->block_count;
 }
 
 template<typename T, s64 block_capacity>
 void Resizable_Block_Array<T, block_capacity>::maybe_shrink() {
-    if(this->last == null) return;
-
-    while(this->count - (this->block_count - 1) * block_capacity == 0) {
-        Block *previous_to_last = this->find_previous_to_block(this->last);
-
-        Block *block_to_free = this->last;
-        this->allocator->deallocate(block_to_free);
+    // The directory itself never shrinks, since it is tiny compared to the blocks.
+    while(this->block_count > 0 && this->count <= (this->block_count - 1) * block_capacity) {
         --this->block_count;
-
-        previous_to_last->next = null;
-        this->last = previous_to_last;
+        this->allocator->deallocate(this->blocks[this->block_count]);
+        this->blocks[this->block_count] = null;
     }
 }
 
 template<typename T, s64 block_capacity>
 void Resizable_Block_Array<T, block_capacity>::clear() {
-    Block *block = this->first;
-    while(block) {
-        Block *next = block->next;
-        this->allocator->deallocate(block);
-        block = next;
-    }
+    for(s64 i = 0; i < this->block_count; ++i) this->allocator->deallocate(this->blocks[i]);
+    if(this->blocks) this->allocator->deallocate(this->blocks);
 
-    this->count = 0;
-    this->first = null;
-    this->last  = null;
+    this->blocks                = null;
+    this->block_count           = 0;
+    this->block_directory_count = 0;
+    this->count                 = 0;
 }
 
 template<typename T, s64 block_capacity>
 void Resizable_Block_Array<T, block_capacity>::clear_without_deallocation() {
-    this->first = null;
-    this->last  = null;
-    this->count = 0;
+    this->blocks                = null;
+    this->block_count           = 0;
+    this->block_directory_count = 0;
+    this->count                 = 0;
 }
 
 template<typename T, s64 block_capacity>
 void Resizable_Block_Array<T, block_capacity>::add(T const &data) {
     this->maybe_grow();
-
-    s64 index_in_block;
-    Block *block = this->find_block(this->count, &index_in_block);
-    block->data[index_in_block] = data;
-
+    this->blocks[(u64) this->count / block_capacity]->data[(u64) this->count % block_capacity] = data;
     ++this->count;
 }
 
@@ -350,11 +586,26 @@ template<typename T, s64 block_capacity>
 void Resizable_Block_Array<T, block_capacity>::insert(s64 index, T const &data) {
     assert(index >= 0 && index <= this->count);
 
-    s64 index_in_block;
-    Block *block = this->find_block(index, &index_in_block);
+    this->maybe_grow();
 
-    this->move_entries(block, index_in_block, index_in_block + 1);
+    s64 first_block    = (u64) index / block_capacity;
+    s64 index_in_block = (u64) index % block_capacity;
+    s64 last_block     = (u64) this->count / block_capacity; // The block which receives the new last entry.
+
+    //
+    // Shift every block after the insertion point one entry to the right, carrying over the last entry of
+    // the previous block.
+    //
+    for(s64 i = last_block; i > first_block; --i) {
+        Block *block = this->blocks[i];
+        s64 entries_to_move = MIN(this->calculate_block_entry_count(i), block_capacity - 1);
+        memmove(&block->data[1], &block->data[0], entries_to_move * sizeof(T));
+        block->data[0] = this->blocks[i - 1]->data[block_capacity - 1];
+    }
 
+    Block *block = this->blocks[first_block];
+    s64 entries_to_move = MIN(this->calculate_block_entry_count(first_block), block_capacity - 1) - index_in_block;
+    if(entries_to_move > 0) memmove(&block->data[index_in_block + 1], &block->data[index_in_block], entries_to_move * sizeof(T));
     block->data[index_in_block] = data;
 
     ++this->count;
@@ -364,12 +615,23 @@ template<typename T, s64 block_capacity>
 void Resizable_Block_Array<T, block_capacity>::remove(s64 index) {
     assert(index >= 0 && index < this->count);
 
-    s64 index_in_block;
-    Block *block = this->find_block(index, &index_in_block);
+    s64 first_block    = (u64) index / block_capacity;
+    s64 index_in_block = (u64) index % block_capacity;
+    s64 last_block     = (u64) (this->count - 1) / block_capacity;
+
+    //
+    // Shift every block from the removal point one entry to the left, carrying over the first entry of the
+    // next block.
+    //
+    for(s64 i = first_block; i <= last_block; ++i) {
+        Block *block = this->blocks[i];
+        s64 start = i == first_block ? index_in_block : 0;
+        s64 entries_to_move = this->calculate_block_entry_count(i) - 1 - start;
+        if(entries_to_move > 0) memmove(&block->data[start], &block->data[start + 1], entries_to_move * sizeof(T));
+        if(i < last_block) block->data[block_capacity - 1] = this->blocks[i + 1]->data[0];
+    }
 
-    this->move_entries(block, index_in_block + 1, index_in_block);
     --this->count;
-
     this->maybe_shrink();
 }
 
@@ -392,11 +654,10 @@ void Resizable_Block_Array<T, block_capacity>::remove_value(T const &value) {
 
 template<typename T, s64 block_capacity>
 void Resizable_Block_Array<T, block_capacity>::remove_value_pointer(T *pointer) {
-    for(s64 i = 0; i < this->count; ++i) {
-        s64 index_in_block;
-        Block *block = this->find_block(this->count, &index_in_block);
-        if(&block->data[index_in_block] == pointer) {
-            this->remove(i);
+    for(s64 i = 0; i < this->block_count; ++i) {
+        T *data = this->blocks[i]->data;
+        if(pointer >= data && pointer < data + this->calculate_block_entry_count(i)) {
+            this->remove(i * block_capacity + (pointer - data));
             break;
         }
     }
@@ -404,11 +665,12 @@ void Resizable_Block_Array<T, block_capacity>::remove_value_pointer(T *pointer)
 
 template<typename T, s64 block_capacity>
 b8 Resizable_Block_Array<T, block_capacity>::contains(T const &value) {
-    for(s64 i = 0; i < this->count; ++i) {
-        s64 index_in_block;
-        Block *block = this->find_block(this->count, &index_in_block);
-        if(block->data[index_in_block] == value) {
-            return true;
+    for(s64 i = 0; i < this->block_count; ++i) {
+        T *data = this->blocks[i]->data;
+        s64 entry_count = this->calculate_block_entry_count(i);
+
+        for(s64 j = 0; j < entry_count; ++j) {
+            if(data[j] == value) return true;
         }
     }
 
@@ -438,41 +700,70 @@ Resizable_Block_Array<T, block_capacity> Resizable_Block_Array<T, block_capacity
     Resizable_Block_Array<T, block_capacity> copy{};
     copy.allocator = this->allocator;
 
-    Block *my_block = this->first;
-    while(my_block) {
-        copy.maybe_grow(true);
-        Block *other_block = copy.last;
+    if(this->block_count > 0) {
+        copy.block_count           = this->block_count;
+        copy.block_directory_count = this->block_count;
+        copy.blocks = (Block **) copy.allocator->allocate(copy.block_directory_count * sizeof(Block *));
 
-        s64 count = this->calculate_block_entry_count(my_block);
-        memcpy(other_block->data, my_block->data, count * sizeof(T));
-        copy.count += count;
-        
-        my_block = my_block->next;
+        for(s64 i = 0; i < this->block_count; ++i) {
+            copy.blocks[i] = (Block *) copy.allocator->allocate(sizeof(Block));
+            memcpy(copy.blocks[i]->data, this->blocks[i]->data, this->calculate_block_entry_count(i) * sizeof(T));
+        }
     }
-    
+
+    copy.count = this->count;
     return copy;
 }
 
+template<typename T, s64 block_capacity>
+template<typename Procedure>
+void Resizable_Block_Array<T, block_capacity>::iterate(Procedure procedure) {
+    s64 full_blocks = (u64) this->count / block_capacity;
+
+    for(s64 i = 0; i < full_blocks; ++i) {
+        T *data = this->blocks[i]->data;
+        for(s64 j = 0; j < block_capacity; ++j) procedure(&data[j]);
+    }
+
+    s64 remaining = (u64) this->count % block_capacity;
+    if(remaining) {
+        T *data = this->blocks[full_blocks]->data;
+        for(s64 j = 0; j < remaining; ++j) procedure(&data[j]);
+    }
+}
+
 template<typename T, s64 block_capacity>
 T &Resizable_Block_Array<T, block_capacity>::operator[](s64 index) {
     assert(index >= 0 && index < this->count);
-    s64 index_in_block;
-    Block *block = this->find_block(index, &index_in_block);
-    return block->data[index_in_block];
+    return this->blocks[(u64) index / block_capacity]->data[(u64) index % block_capacity];
 }
 
 
-
 /* ----------------------------------------------- Linked List ----------------------------------------------- */
 
 template<typename T>
 Linked_List_Node<T> *Linked_List<T>::make_node(T const &value) {
-    Linked_List_Node<T> *node = (Linked_List_Node<T> *) this->allocator->allocate(sizeof(Linked_List_Node<T>));
+    Linked_List_Node<T> *node;
+
+    if(this->free_nodes) {
+        node = this->free_nodes;
+        this->free_nodes = node->next;
+    } else {
+        node = (Linked_List_Node<T> *) this->allocator->allocate(sizeof(Linked_List_Node<T>));
+    }
+
+    node->previous = null;
     node->next = null;
     node->data = value;
     return node;
 }
 
+template<typename T>
+void Linked_List<T>::free_node(Linked_List_Node<T> *node) {
+    node->next = this->free_nodes;
+    this->free_nodes = node;
+}
+
 template<typename T>
 void Linked_List<T>::clear() {
     Linked_List_Node<T> *node = this->head;
@@ -483,8 +774,17 @@ void Linked_List<T>::clear() {
         node = next;
     }
 
+    node = this->free_nodes;
+
+    while(node) {
+        auto next = node->next;
+        this->allocator->deallocate(node);
+        node = next;
+    }
+
     this->head = null;
     this->tail = null;
+    this->free_nodes = null;
     this->count = 0;
 }
 
@@ -493,6 +793,7 @@ void Linked_List<T>::add(T const &value) {
     Linked_List_Node<T> *node = this->make_node(value);
 		
     if(this->head) {
+        node->previous = this->tail;
         this->tail->next = node;
         this->tail = node;
     } else {
@@ -509,6 +810,7 @@ void Linked_List<T>::add_first(T const &value) {
 		
     if(this->head) {
         node->next = this->head;
+        this->head->previous = node;
         this->head = node;
     } else {
         this->head = node;
@@ -522,23 +824,21 @@ template<typename T>
 void Linked_List<T>::remove_node(Linked_List_Node<T> *node) {
     if(!node) return;
 
-    if(node != this->head) {
-        Linked_List_Node<T> *previous = this->head;
-
-        while(previous && previous->next != node) {
-            previous = previous->next;
-        }
-
-        assert(previous != null);
-        previous->next = node->next;
-
-        if(this->tail == node) this->tail = previous;
+    if(node->previous) {
+        node->previous->next = node->next;
     } else {
-        this->head = this->head->next;
+        assert(this->head == node);
+        this->head = node->next;
     }
 
-    this->allocator->deallocate(node);
+    if(node->next) {
+        node->next->previous = node->previous;
+    } else {
+        assert(this->tail == node);
+        this->tail = node->previous;
+    }
 
+    this->free_node(node);
     
     --this->count;
 }
@@ -556,27 +856,14 @@ void Linked_List<T>::remove_value(T const &value) {
 
 template<typename T>
 void Linked_List<T>::remove_value_pointer(T *value_pointer) {
-    Linked_List_Node<T> *node = this->head;
-
-    while(node && &node->data != value_pointer) {
-        node = node->next;
-    }
-
-    this->remove_node(node);
+    // The data is the first member of the node.
+    this->remove_node((Linked_List_Node<T> *) value_pointer);
 }
 
 template<typename T>
 void Linked_List<T>::remove(s64 index) {
     assert(index >= 0 && index < this->count);
-		
-    Linked_List_Node<T> *node = this->head;
-
-    while(index > 0) {
-        node = node->next;
-        --index;
-    }
-
-    this->remove_node(node);
+    this->remove_value_pointer(&(*this)[index]);
 }
 
 template<typename T>
@@ -609,7 +896,7 @@ T Linked_List<T>::pop() {
 template<typename T>
 T Linked_List<T>::pop_first() {
     assert(this->count > 0);
-    T value = this->head->value;
+    T value = this->head->data;
     this->remove_node(this->head);
     return value;
 }
@@ -618,12 +905,140 @@ template<typename T>
 T &Linked_List<T>::operator[](s64 index) {
     assert(index >= 0 && index < this->count);
 
-    Linked_List_Node<T> *node = this->head;
+    Linked_List_Node<T> *node;
 
-    while(index > 0) {
-        node = node->next;
-        --index;
+    // Walk from whichever end is closer.
+    if(index < this->count / 2) {
+        node = this->head;
+
+        while(index > 0) {
+            node = node->next;
+            --index;
+        }
+    } else {
+        node = this->tail;
+
+        while(index < this->count - 1) {
+            node = node->previous;
+            ++index;
+        }
     }
 
     return node->data;
 }
+
+
+
+/* --------------------------------------------- Intrusive List --------------------------------------------- */
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+void Intrusive_List<T, Link>::clear() {
+    T *entry = this->head;
+
+    while(entry) {
+        T *next = (entry->*Link).next;
+        (entry->*Link).previous = null;
+        (entry->*Link).next     = null;
+        entry = next;
+    }
+
+    this->head  = null;
+    this->tail  = null;
+    this->count = 0;
+}
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+void Intrusive_List<T, Link>::add(T *entry) {
+    Intrusive_List_Link<T> *link = &(entry->*Link);
+    link->previous = this->tail;
+    link->next     = null;
+
+    if(this->tail) {
+        (this->tail->*Link).next = entry;
+    } else {
+        this->head = entry;
+    }
+
+    this->tail = entry;
+    ++this->count;
+}
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+void Intrusive_List<T, Link>::add_first(T *entry) {
+    Intrusive_List_Link<T> *link = &(entry->*Link);
+    link->previous = null;
+    link->next     = this->head;
+
+    if(this->head) {
+        (this->head->*Link).previous = entry;
+    } else {
+        this->tail = entry;
+    }
+
+    this->head = entry;
+    ++this->count;
+}
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+void Intrusive_List<T, Link>::insert_after(T *position, T *entry) {
+    if(!position || position == this->tail) {
+        if(position) this->add(entry); else this->add_first(entry);
+        return;
+    }
+
+    Intrusive_List_Link<T> *position_link = &(position->*Link);
+    Intrusive_List_Link<T> *link = &(entry->*Link);
+    link->previous = position;
+    link->next     = position_link->next;
+    (position_link->next->*Link).previous = entry;
+    position_link->next = entry;
+    ++this->count;
+}
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+void Intrusive_List<T, Link>::remove(T *entry) {
+    Intrusive_List_Link<T> *link = &(entry->*Link);
+
+    if(link->previous) {
+        (link->previous->*Link).next = link->next;
+    } else {
+        assert(this->head == entry, "Tried to remove an entry which is not part of this list.");
+        this->head = link->next;
+    }
+
+    if(link->next) {
+        (link->next->*Link).previous = link->previous;
+    } else {
+        assert(this->tail == entry, "Tried to remove an entry which is not part of this list.");
+        this->tail = link->previous;
+    }
+
+    link->previous = null;
+    link->next     = null;
+    --this->count;
+}
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+b8 Intrusive_List<T, Link>::contains(T *entry) {
+    for(T *it = this->head; it; it = (it->*Link).next) {
+        if(it == entry) return true;
+    }
+
+    return false;
+}
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+T *Intrusive_List<T, Link>::pop() {
+    assert(this->count > 0);
+    T *entry = this->tail;
+    this->remove(entry);
+    return entry;
+}
+
+template<typename T, Intrusive_List_Link<T> T::*Link>
+T *Intrusive_List<T, Link>::pop_first() {
+    assert(this->count > 0);
+    T *entry = this->head;
+    this->remove(entry);
+    return entry;
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "foundation.h"
+#include "memutils.h"
+#include "string_type.h"
+
+//
+// Two ordered maps for when a hash table is not enough, because entries need to be visited in key order or
+// looked up by range:
+//   The Flat_Map keeps its keys and values in two sorted Resizable_Arrays. A lookup is a branchless binary
+//   search over the keys only, which compiles down to conditional moves and a predictable loop, and the
+//   whole map is just two contiguous blocks of memory. Inserting or removing shifts the tail of the arrays,
+//   so this is meant for small or read-mostly maps (inserting keys in ascending order is just an append).
+//   The BTree_Map is a B+ tree whose nodes are sized to a few cache lines. All entries live in the leaves,
+//   which are linked to their neighbours, so that range scans just walk along the leaf chain. Inner nodes
+//   only store the separator keys and child pointers, so that a lookup touches very few cache lines per
+//   level. Inserting and removing is O(log n).
+//   Neither map keeps value pointers stable across modifications: The Flat_Map shifts (and may reallocate) its
+//   arrays, and the BTree_Map moves entries around when nodes get split or merged.
+//
+// Keys are compared through Ordered_Key<K>::less, which defaults to operator<. Strings are compared byte-wise
+// (like memcmp), with a shorter string being smaller than a longer one it is a prefix of.
+//
+
+#define BTREE_NODE_SIZE 256 // The number of bytes reserved for the keys in each node, i.e. four cache lines.
+
+template<typename K>
+struct Ordered_Key {
+    static b8 less(K const &lhs, K const &rhs) { return lhs < rhs; }
+};
+
+template<>
+struct Ordered_Key<string> {
+    static b8 less(string const &lhs, string const &rhs) {
+        // Empty strings may have a null data pointer, which must not be passed to memcmp even with a zero length.
+        s64 shorter = MIN(lhs.count, rhs.count);
+        int result  = shorter > 0 ? memcmp(lhs.data, rhs.data, shorter) : 0;
+        return result < 0 || (result == 0 && lhs.count < rhs.count);
+    }
+};
+
+template<typename K, typename V>
+struct Ordered_Map_Pair {
+    K *key;
+    V *value;
+};
+
+
+
+/* ------------------------------------------------- Flat Map ------------------------------------------------- */
+
+template<typename K, typename V, typename Compare = Ordered_Key<K>>
+struct Flat_Map {
+    typedef Ordered_Map_Pair<K, V> Pair;
+
+    struct Iterator {
+        Flat_Map *map;
+        s64 index;
+
+        b8 operator==(Iterator const &it) const { return this->index == it.index; }
+        b8 operator!=(Iterator const &it) const { return this->index != it.index; }
+        Iterator &operator++() { ++this->index; return *this; }
+
+        Pair operator*() { return { &this->map->keys[this->index], &this->map->values[this->index] }; }
+    };
+
+    Allocator *allocator = Default_Allocator;
+    s64 count = 0;
+
+    Resizable_Array<K> keys; // Sorted in ascending order.
+    Resizable_Array<V> values; // values[i] belongs to keys[i].
+
+    void create(Allocator *allocator = Default_Allocator, s64 initial_capacity = 0);
+    void destroy();
+    void clear();
+
+    b8 add(K const &key, V const &value); // Returns false if the key already exists, in which case the existing value is left untouched.
+    V *push(K const &key); // Returns the value for this key, inserting a default-constructed value if the key does not exist yet.
+    V *query(K const &key);
+    b8 remove(K const &key); // Returns false if the key did not exist.
+
+    s64 lower_bound(K const &key); // Returns the index of the first key not smaller than the given one, or count if there is none.
+    s64 upper_bound(K const &key); // Returns the index of the first key bigger than the given one, or count if there is none.
+
+    // The procedure gets called as procedure(K *key, V *value) for each entry in ascending key order.
+    template<typename Procedure> void iterate(Procedure procedure);
+    template<typename Procedure> void iterate_range(K const &min, K const &max, Procedure procedure); // Both bounds are inclusive.
+
+    Iterator begin() { return { this, 0 }; }
+    Iterator end() { return { this, this->count }; }
+};
+
+
+
+/* ------------------------------------------------- BTree Map ------------------------------------------------- */
+
+template<typename K, typename V>
+struct BTree_Node {
+    // Always keep a reasonable fan-out, even if a single key is already bigger than the node size.
+    static const s64 CAPACITY  = sizeof(K) * 8 <= BTREE_NODE_SIZE ? BTREE_NODE_SIZE / sizeof(K) : 8;
+    static const s64 MIN_COUNT = CAPACITY / 2; // Every node except the root holds at least this many keys.
+
+    b8 leaf;
+    s64 count; // The number of keys in this node.
+    K keys[CAPACITY];
+};
+
+template<typename K, typename V>
+struct BTree_Inner_Node : BTree_Node<K, V> {
+    // children[i] holds all keys smaller than keys[i], children[count] all keys not smaller than keys[count - 1].
+    BTree_Node<K, V> *children[BTree_Node<K, V>::CAPACITY + 1];
+};
+
+template<typename K, typename V>
+struct BTree_Leaf : BTree_Node<K, V> {
+    V values[BTree_Node<K, V>::CAPACITY];
+    BTree_Leaf *previous;
+    BTree_Leaf *next;
+};
+
+template<typename K, typename V, typename Compare = Ordered_Key<K>>
+struct BTree_Map {
+    typedef BTree_Node<K, V> Node;
+    typedef BTree_Inner_Node<K, V> Inner_Node;
+    typedef BTree_Leaf<K, V> Leaf;
+    typedef Ordered_Map_Pair<K, V> Pair;
+
+    static const s64 CAPACITY  = Node::CAPACITY;
+    static const s64 MIN_COUNT = Node::MIN_COUNT;
+
+    struct Iterator {
+        Leaf *leaf; // Null for the end iterator.
+        s64 index;
+
+        b8 operator==(Iterator const &it) const { return this->leaf == it.leaf && this->index == it.index; }
+        b8 operator!=(Iterator const &it) const { return this->leaf != it.leaf || this->index != it.index; }
+        Iterator &operator++();
+
+        Pair operator*() { return { &this->leaf->keys[this->index], &this->leaf->values[this->index] }; }
+    };
+
+    struct Split {
+        Node *right; // Null if the node did not need to be split.
+        K separator; // The smallest key in the right subtree.
+    };
+
+    Allocator *allocator = Default_Allocator;
+    Node *root  = null;
+    Leaf *first = null; // The leftmost leaf, where in-order iteration starts.
+    Leaf *last  = null; // The rightmost leaf.
+    s64 count   = 0;
+
+    void create(Allocator *allocator = Default_Allocator);
+    void destroy();
+    void clear();
+
+    b8 add(K const &key, V const &value); // Returns false if the key already exists, in which case the existing value is left untouched.
+    V *push(K const &key); // Returns the value for this key, inserting a default-constructed value if the key does not exist yet.
+    V *query(K const &key);
+    b8 remove(K const &key); // Returns false if the key did not exist.
+
+    Iterator lower_bound(K const &key); // Returns the first entry whose key is not smaller than the given one, or end().
+    Iterator upper_bound(K const &key); // Returns the first entry whose key is bigger than the given one, or end().
+
+    // The procedure gets called as procedure(K *key, V *value) for each entry in ascending key order.
+    template<typename Procedure> void iterate(Procedure procedure);
+    template<typename Procedure> void iterate_range(K const &min, K const &max, Procedure procedure); // Both bounds are inclusive.
+
+    Iterator begin() { return this->count ? Iterator{ this->first, 0 } : this->end(); }
+    Iterator end() { return { null, 0 }; }
+
+    Leaf *make_leaf();
+    Inner_Node *make_inner_node();
+    void free_recursive(Node *node);
+
+    Leaf *find_leaf(K const &key);
+    V *insert(K const &key, b8 *inserted);
+    Split insert_recursive(Node *node, K const &key, V **value, b8 *inserted);
+    b8 remove_recursive(Node *node, K const &key);
+    void rebalance_child(Inner_Node *parent, s64 child_index);
+};
+
+// Because C++ is a terrible language, we need to supply the template definitions in the header file for
+// instantiation to work correctly... This feels horrible but still better than just inlining the code I guess.
+#include "ordered_map.inl"
@@ -0,0 +1,587 @@
+/* ---------------------------------------------- Binary Search ---------------------------------------------- */
+
+//
+// Branchless binary searches: Instead of stopping early when the key is found, the search range is halved
+// exactly log2(count) times, and the only decision per step is whether the base moves forward. Compilers
+// turn that into a conditional move, so there are no mispredicted branches, and the number of iterations
+// only depends on the count.
+//
+
+template<typename K, typename Compare>
+static inline
+s64 ordered_lower_bound(K const *keys, s64 count, K const &key) {
+    if(count == 0) return 0;
+
+    K const *base = keys;
+    while(count > 1) {
+        s64 half = count / 2;
+        base = Compare::less(base[half], key) ? base + half : base;
+        count -= half;
+    }
+
+    return (base - keys) + Compare::less(*base, key);
+}
+
+template<typename K, typename Compare>
+static inline
+s64 ordered_upper_bound(K const *keys, s64 count, K const &key) {
+    if(count == 0) return 0;
+
+    K const *base = keys;
+    while(count > 1) {
+        s64 half = count / 2;
+        base = !Compare::less(key, base[half]) ? base + half : base;
+        count -= half;
+    }
+
+    return (base - keys) + !Compare::less(key, *base);
+}
+
+
+
+/* ------------------------------------------------- Flat Map ------------------------------------------------- */
+
+template<typename K, typename V, typename Compare>
+void Flat_Map<K, V, Compare>::create(Allocator *allocator, s64 initial_capacity) {
+    this->allocator = allocator;
+    this->count     = 0;
+
+    this->keys.allocator   = allocator;
+    this->values.allocator = allocator;
+
+    if(initial_capacity > 0) {
+        this->keys.reserve_exact(initial_capacity);
+        this->values.reserve_exact(initial_capacity);
+    }
+}
+
+template<typename K, typename V, typename Compare>
+void Flat_Map<K, V, Compare>::destroy() {
+    this->keys.clear();
+    this->values.clear();
+    this->count = 0;
+}
+
+template<typename K, typename V, typename Compare>
+void Flat_Map<K, V, Compare>::clear() {
+    this->keys.count   = 0;
+    this->values.count = 0;
+    this->count = 0;
+}
+
+template<typename K, typename V, typename Compare>
+b8 Flat_Map<K, V, Compare>::add(K const &key, V const &value) {
+    s64 index = this->lower_bound(key);
+    if(index < this->count && !Compare::less(key, this->keys[index])) return false;
+
+    this->keys.insert(index, key);
+    this->values.insert(index, value);
+    ++this->count;
+    return true;
+}
+
+template<typename K, typename V, typename Compare>
+V *Flat_Map<K, V, Compare>::push(K const &key) {
+    s64 index = this->lower_bound(key);
+    if(index < this->count && !Compare::less(key, this->keys[index])) return &this->values[index];
+
+    this->keys.insert(index, key);
+    this->values.insert(index, V());
+    ++this->count;
+    return &this->values[index];
+}
+
+template<typename K, typename V, typename Compare>
+V *Flat_Map<K, V, Compare>::query(K const &key) {
+    s64 index = this->lower_bound(key);
+    if(index < this->count && !Compare::less(key, this->keys[index])) return &this->values[index];
+    return null;
+}
+
+template<typename K, typename V, typename Compare>
+b8 Flat_Map<K, V, Compare>::remove(K const &key) {
+    s64 index = this->lower_bound(key);
+    if(index == this->count || Compare::less(key, this->keys[index])) return false;
+
+    this->keys.remove(index);
+    this->values.remove(index);
+    --this->count;
+    return true;
+}
+
+template<typename K, typename V, typename Compare>
+s64 Flat_Map<K, V, Compare>::lower_bound(K const &key) {
+    return ordered_lower_bound<K, Compare>(this->keys.data, this->count, key);
+}
+
+template<typename K, typename V, typename Compare>
+s64 Flat_Map<K, V, Compare>::upper_bound(K const &key) {
+    return ordered_upper_bound<K, Compare>(this->keys.data, this->count, key);
+}
+
+template<typename K, typename V, typename Compare>
+template<typename Procedure>
+void Flat_Map<K, V, Compare>::iterate(Procedure procedure) {
+    for(s64 i = 0; i < this->count; ++i) {
+        procedure(&this->keys.data[i], &this->values.data[i]);
+    }
+}
+
+template<typename K, typename V, typename Compare>
+template<typename Procedure>
+void Flat_Map<K, V, Compare>::iterate_range(K const &min, K const &max, Procedure procedure) {
+    if(Compare::less(max, min)) return;
+
+    s64 first = this->lower_bound(min);
+    s64 end   = this->upper_bound(max);
+
+    for(s64 i = first; i < end; ++i) {
+        procedure(&this->keys.data[i], &this->values.data[i]);
+    }
+}
+
+
+
+/* ------------------------------------------------- BTree Map ------------------------------------------------- */
+
+template<typename K, typename V, typename Compare>
+typename BTree_Map<K, V, Compare>::Iterator &BTree_Map<K, V, Compare>::Iterator::operator++() {
+    ++this->index;
+
+    if(this->index == this->leaf->count) {
+        // Leaves are never empty (except for an empty root, which never has any entries to iterate over).
+        this->leaf  = this->leaf->next;
+        this->index = 0;
+    }
+
+    return *this;
+}
+
+template<typename K, typename V, typename Compare>
+void BTree_Map<K, V, Compare>::create(Allocator *allocator) {
+    this->allocator = allocator;
+    this->root  = null;
+    this->first = null;
+    this->last  = null;
+    this->count = 0;
+}
+
+template<typename K, typename V, typename Compare>
+void BTree_Map<K, V, Compare>::destroy() {
+    this->clear();
+}
+
+template<typename K, typename V, typename Compare>
+void BTree_Map<K, V, Compare>::clear() {
+    if(this->root) this->free_recursive(this->root);
+    this->root  = null;
+    this->first = null;
+    this->last  = null;
+    this->count = 0;
+}
+
+template<typename K, typename V, typename Compare>
+b8 BTree_Map<K, V, Compare>::add(K const &key, V const &value) {
+    b8 inserted;
+    V *pointer = this->insert(key, &inserted);
+    if(inserted) *pointer = value;
+    return inserted;
+}
+
+template<typename K, typename V, typename Compare>
+V *BTree_Map<K, V, Compare>::push(K const &key) {
+    b8 inserted;
+    return this->insert(key, &inserted);
+}
+
+template<typename K, typename V, typename Compare>
+V *BTree_Map<K, V, Compare>::query(K const &key) {
+    if(!this->root) return null;
+
+    Leaf *leaf = this->find_leaf(key);
+    s64 index = ordered_lower_bound<K, Compare>(leaf->keys, leaf->count, key);
+    if(index < leaf->count && !Compare::less(key, leaf->keys[index])) return &leaf->values[index];
+    return null;
+}
+
+template<typename K, typename V, typename Compare>
+b8 BTree_Map<K, V, Compare>::remove(K const &key) {
+    if(!this->root || !this->remove_recursive(this->root, key)) return false;
+
+    --this->count;
+
+    if(this->root->count == 0) {
+        // Shrink the tree: An inner root with a single child gets replaced by that child, an empty leaf root
+        // gets removed entirely.
+        Node *old_root = this->root;
+
+        if(old_root->leaf) {
+            this->root  = null;
+            this->first = null;
+            this->last  = null;
+        } else {
+            this->root = ((Inner_Node *) old_root)->children[0];
+        }
+
+        this->allocator->deallocate(old_root);
+    }
+
+    return true;
+}
+
+template<typename K, typename V, typename Compare>
+typename BTree_Map<K, V, Compare>::Iterator BTree_Map<K, V, Compare>::lower_bound(K const &key) {
+    if(!this->root) return this->end();
+
+    Leaf *leaf = this->find_leaf(key);
+    s64 index = ordered_lower_bound<K, Compare>(leaf->keys, leaf->count, key);
+
+    // All keys in the next leaf are at least as big as the separator in front of it, which is bigger than the key.
+    if(index == leaf->count) return { leaf->next, 0 };
+    return { leaf, index };
+}
+
+template<typename K, typename V, typename Compare>
+typename BTree_Map<K, V, Compare>::Iterator BTree_Map<K, V, Compare>::upper_bound(K const &key) {
+    if(!this->root) return this->end();
+
+    Leaf *leaf = this->find_leaf(key);
+    s64 index = ordered_upper_bound<K, Compare>(leaf->keys, leaf->count, key);
+
+    if(index == leaf->count) return { leaf->next, 0 };
+    return { leaf, index };
+}
+
+template<typename K, typename V, typename Compare>
+template<typename Procedure>
+void BTree_Map<K, V, Compare>::iterate(Procedure procedure) {
+    for(Leaf *leaf = this->first; leaf != null; leaf = leaf->next) {
+        for(s64 i = 0; i < leaf->count; ++i) {
+            procedure(&leaf->keys[i], &leaf->values[i]);
+        }
+    }
+}
+
+template<typename K, typename V, typename Compare>
+template<typename Procedure>
+void BTree_Map<K, V, Compare>::iterate_range(K const &min, K const &max, Procedure procedure) {
+    if(!this->root || Compare::less(max, min)) return;
+
+    Iterator it = this->lower_bound(min);
+    Leaf *leaf = it.leaf;
+    s64 index  = it.index;
+
+    while(leaf) {
+        for(; index < leaf->count; ++index) {
+            if(Compare::less(max, leaf->keys[index])) return;
+            procedure(&leaf->keys[index], &leaf->values[index]);
+        }
+
+        leaf  = leaf->next;
+        index = 0;
+    }
+}
+
+template<typename K, typename V, typename Compare>
+typename BTree_Map<K, V, Compare>::Leaf *BTree_Map<K, V, Compare>::make_leaf() {
+    Leaf *leaf = (Leaf *) this->allocator->allocate(sizeof(Leaf));
+    leaf->leaf     = true;
+    leaf->count    = 0;
+    leaf->previous = null;
+    leaf->next     = null;
+    return leaf;
+}
+
+template<typename K, typename V, typename Compare>
+typename BTree_Map<K, V, Compare>::Inner_Node *BTree_Map<K, V, Compare>::make_inner_node() {
+    Inner_Node *inner = (Inner_Node *) this->allocator->allocate(sizeof(Inner_Node));
+    inner->leaf  = false;
+    inner->count = 0;
+    return inner;
+}
+
+template<typename K, typename V, typename Compare>
+void BTree_Map<K, V, Compare>::free_recursive(Node *node) {
+    if(!node->leaf) {
+        Inner_Node *inner = (Inner_Node *) node;
+        for(s64 i = 0; i <= inner->count; ++i) this->free_recursive(inner->children[i]);
+    }
+
+    this->allocator->deallocate(node);
+}
+
+template<typename K, typename V, typename Compare>
+typename BTree_Map<K, V, Compare>::Leaf *BTree_Map<K, V, Compare>::find_leaf(K const &key) {
+    Node *node = this->root;
+
+    while(!node->leaf) {
+        Inner_Node *inner = (Inner_Node *) node;
+        node = inner->children[ordered_upper_bound<K, Compare>(inner->keys, inner->count, key)];
+    }
+
+    return (Leaf *) node;
+}
+
+template<typename K, typename V, typename Compare>
+V *BTree_Map<K, V, Compare>::insert(K const &key, b8 *inserted) {
+    if(!this->root) {
+        Leaf *leaf  = this->make_leaf();
+        this->root  = leaf;
+        this->first = leaf;
+        this->last  = leaf;
+    }
+
+    V *value;
+    Split split = this->insert_recursive(this->root, key, &value, inserted);
+
+    if(split.right) {
+        // The root got split, so the tree grows by one level.
+        Inner_Node *new_root  = this->make_inner_node();
+        new_root->count       = 1;
+        new_root->keys[0]     = split.separator;
+        new_root->children[0] = this->root;
+        new_root->children[1] = split.right;
+        this->root = new_root;
+    }
+
+    if(*inserted) ++this->count;
+    return value;
+}
+
+template<typename K, typename V, typename Compare>
+typename BTree_Map<K, V, Compare>::Split BTree_Map<K, V, Compare>::insert_recursive(Node *node, K const &key, V **value, b8 *inserted) {
+    Split split;
+    split.right = null;
+
+    if(node->leaf) {
+        Leaf *leaf = (Leaf *) node;
+        s64 index = ordered_lower_bound<K, Compare>(leaf->keys, leaf->count, key);
+
+        if(index < leaf->count && !Compare::less(key, leaf->keys[index])) {
+            *value    = &leaf->values[index];
+            *inserted = false;
+            return split;
+        }
+
+        if(leaf->count == CAPACITY) {
+            // Move the upper half into a new leaf to its right, then insert into whichever half the key
+            // belongs to.
+            Leaf *right = this->make_leaf();
+            s64 half = CAPACITY / 2;
+
+            for(s64 i = half; i < CAPACITY; ++i) {
+                right->keys[i - half]   = leaf->keys[i];
+                right->values[i - half] = leaf->values[i];
+            }
+
+            right->count = CAPACITY - half;
+            leaf->count  = half;
+
+            right->previous = leaf;
+            right->next     = leaf->next;
+            if(leaf->next) {
+                leaf->next->previous = right;
+            } else {
+                this->last = right;
+            }
+            leaf->next = right;
+
+            split.right = right;
+
+            if(index > half) {
+                leaf   = right;
+                index -= half;
+            }
+        }
+
+        for(s64 i = leaf->count; i > index; --i) {
+            leaf->keys[i]   = leaf->keys[i - 1];
+            leaf->values[i] = leaf->values[i - 1];
+        }
+
+        leaf->keys[index]   = key;
+        leaf->values[index] = V();
+        ++leaf->count;
+
+        *value    = &leaf->values[index];
+        *inserted = true;
+
+        if(split.right) split.separator = split.right->keys[0];
+        return split;
+    }
+
+    Inner_Node *inner = (Inner_Node *) node;
+    s64 child = ordered_upper_bound<K, Compare>(inner->keys, inner->count, key);
+
+    Split child_split = this->insert_recursive(inner->children[child], key, value, inserted);
+    if(!child_split.right) return split;
+
+    if(inner->count < CAPACITY) {
+        for(s64 i = inner->count; i > child; --i) {
+            inner->keys[i]         = inner->keys[i - 1];
+            inner->children[i + 1] = inner->children[i];
+        }
+
+        inner->keys[child]         = child_split.separator;
+        inner->children[child + 1] = child_split.right;
+        ++inner->count;
+        return split;
+    }
+
+    //
+    // The inner node is full, so it needs to be split as well. Assemble all keys and children (including the
+    // new ones) in order, keep the lower half in this node, move the middle key up to the parent as the
+    // separator, and move the upper half into a new node.
+    //
+    K all_keys[CAPACITY + 1];
+    Node *all_children[CAPACITY + 2];
+
+    for(s64 i = 0, j = 0; i <= CAPACITY; ++i) all_keys[i] = (i == child) ? child_split.separator : inner->keys[j++];
+    for(s64 i = 0, j = 0; i <= CAPACITY + 1; ++i) all_children[i] = (i == child + 1) ? child_split.right : inner->children[j++];
+
+    Inner_Node *right = this->make_inner_node();
+    s64 half = CAPACITY / 2;
+
+    inner->count = half;
+    for(s64 i = 0; i < half; ++i) inner->keys[i] = all_keys[i];
+    for(s64 i = 0; i <= half; ++i) inner->children[i] = all_children[i];
+
+    right->count = CAPACITY - half;
+    for(s64 i = 0; i < right->count; ++i) right->keys[i] = all_keys[half + 1 + i];
+    for(s64 i = 0; i <= right->count; ++i) right->children[i] = all_children[half + 1 + i];
+
+    split.right     = right;
+    split.separator = all_keys[half];
+    return split;
+}
+
+template<typename K, typename V, typename Compare>
+b8 BTree_Map<K, V, Compare>::remove_recursive(Node *node, K const &key) {
+    if(node->leaf) {
+        Leaf *leaf = (Leaf *) node;
+        s64 index = ordered_lower_bound<K, Compare>(leaf->keys, leaf->count, key);
+        if(index == leaf->count || Compare::less(key, leaf->keys[index])) return false;
+
+        for(s64 i = index; i < leaf->count - 1; ++i) {
+            leaf->keys[i]   = leaf->keys[i + 1];
+            leaf->values[i] = leaf->values[i + 1];
+        }
+
+        --leaf->count;
+        return true;
+    }
+
+    Inner_Node *inner = (Inner_Node *) node;
+    s64 child = ordered_upper_bound<K, Compare>(inner->keys, inner->count, key);
+
+    if(!this->remove_recursive(inner->children[child], key)) return false;
+
+    if(inner->children[child]->count < MIN_COUNT) this->rebalance_child(inner, child);
+    return true;
+}
+
+template<typename K, typename V, typename Compare>
+void BTree_Map<K, V, Compare>::rebalance_child(Inner_Node *parent, s64 child_index) {
+    //
+    // The child has fallen below the minimum fill. If a direct sibling can spare an entry, borrow it through
+    // the parent. Otherwise the child and a sibling together fit into a single node, so merge them and remove
+    // the separator between them from the parent (which may in turn underflow, and get fixed one level up).
+    //
+    Node *child = parent->children[child_index];
+    Node *left  = child_index > 0 ? parent->children[child_index - 1] : null;
+    Node *right = child_index < parent->count ? parent->children[child_index + 1] : null;
+
+    if(left && left->count > MIN_COUNT) {
+        if(child->leaf) {
+            Leaf *to = (Leaf *) child, *from = (Leaf *) left;
+
+            for(s64 i = to->count; i > 0; --i) {
+                to->keys[i]   = to->keys[i - 1];
+                to->values[i] = to->values[i - 1];
+            }
+
+            to->keys[0]   = from->keys[from->count - 1];
+            to->values[0] = from->values[from->count - 1];
+            parent->keys[child_index - 1] = to->keys[0];
+        } else {
+            Inner_Node *to = (Inner_Node *) child, *from = (Inner_Node *) left;
+
+            for(s64 i = to->count; i > 0; --i) to->keys[i] = to->keys[i - 1];
+            for(s64 i = to->count + 1; i > 0; --i) to->children[i] = to->children[i - 1];
+
+            to->keys[0]     = parent->keys[child_index - 1];
+            to->children[0] = from->children[from->count];
+            parent->keys[child_index - 1] = from->keys[from->count - 1];
+        }
+
+        ++child->count;
+        --left->count;
+        return;
+    }
+
+    if(right && right->count > MIN_COUNT) {
+        if(child->leaf) {
+            Leaf *to = (Leaf *) child, *from = (Leaf *) right;
+
+            to->keys[to->count]   = from->keys[0];
+            to->values[to->count] = from->values[0];
+
+            for(s64 i = 0; i < from->count - 1; ++i) {
+                from->keys[i]   = from->keys[i + 1];
+                from->values[i] = from->values[i + 1];
+            }
+
+            parent->keys[child_index] = from->keys[0];
+        } else {
+            Inner_Node *to = (Inner_Node *) child, *from = (Inner_Node *) right;
+
+            to->keys[to->count]         = parent->keys[child_index];
+            to->children[to->count + 1] = from->children[0];
+            parent->keys[child_index]   = from->keys[0];
+
+            for(s64 i = 0; i < from->count - 1; ++i) from->keys[i] = from->keys[i + 1];
+            for(s64 i = 0; i < from->count; ++i) from->children[i] = from->children[i + 1];
+        }
+
+        ++child->count;
+        --right->count;
+        return;
+    }
+
+    // Merge the right one of the two nodes into the left one.
+    s64 separator_index = left ? child_index - 1 : child_index;
+    Node *into = left ? left : child;
+    Node *from = left ? child : right;
+
+    if(into->leaf) {
+        Leaf *to = (Leaf *) into, *source = (Leaf *) from;
+
+        for(s64 i = 0; i < source->count; ++i) {
+            to->keys[to->count + i]   = source->keys[i];
+            to->values[to->count + i] = source->values[i];
+        }
+
+        to->count += source->count;
+
+        to->next = source->next;
+        if(source->next) {
+            source->next->previous = to;
+        } else {
+            this->last = to;
+        }
+    } else {
+        Inner_Node *to = (Inner_Node *) into, *source = (Inner_Node *) from;
+
+        to->keys[to->count] = parent->keys[separator_index];
+        for(s64 i = 0; i < source->count; ++i) to->keys[to->count + 1 + i] = source->keys[i];
+        for(s64 i = 0; i <= source->count; ++i) to->children[to->count + 1 + i] = source->children[i];
+
+        to->count += 1 + source->count;
+    }
+
+    this->allocator->deallocate(from);
+
+    for(s64 i = separator_index; i < parent->count - 1; ++i) parent->keys[i] = parent->keys[i + 1];
+    for(s64 i = separator_index + 1; i < parent->count; ++i) parent->children[i] = parent->children[i + 1];
+    --parent->count;
+}
@@ -61,6 +61,8 @@ u64 os_get_working_set_size();
 
 string os_read_file(Allocator *allocator, string file_path);
 void os_free_file_content(Allocator *allocator, string *file_content);
+string os_map_file(string file_path); // Maps the file copy-on-write: Writes to the mapping are private and never reach the file. Returns an empty string on failure.
+void os_unmap_file(string *file_content);
 b8 os_write_file(string file_path, string file_content, b8 append);
 b8 os_create_directory(string file_path);
 b8 os_delete_file(string file_path);
@@ -68,6 +70,11 @@ b8 os_delete_directory(string file_path);
 b8 os_file_exists(string file_path);
 b8 os_directory_exists(string file_path);
 
+// For writing a file incrementally. Returns INVALID_FILE_HANDLE if the file could not be opened.
+File_Handle os_open_file_for_writing(string file_path, b8 append);
+b8 os_write_file_chunks(File_Handle file, string *chunks, s64 count); // Writes all chunks in order, with as few system calls as possible.
+void os_close_file(File_Handle file);
+
 struct File_Information {
     b8 valid;
     s64 file_size_in_bytes;
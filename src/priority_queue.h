@@ -0,0 +1,60 @@
+#pragma once
+
+#include "foundation.h"
+#include "memutils.h"
+
+//
+// A d-ary min-heap: pop() always returns the entry with the smallest priority (e.g. the earliest deadline).
+// Compared to a binary heap, a wider heap is shallower, so pushing an entry or decreasing its priority touches
+// fewer levels. All children of a node also lie next to each other in memory, which keeps the scan for the
+// smallest child in sift-down cache friendly. Four children per node is usually the sweet spot.
+//     Every pushed entry gets a stable handle, through which its priority can later be changed or the entry
+// can be removed, without having to search the heap. A handle gets reused once its entry has left the queue.
+// The priority type only needs to support operator<.
+//
+
+typedef s64 Priority_Queue_Handle;
+
+#define INVALID_PRIORITY_QUEUE_HANDLE ((Priority_Queue_Handle) -1)
+#define INVALID_PRIORITY_QUEUE_INDEX  ((s64) -1)
+
+template<typename T, typename P = f64, s64 Arity = 4>
+struct Priority_Queue {
+    static_assert(Arity >= 2, "A heap needs at least two children per node.");
+
+    struct Entry {
+        P priority;
+        Priority_Queue_Handle handle;
+        T value;
+    };
+
+    Allocator *allocator = Default_Allocator;
+    s64 count = 0; // The number of entries currently in the queue.
+
+    Resizable_Array<Entry> heap;
+    Resizable_Array<s64> positions; // Maps a handle to the index of its entry in the heap, or INVALID_PRIORITY_QUEUE_INDEX if the handle is unused.
+    Resizable_Array<Priority_Queue_Handle> free_handles;
+
+    void create(Allocator *allocator, s64 initial_capacity = 128);
+    void destroy();
+    void clear(); // Removes all entries, but keeps the memory around.
+
+    Priority_Queue_Handle push(T const &value, P priority);
+    T pop(P *priority = null);
+    Entry *peek(); // Returns the entry with the smallest priority, or null if the queue is empty.
+
+    void update_priority(Priority_Queue_Handle handle, P priority); // The new priority may be smaller or bigger than the previous one.
+    T remove(Priority_Queue_Handle handle);
+
+    b8 handle_is_valid(Priority_Queue_Handle handle);
+    T *query(Priority_Queue_Handle handle);
+    P query_priority(Priority_Queue_Handle handle);
+
+    void sift_up(s64 index);
+    void sift_down(s64 index);
+    void remove_at(s64 index);
+};
+
+// Because C++ is a terrible language, we need to supply the template definitions in the header file for
+// instantiation to work correctly... This feels horrible but still better than just inlining the code I guess.
+#include "priority_queue.inl"
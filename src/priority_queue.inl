@@ -0,0 +1,178 @@
+template<typename T, typename P, s64 Arity>
+void Priority_Queue<T, P, Arity>::create(Allocator *allocator, s64 initial_capacity) {
+    this->allocator = allocator;
+    this->count     = 0;
+
+    this->heap.allocator         = allocator;
+    this->positions.allocator    = allocator;
+    this->free_handles.allocator = allocator;
+
+    this->heap.reserve_exact(initial_capacity);
+    this->positions.reserve_exact(initial_capacity);
+}
+
+template<typename T, typename P, s64 Arity>
+void Priority_Queue<T, P, Arity>::destroy() {
+    this->heap.clear();
+    this->positions.clear();
+    this->free_handles.clear();
+    this->count = 0;
+}
+
+template<typename T, typename P, s64 Arity>
+void Priority_Queue<T, P, Arity>::clear() {
+    // All handles are free again, but we might as well hand them out from the beginning.
+    this->heap.count         = 0;
+    this->positions.count    = 0;
+    this->free_handles.count = 0;
+    this->count = 0;
+}
+
+template<typename T, typename P, s64 Arity>
+Priority_Queue_Handle Priority_Queue<T, P, Arity>::push(T const &value, P priority) {
+    Priority_Queue_Handle handle;
+
+    if(this->free_handles.count) {
+        handle = this->free_handles.pop();
+    } else {
+        handle = this->positions.count;
+        this->positions.add(INVALID_PRIORITY_QUEUE_INDEX);
+    }
+
+    s64 index = this->count;
+    this->heap.add({ priority, handle, value });
+    this->positions[handle] = index;
+    ++this->count;
+
+    this->sift_up(index);
+    return handle;
+}
+
+template<typename T, typename P, s64 Arity>
+T Priority_Queue<T, P, Arity>::pop(P *priority) {
+    assert(this->count > 0, "Tried to pop from an empty Priority Queue.");
+
+    if(priority) *priority = this->heap[0].priority;
+    T value = this->heap[0].value;
+    this->remove_at(0);
+    return value;
+}
+
+template<typename T, typename P, s64 Arity>
+typename Priority_Queue<T, P, Arity>::Entry *Priority_Queue<T, P, Arity>::peek() {
+    return this->count > 0 ? &this->heap[0] : null;
+}
+
+template<typename T, typename P, s64 Arity>
+void Priority_Queue<T, P, Arity>::update_priority(Priority_Queue_Handle handle, P priority) {
+    assert(this->handle_is_valid(handle), "Invalid Priority Queue Handle.");
+
+    s64 index = this->positions[handle];
+    b8 decreased = priority < this->heap[index].priority;
+    this->heap[index].priority = priority;
+
+    if(decreased) {
+        this->sift_up(index);
+    } else {
+        this->sift_down(index);
+    }
+}
+
+template<typename T, typename P, s64 Arity>
+T Priority_Queue<T, P, Arity>::remove(Priority_Queue_Handle handle) {
+    assert(this->handle_is_valid(handle), "Invalid Priority Queue Handle.");
+
+    s64 index = this->positions[handle];
+    T value = this->heap[index].value;
+    this->remove_at(index);
+    return value;
+}
+
+template<typename T, typename P, s64 Arity>
+b8 Priority_Queue<T, P, Arity>::handle_is_valid(Priority_Queue_Handle handle) {
+    return handle >= 0 && handle < this->positions.count && this->positions[handle] != INVALID_PRIORITY_QUEUE_INDEX;
+}
+
+template<typename T, typename P, s64 Arity>
+T *Priority_Queue<T, P, Arity>::query(Priority_Queue_Handle handle) {
+    assert(this->handle_is_valid(handle), "Invalid Priority Queue Handle.");
+    return &this->heap[this->positions[handle]].value;
+}
+
+template<typename T, typename P, s64 Arity>
+P Priority_Queue<T, P, Arity>::query_priority(Priority_Queue_Handle handle) {
+    assert(this->handle_is_valid(handle), "Invalid Priority Queue Handle.");
+    return this->heap[this->positions[handle]].priority;
+}
+
+template<typename T, typename P, s64 Arity>
+void Priority_Queue<T, P, Arity>::sift_up(s64 index) {
+    //
+    // Instead of swapping the entry with its parent on every level, keep the entry out of the heap, move the
+    // parents down into the hole, and only write the entry once its final position is known.
+    //
+    Entry *data = this->heap.data;
+    Entry entry = data[index];
+
+    while(index > 0) {
+        s64 parent = (index - 1) / Arity;
+        if(!(entry.priority < data[parent].priority)) break;
+
+        data[index] = data[parent];
+        this->positions.data[data[index].handle] = index;
+        index = parent;
+    }
+
+    data[index] = entry;
+    this->positions.data[entry.handle] = index;
+}
+
+template<typename T, typename P, s64 Arity>
+void Priority_Queue<T, P, Arity>::sift_down(s64 index) {
+    Entry *data = this->heap.data;
+    Entry entry = data[index];
+
+    while(true) {
+        s64 first_child = index * Arity + 1;
+        if(first_child >= this->count) break;
+
+        s64 last_child     = MIN(first_child + Arity, this->count);
+        s64 smallest_child = first_child;
+
+        for(s64 child = first_child + 1; child < last_child; ++child) {
+            if(data[child].priority < data[smallest_child].priority) smallest_child = child;
+        }
+
+        if(!(data[smallest_child].priority < entry.priority)) break;
+
+        data[index] = data[smallest_child];
+        this->positions.data[data[index].handle] = index;
+        index = smallest_child;
+    }
+
+    data[index] = entry;
+    this->positions.data[entry.handle] = index;
+}
+
+template<typename T, typename P, s64 Arity>
+void Priority_Queue<T, P, Arity>::remove_at(s64 index) {
+    Priority_Queue_Handle handle = this->heap[index].handle;
+    this->positions[handle] = INVALID_PRIORITY_QUEUE_INDEX;
+    this->free_handles.add(handle);
+
+    --this->count;
+
+    if(index != this->count) {
+        // Fill the hole with the last entry, which may need to move either up or down from here.
+        this->heap[index] = this->heap[this->count];
+        this->heap.count = this->count;
+
+        if(index > 0 && this->heap[index].priority < this->heap[(index - 1) / Arity].priority) {
+            this->sift_up(index);
+        } else {
+            this->sift_down(index);
+        }
+    } else {
+        this->heap.count = this->count;
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "foundation.h"
+#include "memutils.h" // For Default_Allocator
+#include "jobs.h"
 
 enum Sort_Comparison_Result : s64 {
     SORT_Lhs_Is_Smaller = -1,
@@ -9,11 +11,54 @@ enum Sort_Comparison_Result : s64 {
 
     SORT_Rhs_Is_Bigger = -1,
     SORT_Rhs_Equals_Lhs = 0,
-    SORT_Rhs_Is_Smaller = +1,    
+    SORT_Rhs_Is_Smaller = +1,
 };
 
-template<typename T>
-void sort(T *array, s64 count, Sort_Comparison_Result(*compare)(T *, T *));
+//
+// A pattern-defeating quicksort (pdqsort). This is an unstable introsort which uses insertion sort for
+// small ranges, picks the pivot as the median of three (or a ninther for big ranges), detects already
+// partitioned / sorted ranges and ranges with many equal elements, and breaks up adversarial patterns by
+// shuffling. If too many bad partitions happen anyway, it falls back to heap sort, so the worst case is
+// O(n log n). The recursion depth is bounded by O(log n).
+// The comparison procedure gets called as compare(T *lhs, T *rhs) and should return a Sort_Comparison_Result
+// (or anything comparable to zero). Since it is a template parameter, lambdas get inlined into the sort.
+//
+template<typename T, typename Compare>
+void sort(T *array, s64 count, Compare compare);
+
+//
+// A stable merge sort, which uses insertion sort for small runs and then merges them bottom-up. Equal
+// elements keep their relative order. The allocator is used for one temporary buffer of count elements.
+//
+template<typename T, typename Compare>
+void stable_sort(T *array, s64 count, Compare compare, Allocator *allocator = Default_Allocator);
+
+//
+// Sorts the array in parallel on the job system. The array gets split into one chunk per worker (plus one for
+// the calling thread), which get sorted concurrently, and are then merged in log2(chunks) rounds. Every
+// merge is split into independent pieces as well, so that all threads stay busy until the last round.
+// The calling thread participates in the sort and only returns once the array is sorted. Small arrays are
+// just sorted on the calling thread. The allocator is used for one temporary buffer of count elements.
+//
+template<typename T, typename Compare>
+void parallel_sort(Job_System *system, T *array, s64 count, Compare compare, Allocator *allocator = Default_Allocator);
+
+// Like parallel_sort, but equal elements keep their relative order.
+template<typename T, typename Compare>
+void parallel_stable_sort(Job_System *system, T *array, s64 count, Compare compare, Allocator *allocator = Default_Allocator);
+
+//
+// A least-significant-digit radix sort for integer and floating point keys (u16, s16, u32, s32, u64, s64, f32
+// and f64), which sorts the keys in ascending order and permutes the values along with them. This is a
+// stable sort. Passes in which all keys have the same byte get skipped. Negative floats sort before
+// positive ones, NaNs end up at the ends of the array depending on their sign.
+// The allocator is used for the temporary buffers (two key arrays and one value array).
+//
+template<typename K, typename V>
+void radix_sort(K *keys, V *values, s64 count, Allocator *allocator = Default_Allocator);
+
+template<typename K>
+void radix_sort(K *keys, s64 count, Allocator *allocator = Default_Allocator);
 
 // Because C++ is a terrible language, we need to supply the template definitions in the header file for
 // instantiation to work correctly... This feels horrible but still better than just inlining the code I guess.
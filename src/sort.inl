@@ -3,53 +3,686 @@
 // This source file gets #include'd in the header file, because templates are shit!
 //
 
-#define sort_swap(lhs, rhs) { auto tmp = *lhs; *lhs = *rhs; *rhs = tmp; }
+#define SORT_INSERTION_THRESHOLD     24  // Ranges smaller than this get insertion sorted.
+#define SORT_NINTHER_THRESHOLD       128 // Ranges bigger than this use the pseudo-median of nine as the pivot.
+#define SORT_PARTIAL_INSERTION_LIMIT 8   // The number of moves after which partial_insertion_sort gives up.
 
-template<typename T>
+#define sort_less(lhs, rhs) (compare(lhs, rhs) < 0)
+#define sort_swap(lhs, rhs) { auto tmp = *(lhs); *(lhs) = *(rhs); *(rhs) = tmp; }
+
+
+
+/* -------------------------------------------------- Pdqsort -------------------------------------------------- */
+
+template<typename T, typename Compare>
+static inline
+void internal_sort2(T *a, T *b, Compare &compare) {
+    if(sort_less(b, a)) sort_swap(a, b);
+}
+
+template<typename T, typename Compare>
+static inline
+void internal_sort3(T *a, T *b, T *c, Compare &compare) {
+    internal_sort2(a, b, compare);
+    internal_sort2(b, c, compare);
+    internal_sort2(a, b, compare);
+}
+
+template<typename T, typename Compare>
+static
+void internal_insertion_sort(T *begin, T *end, Compare &compare) {
+    if(begin == end) return;
+
+    for(T *current = begin + 1; current != end; ++current) {
+        T *sift   = current;
+        T *sift_1 = current - 1;
+
+        if(sort_less(sift, sift_1)) {
+            T tmp = *sift;
+
+            do {
+                *sift-- = *sift_1;
+            } while(sift != begin && sort_less(&tmp, --sift_1));
+
+            *sift = tmp;
+        }
+    }
+}
+
+template<typename T, typename Compare>
+static
+void internal_unguarded_insertion_sort(T *begin, T *end, Compare &compare) {
+    // Assumes that the element before begin is smaller than or equal to all elements in the range, so that
+    // we don't need to check the bounds.
+    if(begin == end) return;
+
+    for(T *current = begin + 1; current != end; ++current) {
+        T *sift   = current;
+        T *sift_1 = current - 1;
+
+        if(sort_less(sift, sift_1)) {
+            T tmp = *sift;
+
+            do {
+                *sift-- = *sift_1;
+            } while(sort_less(&tmp, --sift_1));
+
+            *sift = tmp;
+        }
+    }
+}
+
+template<typename T, typename Compare>
 static
-void internal_quick_sort(T *array, s64 low, s64 high, Sort_Comparison_Result(*lambda)(T *, T *)) {
-    if(low < 0 || low >= high) return;
+b8 internal_partial_insertion_sort(T *begin, T *end, Compare &compare) {
+    // Attempts to insertion sort the range, but gives up if too many elements need to be moved. Returns
+    // true if the range is now sorted.
+    if(begin == end) return true;
+
+    s64 limit = 0;
+
+    for(T *current = begin + 1; current != end; ++current) {
+        T *sift   = current;
+        T *sift_1 = current - 1;
 
+        if(sort_less(sift, sift_1)) {
+            T tmp = *sift;
+
+            do {
+                *sift-- = *sift_1;
+            } while(sift != begin && sort_less(&tmp, --sift_1));
+
+            *sift = tmp;
+            limit += current - sift;
+        }
+
+        if(limit > SORT_PARTIAL_INSERTION_LIMIT) return false;
+    }
+
+    return true;
+}
+
+template<typename T, typename Compare>
+static
+void internal_sift_down(T *array, s64 root, s64 count, Compare &compare) {
+    while(true) {
+        s64 child = root * 2 + 1;
+        if(child >= count) break;
+
+        if(child + 1 < count && sort_less(&array[child], &array[child + 1])) ++child;
+        if(!sort_less(&array[root], &array[child])) break;
+
+        sort_swap(&array[root], &array[child]);
+        root = child;
+    }
+}
+
+template<typename T, typename Compare>
+static
+void internal_heap_sort(T *begin, T *end, Compare &compare) {
+    s64 count = end - begin;
+
+    for(s64 i = count / 2 - 1; i >= 0; --i) internal_sift_down(begin, i, count, compare);
+
+    for(s64 i = count - 1; i > 0; --i) {
+        sort_swap(&begin[0], &begin[i]);
+        internal_sift_down(begin, 0, i, compare);
+    }
+}
+
+template<typename T, typename Compare>
+static
+T *internal_partition_right(T *begin, T *end, b8 *already_partitioned, Compare &compare) {
     //
-    // Split the interval into two partitions.
-    // Choose the middle element as the pivot.
+    // Partitions the range around the pivot *begin, so that all elements smaller than the pivot come before
+    // and all elements bigger than or equal to the pivot come after it. Returns the final pivot position.
+    // Requires the pivot to be a median of at least three elements, so that the scans cannot run out of
+    // bounds.
     //
-    T pivot_element = array[(low + high) / 2];
+    T pivot = *begin;
+    T *first = begin;
+    T *last  = end;
 
-    s64 lt = low;
-    s64 eq = low;
-    s64 gt = high;
+    while(sort_less(++first, &pivot));
 
-    while(eq <= gt) {
-        s64 comparison = lambda(&array[eq], &pivot_element);
+    // Find the first element smaller than the pivot from the right. If there was no element bigger than or
+    // equal to the pivot on the left, we need to guard this scan.
+    if(first - 1 == begin) {
+        while(first < last && !sort_less(--last, &pivot));
+    } else {
+        while(!sort_less(--last, &pivot));
+    }
+
+    // If the first pair of elements that should be swapped already crosses, the range was already
+    // partitioned.
+    *already_partitioned = first >= last;
+
+    while(first < last) {
+        sort_swap(first, last);
+        while(sort_less(++first, &pivot));
+        while(!sort_less(--last, &pivot));
+    }
+
+    T *pivot_position = first - 1;
+    *begin = *pivot_position;
+    *pivot_position = pivot;
+    return pivot_position;
+}
 
-        if(comparison < 0) {
-            // The value at the equal-index isn't actually equal to the pivot, swap it to be at the 
-            // lesser-index. We now have one more 'lesser' value, and one less 'equal' value.
-            sort_swap(&array[eq], &array[lt]);
-            ++lt;
-            ++eq;
-        } else if(comparison > 0) {
-            // The value at the equal-index isn't actually equal to the pivot, swap it to be at the 
-            // greater-index. We now have one more 'greater' value, and one less 'equal' value.
-            sort_swap(&array[eq], &array[gt]);
-            --gt;
+template<typename T, typename Compare>
+static
+T *internal_partition_left(T *begin, T *end, Compare &compare) {
+    // Like partition_right, but puts elements equal to the pivot to the left. This is used when the pivot
+    // is equal to the element before the range, in which case all elements equal to the pivot are already
+    // at their final position.
+    T pivot = *begin;
+    T *first = begin;
+    T *last  = end;
+
+    while(sort_less(&pivot, --last));
+
+    if(last + 1 == end) {
+        while(first < last && !sort_less(&pivot, ++first));
+    } else {
+        while(!sort_less(&pivot, ++first));
+    }
+
+    while(first < last) {
+        sort_swap(first, last);
+        while(sort_less(&pivot, --last));
+        while(!sort_less(&pivot, ++first));
+    }
+
+    T *pivot_position = last;
+    *begin = *pivot_position;
+    *pivot_position = pivot;
+    return pivot_position;
+}
+
+template<typename T, typename Compare>
+static
+void internal_pdqsort(T *begin, T *end, s64 bad_partitions_allowed, b8 leftmost, Compare &compare) {
+    while(true) {
+        s64 size = end - begin;
+
+        if(size < SORT_INSERTION_THRESHOLD) {
+            if(leftmost) {
+                internal_insertion_sort(begin, end, compare);
+            } else {
+                internal_unguarded_insertion_sort(begin, end, compare);
+            }
+
+            return;
+        }
+
+        //
+        // Choose the pivot as the median of three or the pseudo-median of nine, and move it to *begin.
+        //
+        s64 half = size / 2;
+        if(size > SORT_NINTHER_THRESHOLD) {
+            internal_sort3(begin, begin + half, end - 1, compare);
+            internal_sort3(begin + 1, begin + (half - 1), end - 2, compare);
+            internal_sort3(begin + 2, begin + (half + 1), end - 3, compare);
+            internal_sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+            sort_swap(begin, begin + half);
+        } else {
+            internal_sort3(begin + half, begin, end - 1, compare);
+        }
+
+        //
+        // If the pivot is equal to the element before this range (which is the pivot of a previous partition),
+        // then all elements equal to it can be put to the left and never need to be looked at again. This
+        // makes ranges with many equal elements linear.
+        //
+        if(!leftmost && !sort_less(begin - 1, begin)) {
+            begin = internal_partition_left(begin, end, compare) + 1;
+            continue;
+        }
+
+        b8 already_partitioned;
+        T *pivot_position = internal_partition_right(begin, end, &already_partitioned, compare);
+
+        s64 left_size  = pivot_position - begin;
+        s64 right_size = end - (pivot_position + 1);
+        b8 highly_unbalanced = left_size < size / 8 || right_size < size / 8;
+
+        if(highly_unbalanced) {
+            // Too many bad partitions indicate an adversarial input, fall back to the guaranteed O(n log n).
+            if(--bad_partitions_allowed == 0) {
+                internal_heap_sort(begin, end, compare);
+                return;
+            }
+
+            // Shuffle some elements around to break up patterns.
+            if(left_size >= SORT_INSERTION_THRESHOLD) {
+                sort_swap(begin, begin + left_size / 4);
+                sort_swap(pivot_position - 1, pivot_position - left_size / 4);
+
+                if(left_size > SORT_NINTHER_THRESHOLD) {
+                    sort_swap(begin + 1, begin + (left_size / 4 + 1));
+                    sort_swap(begin + 2, begin + (left_size / 4 + 2));
+                    sort_swap(pivot_position - 2, pivot_position - (left_size / 4 + 1));
+                    sort_swap(pivot_position - 3, pivot_position - (left_size / 4 + 2));
+                }
+            }
+
+            if(right_size >= SORT_INSERTION_THRESHOLD) {
+                sort_swap(pivot_position + 1, pivot_position + (1 + right_size / 4));
+                sort_swap(end - 1, end - right_size / 4);
+
+                if(right_size > SORT_NINTHER_THRESHOLD) {
+                    sort_swap(pivot_position + 2, pivot_position + (2 + right_size / 4));
+                    sort_swap(pivot_position + 3, pivot_position + (3 + right_size / 4));
+                    sort_swap(end - 2, end - (1 + right_size / 4));
+                    sort_swap(end - 3, end - (2 + right_size / 4));
+                }
+            }
+        } else {
+            // A well-balanced partition which did not need any swaps hints at an already sorted input.
+            if(already_partitioned && internal_partial_insertion_sort(begin, pivot_position, compare) && internal_partial_insertion_sort(pivot_position + 1, end, compare)) return;
+        }
+
+        //
+        // Recurse into the smaller partition and loop on the bigger one, so that the recursion depth stays
+        // logarithmic.
+        //
+        if(left_size < right_size) {
+            internal_pdqsort(begin, pivot_position, bad_partitions_allowed, leftmost, compare);
+            begin    = pivot_position + 1;
+            leftmost = false;
         } else {
-            // The value at the equal-index is equal to the pivot, so no swapping needed.
-            ++eq;
+            internal_pdqsort(pivot_position + 1, end, bad_partitions_allowed, false, compare);
+            end = pivot_position;
         }
     }
+}
+
+template<typename T, typename Compare>
+void sort(T *array, s64 count, Compare compare) {
+    if(count < 2) return;
+
+    s64 bad_partitions_allowed = 0;
+    for(s64 i = count; i > 1; i >>= 1) ++bad_partitions_allowed;
+
+    internal_pdqsort(array, array + count, bad_partitions_allowed, true, compare);
+}
+
+
+
+/* ------------------------------------------------ Stable Sort ------------------------------------------------ */
+
+#define SORT_STABLE_RUN_LENGTH 32 // Runs of this length get insertion sorted before merging.
+
+template<typename T, typename Compare>
+static
+void internal_merge(T *lhs, s64 lhs_count, T *rhs, s64 rhs_count, T *output, Compare &compare) {
+    // Takes from the left side on equal elements, so that the merge is stable.
+    T *lhs_end = lhs + lhs_count;
+    T *rhs_end = rhs + rhs_count;
+
+    while(lhs != lhs_end && rhs != rhs_end) {
+        if(sort_less(rhs, lhs)) {
+            *output++ = *rhs++;
+        } else {
+            *output++ = *lhs++;
+        }
+    }
+
+    while(lhs != lhs_end) *output++ = *lhs++;
+    while(rhs != rhs_end) *output++ = *rhs++;
+}
+
+template<typename T, typename Compare>
+static
+void internal_stable_sort(T *array, T *buffer, s64 count, Compare &compare) {
+    // The buffer must have space for count elements. Insertion sort only moves elements past strictly
+    // bigger ones, so it is stable.
+    for(s64 i = 0; i < count; i += SORT_STABLE_RUN_LENGTH) {
+        internal_insertion_sort(array + i, array + MIN(i + SORT_STABLE_RUN_LENGTH, count), compare);
+    }
+
+    T *src = array;
+    T *dst = buffer;
+
+    for(s64 width = SORT_STABLE_RUN_LENGTH; width < count; width *= 2) {
+        for(s64 begin = 0; begin < count; begin += width * 2) {
+            s64 middle = MIN(begin + width, count);
+            s64 end    = MIN(begin + width * 2, count);
+            internal_merge(src + begin, middle - begin, src + middle, end - middle, dst + begin, compare);
+        }
+
+        T *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if(src != array) memcpy(array, src, count * sizeof(T));
+}
+
+template<typename T, typename Compare>
+void stable_sort(T *array, s64 count, Compare compare, Allocator *allocator) {
+    if(count < 2) return;
+
+    if(count <= SORT_STABLE_RUN_LENGTH) {
+        internal_insertion_sort(array, array + count, compare);
+        return;
+    }
+
+    T *buffer = (T *) allocator->allocate(count * sizeof(T));
+    internal_stable_sort(array, buffer, count, compare);
+    allocator->deallocate(buffer);
+}
+
+
+
+/* ----------------------------------------------- Parallel Sort ----------------------------------------------- */
+
+#define SORT_PARALLEL_MIN_CHUNK 16384 // Don't bother spawning jobs for fewer elements than this per thread.
+
+template<typename T, typename Compare>
+struct Parallel_Sort_Context {
+    T *array;
+    T *buffer;
+    Compare *compare;
+    b8 stable;
+    Atomic<s64> remaining_tasks;
+};
+
+template<typename T, typename Compare>
+struct Parallel_Sort_Task {
+    Parallel_Sort_Context<T, Compare> *context;
+
+    // Chunk sorts sort [begin, end) of the array. Merges merge the sorted runs [begin, middle) and
+    // [middle, end) of src, and write the outputs [output_begin, output_end) (relative to begin) into dst.
+    T *src;
+    T *dst;
+    s64 begin, middle, end;
+    s64 output_begin, output_end;
+};
+
+template<typename T, typename Compare>
+static
+s64 internal_merge_split(T *lhs, s64 lhs_count, T *rhs, s64 rhs_count, s64 output_index, Compare &compare) {
+    //
+    // Returns how many elements of lhs end up in the first output_index elements of the (stable) merge of
+    // lhs and rhs. This lets a single merge be split into independent pieces at any output position.
+    //
+    s64 low  = MAX(0, output_index - rhs_count);
+    s64 high = MIN(output_index, lhs_count);
+
+    while(low < high) {
+        s64 i = (low + high) / 2;
+        s64 j = output_index - i;
+
+        // Equal elements of lhs come before those of rhs, so lhs[i] is part of the output if it is not
+        // bigger than rhs[j - 1].
+        if(sort_less(&rhs[j - 1], &lhs[i])) {
+            high = i;
+        } else {
+            low = i + 1;
+        }
+    }
+
+    return low;
+}
+
+template<typename T, typename Compare>
+static
+void internal_parallel_sort_chunk(Parallel_Sort_Task<T, Compare> *task) {
+    Parallel_Sort_Context<T, Compare> *context = task->context;
+    Compare &compare = *context->compare;
+
+    T *array  = context->array + task->begin;
+    s64 count = task->end - task->begin;
+
+    if(context->stable) {
+        internal_stable_sort(array, context->buffer + task->begin, count, compare);
+    } else {
+        sort(array, count, compare);
+    }
+
+    context->remaining_tasks.add(-1);
+}
+
+template<typename T, typename Compare>
+static
+void internal_parallel_sort_merge(Parallel_Sort_Task<T, Compare> *task) {
+    Parallel_Sort_Context<T, Compare> *context = task->context;
+    Compare &compare = *context->compare;
+
+    T *lhs = task->src + task->begin;
+    T *rhs = task->src + task->middle;
+    s64 lhs_count = task->middle - task->begin;
+    s64 rhs_count = task->end - task->middle;
+
+    s64 lhs_begin = internal_merge_split(lhs, lhs_count, rhs, rhs_count, task->output_begin, compare);
+    s64 lhs_end   = internal_merge_split(lhs, lhs_count, rhs, rhs_count, task->output_end, compare);
+    s64 rhs_begin = task->output_begin - lhs_begin;
+    s64 rhs_end   = task->output_end - lhs_end;
+
+    internal_merge(lhs + lhs_begin, lhs_end - lhs_begin, rhs + rhs_begin, rhs_end - rhs_begin, task->dst + task->begin + task->output_begin, compare);
+
+    context->remaining_tasks.add(-1);
+}
+
+template<typename T, typename Compare>
+static
+void internal_run_parallel_sort_tasks(Job_System *system, Parallel_Sort_Context<T, Compare> *context, Parallel_Sort_Task<T, Compare> *tasks, s64 task_count, void(*procedure)(Parallel_Sort_Task<T, Compare> *)) {
+    context->remaining_tasks.store(task_count);
+
+    for(s64 i = 1; i < task_count; ++i) {
+        spawn_job(system, { (Job_Procedure) procedure, &tasks[i] });
+    }
+
+    // The calling thread takes the first task itself instead of just waiting around.
+    procedure(&tasks[0]);
+
+    while(context->remaining_tasks.load() != 0) {}
+}
+
+template<typename T, typename Compare>
+static
+void internal_parallel_sort(Job_System *system, T *array, s64 count, Compare &compare, b8 stable, Allocator *allocator) {
+    s64 chunk_count = MIN(system->worker_count + 1, count / SORT_PARALLEL_MIN_CHUNK);
+
+    if(chunk_count <= 1) {
+        if(stable) {
+            stable_sort(array, count, compare, allocator);
+        } else {
+            sort(array, count, compare);
+        }
+
+        return;
+    }
+
+    Parallel_Sort_Context<T, Compare> context;
+    context.array   = array;
+    context.buffer  = (T *) allocator->allocate(count * sizeof(T));
+    context.compare = &compare;
+    context.stable  = stable;
+
+    // A merge round splits every merge into pieces of at most piece_size output elements, which means that
+    // there are at most chunk_count + (number of merges) tasks per round.
+    s64 max_task_count = chunk_count * 2;
+    Parallel_Sort_Task<T, Compare> *tasks = (Parallel_Sort_Task<T, Compare> *) allocator->allocate(max_task_count * sizeof(Parallel_Sort_Task<T, Compare>));
 
     //
-    // Recurse the partitions
+    // Sort all chunks concurrently.
     //
-    internal_quick_sort(array, low, lt - 1, lambda);
-    internal_quick_sort(array, gt + 1, high, lambda);
+    for(s64 i = 0; i < chunk_count; ++i) {
+        tasks[i].context = &context;
+        tasks[i].begin   = i * count / chunk_count;
+        tasks[i].end     = (i + 1) * count / chunk_count;
+    }
+
+    internal_run_parallel_sort_tasks(system, &context, tasks, chunk_count, internal_parallel_sort_chunk<T, Compare>);
+
+    //
+    // Merge pairs of neighbouring runs, until only a single run remains.
+    //
+    s64 piece_size = (count + chunk_count - 1) / chunk_count;
+    T *src = array;
+    T *dst = context.buffer;
+
+    for(s64 width = 1; width < chunk_count; width *= 2) {
+        s64 task_count = 0;
+
+        for(s64 first_chunk = 0; first_chunk < chunk_count; first_chunk += width * 2) {
+            s64 begin  = first_chunk * count / chunk_count;
+            s64 middle = MIN(first_chunk + width, chunk_count) * count / chunk_count;
+            s64 end    = MIN(first_chunk + width * 2, chunk_count) * count / chunk_count;
+
+            // A run without a partner still needs to be copied into dst, which is just a merge with an empty
+            // right side.
+            for(s64 output_begin = 0; output_begin < end - begin; output_begin += piece_size) {
+                assert(task_count < max_task_count);
+
+                Parallel_Sort_Task<T, Compare> *task = &tasks[task_count++];
+                task->context      = &context;
+                task->src          = src;
+                task->dst          = dst;
+                task->begin        = begin;
+                task->middle       = middle;
+                task->end          = end;
+                task->output_begin = output_begin;
+                task->output_end   = MIN(output_begin + piece_size, end - begin);
+            }
+        }
+
+        internal_run_parallel_sort_tasks(system, &context, tasks, task_count, internal_parallel_sort_merge<T, Compare>);
+
+        T *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if(src != array) memcpy(array, src, count * sizeof(T));
+
+    allocator->deallocate(tasks);
+    allocator->deallocate(context.buffer);
+}
+
+template<typename T, typename Compare>
+void parallel_sort(Job_System *system, T *array, s64 count, Compare compare, Allocator *allocator) {
+    if(count < 2) return;
+    internal_parallel_sort(system, array, count, compare, false, allocator);
+}
+
+template<typename T, typename Compare>
+void parallel_stable_sort(Job_System *system, T *array, s64 count, Compare compare, Allocator *allocator) {
+    if(count < 2) return;
+    internal_parallel_sort(system, array, count, compare, true, allocator);
+}
+
+
+
+/* ------------------------------------------------ Radix Sort ------------------------------------------------ */
+
+// Maps the keys to unsigned integers of the same size whose unsigned order matches the order of the keys.
+template<typename K> struct Radix_Key;
+
+template<> struct Radix_Key<u16> { typedef u16 Bits; static u16 encode(u16 bits) { return bits; }          static u16 decode(u16 bits) { return bits; } };
+template<> struct Radix_Key<s16> { typedef u16 Bits; static u16 encode(u16 bits) { return bits ^ 0x8000; } static u16 decode(u16 bits) { return bits ^ 0x8000; } };
+template<> struct Radix_Key<u32> { typedef u32 Bits; static u32 encode(u32 bits) { return bits; }              static u32 decode(u32 bits) { return bits; } };
+template<> struct Radix_Key<s32> { typedef u32 Bits; static u32 encode(u32 bits) { return bits ^ 0x80000000; } static u32 decode(u32 bits) { return bits ^ 0x80000000; } };
+template<> struct Radix_Key<u64> { typedef u64 Bits; static u64 encode(u64 bits) { return bits; }                      static u64 decode(u64 bits) { return bits; } };
+template<> struct Radix_Key<s64> { typedef u64 Bits; static u64 encode(u64 bits) { return bits ^ 0x8000000000000000; } static u64 decode(u64 bits) { return bits ^ 0x8000000000000000; } };
+
+// Negative floats have all bits flipped (so that bigger magnitudes sort first), positive floats just get
+// the sign bit set (so that they sort after all negative ones).
+template<> struct Radix_Key<f32> {
+    typedef u32 Bits;
+    static u32 encode(u32 bits) { return (bits & 0x80000000) ? ~bits : bits | 0x80000000; }
+    static u32 decode(u32 bits) { return (bits & 0x80000000) ? bits & 0x7fffffff : ~bits; }
+};
+
+template<> struct Radix_Key<f64> {
+    typedef u64 Bits;
+    static u64 encode(u64 bits) { return (bits & 0x8000000000000000) ? ~bits : bits | 0x8000000000000000; }
+    static u64 decode(u64 bits) { return (bits & 0x8000000000000000) ? bits & 0x7fffffffffffffff : ~bits; }
+};
+
+template<typename K, typename V>
+void radix_sort(K *keys, V *values, s64 count, Allocator *allocator) {
+    typedef typename Radix_Key<K>::Bits Bits;
+    const s64 pass_count = sizeof(Bits);
+
+    if(count < 2) return;
+
+    Bits *src_keys   = (Bits *) allocator->allocate(count * sizeof(Bits));
+    Bits *dst_keys   = (Bits *) allocator->allocate(count * sizeof(Bits));
+    V *src_values    = values;
+    V *dst_values    = values ? (V *) allocator->allocate(count * sizeof(V)) : null;
+    V *values_buffer = dst_values;
+
+    //
+    // Encode all keys and build the histograms of all passes at once.
+    //
+    s64 histograms[pass_count][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for(s64 i = 0; i < count; ++i) {
+        Bits bits;
+        memcpy(&bits, &keys[i], sizeof(Bits));
+        bits = Radix_Key<K>::encode(bits);
+        src_keys[i] = bits;
+
+        for(s64 pass = 0; pass < pass_count; ++pass) {
+            ++histograms[pass][(bits >> (pass * 8)) & 0xff];
+        }
+    }
+
+    //
+    // Scatter by one byte per pass, from the least significant to the most significant one.
+    //
+    for(s64 pass = 0; pass < pass_count; ++pass) {
+        s64 *histogram = histograms[pass];
+
+        // If all keys have the same byte in this pass, the pass would not change anything.
+        if(histogram[(src_keys[0] >> (pass * 8)) & 0xff] == count) continue;
+
+        s64 offsets[256];
+        s64 offset = 0;
+        for(s64 i = 0; i < 256; ++i) {
+            offsets[i] = offset;
+            offset += histogram[i];
+        }
+
+        for(s64 i = 0; i < count; ++i) {
+            Bits bits = src_keys[i];
+            s64 destination = offsets[(bits >> (pass * 8)) & 0xff]++;
+            dst_keys[destination] = bits;
+            if(values) dst_values[destination] = src_values[i];
+        }
+
+        Bits *tmp_keys = src_keys;
+        src_keys = dst_keys;
+        dst_keys = tmp_keys;
+
+        V *tmp_values = src_values;
+        src_values = dst_values;
+        dst_values = tmp_values;
+    }
+
+    //
+    // Decode the keys back into the caller's array, and make sure the values end up there as well.
+    //
+    for(s64 i = 0; i < count; ++i) {
+        Bits bits = Radix_Key<K>::decode(src_keys[i]);
+        memcpy(&keys[i], &bits, sizeof(Bits));
+    }
+
+    if(values && src_values != values) memcpy(values, src_values, count * sizeof(V));
+
+    allocator->deallocate(src_keys);
+    allocator->deallocate(dst_keys);
+    if(values_buffer) allocator->deallocate(values_buffer);
 }
 
-template<typename T>
-void sort(T *array, s64 count, Sort_Comparison_Result(*compare)(T *, T *)) {
-    internal_quick_sort(array, 0, count - 1, compare);
+template<typename K>
+void radix_sort(K *keys, s64 count, Allocator *allocator) {
+    radix_sort(keys, (u8 *) null, count, allocator);
 }
 
-#undef sort_wrap
\ No newline at end of file
+#undef sort_less
+#undef sort_swap
@@ -3,15 +3,218 @@
 #include "os_specific.h"
 
 #if FOUNDATION_WIN32
-# include <intrin.h> // For _addcarry_u64...
+# include <intrin.h> // For _umul128...
 #elif FOUNDATION_LINUX
-# include <x86intrin.h> // For _addcarry_u64...
+# include <x86intrin.h> // For SIMD intrinsics...
 #endif
 
-#include <fenv.h> // For feclearexcept...
 #include <string.h> // For strcmp
+#include <stdlib.h> // For strtod
 #include <stdarg.h>
 
+#include "string_conversion_tables.inl"
+
+
+
+/* ------------------------------------------------ SIMD Helpers ------------------------------------------------ */
+
+//
+// The searching and comparison procedures below process a whole register of bytes at a time: compare all bytes
+// of a chunk against something, collapse the result into a bitmask with one bit per byte, and only then look
+// at individual bytes (usually just the lowest set bit). AVX2 handles 32 bytes per step, SSE2 (which every
+// x64 cpu has) 16 bytes.
+//
+
+//
+// Scanning for the null terminator of a c-string, or handling strings shorter than a register, must not read
+// past the end of the string in a way that could cross into an unmapped page. As long as a load stays within
+// the page of the string's first byte, it may safely read a few bytes past the end (the same trick the C
+// runtime uses), but the address sanitizer cannot know that.
+//
+#if FOUNDATION_LINUX && defined(__SANITIZE_ADDRESS__)
+# define STRING_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+# define STRING_NO_SANITIZE_ADDRESS
+#endif
+
+#if defined(__AVX2__)
+# define STRING_SIMD_AVX2 true
+# define STRING_SIMD_WIDTH 32
+# define STRING_SIMD_FULL_MASK 0xffffffff
+
+typedef __m256i String_Register;
+
+static inline String_Register string_register_broadcast(u8 value) { return _mm256_set1_epi8((char) value); }
+static inline String_Register string_register_load(const u8 *data) { return _mm256_loadu_si256((const __m256i *) data); }
+STRING_NO_SANITIZE_ADDRESS static inline String_Register string_register_load_aligned(const u8 *data) { return _mm256_load_si256((const __m256i *) data); }
+STRING_NO_SANITIZE_ADDRESS static inline String_Register string_register_load_overread(const u8 *data) { return _mm256_loadu_si256((const __m256i *) data); }
+static inline u32 string_register_equal_mask(String_Register lhs, String_Register rhs) { return (u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs, rhs)); }
+#else
+# define STRING_SIMD_AVX2 false
+# define STRING_SIMD_WIDTH 16
+# define STRING_SIMD_FULL_MASK 0xffff
+
+typedef __m128i String_Register;
+
+static inline String_Register string_register_broadcast(u8 value) { return _mm_set1_epi8((char) value); }
+static inline String_Register string_register_load(const u8 *data) { return _mm_loadu_si128((const __m128i *) data); }
+STRING_NO_SANITIZE_ADDRESS static inline String_Register string_register_load_aligned(const u8 *data) { return _mm_load_si128((const __m128i *) data); }
+STRING_NO_SANITIZE_ADDRESS static inline String_Register string_register_load_overread(const u8 *data) { return _mm_loadu_si128((const __m128i *) data); }
+static inline u32 string_register_equal_mask(String_Register lhs, String_Register rhs) { return (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(lhs, rhs)); }
+#endif
+
+static inline
+s64 string_lowest_bit(u32 mask) {
+#if FOUNDATION_WIN32
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#elif FOUNDATION_LINUX
+    return __builtin_ctz(mask);
+#endif
+}
+
+static inline
+s64 string_highest_bit(u32 mask) {
+#if FOUNDATION_WIN32
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#elif FOUNDATION_LINUX
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+// The UTF-8 lookup tables and the short number parser need pshufb (SSSE3), which the other SIMD helpers can
+// do without. MSVC always provides the intrinsics, and every x64 cpu of the last fifteen years supports them.
+#if defined(__SSSE3__) || FOUNDATION_WIN32
+# define STRING_SIMD_SSSE3 true
+#else
+# define STRING_SIMD_SSSE3 false
+#endif
+
+#define STRING_PAGE_SIZE 4096
+
+// Returns true if a full register can be loaded at this address without touching the next page.
+static inline
+b8 string_register_can_overread(const u8 *data) {
+    return ((u64) data & (STRING_PAGE_SIZE - 1)) <= STRING_PAGE_SIZE - STRING_SIMD_WIDTH;
+}
+
+// Loads of up to 8 bytes through memcpy, so that they may be unaligned.
+static inline u64 string_load_u64(const u8 *data) { u64 value; memcpy(&value, data, sizeof(u64)); return value; }
+static inline u32 string_load_u32(const u8 *data) { u32 value; memcpy(&value, data, sizeof(u32)); return value; }
+
+// Like to_lower_character on every byte of the register.
+static inline
+String_Register string_register_to_lower(String_Register data) {
+    // Bytes are compared as signed values, so shift the letter range down to the bottom of the signed range.
+#if STRING_SIMD_AVX2
+    __m256i shifted  = _mm256_add_epi8(data, _mm256_set1_epi8((char) (0x80 - 'A')));
+    __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (0x80 + 26)), shifted);
+    return _mm256_or_si256(data, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+#else
+    __m128i shifted  = _mm_add_epi8(data, _mm_set1_epi8((char) (0x80 - 'A')));
+    __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8((char) (0x80 + 26)), shifted);
+    return _mm_or_si128(data, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+#endif
+}
+
+// Like to_lower_character on every byte of the word.
+static inline
+u64 string_word_to_lower(u64 word) {
+    // Only add to the low seven bits of each byte, so that nothing carries into the next byte. The top bit
+    // of each byte then tells whether it is >= 'A', or > 'Z'.
+    u64 heptets  = word & 0x7f7f7f7f7f7f7f7fULL;
+    u64 above_a  = heptets + 0x3f3f3f3f3f3f3f3fULL; // 0x80 - 'A'
+    u64 above_z  = heptets + 0x2525252525252525ULL; // 0x80 - 'Z' - 1
+    u64 is_upper = (above_a ^ above_z) & ~word & 0x8080808080808080ULL;
+    return word | (is_upper >> 2);
+}
+
+static
+b8 string_memory_equal(const u8 *lhs, const u8 *rhs, s64 count) {
+    if(count >= STRING_SIMD_WIDTH) {
+        s64 i = 0;
+        for(; i + STRING_SIMD_WIDTH <= count; i += STRING_SIMD_WIDTH) {
+            if(string_register_equal_mask(string_register_load(lhs + i), string_register_load(rhs + i)) != STRING_SIMD_FULL_MASK) return false;
+        }
+
+        // Compare the remaining bytes with one last chunk which overlaps the previous one.
+        if(i < count) {
+            i = count - STRING_SIMD_WIDTH;
+            if(string_register_equal_mask(string_register_load(lhs + i), string_register_load(rhs + i)) != STRING_SIMD_FULL_MASK) return false;
+        }
+
+        return true;
+    }
+
+    if(count == 0) return true;
+
+    if(string_register_can_overread(lhs) && string_register_can_overread(rhs)) {
+        u32 mask = string_register_equal_mask(string_register_load_overread(lhs), string_register_load_overread(rhs));
+        return (~mask & ((1u << count) - 1)) == 0;
+    }
+
+    // Otherwise compare the first and last (possibly overlapping) words.
+    if(count >= 8) {
+        for(s64 i = 0; i + 8 < count; i += 8) {
+            if(string_load_u64(lhs + i) != string_load_u64(rhs + i)) return false;
+        }
+
+        return string_load_u64(lhs + count - 8) == string_load_u64(rhs + count - 8);
+    }
+
+    if(count >= 4) return string_load_u32(lhs) == string_load_u32(rhs) && string_load_u32(lhs + count - 4) == string_load_u32(rhs + count - 4);
+
+    for(s64 i = 0; i < count; ++i) {
+        if(lhs[i] != rhs[i]) return false;
+    }
+
+    return true;
+}
+
+// The same as string_memory_equal, but folds both sides to lower case before comparing.
+static
+b8 string_memory_equal_ignore_case(const u8 *lhs, const u8 *rhs, s64 count) {
+    if(count >= STRING_SIMD_WIDTH) {
+        s64 i = 0;
+        for(; i + STRING_SIMD_WIDTH <= count; i += STRING_SIMD_WIDTH) {
+            if(string_register_equal_mask(string_register_to_lower(string_register_load(lhs + i)), string_register_to_lower(string_register_load(rhs + i))) != STRING_SIMD_FULL_MASK) return false;
+        }
+
+        if(i < count) {
+            i = count - STRING_SIMD_WIDTH;
+            if(string_register_equal_mask(string_register_to_lower(string_register_load(lhs + i)), string_register_to_lower(string_register_load(rhs + i))) != STRING_SIMD_FULL_MASK) return false;
+        }
+
+        return true;
+    }
+
+    if(count == 0) return true;
+
+    if(string_register_can_overread(lhs) && string_register_can_overread(rhs)) {
+        u32 mask = string_register_equal_mask(string_register_to_lower(string_register_load_overread(lhs)), string_register_to_lower(string_register_load_overread(rhs)));
+        return (~mask & ((1u << count) - 1)) == 0;
+    }
+
+    if(count >= 8) {
+        for(s64 i = 0; i + 8 < count; i += 8) {
+            if(string_word_to_lower(string_load_u64(lhs + i)) != string_word_to_lower(string_load_u64(rhs + i))) return false;
+        }
+
+        return string_word_to_lower(string_load_u64(lhs + count - 8)) == string_word_to_lower(string_load_u64(rhs + count - 8));
+    }
+
+    if(count >= 4) return string_word_to_lower(string_load_u32(lhs)) == string_word_to_lower(string_load_u32(rhs)) && string_word_to_lower(string_load_u32(lhs + count - 4)) == string_word_to_lower(string_load_u32(rhs + count - 4));
+
+    for(s64 i = 0; i < count; ++i) {
+        if(to_lower_character(lhs[i]) != to_lower_character(rhs[i])) return false;
+    }
+
+    return true;
+}
+
 
 
 /* ------------------------------------------------ Characters ------------------------------------------------ */
@@ -26,39 +229,97 @@ b8 is_lower_character(u8 c) {
 }
 
 b8 is_upper_character(u8 c) {
-    return !is_lower_character(c);
+    return c >= 'A' && c <= 'Z';
 }
 
+// Branchless: Letters only differ in bit 5 between upper and lower case, and the unsigned subtraction folds
+// both range checks into one comparison.
 u8 to_lower_character(u8 c) {
-    if (c >= 'A' && c <= 'Z') return (c - 'A') + 'a';
-    return c;
+    return c | ((u8) ((u8) (c - 'A') < 26) << 5);
 }
 
 u8 to_upper_character(u8 c) {
-    if (c >= 'a' && c <= 'z') return (c - 'a') + 'A';
-    return c;
+    return c & ~((u8) ((u8) (c - 'a') < 26) << 5);
+}
+
+static inline
+void convert_character_case(string _string, u8 first, u8 flip) {
+    s64 i = 0;
+
+#if STRING_SIMD_AVX2
+    // Bytes are compared as signed values, so shift the letter range down to the bottom of the signed range.
+    __m256i offset = _mm256_set1_epi8((char) (0x80 - first));
+    __m256i limit  = _mm256_set1_epi8((char) (0x80 + 25));
+    __m256i bit    = _mm256_set1_epi8((char) flip);
+
+    for(; i + 32 <= _string.count; i += 32) {
+        __m256i chunk    = _mm256_loadu_si256((__m256i *) &_string.data[i]);
+        __m256i shifted  = _mm256_add_epi8(chunk, offset);
+        __m256i is_other = _mm256_cmpgt_epi8(shifted, limit);
+        _mm256_storeu_si256((__m256i *) &_string.data[i], _mm256_xor_si256(chunk, _mm256_andnot_si256(is_other, bit)));
+    }
+#else
+    __m128i offset = _mm_set1_epi8((char) (0x80 - first));
+    __m128i limit  = _mm_set1_epi8((char) (0x80 + 25));
+    __m128i bit    = _mm_set1_epi8((char) flip);
+
+    for(; i + 16 <= _string.count; i += 16) {
+        __m128i chunk    = _mm_loadu_si128((__m128i *) &_string.data[i]);
+        __m128i shifted  = _mm_add_epi8(chunk, offset);
+        __m128i is_other = _mm_cmpgt_epi8(shifted, limit);
+        _mm_storeu_si128((__m128i *) &_string.data[i], _mm_xor_si128(chunk, _mm_andnot_si128(is_other, bit)));
+    }
+#endif
+
+    for(; i < _string.count; ++i) {
+        _string.data[i] ^= ((u8) (_string.data[i] - first) < 26) ? flip : 0;
+    }
+}
+
+void to_lower_string(string _string) {
+    convert_character_case(_string, 'A', 0x20);
+}
+
+void to_upper_string(string _string) {
+    convert_character_case(_string, 'a', 0x20);
 }
 
 
 
 /* ------------------------------------------------- C String ------------------------------------------------- */
 
-s64 cstring_length(char *cstring) {
-    s64 length = 0;
-    while(*cstring) {
-        ++length;
-        ++cstring;
+// Returns the index of the first byte equal to _char or to the null terminator.
+STRING_NO_SANITIZE_ADDRESS
+static
+s64 search_cstring_or_terminator(const char *cstring, u8 _char) {
+    //
+    // Start at the aligned chunk containing the first character, and ignore the bytes in front of the string.
+    // From then on, every load is aligned, so that it never crosses into the next (potentially unmapped) page.
+    //
+    const u8 *start = (const u8 *) cstring;
+    const u8 *chunk = (const u8 *) ((u64) start & ~(u64) (STRING_SIMD_WIDTH - 1));
+
+    String_Register zero   = string_register_broadcast(0);
+    String_Register needle = string_register_broadcast(_char);
+
+    String_Register data = string_register_load_aligned(chunk);
+    u32 mask = (string_register_equal_mask(data, zero) | string_register_equal_mask(data, needle)) >> (start - chunk);
+    if(mask) return string_lowest_bit(mask);
+
+    while(true) {
+        chunk += STRING_SIMD_WIDTH;
+        data = string_register_load_aligned(chunk);
+        mask = string_register_equal_mask(data, zero) | string_register_equal_mask(data, needle);
+        if(mask) return (chunk - start) + string_lowest_bit(mask);
     }
-    return length;
+}
+
+s64 cstring_length(char *cstring) {
+    return search_cstring_or_terminator(cstring, 0);
 }
 
 s64 cstring_length(const char *cstring) {
-    s64 length = 0;
-    while(*cstring) {
-        ++length;
-        ++cstring;
-    }
-    return length;
+    return search_cstring_or_terminator(cstring, 0);
 }
 
 string from_cstring(Allocator *allocator, const char *cstring) {
@@ -88,19 +349,12 @@ void free_cstring(Allocator *allocator, char *cstring) {
 }
 
 s64 search_cstring(const char *string, u8 _char) {
-    for(s64 i = 0; *string != 0; ++string, ++i) {
-        if(*string == _char) return i;
-    }
-
-    return -1;
+    s64 index = search_cstring_or_terminator(string, _char);
+    return string[index] != 0 ? index : -1;
 }
 
 s64 search_cstring_reverse(const char *string, u8 _char) {
-    for(s64 i = strlen(string); *string != 0; ++string, --i) {
-        if(*string == _char) return i;
-    }
-
-    return -1;
+    return search_string_reverse(cstring_view(string), _char);
 }
 
 b8 cstrings_equal(const char *lhs, const char *rhs) {
@@ -111,22 +365,50 @@ b8 cstrings_equal(const char *lhs, const char *rhs, s64 length) {
     return strncmp(lhs, rhs, length) == 0;
 }
 
-b8 cstrings_equal_ignore_case(const char *lhs, const char *rhs) {
-    for(;; ++lhs, ++rhs) {
-        char d = to_lower_character((unsigned char) *lhs) - to_lower_character((unsigned char) *rhs);
-        if(d != 0 || !*lhs) return false;
+//
+// Compares at most length characters, stopping at the null terminator like strncmp. Both strings are walked
+// a register at a time in a single pass, as long as neither load crosses into the next page. Only close to a
+// page boundary the characters are compared one at a time, until both strings are past it.
+//
+STRING_NO_SANITIZE_ADDRESS
+static
+b8 cstrings_equal_ignore_case_up_to(const char *lhs, const char *rhs, s64 length) {
+    const u8 *lhs_data = (const u8 *) lhs;
+    const u8 *rhs_data = (const u8 *) rhs;
+
+    String_Register zero = string_register_broadcast(0);
+    s64 i = 0;
+
+    while(i < length) {
+        if(string_register_can_overread(lhs_data + i) && string_register_can_overread(rhs_data + i)) {
+            String_Register lhs_chunk = string_register_to_lower(string_register_load_overread(lhs_data + i));
+            String_Register rhs_chunk = string_register_to_lower(string_register_load_overread(rhs_data + i));
+
+            // Stop at the first difference, or at the terminator (where both strings end if they are equal).
+            u32 different = ~string_register_equal_mask(lhs_chunk, rhs_chunk) & STRING_SIMD_FULL_MASK;
+            u32 stop = different | string_register_equal_mask(lhs_chunk, zero);
+            if(length - i < STRING_SIMD_WIDTH) stop &= (1u << (length - i)) - 1;
+
+            if(stop) return (stop & (0 - stop) & different) == 0;
+
+            i += STRING_SIMD_WIDTH;
+        } else {
+            u8 lhs_character = to_lower_character(lhs_data[i]);
+            if(lhs_character != to_lower_character(rhs_data[i])) return false;
+            if(lhs_character == 0) return true;
+            ++i;
+        }
     }
 
     return true;
 }
 
-b8 cstrings_equal_ignore_case(const char *lhs, const char *rhs, s64 length) {
-    for(s64 i = 0; i < length; ++lhs, ++rhs, ++i) {
-        char d = to_lower_character((unsigned char) *lhs) - to_lower_character((unsigned char) *rhs);
-        if(d != 0 || !*lhs) return false;
-    }
+b8 cstrings_equal_ignore_case(const char *lhs, const char *rhs) {
+    return cstrings_equal_ignore_case_up_to(lhs, rhs, MAX_S64);
+}
 
-    return true;
+b8 cstrings_equal_ignore_case(const char *lhs, const char *rhs, s64 length) {
+    return cstrings_equal_ignore_case_up_to(lhs, rhs, length);
 }
 
 b8 cstring_starts_with(const char *lhs, const char *rhs) {
@@ -134,7 +416,7 @@ b8 cstring_starts_with(const char *lhs, const char *rhs) {
 }
 
 b8 cstring_starts_with_ignore_case(const char *lhs, const char *rhs) {
-    return cstrings_equal_ignore_case(lhs, rhs, strlen(rhs));
+    return cstrings_equal_ignore_case(lhs, rhs, cstring_length(rhs));
 }
 
 b8 cstring_ends_with(const char *lhs, const char *rhs) {
@@ -261,16 +543,101 @@ string concatenate_strings(Allocator *allocator, string lhs, string rhs) {
 
 
 s64 search_string(string _string, u8 _char) {
-    for(s64 i = 0; i < _string.count; ++i) {
-        if(_string.data[i] == _char) return i;
+    if(_string.count < STRING_SIMD_WIDTH) {
+        if(_string.count == 0) return -1;
+
+        if(string_register_can_overread(_string.data)) {
+            u32 mask = string_register_equal_mask(string_register_load_overread(_string.data), string_register_broadcast(_char)) & ((1u << _string.count) - 1);
+            return mask ? string_lowest_bit(mask) : -1;
+        }
+
+        for(s64 i = 0; i < _string.count; ++i) {
+            if(_string.data[i] == _char) return i;
+        }
+
+        return -1;
+    }
+
+    String_Register needle = string_register_broadcast(_char);
+
+    s64 i = 0;
+    for(; i + STRING_SIMD_WIDTH <= _string.count; i += STRING_SIMD_WIDTH) {
+        u32 mask = string_register_equal_mask(string_register_load(&_string.data[i]), needle);
+        if(mask) return i + string_lowest_bit(mask);
+    }
+
+    if(i < _string.count) {
+        // Search the remaining bytes with one last chunk which overlaps the previous one, ignoring the bytes
+        // that have already been searched.
+        s64 last = _string.count - STRING_SIMD_WIDTH;
+        u32 mask = string_register_equal_mask(string_register_load(&_string.data[last]), needle) >> (i - last);
+        if(mask) return i + string_lowest_bit(mask);
     }
 
     return -1;
 }
 
 s64 search_string_reverse(string _string, u8 _char) {
-    for(s64 i = _string.count - 1; i >= 0; --i) {
-        if(_string.data[i] == _char) return i;
+    if(_string.count < STRING_SIMD_WIDTH) {
+        if(_string.count == 0) return -1;
+
+        if(string_register_can_overread(_string.data)) {
+            u32 mask = string_register_equal_mask(string_register_load_overread(_string.data), string_register_broadcast(_char)) & ((1u << _string.count) - 1);
+            return mask ? string_highest_bit(mask) : -1;
+        }
+
+        for(s64 i = _string.count - 1; i >= 0; --i) {
+            if(_string.data[i] == _char) return i;
+        }
+
+        return -1;
+    }
+
+    String_Register needle = string_register_broadcast(_char);
+
+    s64 end = _string.count;
+    for(; end >= STRING_SIMD_WIDTH; end -= STRING_SIMD_WIDTH) {
+        u32 mask = string_register_equal_mask(string_register_load(&_string.data[end - STRING_SIMD_WIDTH]), needle);
+        if(mask) return end - STRING_SIMD_WIDTH + string_highest_bit(mask);
+    }
+
+    if(end > 0) {
+        // The first chunk overlaps the one searched last, so only look at its first 'end' bytes.
+        u32 mask = string_register_equal_mask(string_register_load(&_string.data[0]), needle) & ((1u << end) - 1);
+        if(mask) return string_highest_bit(mask);
+    }
+
+    return -1;
+}
+
+s64 search_substring(string haystack, string needle) {
+    if(needle.count == 0) return 0;
+    if(needle.count > haystack.count) return -1;
+    if(needle.count == 1) return search_string(haystack, needle.data[0]);
+
+    //
+    // Compare a chunk of the haystack against the first character of the needle, and the chunk shifted by
+    // (needle.count - 1) against the last character. Only positions where both match are candidates which
+    // need a full comparison, which filters out almost all positions for real-world text.
+    //
+    s64 last_start = haystack.count - needle.count; // The last position at which the needle could start.
+    s64 i = 0;
+
+    String_Register first = string_register_broadcast(needle.data[0]);
+    String_Register last  = string_register_broadcast(needle.data[needle.count - 1]);
+
+    for(; i + STRING_SIMD_WIDTH - 1 <= last_start; i += STRING_SIMD_WIDTH) {
+        u32 mask = string_register_equal_mask(string_register_load(&haystack.data[i]), first) & string_register_equal_mask(string_register_load(&haystack.data[i + needle.count - 1]), last);
+
+        while(mask) {
+            s64 candidate = i + string_lowest_bit(mask);
+            if(string_memory_equal(&haystack.data[candidate + 1], &needle.data[1], needle.count - 2)) return candidate;
+            mask &= mask - 1;
+        }
+    }
+
+    for(; i <= last_start; ++i) {
+        if(haystack.data[i] == needle.data[0] && haystack.data[i + needle.count - 1] == needle.data[needle.count - 1] && string_memory_equal(&haystack.data[i + 1], &needle.data[1], needle.count - 2)) return i;
     }
 
     return -1;
@@ -280,19 +647,37 @@ s64 search_string_reverse(string _string, u8 _char) {
 b8 strings_equal(const string &lhs, const string &rhs) {
     if(lhs.count != rhs.count) return false;
 
-    return memcmp(lhs.data, rhs.data, lhs.count) == 0;
+    return string_memory_equal(lhs.data, rhs.data, lhs.count);
+}
+
+b8 strings_equal_ignore_case(const string &lhs, const string &rhs) {
+    if(lhs.count != rhs.count) return false;
+
+    return string_memory_equal_ignore_case(lhs.data, rhs.data, lhs.count);
 }
 
 b8 string_starts_with(string lhs, string rhs) {
     if(rhs.count > lhs.count) return false;
 
-    return strings_equal(substring_view(lhs, 0, rhs.count), rhs);
+    return string_memory_equal(lhs.data, rhs.data, rhs.count);
+}
+
+b8 string_starts_with_ignore_case(string lhs, string rhs) {
+    if(rhs.count > lhs.count) return false;
+
+    return string_memory_equal_ignore_case(lhs.data, rhs.data, rhs.count);
 }
 
 b8 string_ends_with(string lhs, string rhs) {
     if(rhs.count > lhs.count) return false;
 
-    return strings_equal(substring_view(lhs, lhs.count - rhs.count, lhs.count), rhs);
+    return string_memory_equal(&lhs.data[lhs.count - rhs.count], rhs.data, rhs.count);
+}
+
+b8 string_ends_with_ignore_case(string lhs, string rhs) {
+    if(rhs.count > lhs.count) return false;
+
+    return string_memory_equal_ignore_case(&lhs.data[lhs.count - rhs.count], rhs.data, rhs.count);
 }
 
 
@@ -373,453 +758,1569 @@ u64 string_hash(char const *input) {
     return hash;
 }
 
+u64 string_hash_ignore_case(const string &input) {
+    // fnv1a_64 hash
+    u64 prime = 1099511628211;
+    u64 offset = 14695981039346656037U;
 
-
-/* -------------------------------------------- String Conversion -------------------------------------------- */
-
-s64 string_to_int(string input, b8 *success) {
-    if(input.count <= 0) {
-        if(success) *success = false;
-        return 0;
-    }
-
-    s64 sign = 1;
-    s64 radix = 10;
-    s64 number_start = 0;
-    b8 valid = true;
+    u64 hash = offset;
+    s64 i = 0;
 
     //
-    // Parse a potential sign character.
+    // The hash itself is one long dependency chain of multiplications, so fold eight characters at a time
+    // off that chain, which makes this as fast as string_hash. The steps are unrolled by hand, since a loop
+    // over the bytes of the word costs more than the folding saves.
     //
-    if(input[number_start] == '-') {
-        sign = -1;
-        number_start += 1;
-    } else if(input[number_start] == '+') {
-        number_start += 1;
+    for(; i + 8 <= input.count; i += 8) {
+        u64 word = string_word_to_lower(string_load_u64(&input.data[i]));
+        hash = (hash ^ ((word >>  0) & 0xff)) * prime;
+        hash = (hash ^ ((word >>  8) & 0xff)) * prime;
+        hash = (hash ^ ((word >> 16) & 0xff)) * prime;
+        hash = (hash ^ ((word >> 24) & 0xff)) * prime;
+        hash = (hash ^ ((word >> 32) & 0xff)) * prime;
+        hash = (hash ^ ((word >> 40) & 0xff)) * prime;
+        hash = (hash ^ ((word >> 48) & 0xff)) * prime;
+        hash = (hash ^ ((word >> 56) & 0xff)) * prime;
     }
 
-    //
-    // Parse a potential radix specifier.
-    //
-    if(input.count >= 2 && input[number_start] == '0' && (input[number_start + 1] == 'x' || input[number_start + 1] == 'X')) {
-        radix = 16;
-        number_start += 2;
-    } else if(input.count >= 2 && input[number_start] == '0' && (input[number_start + 1] == 'b' || input[number_start + 1] == 'B')) {
-        radix = 2;
-        number_start += 2;
+    for(; i < input.count; ++i) {
+        hash ^= to_lower_character(input.data[i]);
+        hash *= prime;
     }
 
-    //
-    // Ignore leading zeros.
-    //
-    while(number_start < input.count && (input[number_start] == '0' || input[number_start] == '_')) ++number_start;
-
-    //
-    // Parse each digit and sum the result together.
-    //
-    char character;
-    u64 character_decimal_value;
-    u64 character_power = 1, result = 0;
-    s64 character_index = 0;
-    s64 character_count = input.count - number_start;
+    return hash;
+}
 
-    while(valid && character_index < character_count) {
-        character = input[input.count - character_index - 1];
-        ++character_index;
+u64 string_hash_ignore_case(char const *input) {
+    return string_hash_ignore_case(cstring_view(input));
+}
 
-        if(character == '_') continue;
 
-        switch(radix) {
-        case 2:
-            if(character >= '0' && character <= '1') {
-                character_decimal_value = character - '0';
-            } else {
-                valid = false;
-            }
-            break;
 
-        case 10:
-            if(character >= '0' && character <= '9') {
-                character_decimal_value = character - '0';
-            } else {
-                valid = false;
-            }
-            break;
+/* -------------------------------------------------- Unicode -------------------------------------------------- */
 
-        case 16:
-            if(character >= '0' && character <= '9') {
-                character_decimal_value = character - '0';
-            } else if(character >= 'a' && character <= 'f') {
-                character_decimal_value = character - 'a' + 10;
-            } else if(character >= 'A' && character <= 'F') {
-                character_decimal_value = character - 'A' + 10;
-            } else {
-                valid = false;
-            }
-            break;
-        }
+#define UTF8_INVALID_SEQUENCE ((u32) -1)
 
-        if(!valid) break;
+// Decodes the sequence at the start of data, returns the number of bytes consumed (at least one). Malformed
+// sequences produce UTF8_INVALID_SEQUENCE and consume their maximal valid prefix.
+static inline
+s64 utf8_decode_sequence(const u8 *data, s64 remaining, u32 *code_point) {
+    u8 lead = data[0];
 
-        character_decimal_value = character_decimal_value * character_power;
+    if(lead < 0x80) {
+        *code_point = lead;
+        return 1;
+    }
 
-        b8 addcarry_overflow = _addcarry_u64(0, result, character_decimal_value, &result);
-        u64 previous_character_power = character_power; // Really stupid way of detecting an overflow in the multiplication that doesn't require special instructions
-        character_power *= radix;
-        
-        if(addcarry_overflow || (previous_character_power > character_power && character_index + 1 < character_count)) {
-            valid = false;
-            break;
-        }
+    s64 length;
+    u32 value;
+    u8 lower = 0x80, upper = 0xBF; // The valid range of the next byte. Only the second byte may be restricted further.
+
+    if(lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        value  = lead & 0x1F;
+    } else if(lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        value  = lead & 0x0F;
+        if(lead == 0xE0) lower = 0xA0; // Overlong.
+        if(lead == 0xED) upper = 0x9F; // Surrogates.
+    } else if(lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        value  = lead & 0x07;
+        if(lead == 0xF0) lower = 0x90; // Overlong.
+        if(lead == 0xF4) upper = 0x8F; // Above UNICODE_MAX_CODE_POINT.
+    } else {
+        *code_point = UTF8_INVALID_SEQUENCE;
+        return 1;
     }
 
-    if(success) *success = valid;
-    return result * sign;
-}
+    for(s64 i = 1; i < length; ++i) {
+        if(i >= remaining || data[i] < lower || data[i] > upper) {
+            *code_point = UTF8_INVALID_SEQUENCE;
+            return i;
+        }
 
-f64 string_to_double(string input, b8 *success) {
-    if(input.count <= 0) {
-        if(success) *success = false;
-        return 0;
+        value = (value << 6) | (data[i] & 0x3F);
+        lower = 0x80;
+        upper = 0xBF;
     }
 
-    const f64 radix = 10;
-    f64 sign = 1;
-    b8 valid = true;
+    *code_point = value;
+    return length;
+}
 
-    s64 number_start = 0;
+#if STRING_SIMD_SSSE3
+//
+// Every error bit describes an invalid pair of (previous byte, current byte). The three tables map the high
+// nibble of the previous byte, the low nibble of the previous byte and the high nibble of the current byte to
+// all errors that nibble could take part in.
+//
+#define UTF8_TOO_SHORT         (1 << 0) // 11______ 0_______, 11______ 11______
+#define UTF8_TOO_LONG          (1 << 1) // 0_______ 10______
+#define UTF8_OVERLONG_3        (1 << 2) // 11100000 100_____
+#define UTF8_TOO_LARGE         (1 << 3) // 11110100 1001____, 11110100 101_____, 111101__ 1001____...
+#define UTF8_SURROGATE         (1 << 4) // 11101101 101_____
+#define UTF8_OVERLONG_2        (1 << 5) // 1100000_ 10______
+#define UTF8_TOO_LARGE_1000    (1 << 6) // 11110101 1000____, 1111011_ 1000____, 11111___ 1000____
+#define UTF8_OVERLONG_4        (1 << 6) // 11110000 1000____
+#define UTF8_TWO_CONTINUATIONS (1 << 7) // 10______ 10______
+#define UTF8_CARRY             (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTINUATIONS) // Errors which don't depend on the low nibble.
+
+static inline
+__m128i utf8_high_nibbles(__m128i bytes) {
+    return _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+}
+
+// Returns a non-zero byte for every byte in the block which is part of an invalid sequence. The previous block
+// is needed for sequences crossing the block boundary.
+static inline
+__m128i utf8_block_errors(__m128i block, __m128i previous_block) {
+    __m128i previous1 = _mm_alignr_epi8(block, previous_block, 15);
+
+    __m128i byte_1_high = _mm_shuffle_epi8(_mm_setr_epi8(
+        // 0_______ ________ (ASCII)
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        // 10______ ________ (Continuation)
+        (char) UTF8_TWO_CONTINUATIONS, (char) UTF8_TWO_CONTINUATIONS, (char) UTF8_TWO_CONTINUATIONS, (char) UTF8_TWO_CONTINUATIONS,
+        // 1100____ ________, 1101____ ________ (Two byte lead)
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2, UTF8_TOO_SHORT,
+        // 1110____ ________ (Three byte lead)
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        // 1111____ ________ (Four byte lead)
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4), utf8_high_nibbles(previous1));
+
+    __m128i byte_1_low = _mm_shuffle_epi8(_mm_setr_epi8(
+        // ____0000 ________, ____0001 ________
+        (char) (UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4), (char) (UTF8_CARRY | UTF8_OVERLONG_2),
+        // ____001_ ________
+        (char) UTF8_CARRY, (char) UTF8_CARRY,
+        // ____0100 ________
+        (char) (UTF8_CARRY | UTF8_TOO_LARGE),
+        // ____0101 ________, ____011_ ________
+        (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        // ____1___ ________
+        (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        // ____1101 ________
+        (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE),
+        (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), (char) (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000)), _mm_and_si128(previous1, _mm_set1_epi8(0x0F)));
+
+    __m128i byte_2_high = _mm_shuffle_epi8(_mm_setr_epi8(
+        // ________ 0_______ (ASCII)
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        // ________ 1000____
+        (char) (UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4),
+        // ________ 1001____
+        (char) (UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE),
+        // ________ 101_____
+        (char) (UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE), (char) (UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+        // ________ 11______ (Lead)
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT), utf8_high_nibbles(block));
+
+    __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
 
     //
-    // Parse a potential sign character.
+    // The third and fourth byte of a sequence must be continuations, which the pairs above cannot see. The
+    // bytes two (three) after a three (four) byte lead get bit 7 set, which cancels out UTF8_TWO_CONTINUATIONS.
     //
-    if(input[number_start] == '-') {
-        sign = -1;
-        number_start += 1;
-    } else if(input[number_start] == '+') {
-        number_start += 1;
-    }
+    __m128i previous2 = _mm_alignr_epi8(block, previous_block, 14);
+    __m128i previous3 = _mm_alignr_epi8(block, previous_block, 13);
+    __m128i is_third_byte  = _mm_subs_epu8(previous2, _mm_set1_epi8((char) (0xE0 - 0x80))); // Only 111_____ stays >= 0x80.
+    __m128i is_fourth_byte = _mm_subs_epu8(previous3, _mm_set1_epi8((char) (0xF0 - 0x80))); // Only 1111____ stays >= 0x80.
+    __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8((char) 0x80));
 
-    //
-    // Ignore leading zeros.
-    //
-    while(number_start < input.count && (input[number_start] == '0' || input[number_start] == '_')) ++number_start;
+    return _mm_xor_si128(must_be_continuation, special_cases);
+}
 
-    //
-    // Find the dot seperating the whole from the fractional part.
-    //
-    s64 dot_index = search_string(input, '.');
+// Returns a non-zero byte if the block ends in the middle of a sequence.
+static inline
+__m128i utf8_block_incomplete(__m128i block) {
+    const __m128i maximum = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char) (0xF0 - 1), (char) (0xE0 - 1), (char) (0xC0 - 1));
+    return _mm_subs_epu8(block, maximum);
+}
+#endif
 
-    //
-    // Parse the whole part back to front.
-    //
-    char character;
-    s64 character_index = 0;
-    f64 character_decimal_value, character_power = 1, result = 0;
-    s64 whole_part_size = (dot_index != -1 ? dot_index : input.count);
+b8 is_valid_utf8(string input) {
+#if STRING_SIMD_SSSE3
+    __m128i errors = _mm_setzero_si128();
+    __m128i previous_block = _mm_setzero_si128();
+    __m128i previous_incomplete = _mm_setzero_si128();
 
-    while(character_index + number_start < whole_part_size) {
-        character = input[whole_part_size - character_index - 1];
-        ++character_index;
+    u8 padded[16] = { 0 };
 
-        if(character == '_') continue;
-        
-        if(character < '0' || character > '9') {
-            valid = false;
-            continue;
+    for(s64 i = 0; i <= input.count; i += 16) {
+        __m128i block;
+
+        if(i + 16 <= input.count) {
+            block = _mm_loadu_si128((const __m128i *) &input.data[i]);
+        } else {
+            // Pad the last block with zeros (even if it is empty), so that a sequence cut off by the end of the
+            // input shows up as being too short.
+            memcpy(padded, &input.data[i], input.count - i);
+            block = _mm_loadu_si128((const __m128i *) padded);
         }
-        
-        character_decimal_value = (f64) (character - '0') * character_power;
 
-        feclearexcept(FE_ALL_EXCEPT);
-        result += character_decimal_value;
-        if(fetestexcept(FE_OVERFLOW)) valid = false;
+        if(_mm_movemask_epi8(block) == 0) {
+            // An ASCII block is valid on its own, but the previous block might have ended too early.
+            errors = _mm_or_si128(errors, previous_incomplete);
+            previous_incomplete = _mm_setzero_si128();
+        } else {
+            errors = _mm_or_si128(errors, utf8_block_errors(block, previous_block));
+            previous_incomplete = utf8_block_incomplete(block);
+        }
 
-        character_power = character_power * radix;
+        previous_block = block;
     }
 
-    if(dot_index != -1) {
-        //
-        // Parse the fractional part front to back.
-        //
-        character_power = 0.1;
-        character_index = dot_index + 1;
-
-        while(character_index < input.count) {
-            character = input[character_index];
-            ++character_index;
-            
-            character_decimal_value = (f64) (character - '0') * character_power;
-
-            if(character == '_') continue;
-        
-            if(character < '0' || character > '9') {
-                valid = false;
-                continue;
-            }
-
-            feclearexcept(FE_ALL_EXCEPT);
-            result += character_decimal_value;
-            if(fetestexcept(FE_OVERFLOW)) valid = false;
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(errors, _mm_setzero_si128())) == 0xFFFF;
+#else
+    s64 index = 0;
 
-            character_power = character_power / radix;
-        }
+    while(index < input.count) {
+        u32 code_point;
+        index += utf8_decode_sequence(&input.data[index], input.count - index, &code_point);
+        if(code_point == UTF8_INVALID_SEQUENCE) return false;
     }
 
-    if(success) *success = valid;
-    return result * sign;
+    return true;
+#endif
 }
 
-f32 string_to_float(string input, b8 *success) {
-    f64 _f64 = string_to_double(input, success);
-    return (f32) _f64;
+u32 utf8_decode_next(string input, s64 *index) {
+    assert(*index >= 0 && *index < input.count);
+
+    u32 code_point;
+    *index += utf8_decode_sequence(&input.data[*index], input.count - *index, &code_point);
+    return code_point != UTF8_INVALID_SEQUENCE ? code_point : UNICODE_REPLACEMENT_CHARACTER;
 }
 
-b8 string_to_bool(string input, b8 *success) {
-    if(strings_equal(input, "false"_s) || strings_equal(input, "0"_s)) {
-        if(success) *success = true;
-        return false;
+s64 utf8_encode(u32 code_point, u8 *output) {
+    if((code_point >= 0xD800 && code_point <= 0xDFFF) || code_point > UNICODE_MAX_CODE_POINT) code_point = UNICODE_REPLACEMENT_CHARACTER;
+
+    if(code_point < 0x80) {
+        output[0] = (u8) code_point;
+        return 1;
+    } else if(code_point < 0x800) {
+        output[0] = (u8) (0xC0 | (code_point >> 6));
+        output[1] = (u8) (0x80 | (code_point & 0x3F));
+        return 2;
+    } else if(code_point < 0x10000) {
+        output[0] = (u8) (0xE0 | (code_point >> 12));
+        output[1] = (u8) (0x80 | ((code_point >> 6) & 0x3F));
+        output[2] = (u8) (0x80 | (code_point & 0x3F));
+        return 3;
+    } else {
+        output[0] = (u8) (0xF0 | (code_point >> 18));
+        output[1] = (u8) (0x80 | ((code_point >> 12) & 0x3F));
+        output[2] = (u8) (0x80 | ((code_point >> 6) & 0x3F));
+        output[3] = (u8) (0x80 | (code_point & 0x3F));
+        return 4;
     }
+}
 
-    if(strings_equal(input, "true"_s) || strings_equal(input, "1"_s)) {
-        if(success) *success = true;
-        return true;
+s64 utf8_to_code_points(string input, u32 *code_points) {
+    s64 count = 0;
+    s64 index = 0;
+
+    while(index < input.count) {
+        if(input.data[index] < 0x80 && index + 16 <= input.count) {
+            //
+            // Widen the whole block, but only keep its ASCII prefix. Since every code point consumes at least
+            // one byte, count <= index, so the output has room for all 16 (the rest gets overwritten later).
+            //
+            __m128i block = _mm_loadu_si128((const __m128i *) &input.data[index]);
+            __m128i zero  = _mm_setzero_si128();
+            __m128i low   = _mm_unpacklo_epi8(block, zero);
+            __m128i high  = _mm_unpackhi_epi8(block, zero);
+
+            __m128i *output = (__m128i *) &code_points[count];
+            _mm_storeu_si128(output + 0, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(output + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(output + 3, _mm_unpackhi_epi16(high, zero));
+
+            u32 non_ascii = (u32) _mm_movemask_epi8(block);
+            s64 ascii = non_ascii ? string_lowest_bit(non_ascii) : 16;
+            count += ascii;
+            index += ascii;
+            continue;
+        }
+
+        // Decode sequence by sequence until the next ASCII byte.
+        do {
+            u32 code_point;
+            index += utf8_decode_sequence(&input.data[index], input.count - index, &code_point);
+            code_points[count++] = code_point != UTF8_INVALID_SEQUENCE ? code_point : UNICODE_REPLACEMENT_CHARACTER;
+        } while(index < input.count && input.data[index] >= 0x80);
     }
 
-    if(success) *success = false;
-    return true;
+    return count;
 }
 
 
 
-/* ---------------------------------------------- String Builder ---------------------------------------------- */
+/* ---------------------------------------------- Line Iterator ---------------------------------------------- */
 
-u8 *String_Builder::grow(s64 count) {
-    assert(count < BLOCK_SIZE);
+Character_Masks classify_characters(string _string, s64 offset) {
+    const u8 *data = &_string.data[offset];
 
-    if(!this->current) {
-        // This is the first time the string builder has been used. Set up the
-        // first node without an allocation to provide a fast code path for small
-        // strings.
-        this->current  = &this->first;
-        *this->current = { };
-    } else if(this->current->count + count > BLOCK_SIZE) {
-        // The new data doesn't fit into the current block. We therefore need allocate
-        // a new block, insert it into the linked list, and start using that.
-        Block *block = (Block *) this->allocator->allocate(sizeof(Block));
-        this->current->next = block;
-        this->current       = block;
-        *this->current      = { };
+    u8 padded[CHARACTER_BLOCK_SIZE];
+    if(offset + CHARACTER_BLOCK_SIZE > _string.count) {
+        // Only the last block of a string is incomplete, so copying it is cheap enough.
+        s64 remaining = _string.count - offset;
+        memcpy(padded, data, remaining);
+        memset(&padded[remaining], ' ', CHARACTER_BLOCK_SIZE - remaining);
+        data = padded;
     }
 
-    u8 *pointer = &this->current->data[this->current->count];
-    this->current->count += count;
-    this->total_count    += count;
+    Character_Masks masks;
+    masks.newlines   = 0;
+    masks.whitespace = 0;
 
-    return pointer;
+    String_Register newline = string_register_broadcast('\n');
+    String_Register space   = string_register_broadcast(' ');
+
+    for(s64 i = 0; i < CHARACTER_BLOCK_SIZE; i += STRING_SIMD_WIDTH) {
+        String_Register chunk = string_register_load(&data[i]);
+
+        // A byte is whitespace if it is (unsigned) smaller than or equal to a space, i.e. min(byte, ' ') == byte.
+#if STRING_SIMD_AVX2
+        String_Register clamped = _mm256_min_epu8(chunk, space);
+#else
+        String_Register clamped = _mm_min_epu8(chunk, space);
+#endif
+
+        masks.newlines   |= (u64) string_register_equal_mask(chunk, newline) << i;
+        masks.whitespace |= (u64) string_register_equal_mask(chunk, clamped) << i;
+    }
+
+    return masks;
 }
 
-u64 String_Builder::radix_value(Radix radix, u64 index) {
-    u64 power = 1;
+void Line_Iterator::create(string data) {
+    this->data         = data;
+    this->position     = 0;
+    this->line_number  = 0;
+    this->block_start  = -CHARACTER_BLOCK_SIZE;
+    this->newline_mask = 0;
+}
 
-    switch(radix) {
-    case RADIX_Binary:      power = 1ULL << index; break;
-    case RADIX_Hexadecimal: power = 1ULL << (index * 4); break;
-    case RADIX_Decimal:
-        for(u64 i = 0; i < index; ++i) {
-            power *= 10;
+b8 Line_Iterator::next(string *line) {
+    if(this->position >= this->data.count) return false;
+
+    ++this->line_number;
+
+    while(!this->newline_mask) {
+        this->block_start += CHARACTER_BLOCK_SIZE;
+
+        if(this->block_start >= this->data.count) {
+            // No newline left, so the rest of the data is the last line.
+            line->count    = this->data.count - this->position;
+            line->data     = &this->data.data[this->position];
+            this->position = this->data.count;
+            return true;
         }
-        break;
-    default: power = 1; break;
+
+        this->newline_mask = classify_characters(this->data, this->block_start).newlines;
     }
 
-    return power;
+    s64 end = this->block_start + os_lowest_bit_set(this->newline_mask);
+    this->newline_mask &= this->newline_mask - 1;
+
+    line->count    = end - this->position;
+    line->data     = &this->data.data[this->position];
+    this->position = end + 1;
+    return true;
 }
 
-u64 String_Builder::number_of_required_digits(Radix radix, u64 value) {
-    if(value == 0) return 1;
 
-    u64 count = 0;
 
-    while(value != 0) {
-        value /= radix;
-        ++count;
+/* -------------------------------------------- String Conversion -------------------------------------------- */
+
+//
+// Parsing floating point numbers follows the Eisel-Lemire algorithm (as popularized by fast_float): the
+// decimal digits get gathered into a 64-bit significand w and a decimal exponent q, and w * 10^q = w * 5^q * 2^q
+// is then computed with one (rarely two) 64x64-bit multiplications against a 128-bit approximation of 5^q.
+// That gives the correctly rounded result for every input with at most 19 significant digits. Longer inputs
+// are rounded down to 19 digits; if w and w+1 round to the same float, that is the answer, otherwise (which
+// practically never happens) we fall back to the C runtime.
+// Small integral values with small exponents skip all of that, since they can be computed exactly with a
+// single floating point multiplication or division (Clinger's fast path).
+//
+
+struct Wide_Product {
+    u64 low;
+    u64 high;
+};
+
+static inline
+Wide_Product multiply_u64(u64 lhs, u64 rhs) {
+    Wide_Product result;
+#if FOUNDATION_WIN32
+    result.low = _umul128(lhs, rhs, &result.high);
+#elif FOUNDATION_LINUX
+    unsigned __int128 product = (unsigned __int128) lhs * rhs;
+    result.low  = (u64) product;
+    result.high = (u64) (product >> 64);
+#endif
+    return result;
+}
+
+static inline
+s64 leading_zeros_u64(u64 value) {
+    assert(value != 0);
+#if FOUNDATION_WIN32
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - index;
+#elif FOUNDATION_LINUX
+    return __builtin_clzll(value);
+#endif
+}
+
+// Checks whether all eight bytes of this (little endian) chunk are ascii digits.
+static inline
+b8 is_eight_digits(u64 chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+// Converts eight ascii digits into their value with three multiplications, by combining adjacent digits into
+// pairs, then quadruples, then the full number.
+static inline
+u64 parse_eight_digits(u64 chunk) {
+    const u64 mask = 0x000000FF000000FF;
+    const u64 mul1 = 0x000F424000000064; // 100 + (1000000 << 32)
+    const u64 mul2 = 0x0000271000000001; // 1 + (10000 << 32)
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    return (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+}
+
+static inline
+b8 is_digit_character(u8 character) {
+    return (u8) (character - '0') < 10;
+}
+
+#define MAX_SIGNIFICANT_DIGITS 19 // The most decimal digits that always fit into a u64.
+
+struct Parsed_Decimal {
+    u64 significand; // The (up to) 19 most significant digits.
+    s64 exponent;    // The value is significand * 10^exponent.
+    b8 negative;
+    b8 truncated;    // Non-zero digits had to be dropped from the significand, so it has been rounded down.
+};
+
+struct Digit_Run {
+    s64 kept;    // Digits that went into the significand, including leading zeros.
+    s64 dropped; // Digits that did not fit into the significand anymore.
+};
+
+// Consumes a run of digits (and '_' separators) starting at *index, appending them to the significand for as
+// long as they fit.
+static
+Digit_Run parse_digit_run(string input, s64 *index, Parsed_Decimal *decimal, s64 *significant_digits) {
+    Digit_Run run = { 0, 0 };
+    s64 i = *index;
+
+    while(i < input.count) {
+        if(i + 8 <= input.count && *significant_digits + 8 <= MAX_SIGNIFICANT_DIGITS && (decimal->significand != 0 || input.data[i] != '0')) {
+            u64 chunk = string_load_u64(&input.data[i]);
+            if(is_eight_digits(chunk)) {
+                decimal->significand = decimal->significand * 100000000 + parse_eight_digits(chunk);
+                *significant_digits += 8;
+                run.kept += 8;
+                i += 8;
+                continue;
+            }
+        }
+
+        u8 character = input.data[i];
+        if(character == '_') {
+            ++i;
+            continue;
+        }
+
+        if(!is_digit_character(character)) break;
+
+        u64 digit = character - '0';
+        if(decimal->significand == 0 && digit == 0) {
+            ++run.kept; // A leading zero, which does not count as a significant digit.
+        } else if(*significant_digits < MAX_SIGNIFICANT_DIGITS) {
+            decimal->significand = decimal->significand * 10 + digit;
+            ++*significant_digits;
+            ++run.kept;
+        } else {
+            decimal->truncated |= digit != 0;
+            ++run.dropped;
+        }
+
+        ++i;
+    }
+
+    *index = i;
+    return run;
+}
+
+#if STRING_SIMD_SSSE3
+#define SHORT_DECIMAL_LENGTH 16
+
+// Parses the common case of a number in text files ("12", "-0.375", "1024.5") in one register: Up to 16
+// characters which are all digits, except for at most one '.'. The digits are shuffled together (dropping the
+// '.') and right-aligned, then combined into pairs, quadruples and octets with multiply-adds, just like
+// parse_eight_digits does. Returns false for anything else (exponents, separators, longer numbers), which is
+// then left to the general parser. This may read up to SHORT_DECIMAL_LENGTH bytes from data, so the caller
+// has to check can_parse_short_decimal first.
+static inline
+b8 can_parse_short_decimal(const u8 *data, s64 count) {
+    return count > 0 && count <= SHORT_DECIMAL_LENGTH && ((u64) data & (STRING_PAGE_SIZE - 1)) <= STRING_PAGE_SIZE - SHORT_DECIMAL_LENGTH;
+}
+
+STRING_NO_SANITIZE_ADDRESS
+static
+b8 parse_short_decimal(const u8 *data, s64 count, u64 *significand, s64 *fraction_digits) {
+    assert(count > 0 && count <= SHORT_DECIMAL_LENGTH);
+
+    __m128i chunk  = _mm_loadu_si128((const __m128i *) data);
+    __m128i lanes  = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i digits = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+
+    u32 token_mask = (u32) ((1ULL << count) - 1);
+    u32 digit_mask = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits)) & token_mask;
+    u32 dot_mask   = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('.'))) & token_mask;
+
+    if((digit_mask | dot_mask) != token_mask || (dot_mask & (dot_mask - 1)) != 0 || digit_mask == 0) return false;
+
+    s64 dot         = dot_mask ? string_lowest_bit(dot_mask) : count;
+    s64 digit_count = count - (dot_mask != 0);
+
+    // Lane i of the result takes digit i - (16 - digit_count), which is negative for the leading lanes, so
+    // that pshufb zeroes them. Digits after the '.' are one byte further in the input.
+    __m128i index     = _mm_sub_epi8(lanes, _mm_set1_epi8((char) (SHORT_DECIMAL_LENGTH - digit_count)));
+    __m128i after_dot = _mm_cmpgt_epi8(index, _mm_set1_epi8((char) (dot - 1)));
+    __m128i aligned   = _mm_shuffle_epi8(digits, _mm_sub_epi8(index, after_dot));
+
+    __m128i pairs   = _mm_maddubs_epi16(aligned, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    __m128i quads   = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    __m128i packed  = _mm_packs_epi32(quads, quads);
+    __m128i octets  = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+
+    u64 high = (u32) _mm_cvtsi128_si32(octets);
+    u64 low  = (u32) _mm_cvtsi128_si32(_mm_srli_si128(octets, 4));
+
+    *significand     = high * 100000000 + low;
+    *fraction_digits = dot_mask ? count - dot - 1 : 0;
+    return true;
+}
+#endif
+
+// Parses [+-]digits[.digits][(e|E)[+-]digits], where digits may contain '_' separators. Returns false if the
+// input is not a number in this form.
+static
+b8 parse_decimal(string input, Parsed_Decimal *decimal) {
+    *decimal = { 0, 0, false, false };
+
+    s64 index = 0;
+    if(index < input.count && (input.data[index] == '-' || input.data[index] == '+')) {
+        decimal->negative = input.data[index] == '-';
+        ++index;
+    }
+
+#if STRING_SIMD_SSSE3
+    if(can_parse_short_decimal(&input.data[index], input.count - index)) {
+        s64 fraction_digits;
+        if(parse_short_decimal(&input.data[index], input.count - index, &decimal->significand, &fraction_digits)) {
+            decimal->exponent = -fraction_digits;
+            return true;
+        }
+    }
+#endif
+
+    s64 significant_digits = 0;
+
+    Digit_Run whole = parse_digit_run(input, &index, decimal, &significant_digits);
+    decimal->exponent += whole.dropped;
+    s64 digit_count = whole.kept + whole.dropped;
+
+    if(index < input.count && input.data[index] == '.') {
+        ++index;
+        Digit_Run fraction = parse_digit_run(input, &index, decimal, &significant_digits);
+        decimal->exponent -= fraction.kept;
+        digit_count += fraction.kept + fraction.dropped;
+    }
+
+    if(digit_count == 0) return false;
+
+    if(index < input.count && (input.data[index] == 'e' || input.data[index] == 'E')) {
+        ++index;
+
+        b8 negative_exponent = false;
+        if(index < input.count && (input.data[index] == '-' || input.data[index] == '+')) {
+            negative_exponent = input.data[index] == '-';
+            ++index;
+        }
+
+        s64 exponent_start = index;
+        s64 exponent = 0;
+        while(index < input.count && is_digit_character(input.data[index])) {
+            if(exponent < 0x10000000) exponent = exponent * 10 + (input.data[index] - '0'); // Anything bigger over- or underflows anyway.
+            ++index;
+        }
+
+        if(index == exponent_start) return false;
+
+        decimal->exponent += negative_exponent ? -exponent : exponent;
+    }
+
+    return index == input.count;
+}
+
+template<typename Float>
+struct Float_Traits;
+
+template<>
+struct Float_Traits<f64> {
+    typedef u64 Bits;
+    static const s64 MANTISSA_BITS              = 52;
+    static const s64 MIN_EXPONENT               = -1023;
+    static const s64 INFINITE_POWER             = 0x7FF;
+    static const s64 SMALLEST_POWER_OF_TEN      = -342; // Anything smaller rounds to zero.
+    static const s64 LARGEST_POWER_OF_TEN       = 308;  // Anything bigger rounds to infinity.
+    static const s64 MIN_EXPONENT_ROUND_TO_EVEN = -4;   // Only in this range of decimal exponents can w * 10^q be exactly halfway between two floats.
+    static const s64 MAX_EXPONENT_ROUND_TO_EVEN = 23;
+    static const s64 MAX_EXPONENT_FAST_PATH     = 22;   // The largest power of ten that is exactly representable.
+    static const u64 MAX_MANTISSA_FAST_PATH     = 2ULL << 52;
+};
+
+template<>
+struct Float_Traits<f32> {
+    typedef u32 Bits;
+    static const s64 MANTISSA_BITS              = 23;
+    static const s64 MIN_EXPONENT               = -127;
+    static const s64 INFINITE_POWER             = 0xFF;
+    static const s64 SMALLEST_POWER_OF_TEN      = -65;
+    static const s64 LARGEST_POWER_OF_TEN       = 38;
+    static const s64 MIN_EXPONENT_ROUND_TO_EVEN = -17;
+    static const s64 MAX_EXPONENT_ROUND_TO_EVEN = 10;
+    static const s64 MAX_EXPONENT_FAST_PATH     = 10;
+    static const u64 MAX_MANTISSA_FAST_PATH     = 2ULL << 23;
+};
+
+static const f64 exact_powers_of_ten_f64[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static const f32 exact_powers_of_ten_f32[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
+static inline f64 exact_power_of_ten(f64, s64 exponent) { return exact_powers_of_ten_f64[exponent]; }
+static inline f32 exact_power_of_ten(f32, s64 exponent) { return exact_powers_of_ten_f32[exponent]; }
+
+struct Adjusted_Mantissa {
+    u64 mantissa; // Without the implicit bit.
+    s64 power2;   // The biased binary exponent.
+
+    b8 operator==(Adjusted_Mantissa const &other) const { return this->mantissa == other.mantissa && this->power2 == other.power2; }
+    b8 operator!=(Adjusted_Mantissa const &other) const { return !(*this == other); }
+};
+
+// Computes the correctly rounded (to nearest, ties to even) binary float closest to w * 10^q.
+template<typename Float>
+static
+Adjusted_Mantissa compute_float(s64 q, u64 w) {
+    typedef Float_Traits<Float> Traits;
+
+    if(w == 0 || q < Traits::SMALLEST_POWER_OF_TEN) return { 0, 0 };
+    if(q > Traits::LARGEST_POWER_OF_TEN) return { 0, Traits::INFINITE_POWER };
+
+    s64 lz = leading_zeros_u64(w);
+    w <<= lz;
+
+    //
+    // Multiply the normalized significand by the 128-bit power of five. We only need the high bits of the
+    // product, and the first multiplication is already exact enough unless all the bits below the ones we
+    // keep (plus the rounding bits) are set, in which case the low half of the power may still carry into them.
+    //
+    const u64 precision_mask = 0xFFFFFFFFFFFFFFFF >> (Traits::MANTISSA_BITS + 3);
+    s64 index = 2 * (q - POWER_OF_FIVE_MIN_EXPONENT);
+
+    Wide_Product product = multiply_u64(w, power_of_five_128[index]);
+    if((product.high & precision_mask) == precision_mask) {
+        Wide_Product second = multiply_u64(w, power_of_five_128[index + 1]);
+        product.low += second.high;
+        if(second.high > product.low) ++product.high;
+    }
+
+    s64 upper_bit = (s64) (product.high >> 63);
+    s64 shift     = upper_bit + 64 - Traits::MANTISSA_BITS - 3;
+    s64 power     = (((152170 + 65536) * q) >> 16) + 63; // floor(log2(10^q)) + 63, exact for |q| < 1700.
+
+    Adjusted_Mantissa result;
+    result.mantissa = product.high >> shift;
+    result.power2   = power + upper_bit - lz - Traits::MIN_EXPONENT;
+
+    if(result.power2 <= 0) {
+        // The result is subnormal (or rounds to zero).
+        if(-result.power2 + 1 >= 64) return { 0, 0 };
+
+        result.mantissa >>= -result.power2 + 1;
+        result.mantissa += result.mantissa & 1;
+        result.mantissa >>= 1;
+        result.power2 = result.mantissa < (1ULL << Traits::MANTISSA_BITS) ? 0 : 1; // Rounding up may have made it a normal float.
+        return result;
+    }
+
+    // If the product was exact and we are exactly halfway between two floats, round to even instead of up.
+    if(product.low <= 1 && q >= Traits::MIN_EXPONENT_ROUND_TO_EVEN && q <= Traits::MAX_EXPONENT_ROUND_TO_EVEN && (result.mantissa & 3) == 1) {
+        if((result.mantissa << shift) == product.high) result.mantissa &= ~1ULL;
+    }
+
+    result.mantissa += result.mantissa & 1;
+    result.mantissa >>= 1;
+
+    if(result.mantissa >= (2ULL << Traits::MANTISSA_BITS)) {
+        // Rounding up overflowed into the next binade.
+        result.mantissa = 1ULL << Traits::MANTISSA_BITS;
+        ++result.power2;
+    }
+
+    result.mantissa &= ~(1ULL << Traits::MANTISSA_BITS);
+
+    if(result.power2 >= Traits::INFINITE_POWER) return { 0, Traits::INFINITE_POWER };
+
+    return result;
+}
+
+template<typename Float>
+static
+Float assemble_float(Adjusted_Mantissa adjusted, b8 negative) {
+    typedef Float_Traits<Float> Traits;
+    typename Traits::Bits bits = (typename Traits::Bits) (adjusted.mantissa | ((u64) adjusted.power2 << Traits::MANTISSA_BITS) | ((u64) negative << (sizeof(Float) * 8 - 1)));
+
+    Float result;
+    memcpy(&result, &bits, sizeof(Float));
+    return result;
+}
+
+static inline f64 parse_with_c_runtime(f64, const char *cstring) { return strtod(cstring, null); }
+static inline f32 parse_with_c_runtime(f32, const char *cstring) { return strtof(cstring, null); }
+
+static
+b8 equal_ignoring_case(string input, s64 offset, string expected) {
+    if(input.count - offset != expected.count) return false;
+
+    for(s64 i = 0; i < expected.count; ++i) {
+        if(to_lower_character(input.data[offset + i]) != expected.data[i]) return false;
+    }
+
+    return true;
+}
+
+template<typename Float>
+static
+Float parse_float(string input, b8 *success) {
+    typedef Float_Traits<Float> Traits;
+
+    Parsed_Decimal decimal;
+    if(!parse_decimal(input, &decimal)) {
+        //
+        // Accept the special values the string builder produces for infinities and nans.
+        //
+        s64 offset = (input.count > 0 && (input.data[0] == '-' || input.data[0] == '+')) ? 1 : 0;
+        b8 negative = offset == 1 && input.data[0] == '-';
+
+        if(equal_ignoring_case(input, offset, "inf"_s) || equal_ignoring_case(input, offset, "infinity"_s)) {
+            if(success) *success = true;
+            return assemble_float<Float>({ 0, Traits::INFINITE_POWER }, negative);
+        }
+
+        if(equal_ignoring_case(input, offset, "nan"_s)) {
+            if(success) *success = true;
+            return assemble_float<Float>({ 1ULL << (Traits::MANTISSA_BITS - 1), Traits::INFINITE_POWER }, negative);
+        }
+
+        if(success) *success = false;
+        return 0;
+    }
+
+    //
+    // Clinger's fast path: Both the significand and the power of ten are exactly representable, so a single
+    // (correctly rounded) floating point operation gives the correctly rounded result.
+    //
+    if(!decimal.truncated && decimal.significand <= Traits::MAX_MANTISSA_FAST_PATH && decimal.exponent >= -Traits::MAX_EXPONENT_FAST_PATH && decimal.exponent <= Traits::MAX_EXPONENT_FAST_PATH) {
+        Float value = (Float) decimal.significand;
+        if(decimal.exponent < 0) {
+            value = value / exact_power_of_ten(value, -decimal.exponent);
+        } else {
+            value = value * exact_power_of_ten(value, decimal.exponent);
+        }
+
+        if(success) *success = true;
+        return decimal.negative ? -value : value;
+    }
+
+    Adjusted_Mantissa adjusted = compute_float<Float>(decimal.exponent, decimal.significand);
+
+    if(decimal.truncated && adjusted != compute_float<Float>(decimal.exponent, decimal.significand + 1)) {
+        //
+        // The dropped digits decide the rounding, so let the C runtime handle the full input. It does not know
+        // about our digit separators though.
+        //
+        char *cstring = (char *) Default_Allocator->allocate(input.count + 1);
+        s64 length = 0;
+
+        for(s64 i = 0; i < input.count; ++i) {
+            if(input.data[i] != '_') cstring[length++] = input.data[i];
+        }
+
+        cstring[length] = 0;
+
+        Float value = parse_with_c_runtime((Float) 0, cstring);
+        Default_Allocator->deallocate(cstring);
+
+        if(success) *success = value - value == 0; // False for infinities, i.e. on overflow.
+        return value;
+    }
+
+    // Like before, report overflows as failures (but still return the infinity).
+    if(success) *success = adjusted.power2 != Traits::INFINITE_POWER;
+    return assemble_float<Float>(adjusted, decimal.negative);
+}
+
+s64 string_to_int(string input, b8 *success) {
+    s64 index = 0;
+    b8 negative = false;
+
+    //
+    // Parse a potential sign character.
+    //
+    if(index < input.count && (input.data[index] == '-' || input.data[index] == '+')) {
+        negative = input.data[index] == '-';
+        ++index;
+    }
+
+    //
+    // Parse a potential radix specifier.
+    //
+    u64 radix = 10;
+
+    if(index + 1 < input.count && input.data[index] == '0' && (input.data[index + 1] == 'x' || input.data[index + 1] == 'X')) {
+        radix = 16;
+        index += 2;
+    } else if(index + 1 < input.count && input.data[index] == '0' && (input.data[index + 1] == 'b' || input.data[index + 1] == 'B')) {
+        radix = 2;
+        index += 2;
+    }
+
+#if STRING_SIMD_SSSE3
+    // Sixteen digits always fit, a '.' is not part of an integer.
+    if(radix == 10 && can_parse_short_decimal(&input.data[index], input.count - index)) {
+        u64 result;
+        s64 fraction_digits;
+        if(parse_short_decimal(&input.data[index], input.count - index, &result, &fraction_digits) && fraction_digits == 0 && input.data[input.count - 1] != '.') {
+            if(success) *success = true;
+            return (s64) (negative ? 0 - result : result);
+        }
+    }
+#endif
+
+    //
+    // Parse the digits front to back, detecting an overflow of the u64 before it happens. Values above
+    // MAX_S64 are allowed so that this can also be used to parse u64s.
+    //
+    u64 limit  = MAX_U64 / radix;
+    u64 result = 0;
+    s64 digit_count = 0;
+    b8 valid = true;
+
+    while(index < input.count) {
+        if(radix == 10 && index + 8 <= input.count && result < 100000000000ULL) { // result * 10^8 + 99999999 fits into a u64.
+            u64 chunk = string_load_u64(&input.data[index]);
+            if(is_eight_digits(chunk)) {
+                result = result * 100000000 + parse_eight_digits(chunk);
+                digit_count += 8;
+                index += 8;
+                continue;
+            }
+        }
+
+        u8 character = input.data[index];
+        ++index;
+
+        if(character == '_') continue;
+
+        u64 digit;
+        if(character >= '0' && character <= '9') {
+            digit = character - '0';
+        } else if(character >= 'a' && character <= 'f') {
+            digit = character - 'a' + 10;
+        } else if(character >= 'A' && character <= 'F') {
+            digit = character - 'A' + 10;
+        } else {
+            valid = false;
+            break;
+        }
+
+        if(digit >= radix || result > limit || (result == limit && digit > MAX_U64 - limit * radix)) {
+            valid = false;
+            break;
+        }
+
+        result = result * radix + digit;
+        ++digit_count;
+    }
+
+    if(success) *success = valid && digit_count > 0;
+    return (s64) (negative ? 0 - result : result);
+}
+
+f64 string_to_double(string input, b8 *success) {
+    return parse_float<f64>(input, success);
+}
+
+f32 string_to_float(string input, b8 *success) {
+    return parse_float<f32>(input, success);
+}
+
+b8 string_to_bool(string input, b8 *success) {
+    if(strings_equal(input, "false"_s) || strings_equal(input, "0"_s)) {
+        if(success) *success = true;
+        return false;
+    }
+
+    if(strings_equal(input, "true"_s) || strings_equal(input, "1"_s)) {
+        if(success) *success = true;
+        return true;
+    }
+
+    if(success) *success = false;
+    return true;
+}
+
+
+
+/* ---------------------------------------------- String Builder ---------------------------------------------- */
+
+u8 *String_Builder::grow(s64 count) {
+    if(!this->current || this->current->count + count > this->current->capacity) this->make_room(count);
+
+    u8 *pointer = &this->current->data[this->current->count];
+    this->current->count += count;
+    this->total_count    += count;
+
+    return pointer;
+}
+
+void String_Builder::make_room(s64 count) {
+    if(!this->current) {
+        // This is the first time the string builder has been used. Set up the
+        // first node without an allocation to provide a fast code path for small
+        // strings.
+        this->current           = &this->first;
+        this->current->next     = null;
+        this->current->count    = 0;
+        this->current->capacity = FIRST_BLOCK_SIZE;
+    }
+
+    if(this->current->count + count <= this->current->capacity) return;
+
+    //
+    // A streaming builder writes everything out once it has buffered enough, and then starts over with its
+    // first block.
+    //
+    if(this->sink != INVALID_FILE_HANDLE && this->total_count >= MAX_BLOCK_SIZE) {
+        this->flush();
+        if(this->current->count + count <= this->current->capacity) return;
+    }
+
+    //
+    // Blocks after the current one are empty, left over from before the last flush. Reuse the next one if it
+    // is big enough, otherwise insert a new block in front of it.
+    //
+    Block *next = this->current->next;
+    if(next && next->capacity >= count) {
+        this->current = next;
+        return;
+    }
+
+    s64 capacity = MAX(MIN(this->current->capacity * 2, MAX_BLOCK_SIZE), count);
+
+    Block *block    = (Block *) this->allocator->allocate(sizeof(Block) - FIRST_BLOCK_SIZE + MAX(capacity, FIRST_BLOCK_SIZE));
+    block->next     = next;
+    block->count    = 0;
+    block->capacity = capacity;
+
+    this->current->next = block;
+    this->current       = block;
+}
+
+//
+// Integers are formatted two decimal digits at a time through a lookup table, after computing the exact digit
+// count up front (from the position of the highest set bit), so that the digits can be written straight into
+// place back to front.
+// Floating point values are formatted with Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly
+// and Accurately with Integers"): the value and its rounding boundaries are scaled by a cached power of ten
+// into a range where their digits can be generated with 64-bit integer arithmetic only. The output always
+// parses back to the exact same value, and it is the shortest such digit string in all but very rare cases.
+//
+
+static const char decimal_digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const u64 powers_of_ten_u64[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+    10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+static inline
+s64 decimal_digit_count(u64 value) {
+    value |= 1; // Zero still has one digit. This does not change the count of any other value, since 10^k - 1 is odd.
+    s64 bits     = 64 - leading_zeros_u64(value);
+    s64 estimate = (bits * 1233) >> 12; // bits * log10(2), which is either exact or one too small.
+    return estimate + (value >= powers_of_ten_u64[estimate]);
+}
+
+// Writes the digits of value into the buffer (which needs room for 64 characters), returns the digit count.
+static
+s64 format_u64(char *buffer, Radix radix, u64 value) {
+    static const char digit_characters[] = "0123456789abcdef";
+
+    s64 count;
+
+    switch(radix) {
+    case RADIX_Decimal: {
+        count = decimal_digit_count(value);
+        char *end = buffer + count;
+
+        while(value >= 100) {
+            end -= 2;
+            memcpy(end, &decimal_digit_pairs[(value % 100) * 2], 2);
+            value /= 100;
+        }
+
+        if(value >= 10) {
+            memcpy(end - 2, &decimal_digit_pairs[value * 2], 2);
+        } else {
+            end[-1] = (char) ('0' + value);
+        }
+    } break;
+
+    case RADIX_Binary:
+    case RADIX_Octal:
+    case RADIX_Hexadecimal: {
+        s64 bits_per_digit = radix == RADIX_Binary ? 1 : (radix == RADIX_Octal ? 3 : 4);
+        s64 bits = 64 - leading_zeros_u64(value | 1);
+        count = (bits + bits_per_digit - 1) / bits_per_digit;
+
+        for(s64 i = count - 1; i >= 0; --i) {
+            buffer[i] = digit_characters[value & (radix - 1)];
+            value >>= bits_per_digit;
+        }
+    } break;
+
+    default: assert(false && "Invalid radix for integer formatting."); count = 0; break;
     }
 
     return count;
 }
 
-u64 String_Builder::number_of_required_digits(Radix radix, s64 value) {
-    if(value == 0) return 1;
+struct Diy_Fp {
+    u64 f; // The significand.
+    s64 e; // The binary exponent, so that the value is f * 2^e.
+};
+
+static inline
+Diy_Fp diy_fp_multiply(Diy_Fp lhs, Diy_Fp rhs) {
+    // Only keep the (rounded) upper 64 bits of the product.
+    Wide_Product product = multiply_u64(lhs.f, rhs.f);
+    return { product.high + (product.low >> 63), lhs.e + rhs.e + 64 };
+}
 
-    u64 count = 0;
+static inline
+Diy_Fp diy_fp_normalize(Diy_Fp value) {
+    s64 shift = leading_zeros_u64(value.f);
+    return { value.f << shift, value.e - shift };
+}
+
+// Returns the cached power of ten c = 10^-K, so that the product with a normalized value whose binary exponent is
+// e lands in the binary exponent range [-60, -32], which DigitGen relies on.
+static
+Diy_Fp get_cached_power(s64 e, s64 *K) {
+    f64 dk = (f64) (-61 - e) * 0.30102999566398114 + 347; // This is always positive, so the ceil can be done by hand.
+    s64 k  = (s64) dk;
+    if(dk - (f64) k > 0.0) ++k;
+
+    s64 index = (k >> 3) + 1;
+    *K = -(CACHED_POWER_MIN_EXPONENT + index * CACHED_POWER_STEP);
+    return { cached_power_significands[index], cached_power_binary_exponents[index] };
+}
+
+// Moves the last digit towards the exact value for as long as that stays inside the rounding boundaries.
+static inline
+void grisu_round(char *buffer, s64 length, u64 delta, u64 rest, u64 ten_kappa, u64 distance) {
+    while(rest < distance && delta - rest >= ten_kappa && (rest + ten_kappa < distance || distance - rest > rest + ten_kappa - distance)) {
+        --buffer[length - 1];
+        rest += ten_kappa;
+    }
+}
+
+static
+void grisu_generate_digits(Diy_Fp w, Diy_Fp upper, u64 delta, char *buffer, s64 *length, s64 *K) {
+    Diy_Fp one = { 1ULL << -upper.e, upper.e };
+    u64 distance = upper.f - w.f;
+
+    u32 integral   = (u32) (upper.f >> -one.e);
+    u64 fractional = upper.f & (one.f - 1);
+    s64 kappa      = decimal_digit_count(integral);
+
+    *length = 0;
+
+    while(kappa > 0) {
+        u64 power = powers_of_ten_u64[kappa - 1];
+        u32 digit = (u32) (integral / power);
+        integral  = (u32) (integral % power);
+
+        if(digit || *length) buffer[(*length)++] = (char) ('0' + digit);
+        --kappa;
+
+        u64 rest = ((u64) integral << -one.e) + fractional;
+        if(rest <= delta) {
+            *K += kappa;
+            grisu_round(buffer, *length, delta, rest, powers_of_ten_u64[kappa] << -one.e, distance);
+            return;
+        }
+    }
+
+    while(true) {
+        fractional *= 10;
+        delta      *= 10;
+
+        char digit = (char) (fractional >> -one.e);
+        if(digit || *length) buffer[(*length)++] = (char) ('0' + digit);
+
+        fractional &= one.f - 1;
+        --kappa;
+
+        if(fractional < delta) {
+            *K += kappa;
+            grisu_round(buffer, *length, delta, fractional, one.f, -kappa < 20 ? distance * powers_of_ten_u64[-kappa] : 0);
+            return;
+        }
+    }
+}
+
+// Splits a positive, finite value into its exact significand * 2^exponent.
+template<typename Float>
+static inline
+Diy_Fp decompose_float(Float value) {
+    typedef Float_Traits<Float> Traits;
+
+    u64 bits = 0;
+    memcpy(&bits, &value, sizeof(Float));
+
+    const s64 exponent_bias = -Traits::MIN_EXPONENT + Traits::MANTISSA_BITS;
+    const u64 hidden_bit    = 1ULL << Traits::MANTISSA_BITS;
+
+    u64 biased_exponent = bits >> Traits::MANTISSA_BITS;
+    u64 significand     = bits & (hidden_bit - 1);
+
+    if(biased_exponent != 0) {
+        return { significand + hidden_bit, (s64) biased_exponent - exponent_bias };
+    } else {
+        return { significand, 1 - exponent_bias }; // Subnormal.
+    }
+}
+
+// Generates the shortest (in almost all cases) digits for a positive, finite value, so that it equals
+// digits * 10^K. The buffer needs room for 18 digits.
+template<typename Float>
+static
+void grisu2(Float value, char *buffer, s64 *length, s64 *K) {
+    typedef Float_Traits<Float> Traits;
+
+    const u64 hidden_bit = 1ULL << Traits::MANTISSA_BITS;
+
+    Diy_Fp v = decompose_float(value);
+
+    //
+    // The boundaries are halfway between v and its neighbours. The lower neighbour is closer if v is a power
+    // of two, since the exponent changes right below it.
+    //
+    Diy_Fp upper = diy_fp_normalize({ (v.f << 1) + 1, v.e - 1 });
+    Diy_Fp lower = (v.f == hidden_bit) ? Diy_Fp{ (v.f << 2) - 1, v.e - 2 } : Diy_Fp{ (v.f << 1) - 1, v.e - 1 };
+    lower.f <<= lower.e - upper.e;
+    lower.e   = upper.e;
+
+    Diy_Fp cached = get_cached_power(upper.e, K);
+    Diy_Fp w      = diy_fp_multiply(diy_fp_normalize(v), cached);
+
+    // The scaled boundaries are imprecise by one unit, so shrink the interval to stay on the safe side.
+    upper = diy_fp_multiply(upper, cached);
+    lower = diy_fp_multiply(lower, cached);
+    ++lower.f;
+    --upper.f;
+
+    grisu_generate_digits(w, upper, upper.f - lower.f, buffer, length, K);
+}
+
+//
+// Output with a fixed precision cannot be rounded from the shortest digits, since these are already rounded
+// (17.365 is really 17.364999..., but its shortest digits would round up to 17.37). Instead, all digits of the
+// exact binary value are generated with a small big integer: significand * 2^e is either an integer, or
+// significand * 5^-e * 10^e. This is slow for extremely small or large values, which have hundreds of digits.
+//
+
+#define EXACT_DECIMAL_DIGITS 800 // A double has at most 767 significant digits (for the smallest subnormals).
+#define EXACT_DECIMAL_LIMBS  84  // 2^53 * 5^1074 has fewer than 2560 bits.
+
+struct Exact_Decimal_Integer {
+    u32 limbs[EXACT_DECIMAL_LIMBS]; // Least significant first.
+    s64 count;
+};
+
+static
+void exact_decimal_multiply(Exact_Decimal_Integer *integer, u32 factor) {
+    u64 carry = 0;
+    for(s64 i = 0; i < integer->count; ++i) {
+        u64 product = (u64) integer->limbs[i] * factor + carry;
+        integer->limbs[i] = (u32) product;
+        carry = product >> 32;
+    }
+
+    if(carry) {
+        assert(integer->count < EXACT_DECIMAL_LIMBS);
+        integer->limbs[integer->count++] = (u32) carry;
+    }
+}
+
+static
+void exact_decimal_shift_left(Exact_Decimal_Integer *integer, s64 shift) {
+    s64 limb_shift = shift / 32;
+    s64 bit_shift  = shift % 32;
+    assert(integer->count + limb_shift + 1 <= EXACT_DECIMAL_LIMBS);
+
+    integer->limbs[integer->count + limb_shift] = 0;
+    for(s64 i = integer->count - 1; i >= 0; --i) {
+        u64 shifted = (u64) integer->limbs[i] << bit_shift;
+        integer->limbs[i + limb_shift + 1] |= (u32) (shifted >> 32);
+        integer->limbs[i + limb_shift] = (u32) shifted;
+    }
+
+    for(s64 i = 0; i < limb_shift; ++i) integer->limbs[i] = 0;
+    integer->count += limb_shift + 1;
+    while(integer->count > 1 && integer->limbs[integer->count - 1] == 0) --integer->count;
+}
+
+// Divides the integer by 10^9 in place, returns the remainder.
+static
+u32 exact_decimal_divide(Exact_Decimal_Integer *integer) {
+    u64 remainder = 0;
+    for(s64 i = integer->count - 1; i >= 0; --i) {
+        u64 current = (remainder << 32) | integer->limbs[i];
+        integer->limbs[i] = (u32) (current / 1000000000);
+        remainder = current % 1000000000;
+    }
+
+    while(integer->count > 0 && integer->limbs[integer->count - 1] == 0) --integer->count;
+    return (u32) remainder;
+}
+
+// Generates all digits of a positive, finite value without trailing zeros, so that it equals digits * 10^K.
+// The buffer needs room for EXACT_DECIMAL_DIGITS characters.
+template<typename Float>
+static
+void exact_decimal_digits(Float value, char *buffer, s64 *length, s64 *K) {
+    Diy_Fp v = decompose_float(value);
+
+    Exact_Decimal_Integer integer;
+    integer.limbs[0] = (u32) v.f;
+    integer.limbs[1] = (u32) (v.f >> 32);
+    integer.count    = integer.limbs[1] ? 2 : 1;
+
+    if(v.e >= 0) {
+        exact_decimal_shift_left(&integer, v.e);
+        *K = 0;
+    } else {
+        s64 power = -v.e;
+        for(; power >= 13; power -= 13) exact_decimal_multiply(&integer, 1220703125); // 5^13
+        if(power > 0) exact_decimal_multiply(&integer, (u32) (powers_of_ten_u64[power] >> power)); // 10^p / 2^p = 5^p
+        *K = v.e;
+    }
+
+    //
+    // Produce the digits in chunks of nine from the back, then move them to the front of the buffer.
+    //
+    char *end    = buffer + EXACT_DECIMAL_DIGITS;
+    char *cursor = end;
+
+    while(integer.count > 0) {
+        u32 chunk = exact_decimal_divide(&integer);
+        for(s64 i = 0; i < 9; ++i) {
+            *--cursor = (char) ('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+
+    while(cursor < end - 1 && *cursor == '0') ++cursor;
+    while(end - 1 > cursor && end[-1] == '0') {
+        --end;
+        ++*K;
+    }
+
+    *length = end - cursor;
+    memmove(buffer, cursor, *length);
+}
+
+// Rounds the exact digits to nearest (ties to even, like the C runtime) so that only count of them remain,
+// returns the new digit count. If all digits round up (999 -> 1000), the decimal point moves one to the right.
+static
+s64 round_decimal_digits(char *digits, s64 length, s64 count, s64 *point) {
+    if(count >= length) return length;
+
+    if(count < 0) return 0;
+
+    // The digits have no trailing zeros, so the value is exactly halfway if the first dropped digit is the
+    // last one and a five.
+    b8 halfway  = digits[count] == '5' && count + 1 == length;
+    b8 round_up = halfway ? (count > 0 && (digits[count - 1] - '0') % 2 == 1) : digits[count] >= '5';
+    length = count;
+
+    if(round_up) {
+        s64 i = length - 1;
+        while(i >= 0 && digits[i] == '9') --i;
+
+        if(i < 0) {
+            digits[0] = '1';
+            length = 1;
+            ++*point;
+        } else {
+            ++digits[i];
+            length = i + 1;
+        }
+    }
+
+    return length;
+}
+
+//
+// Writes a floating point number given as sign and digits * 10^(point - length), i.e. the decimal point is in
+// front of digits[point]. The output is formatted like this:
+//   If fractionals is MAX_U8, the digits are printed as is. Values from 1e-4 up to 1e16 are printed
+//   positionally, always with at least one fractional digit ("1.0", "0.001"), everything else in scientific
+//   notation ("1e+16", "1.5e-07").
+//   Otherwise the value is rounded to that many fractional digits (and printed without a decimal point if
+//   that is zero).
+//   If digits is not MAX_U8, the integral part is padded with leading zeros to that many digits.
+//   If exponent_character is not zero, the value is always printed in scientific notation with that
+//   character, rounded to the given number of fractional digits (if any).
+// Returns the number of characters written. The buffer needs room for 1024 characters.
+//
+static
+s64 format_decimal_float(char *buffer, char *digits, s64 length, s64 point, b8 negative, char exponent_character, String_Builder_Format format) {
+    s64 count = 0;
+
+    if(negative) {
+        buffer[count++] = '-';
+    } else if(format.prefix) {
+        buffer[count++] = '+';
+    }
+
+    b8 shortest = format.fractionals == MAX_U8;
+
+    if(exponent_character || (shortest && (point < -3 || point > 16))) {
+        //
+        // Scientific notation.
+        //
+        s64 fractionals = length - 1;
+
+        if(!shortest) {
+            fractionals = format.fractionals;
+            length = round_decimal_digits(digits, length, fractionals + 1, &point);
+        }
+
+        buffer[count++] = digits[0];
+
+        if(fractionals > 0) {
+            buffer[count++] = '.';
+            for(s64 i = 1; i <= fractionals; ++i) buffer[count++] = i < length ? digits[i] : '0';
+        }
+
+        s64 exponent = point - 1;
+        buffer[count++] = exponent_character ? exponent_character : 'e';
+        buffer[count++] = exponent < 0 ? '-' : '+';
+        if(exponent < 0) exponent = -exponent;
+
+        if(exponent >= 100) {
+            buffer[count++] = (char) ('0' + exponent / 100);
+            exponent %= 100;
+        }
+
+        memcpy(&buffer[count], &decimal_digit_pairs[exponent * 2], 2);
+        count += 2;
+        return count;
+    }
+
+    s64 fractionals;
+    if(shortest) {
+        fractionals = MAX(length - point, 1);
+    } else {
+        fractionals = format.fractionals;
+        length = round_decimal_digits(digits, length, point + fractionals, &point);
+    }
+
+    //
+    // Print the integral part, with leading zeros.
+    //
+    s64 integral_digits = MAX(point, 1);
 
-    while(value != 0) {
-        value /= radix;
-        ++count;
+    if(format.digits != MAX_U8) {
+        for(s64 i = integral_digits; i < format.digits; ++i) buffer[count++] = '0';
     }
 
-    return count;
-}
-
-u64 String_Builder::number_of_required_digits(f64 value) {
-    if(value == 0) return 1;
+    for(s64 i = 0; i < integral_digits; ++i) {
+        s64 index = point - integral_digits + i;
+        buffer[count++] = (index >= 0 && index < length) ? digits[index] : '0';
+    }
 
-    u64 count = 0;
+    //
+    // Print the fractional part.
+    //
+    if(fractionals > 0) {
+        buffer[count++] = '.';
 
-    while(value >= 1 || value <= -1) {
-        value /= 10;
-        ++count;
+        for(s64 i = 0; i < fractionals; ++i) {
+            s64 index = point + i;
+            buffer[count++] = (index >= 0 && index < length) ? digits[index] : '0';
+        }
     }
 
     return count;
 }
 
-void String_Builder::append_string_builder_format(String_Builder_Format format) {
-    if(format.prefix) {
-        switch(format.radix) {
-        case RADIX_Binary: this->append_string("0b"_s); break;
-        case RADIX_Hexadecimal: this->append_string("0x"_s); break;
-        default: break; // So that clang doesn't complain
-        }
+// Formats any floating point value (including nan and inf) as described in format_decimal_float. Returns the
+// number of characters written. The buffer needs room for 1024 characters.
+template<typename Float>
+static
+s64 format_float(char *buffer, Float value, char exponent_character, String_Builder_Format format) {
+    b8 negative = signbit(value);
+
+    if(value != value) {
+        memcpy(buffer, "nan", 3);
+        return 3;
     }
 
-    if(format.radix == RADIX_Binary || format.radix == RADIX_Hexadecimal || (format.radix == RADIX_Decimal && !format._signed)) {
-        u64 value = format.value;
-        u64 required_digits = this->number_of_required_digits(format.radix, value);
+    if(value - value != 0) {
+        string text = negative ? "-inf"_s : (format.prefix ? "+inf"_s : "inf"_s);
+        memcpy(buffer, text.data, text.count);
+        return text.count;
+    }
 
-        //
-        // Print out leading zeros.
-        //
-        if(format.digits != MAX_U8) {
-            for(u64 i = required_digits; i < format.digits; ++i) {
-                this->append_char('0');
-            }
-        }
-        
-        //
-        // Print out the actual value.
-        //
-        s64 index = required_digits - 1;
+    char digits[EXACT_DECIMAL_DIGITS];
+    s64 length, K;
 
-        while(index >= 0) {
-            u64 power = this->radix_value(format.radix, index);
-            u64 digit = value / power;
+    if(value == 0) {
+        digits[0] = '0';
+        length = 1;
+        K = 0;
+    } else if(format.fractionals == MAX_U8) {
+        grisu2<Float>(negative ? -value : value, digits, &length, &K);
+    } else {
+        exact_decimal_digits<Float>(negative ? -value : value, digits, &length, &K);
+    }
 
-            this->append_digit(digit);
+    return format_decimal_float(buffer, digits, length, length + K, negative, exponent_character, format);
+}
 
-            value -= digit * power;
-            --index;
-        }
-    } else if(format.radix == RADIX_Decimal && format._signed) {
-        u64 value = format.value;
-        u64 required_digits = this->number_of_required_digits(format.radix, (s64) value);
+template<typename Float>
+static
+void append_float(String_Builder *builder, Float value, String_Builder_Format format) {
+    char buffer[1024];
+    s64 count = format_float(buffer, value, 0, format);
+    builder->append_string(string_view((u8 *) buffer, count));
+}
 
-        //
-        // Handle sign.
-        //
-        if(value & 0x8000000000000000) { // value < 0
-            value = (u64) (- (s64) value);
-            this->append_char('-');
-        } else if(format.prefix) {
-            this->append_char('+');
-        }
+u64 String_Builder::number_of_required_digits(Radix radix, u64 value) {
+    char buffer[64];
+    return format_u64(buffer, radix, value);
+}
 
-        //
-        // Print out leading zeros.
-        //
-        if(format.digits != MAX_U8) {
-            for(u64 i = required_digits; i < format.digits; ++i) {
-                this->append_char('0');
-            }
-        }
-        
-        //
-        // Print out the actual value.
-        //
-        s64 index = required_digits - 1;
+u64 String_Builder::number_of_required_digits(Radix radix, s64 value) {
+    char buffer[64];
+    return format_u64(buffer, radix, value < 0 ? 0 - (u64) value : (u64) value);
+}
 
-        while(index >= 0) {
-            u64 power = this->radix_value(format.radix, index);
-            u64 digit = value / power;
+u64 String_Builder::number_of_required_digits(f64 value) {
+    if(value != value || value - value != 0 || value == 0) return 1;
 
-            this->append_digit(digit);
+    char digits[32];
+    s64 length, K;
+    grisu2<f64>(value < 0 ? -value : value, digits, &length, &K);
+    return MAX(length + K, 1);
+}
 
-            value -= digit * power;
-            --index;
-        }
-    } else if(format.radix == RADIX_Floating_Point) {
+void String_Builder::append_string_builder_format(String_Builder_Format format) {
+    if(format.radix == RADIX_Floating_Point) {
         f64 value;
         memcpy(&value, &format.value, sizeof(f64));
-        u64 required_digits = this->number_of_required_digits(value);
+        append_float<f64>(this, value, format);
+        return;
+    }
 
-        //
-        // Handle sign.
-        //
-        if(value < 0) {
-            value = -value;
-            this->append_char('-');
-        } else if(format.prefix) {
-            this->append_char('+');
-        }
+    char buffer[512];
+    s64 count = 0;
 
-        //
-        // Print out leading zeros.
-        //
-        if(format.digits != MAX_U8) {
-            for(u64 i = required_digits; i < format.digits; ++i) {
-                this->append_char('0');
-            }
+    if(format.prefix) {
+        switch(format.radix) {
+        case RADIX_Binary: buffer[count++] = '0'; buffer[count++] = 'b'; break;
+        case RADIX_Hexadecimal: buffer[count++] = '0'; buffer[count++] = 'x'; break;
+        default: break; // So that clang doesn't complain
         }
-        
-        //
-        // Print out the decimal spaces.
-        //
-        s64 index = required_digits - 1;
-
-        while(index >= 0) {
-            f64 power = pow(10, (f64) index);
-            f64 digit = floor(value / power);
+    }
 
-            this->append_digit((u64) digit);
+    //
+    // Handle sign.
+    //
+    u64 value = format.value;
 
-            value -= digit * power;
-            --index;
+    if(format.radix == RADIX_Decimal && format._signed) {
+        if(value & 0x8000000000000000) { // value < 0
+            value = 0 - value;
+            buffer[count++] = '-';
+        } else if(format.prefix) {
+            buffer[count++] = '+';
         }
+    }
 
-        //
-        // Print the decimal point.
-        //
-
-        this->append_char('.');
-
-        //
-        // Print the fractional spaces.
-        //
-        for(u64 i = 0; i < format.fractionals; ++i) {
-            value *= 10;
-
-            f64 digit = floor(value);
-
-            this->append_digit((u64) digit);
+    char digits[64];
+    s64 required_digits = format_u64(digits, format.radix, value);
 
-            value -= digit;
-        }
+    //
+    // Print out leading zeros.
+    //
+    if(format.digits != MAX_U8) {
+        for(s64 i = required_digits; i < format.digits; ++i) buffer[count++] = '0';
     }
-}
 
-void String_Builder::append_digit(u64 value) {
-    if(value >= 0 && value <= 9) {
-        this->append_char((char) (value + '0'));
-    } else if(value >= 10 && value <= 15) {
-        this->append_char((char) (value - 10 + 'a'));
-    }
+    memcpy(&buffer[count], digits, required_digits);
+    count += required_digits;
+
+    this->append_string(string_view((u8 *) buffer, count));
 }
 
-void String_Builder::create(Allocator *allocator) {
+void String_Builder::create(Allocator *allocator, File_Handle sink) {
     this->allocator   = allocator;
-    this->first       = { };
+    this->first.next  = null;
+    this->first.count = 0;
     this->current     = null;
     this->total_count = 0;
+    this->sink        = sink;
+    this->sink_failed = false;
 }
 
 void String_Builder::destroy() {
@@ -830,11 +2331,48 @@ void String_Builder::destroy() {
         block = next_block;
     }
 
-    this->first       = { };
+    this->first.next  = null;
+    this->first.count = 0;
     this->total_count = 0;
     this->current     = null;
 }
 
+void String_Builder::reserve(s64 count) {
+    if(!this->current || this->current->count + count > this->current->capacity) this->make_room(count);
+}
+
+b8 String_Builder::flush() {
+    assert(this->sink != INVALID_FILE_HANDLE && "Only streaming string builders can be flushed.");
+
+    if(!this->current) return !this->sink_failed;
+
+    //
+    // Gather all blocks into one write, then reset them so that they get reused from the start.
+    //
+    string chunks[64];
+    s64 chunk_count = 0;
+
+    for(Block *block = &this->first; block != null; block = block->next) {
+        if(block->count == 0) continue;
+
+        if(chunk_count == ARRAY_COUNT(chunks)) {
+            this->sink_failed |= !os_write_file_chunks(this->sink, chunks, chunk_count);
+            chunk_count = 0;
+        }
+
+        chunks[chunk_count++] = string_view(block->data, block->count);
+    }
+
+    if(chunk_count) this->sink_failed |= !os_write_file_chunks(this->sink, chunks, chunk_count);
+
+    for(Block *block = &this->first; block != null; block = block->next) block->count = 0;
+
+    this->current     = &this->first;
+    this->total_count = 0;
+
+    return !this->sink_failed;
+}
+
 void String_Builder::append_u8(u8 v) {
     this->append_string_builder_format({ RADIX_Decimal, (u64) v, 1, 0, false, false });
 }
@@ -868,13 +2406,14 @@ void String_Builder::append_s64(s64 v) {
 }
 
 void String_Builder::append_f32(f32 value) {
-    this->append_f64((f64) value);
+    // Print the shortest digits that round trip as an f32, not as the (much longer) f64.
+    append_float<f32>(this, value, { RADIX_Floating_Point, (u64) 0, MAX_U8, MAX_U8, true, false });
 }
 
 void String_Builder::append_f64(f64 value) {
     u64 _u64;
     memcpy(&_u64, &value, sizeof(f64));
-    this->append_string_builder_format({ RADIX_Floating_Point, _u64, 1, 5, true, false });
+    this->append_string_builder_format({ RADIX_Floating_Point, _u64, MAX_U8, MAX_U8, true, false });
 }
 
 void String_Builder::append_char(char c) {
@@ -883,40 +2422,41 @@ void String_Builder::append_char(char c) {
 }
 
 void String_Builder::append_string(const char *s) {
-    s64 length = cstring_length(s);
-
-    while(length > 0) {
-        s64 batch = MIN(BLOCK_SIZE, length);
-        u8 *pointer = this->grow(batch);
-        memcpy(pointer, s, batch);
-        length -= batch;
-        s += batch;
-    }
+    this->append_string(string_view((u8 *) s, cstring_length(s)));
 }
 
 void String_Builder::append_string(char *s) {
-    s64 length = cstring_length(s);
-
-    while(length > 0) {
-        s64 batch = MIN(BLOCK_SIZE, length);
-        u8 *pointer = this->grow(batch);
-        memcpy(pointer, s, batch);
-        length -= batch;
-        s += batch;
-    }
+    this->append_string(string_view((u8 *) s, cstring_length(s)));
 }
 
 void String_Builder::append_string(string s) {
-    while(s.count > 0) {
-        s64 batch = MIN(BLOCK_SIZE, s.count);
-        u8 *pointer = this->grow(batch);
-        memcpy(pointer, s.data, batch);
+    //
+    // Fill up the current block first, so that the blocks stay densely packed.
+    //
+    if(this->current) {
+        s64 batch = MIN(s.count, this->current->capacity - this->current->count);
+        memcpy(&this->current->data[this->current->count], s.data, batch);
+        this->current->count += batch;
+        this->total_count    += batch;
+        s.data  += batch;
         s.count -= batch;
-        s.data += batch;
     }
+
+    if(s.count == 0) return;
+
+    if(this->sink != INVALID_FILE_HANDLE && s.count >= MAX_BLOCK_SIZE) {
+        // Do not copy huge strings into the buffer if they are just going to be written out anyway.
+        this->flush();
+        this->sink_failed |= !os_write_file_chunks(this->sink, &s, 1);
+        return;
+    }
+
+    memcpy(this->grow(s.count), s.data, s.count);
 }
 
 string String_Builder::finish() {
+    assert(this->sink == INVALID_FILE_HANDLE && "Streaming string builders cannot be finished into a string, flush them instead.");
+
     if(this->first.next) {
         // There are at least two different blocks of data which we need to concatenate here.
         string result = allocate_string(this->allocator, this->total_count);
@@ -946,6 +2486,8 @@ string String_Builder::finish() {
 }
 
 char *String_Builder::finish_as_cstring() {
+    assert(this->sink == INVALID_FILE_HANDLE && "Streaming string builders cannot be finished into a string, flush them instead.");
+
     char *result = (char *) this->allocator->allocate(this->total_count + 1);
     s64 offset = 0;
     
@@ -996,3 +2538,392 @@ string mprint(Allocator *allocator, string format, ...) {
     free_cstring(allocator, cstring_format);
     return result;
 }
+
+
+
+/* ------------------------------------------------ Formatting ------------------------------------------------ */
+
+// The output is either appended to a String_Builder, or pushed onto a Memory_Arena. Since consecutive pushes
+// onto an arena are contiguous, the pushed pieces form the final string without any copying.
+struct Format_Output {
+    String_Builder *builder;
+    Memory_Arena *arena;
+    u8 *start;
+    s64 count;
+};
+
+struct Format_Specification {
+    s64 width;
+    s64 precision; // -1 if no precision was given.
+    char conversion; // 0 if no conversion was given.
+    b8 left_align;
+    b8 force_sign;
+    b8 zero_pad;
+};
+
+#define MAX_FORMAT_PRECISION 254 // MAX_U8 means 'no fractionals specified' in String_Builder_Format.
+
+static
+void format_output_append(Format_Output *output, const void *data, s64 count) {
+    if(count <= 0) return;
+
+    if(output->builder) {
+        output->builder->append_string(string_view((u8 *) data, count));
+        output->count += count;
+    } else {
+        u8 *destination = (u8 *) output->arena->push(count);
+        if(!destination) return;
+
+        if(!output->start) output->start = destination;
+        memcpy(destination, data, count);
+        output->count += count;
+    }
+}
+
+static
+void format_output_pad(Format_Output *output, char character, s64 count) {
+    if(count <= 0) return;
+
+    char padding[64];
+    memset(padding, character, sizeof(padding));
+
+    while(count > 0) {
+        s64 chunk = MIN(count, (s64) sizeof(padding));
+        format_output_append(output, padding, chunk);
+        count -= chunk;
+    }
+}
+
+static
+b8 is_format_conversion(u8 character) {
+    switch(character) {
+    case 'd': case 'i': case 'u': case 'c': case 'x': case 'X': case 'o': case 'b':
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 's': case 'p':
+        return true;
+    default:
+        return false;
+    }
+}
+
+static
+b8 is_integer_format_conversion(char conversion) {
+    switch(conversion) {
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'b':
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Parses the specification following a '%' at format.data[index - 1]. Returns the index of the first
+// character after the specification.
+static
+s64 parse_format_specification(string format, s64 index, Format_Specification *specification) {
+    *specification = { 0, -1, 0, false, false, false };
+
+    for(; index < format.count; ++index) {
+        u8 flag = format.data[index];
+
+        if(flag == '-') {
+            specification->left_align = true;
+        } else if(flag == '+') {
+            specification->force_sign = true;
+        } else if(flag == '0') {
+            specification->zero_pad = true;
+        } else {
+            break;
+        }
+    }
+
+    while(index < format.count && is_digit_character(format.data[index])) {
+        specification->width = MIN(specification->width * 10 + (format.data[index] - '0'), 1000000);
+        ++index;
+    }
+
+    if(index < format.count && format.data[index] == '.') {
+        ++index;
+        specification->precision = 0;
+
+        while(index < format.count && is_digit_character(format.data[index])) {
+            specification->precision = MIN(specification->precision * 10 + (format.data[index] - '0'), MAX_FORMAT_PRECISION);
+            ++index;
+        }
+    }
+
+    // Skip C length modifiers, the argument knows its own type.
+    while(index < format.count) {
+        u8 modifier = format.data[index];
+        if(modifier != 'h' && modifier != 'l' && modifier != 'L' && modifier != 'z' && modifier != 'j' && modifier != 't' && modifier != 'q') break;
+        ++index;
+    }
+
+    if(index < format.count && is_format_conversion(format.data[index])) {
+        specification->conversion = (char) format.data[index];
+        ++index;
+    }
+
+    return index;
+}
+
+// Formats an integer given as sign and magnitude. Returns the number of characters written. The buffer needs
+// room for 64 + MAX_FORMAT_PRECISION characters.
+static
+s64 format_integer_argument(char *buffer, u64 magnitude, b8 negative, Format_Specification const *specification) {
+    Radix radix = RADIX_Decimal;
+
+    switch(specification->conversion) {
+    case 'x': case 'X': radix = RADIX_Hexadecimal; break;
+    case 'o': radix = RADIX_Octal; break;
+    case 'b': radix = RADIX_Binary; break;
+    }
+
+    s64 count = 0;
+
+    if(negative) {
+        buffer[count++] = '-';
+    } else if(specification->force_sign && radix == RADIX_Decimal) {
+        buffer[count++] = '+';
+    }
+
+    char digits[64];
+    s64 digit_count = format_u64(digits, radix, magnitude);
+
+    // The precision of an integer is the minimum number of digits.
+    for(s64 i = digit_count; i < specification->precision; ++i) buffer[count++] = '0';
+
+    if(specification->conversion == 'X') {
+        for(s64 i = 0; i < digit_count; ++i) buffer[count++] = (char) to_upper_character(digits[i]);
+    } else {
+        memcpy(&buffer[count], digits, digit_count);
+        count += digit_count;
+    }
+
+    return count;
+}
+
+static
+s64 format_signed_argument(char *buffer, s64 value, u8 size, Format_Specification const *specification) {
+    if(specification->conversion == 'x' || specification->conversion == 'X' || specification->conversion == 'o' || specification->conversion == 'b') {
+        // Like printf, print the two's complement of negative values in the original width of the type.
+        u64 mask = size < 8 ? (1ULL << (size * 8)) - 1 : MAX_U64;
+        return format_integer_argument(buffer, (u64) value & mask, false, specification);
+    }
+
+    return format_integer_argument(buffer, value < 0 ? 0 - (u64) value : (u64) value, value < 0, specification);
+}
+
+template<typename Float>
+static
+s64 format_float_argument(char *buffer, Float value, Format_Specification const *specification) {
+    char exponent_character = (specification->conversion == 'e' || specification->conversion == 'E') ? specification->conversion : 0;
+    u8 fractionals = specification->precision >= 0 ? (u8) specification->precision : MAX_U8;
+    return format_float(buffer, value, exponent_character, String_Builder_Format(RADIX_Floating_Point, (u64) 0, MAX_U8, fractionals, true, specification->force_sign));
+}
+
+static
+void format_argument(Format_Output *output, Format_Argument const *argument, Format_Specification const *specification);
+
+static
+void format_vector_argument(Format_Output *output, Format_Argument const *argument, Format_Specification const *specification) {
+    format_output_append(output, "(", 1);
+
+    const u8 *components = (const u8 *) argument->_pointer;
+
+    for(u8 i = 0; i < argument->component_count; ++i) {
+        if(i > 0) format_output_append(output, ", ", 2);
+
+        const u8 *component = &components[i * argument->component_size];
+
+        Format_Argument component_argument;
+        component_argument.type           = argument->component_type;
+        component_argument.component_size = argument->component_size;
+
+        switch(argument->component_type) {
+        case FORMAT_ARGUMENT_F32: memcpy(&component_argument._f32, component, sizeof(f32)); break;
+        case FORMAT_ARGUMENT_F64: memcpy(&component_argument._f64, component, sizeof(f64)); break;
+
+        case FORMAT_ARGUMENT_Signed:
+            switch(argument->component_size) {
+            case 1: { s8  value; memcpy(&value, component, 1); component_argument._signed = value; } break;
+            case 2: { s16 value; memcpy(&value, component, 2); component_argument._signed = value; } break;
+            case 4: { s32 value; memcpy(&value, component, 4); component_argument._signed = value; } break;
+            default: memcpy(&component_argument._signed, component, 8); break;
+            }
+            break;
+
+        case FORMAT_ARGUMENT_Unsigned:
+            component_argument._unsigned = 0;
+            memcpy(&component_argument._unsigned, component, argument->component_size); // Little endian.
+            break;
+
+        default:
+            assert(false && "Invalid vector component type.");
+            return;
+        }
+
+        format_argument(output, &component_argument, specification);
+    }
+
+    format_output_append(output, ")", 1);
+}
+
+static
+void format_argument(Format_Output *output, Format_Argument const *argument, Format_Specification const *specification) {
+    if(argument->type == FORMAT_ARGUMENT_Vector) {
+        // The specification applies to every component, so that tables of vectors line up.
+        format_vector_argument(output, argument, specification);
+        return;
+    }
+
+    char buffer[1024];
+    string text = { 0, (u8 *) buffer };
+    b8 numeric = false;
+
+    switch(argument->type) {
+    case FORMAT_ARGUMENT_Signed:
+        if(specification->conversion == 'c') {
+            buffer[0] = (char) argument->_signed;
+            text.count = 1;
+        } else {
+            text.count = format_signed_argument(buffer, argument->_signed, argument->component_size, specification);
+            numeric = true;
+        }
+        break;
+
+    case FORMAT_ARGUMENT_Unsigned:
+        if(specification->conversion == 'c') {
+            buffer[0] = (char) argument->_unsigned;
+            text.count = 1;
+        } else {
+            text.count = format_integer_argument(buffer, argument->_unsigned, false, specification);
+            numeric = true;
+        }
+        break;
+
+    case FORMAT_ARGUMENT_Character:
+        if(is_integer_format_conversion(specification->conversion)) {
+            text.count = format_signed_argument(buffer, (s8) argument->_character, 1, specification);
+            numeric = true;
+        } else {
+            buffer[0] = argument->_character;
+            text.count = 1;
+        }
+        break;
+
+    case FORMAT_ARGUMENT_Boolean:
+        if(is_integer_format_conversion(specification->conversion)) {
+            text.count = format_integer_argument(buffer, argument->_boolean ? 1 : 0, false, specification);
+            numeric = true;
+        } else {
+            text = argument->_boolean ? "true"_s : "false"_s;
+        }
+        break;
+
+    case FORMAT_ARGUMENT_F32:
+        text.count = format_float_argument(buffer, argument->_f32, specification);
+        numeric = argument->_f32 - argument->_f32 == 0; // Don't pad nan and inf with zeros.
+        break;
+
+    case FORMAT_ARGUMENT_F64:
+        text.count = format_float_argument(buffer, argument->_f64, specification);
+        numeric = argument->_f64 - argument->_f64 == 0;
+        break;
+
+    case FORMAT_ARGUMENT_String:
+        text = argument->_string;
+        if(specification->precision >= 0 && specification->precision < text.count) text.count = specification->precision;
+        break;
+
+    case FORMAT_ARGUMENT_Pointer:
+        buffer[0] = '0';
+        buffer[1] = 'x';
+        text.count = 2 + format_u64(&buffer[2], RADIX_Hexadecimal, (u64) argument->_pointer);
+        break;
+
+    default:
+        assert(false && "Invalid format argument type.");
+        return;
+    }
+
+    s64 padding = specification->width - text.count;
+
+    if(padding <= 0) {
+        format_output_append(output, text.data, text.count);
+    } else if(specification->left_align) {
+        format_output_append(output, text.data, text.count);
+        format_output_pad(output, ' ', padding);
+    } else if(specification->zero_pad && numeric) {
+        // The zeros go between the sign and the digits.
+        s64 sign = (text.data[0] == '-' || text.data[0] == '+') ? 1 : 0;
+        format_output_append(output, text.data, sign);
+        format_output_pad(output, '0', padding);
+        format_output_append(output, text.data + sign, text.count - sign);
+    } else {
+        format_output_pad(output, ' ', padding);
+        format_output_append(output, text.data, text.count);
+    }
+}
+
+static
+void format_into_output(Format_Output *output, string format, Format_Argument const *arguments, s64 argument_count) {
+    s64 argument_index = 0;
+    s64 index = 0;
+
+    while(index < format.count) {
+        s64 placeholder = search_string(string_view(&format.data[index], format.count - index), '%');
+
+        if(placeholder == -1) {
+            format_output_append(output, &format.data[index], format.count - index);
+            break;
+        }
+
+        format_output_append(output, &format.data[index], placeholder);
+        index += placeholder + 1;
+
+        if(index < format.count && format.data[index] == '%') {
+            format_output_append(output, "%", 1);
+            ++index;
+            continue;
+        }
+
+        s64 specification_start = index - 1;
+
+        Format_Specification specification;
+        index = parse_format_specification(format, index, &specification);
+
+        if(argument_index < argument_count) {
+            format_argument(output, &arguments[argument_index], &specification);
+            ++argument_index;
+        } else {
+            // Leave the placeholder as is, so that the mistake is visible in release builds.
+            assert(false && "The format string has more placeholders than there are arguments.");
+            format_output_append(output, &format.data[specification_start], index - specification_start);
+        }
+    }
+
+    assert(argument_index == argument_count && "The format string has fewer placeholders than there are arguments.");
+}
+
+void format_arguments(String_Builder *builder, string format, Format_Argument const *arguments, s64 argument_count) {
+    Format_Output output = { builder, null, null, 0 };
+    format_into_output(&output, format, arguments, argument_count);
+}
+
+string format_arguments(Memory_Arena *arena, string format, Format_Argument const *arguments, s64 argument_count) {
+    Format_Output output = { null, arena, null, 0 };
+    format_into_output(&output, format, arguments, argument_count);
+
+    // Null-terminate the string (without counting the terminator), so that it can be passed to C APIs.
+    u8 *terminator = (u8 *) arena->push(1);
+    if(!output.start) output.start = terminator;
+    if(terminator) *terminator = 0;
+
+    return { output.count, output.start };
+}
+
+string format_arguments(Allocator *allocator, string format, Format_Argument const *arguments, s64 argument_count) {
+    String_Builder builder;
+    builder.create(allocator);
+    format_arguments(&builder, format, arguments, argument_count);
+    return builder.finish();
+}
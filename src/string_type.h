@@ -35,6 +35,8 @@ b8 is_lower_character(u8 c);
 b8 is_upper_character(u8 c);
 u8 to_lower_character(u8 c);
 u8 to_upper_character(u8 c);
+void to_lower_string(string _string); // Converts the string in place.
+void to_upper_string(string _string); // Converts the string in place.
 
 
 
@@ -84,10 +86,14 @@ string concatenate_strings(Allocator *allocator, string lhs, string rhs);
 
 s64 search_string(string _string, u8 _char); // Returns -1 if the character is not found.
 s64 search_string_reverse(string _string, u8 _char);
+s64 search_substring(string haystack, string needle); // Returns the index of the first occurrence, or -1 if the needle is not found.
 
 b8 strings_equal(const string &lhs, const string &rhs);
+b8 strings_equal_ignore_case(const string &lhs, const string &rhs); // Only folds ASCII letters, like to_lower_character.
 b8 string_starts_with(string lhs, string rhs);
+b8 string_starts_with_ignore_case(string lhs, string rhs);
 b8 string_ends_with(string lhs, string rhs);
+b8 string_ends_with_ignore_case(string lhs, string rhs);
 
 string read_next_line(string *input);
 
@@ -97,6 +103,61 @@ string trim_string(string input);
 
 u64 string_hash(const string &input);
 u64 string_hash(const char *input);
+u64 string_hash_ignore_case(const string &input); // The same as string_hash on the lower case string, for hash tables keyed with strings_equal_ignore_case.
+u64 string_hash_ignore_case(const char *input);
+
+
+
+/* -------------------------------------------------- Unicode -------------------------------------------------- */
+
+//
+// Strings are expected to hold UTF-8. The validator checks a whole register of bytes per step, using the
+// lookup tables of Keiser & Lemire ("Validating UTF-8 In Less Than One Instruction Per Byte"): the high and
+// low nibble of each byte and the high nibble of the next one each select a set of possible errors, and an
+// error is only real if all three agree. Pure ASCII registers skip the lookups entirely.
+//     The decoder converts whole strings into code points, widening 16 ASCII bytes at a time and only falling
+// back to decoding sequence by sequence for the other bytes. Malformed sequences never fail, they decode to
+// UNICODE_REPLACEMENT_CHARACTER (one per maximal invalid subpart, as recommended by the Unicode standard).
+//
+
+#define UNICODE_REPLACEMENT_CHARACTER 0xFFFD
+#define UNICODE_MAX_CODE_POINT        0x10FFFF
+
+b8 is_valid_utf8(string input);
+u32 utf8_decode_next(string input, s64 *index); // Decodes the code point at *index, and advances the index past it.
+s64 utf8_encode(u32 code_point, u8 *output); // Writes the 1 to 4 byte sequence of the code point (or of the replacement character, for surrogates and values past the last code point). Returns the number of bytes.
+s64 utf8_to_code_points(string input, u32 *code_points); // Returns the number of code points. The output needs room for input.count code points.
+
+
+
+/* ---------------------------------------------- Line Iterator ---------------------------------------------- */
+
+//
+// Splitting big text files into lines or whitespace-separated tokens byte by byte is dominated by per-byte
+// branches. Instead, classify_characters looks at a whole block of 64 bytes and returns one bitmask per
+// character class, with one bit per byte. Finding the next boundary then just means finding the next set
+// bit, and every block only needs to be classified once, no matter how many lines or tokens it contains.
+//
+
+#define CHARACTER_BLOCK_SIZE 64
+
+struct Character_Masks {
+    u64 newlines;   // Bit i is set if byte i is a '\n'.
+    u64 whitespace; // Bit i is set if byte i is a space or a control character (which includes newlines).
+};
+
+Character_Masks classify_characters(string _string, s64 offset); // Classifies the (up to) 64 bytes starting at offset. Bytes past the end of the string count as whitespace.
+
+struct Line_Iterator {
+    string data;
+    s64 position;     // The start of the next line.
+    s64 line_number;  // The (one-based) number of the line last returned by next().
+    s64 block_start;  // The offset of the block described by the newline mask.
+    u64 newline_mask; // The newlines of the current block which have not been consumed yet.
+
+    void create(string data);
+    b8 next(string *line); // Returns false once all lines have been read. Like read_next_line, the line does not include the '\n'.
+};
 
 
 
@@ -116,7 +177,13 @@ b8 string_to_bool(string input, b8 *success);
  * the different substrings together.
  * The string builder maintains an internal linked list of different string blocks in case the
  * underlying allocator does not provide it with a continuous block of memory, so that these parts
- * can then be stitched together at the end with as few allocations in-bewteen as possible. */
+ * can then be stitched together at the end with as few allocations in-bewteen as possible.
+ * The first block lives inside the builder itself, so that short strings do not allocate at all. Every
+ * following block is twice as big as the previous one (up to MAX_BLOCK_SIZE), so that big outputs only need
+ * a few allocations.
+ * If the builder is created with a sink file, it never finishes into a string. Instead, once enough data
+ * has been buffered, all blocks get written to the file with a single (gathering) write and then reused, so
+ * that arbitrarily big outputs only need a bounded amount of memory. */
 
 struct String_Builder_Format {
 	Radix radix;
@@ -133,29 +200,34 @@ struct String_Builder_Format {
 };
 
 struct String_Builder {
-	const static s64 BLOCK_SIZE = 256;
+	const static s64 FIRST_BLOCK_SIZE = 256;
+	const static s64 MAX_BLOCK_SIZE   = 1024 * 1024; // Blocks stop growing at this size, unless a single append or reserve needs more. Streaming builders write to the sink about this often.
 	
 	struct Block {
 		Block *next;
-		u8 data[BLOCK_SIZE];
 		s64 count;
+		s64 capacity;
+		u8 data[FIRST_BLOCK_SIZE]; // Heap-allocated blocks have room for 'capacity' bytes here.
 	};
 
 	Allocator *allocator = Default_Allocator;
 	Block first;
 	Block *current = null;
-	s64 total_count = 0;
+	s64 total_count = 0; // The number of bytes currently buffered in the blocks.
+	File_Handle sink = INVALID_FILE_HANDLE;
+	b8 sink_failed = false; // Set if any write to the sink failed.
 
-	u8 *grow(s64 count);
-	u64 radix_value(Radix radix, u64 index);
+	u8 *grow(s64 count); // Returns room for count contiguous bytes.
+	void make_room(s64 count);
 	u64 number_of_required_digits(Radix radix, u64 value);
 	u64 number_of_required_digits(Radix radix, s64 value);
 	u64 number_of_required_digits(f64 value);
 	void append_string_builder_format(String_Builder_Format format);
-	void append_digit(u64 digit);
 
-	void create(Allocator *allocator);
+	void create(Allocator *allocator, File_Handle sink = INVALID_FILE_HANDLE); // The builder does not take ownership of the sink.
 	void destroy(); // This destroys all underlying data of the string builder. This might just pull the rug under the finished()'ed string!
+	void reserve(s64 count); // Makes sure the next count bytes can be appended without any further allocation.
+	b8 flush(); // Writes all buffered data to the sink. Returns false if any write to the sink has failed so far.
 
 	void append_u8(u8 v);
 	void append_u16(u16 v);
@@ -178,3 +250,143 @@ struct String_Builder {
 
 string mprint(Allocator *allocator, const char *format, ...);
 string mprint(Allocator *allocator, string format, ...);
+
+
+
+/* ------------------------------------------------ Formatting ------------------------------------------------ */
+
+/* A type-safe replacement for mprint. Instead of going through C varargs (and formatting everything twice,
+ * once to figure out the size and once to actually print), the arguments are captured as an array of
+ * Format_Arguments which remember their type, and the output is written in a single pass directly into a
+ * String_Builder or a Memory_Arena (whose successive pushes are contiguous, so no copy is needed at all).
+ * Every '%' in the format string is a placeholder for the next argument, "%%" prints a single '%'. The
+ * type of the argument decides how it gets printed, so that a printf-style specification is optional:
+ *   %[-][+][0][width][.precision][conversion]
+ * where '-' left-aligns, '+' always prints a sign and '0' pads numbers with zeros up to the width. The
+ * precision is the number of fractional digits for floating point values (which are otherwise printed with
+ * the shortest digits that round trip), or the maximum length of strings. The conversion is one of
+ * "diucxXobfFeEgGsp": 'x', 'X', 'o' and 'b' print integers in hexadecimal, octal or binary, 'c' prints an
+ * integer as a character, 'e' prints floating point values in scientific notation, everything else is just
+ * accepted for printf compatibility. C length modifiers (like the "ll" in PRId64) are skipped.
+ * Strings, c-strings, pointers, booleans and the vector math types (v2, v3, v4, qt) are supported
+ * natively. Vectors are printed as "(x, y, z)", with the specification applied to every component.
+ * The FORMAT macro additionally counts the placeholders of a literal format string at compile time and
+ * checks them against the number of arguments. */
+
+template<typename T> struct v2;
+template<typename T> struct v3;
+template<typename T> struct v4;
+template<typename T> struct qt;
+
+enum Format_Argument_Type : u8 {
+	FORMAT_ARGUMENT_Signed,
+	FORMAT_ARGUMENT_Unsigned,
+	FORMAT_ARGUMENT_Character,
+	FORMAT_ARGUMENT_Boolean,
+	FORMAT_ARGUMENT_F32,
+	FORMAT_ARGUMENT_F64,
+	FORMAT_ARGUMENT_String,
+	FORMAT_ARGUMENT_Pointer,
+	FORMAT_ARGUMENT_Vector,
+};
+
+struct Format_Argument {
+	Format_Argument_Type type;
+	Format_Argument_Type component_type; // For vectors: The type of each component.
+	u8 component_size;  // The size of the value (or of each vector component) in bytes.
+	u8 component_count; // For vectors: The number of components, which _pointer points to.
+
+	union {
+		s64 _signed;
+		u64 _unsigned;
+		char _character;
+		b8 _boolean;
+		f32 _f32;
+		f64 _f64;
+		string _string;
+		const void *_pointer;
+	};
+};
+
+#define FORMAT_ARGUMENT_OVERLOAD(__type, __argument_type, __member, __member_type) \
+	inline Format_Argument make_format_argument(__type value) { Format_Argument argument; argument.type = __argument_type; argument.component_size = sizeof(__type); argument.__member = (__member_type) value; return argument; }
+
+FORMAT_ARGUMENT_OVERLOAD(signed char,        FORMAT_ARGUMENT_Signed,    _signed,    s64)
+FORMAT_ARGUMENT_OVERLOAD(signed short,       FORMAT_ARGUMENT_Signed,    _signed,    s64)
+FORMAT_ARGUMENT_OVERLOAD(signed int,         FORMAT_ARGUMENT_Signed,    _signed,    s64)
+FORMAT_ARGUMENT_OVERLOAD(signed long,        FORMAT_ARGUMENT_Signed,    _signed,    s64)
+FORMAT_ARGUMENT_OVERLOAD(signed long long,   FORMAT_ARGUMENT_Signed,    _signed,    s64)
+FORMAT_ARGUMENT_OVERLOAD(unsigned char,      FORMAT_ARGUMENT_Unsigned,  _unsigned,  u64)
+FORMAT_ARGUMENT_OVERLOAD(unsigned short,     FORMAT_ARGUMENT_Unsigned,  _unsigned,  u64)
+FORMAT_ARGUMENT_OVERLOAD(unsigned int,       FORMAT_ARGUMENT_Unsigned,  _unsigned,  u64)
+FORMAT_ARGUMENT_OVERLOAD(unsigned long,      FORMAT_ARGUMENT_Unsigned,  _unsigned,  u64)
+FORMAT_ARGUMENT_OVERLOAD(unsigned long long, FORMAT_ARGUMENT_Unsigned,  _unsigned,  u64)
+FORMAT_ARGUMENT_OVERLOAD(char,               FORMAT_ARGUMENT_Character, _character, char)
+FORMAT_ARGUMENT_OVERLOAD(bool,               FORMAT_ARGUMENT_Boolean,   _boolean,   b8)
+FORMAT_ARGUMENT_OVERLOAD(float,              FORMAT_ARGUMENT_F32,       _f32,       f32)
+FORMAT_ARGUMENT_OVERLOAD(double,             FORMAT_ARGUMENT_F64,       _f64,       f64)
+FORMAT_ARGUMENT_OVERLOAD(string,             FORMAT_ARGUMENT_String,    _string,    string)
+FORMAT_ARGUMENT_OVERLOAD(const void *,       FORMAT_ARGUMENT_Pointer,   _pointer,   const void *)
+
+inline Format_Argument make_format_argument(const char *value) { return make_format_argument(value ? cstring_view(value) : "(null)"_s); }
+inline Format_Argument make_format_argument(char *value) { return make_format_argument((const char *) value); }
+
+template<typename T>
+Format_Argument make_format_argument(T *value) { return make_format_argument((const void *) value); }
+
+template<typename T>
+Format_Argument make_format_vector_argument(const T *components, u8 count) {
+	Format_Argument argument = make_format_argument(components[0]);
+	argument.component_type  = argument.type;
+	argument.component_size  = sizeof(T);
+	argument.component_count = count;
+	argument.type            = FORMAT_ARGUMENT_Vector;
+	argument._pointer        = components;
+	return argument;
+}
+
+template<typename T> Format_Argument make_format_argument(v2<T> const &value) { return make_format_vector_argument(value.values, 2); }
+template<typename T> Format_Argument make_format_argument(v3<T> const &value) { return make_format_vector_argument(value.values, 3); }
+template<typename T> Format_Argument make_format_argument(v4<T> const &value) { return make_format_vector_argument(value.values, 4); }
+template<typename T> Format_Argument make_format_argument(qt<T> const &value) { return make_format_vector_argument(&value.x, 4); }
+
+void format_arguments(String_Builder *builder, string format, Format_Argument const *arguments, s64 argument_count);
+string format_arguments(Memory_Arena *arena, string format, Format_Argument const *arguments, s64 argument_count);
+string format_arguments(Allocator *allocator, string format, Format_Argument const *arguments, s64 argument_count);
+
+// The destination is either a String_Builder *, which the output gets appended to, or a Memory_Arena * or
+// an Allocator *, in which case the formatted string is returned.
+template<typename Destination, typename... Args>
+auto format(Destination destination, string format_string, Args const &... args) -> decltype(format_arguments(destination, format_string, (Format_Argument *) null, 0)) {
+	Format_Argument arguments[sizeof...(Args) + 1] = { make_format_argument(args)... }; // Avoid zero-sized arrays.
+	return format_arguments(destination, format_string, arguments, sizeof...(Args));
+}
+
+template<typename Destination, typename... Args>
+auto format(Destination destination, const char *format_string, Args const &... args) -> decltype(format_arguments(destination, ""_s, (Format_Argument *) null, 0)) {
+	return format(destination, cstring_view(format_string), args...);
+}
+
+constexpr s64 format_placeholder_count(const char *format_string) {
+	s64 count = 0;
+
+	for(s64 i = 0; format_string[i] != 0; ++i) {
+		if(format_string[i] != '%') continue;
+
+		if(format_string[i + 1] == '%') {
+			++i;
+		} else {
+			++count;
+		}
+	}
+
+	return count;
+}
+
+template<s64 placeholder_count, typename Destination, typename... Args>
+auto format_checked(Destination destination, string format_string, Args const &... args) -> decltype(format_arguments(destination, format_string, (Format_Argument *) null, 0)) {
+	static_assert(placeholder_count == sizeof...(Args), "The number of placeholders in the format string does not match the number of arguments.");
+	return format(destination, format_string, args...);
+}
+
+#define FORMAT(destination, format_literal, ...) format_checked<format_placeholder_count(format_literal)>(destination, string_view((char *) format_literal, sizeof(format_literal) - 1), ##__VA_ARGS__)
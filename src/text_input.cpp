@@ -45,12 +45,186 @@ Word_Mode get_word_mode_for_character(u8 character) {
     return is_alpha_numeric_character(character) ? WORD_Alpha_Numeric_Characters : WORD_Special_Characters;
 }
 
+static inline
+u8 text_input_character(Text_Input *input, s64 position) {
+    return position < input->gap_start ? input->buffer[position] : input->buffer[position + input->gap_end - input->gap_start];
+}
+
 static
-void insert_text(Text_Input *input, string text) {
+b8 text_input_contains(Text_Input *input, u8 character) {
+    return search_string(string_view(input->buffer, input->gap_start), character) != -1 ||
+        search_string(string_view(&input->buffer[input->gap_end], input->capacity - input->gap_end), character) != -1;
+}
+
+static
+s64 count_newlines(string text) {
+    s64 count = 0;
+
+    for(s64 newline = search_string(text, '\n'); newline != -1; newline = search_string(text, '\n')) {
+        text = string_view(&text.data[newline + 1], text.count - newline - 1);
+        ++count;
+    }
+
+    return count;
+}
+
+// Moves the gap so that it starts at the given position. Only the bytes between the old and the new position
+// of the gap need to be copied.
+static
+void move_gap(Text_Input *input, s64 position) {
+    if(position < input->gap_start) {
+        s64 count = input->gap_start - position;
+        memmove(&input->buffer[input->gap_end - count], &input->buffer[position], count);
+        input->gap_start -= count;
+        input->gap_end   -= count;
+    } else if(position > input->gap_start) {
+        s64 count = position - input->gap_start;
+        memmove(&input->buffer[input->gap_start], &input->buffer[input->gap_end], count);
+        input->gap_start += count;
+        input->gap_end   += count;
+    }
+}
+
+static
+void reserve_gap(Text_Input *input, s64 count) {
+    if(input->gap_end - input->gap_start >= count) return;
+
+    s64 capacity = MAX(input->capacity * 2, (s64) TEXT_INPUT_INITIAL_CAPACITY);
+    while(capacity < input->count + count) capacity *= 2;
+
+    s64 count_after_gap = input->capacity - input->gap_end;
+    u8 *buffer = (u8 *) input->allocator->allocate(capacity);
+
+    if(input->buffer) {
+        memcpy(buffer, input->buffer, input->gap_start);
+        memcpy(&buffer[capacity - count_after_gap], &input->buffer[input->gap_end], count_after_gap);
+        input->allocator->deallocate(input->buffer);
+    }
+
+    input->buffer   = buffer;
+    input->capacity = capacity;
+    input->gap_end  = capacity - count_after_gap;
+}
+
+// Returns a contiguous view of the text between start and end, moving the gap behind the range if it is
+// currently inside of it.
+static
+string text_input_view(Text_Input *input, s64 start, s64 end) {
+    assert(start >= 0 && start <= end && end <= input->count);
+
+    if(start < input->gap_start && end > input->gap_start) move_gap(input, end);
+
+    if(end <= input->gap_start) {
+        return string_view(&input->buffer[start], end - start);
+    } else {
+        return string_view(&input->buffer[start + input->gap_end - input->gap_start], end - start);
+    }
+}
+
+// Returns the line containing the position, and its offset in the text. A position at the very end of a line
+// (on its newline) belongs to that line.
+static
+s64 find_line(Text_Input *input, s64 position, s64 *line_start) {
+    while(position < input->current_line_start) {
+        --input->current_line;
+        input->current_line_start -= input->lines[input->current_line].count + 1;
+    }
+
+    while(position > input->current_line_start + input->lines[input->current_line].count) {
+        input->current_line_start += input->lines[input->current_line].count + 1;
+        ++input->current_line;
+    }
+
+    *line_start = input->current_line_start;
+    return input->current_line;
+}
+
+static
+s64 find_line_start(Text_Input *input, s64 line) {
+    assert(line >= 0 && line < input->lines.count);
+
+    while(line < input->current_line) {
+        --input->current_line;
+        input->current_line_start -= input->lines[input->current_line].count + 1;
+    }
+
+    while(line > input->current_line) {
+        input->current_line_start += input->lines[input->current_line].count + 1;
+        ++input->current_line;
+    }
+
+    return input->current_line_start;
+}
+
+// Updates the lines for text which is about to be inserted at the position.
+static
+void insert_lines(Text_Input *input, s64 position, string text) {
+    s64 line_start;
+    s64 line = find_line(input, position, &line_start);
+    input->lines[line].width = TEXT_INPUT_WIDTH_UNKNOWN;
+
+    s64 newline_count = count_newlines(text);
+    if(newline_count == 0) {
+        input->lines[line].count += text.count;
+        return;
+    }
+
     //
-    // Check for remaining available space.
+    // Split the line at the position, and add a new line for every newline in the text. The part of the
+    // line after the position ends up at the end of the last new line.
     //
-    text.count = min(text.count, TEXT_INPUT_BUFFER_SIZE - input->count);
+    if(input->lines.count + newline_count > input->lines.allocated) input->lines.reserve(newline_count);
+    relocate_entries(&input->lines.data[line + 1 + newline_count], &input->lines.data[line + 1], input->lines.count - line - 1);
+    input->lines.count += newline_count;
+
+    s64 count_after_position = input->lines[line].count - (position - line_start);
+    input->lines[line].count = position - line_start;
+
+    for(s64 i = line; i <= line + newline_count; ++i) {
+        s64 newline = search_string(text, '\n');
+        if(newline == -1) newline = text.count; // The text after the last newline.
+
+        if(i > line) input->lines[i] = { 0, TEXT_INPUT_WIDTH_UNKNOWN };
+        input->lines[i].count += newline;
+        if(newline < text.count) text = string_view(&text.data[newline + 1], text.count - newline - 1);
+    }
+
+    input->lines[line + newline_count].count += count_after_position;
+}
+
+// Updates the lines for text which is about to be removed at the position.
+static
+void remove_lines(Text_Input *input, s64 position, string removed) {
+    s64 line_start;
+    s64 line = find_line(input, position, &line_start);
+
+    // Merge all lines touched by the removed text into the first one.
+    s64 newline_count = count_newlines(removed);
+    s64 merged_count = newline_count - removed.count;
+    for(s64 i = line; i <= line + newline_count; ++i) merged_count += input->lines[i].count;
+
+    input->lines[line] = { merged_count, TEXT_INPUT_WIDTH_UNKNOWN };
+    if(newline_count) input->lines.remove_range(line + 1, line + newline_count);
+}
+
+static
+void reset_text(Text_Input *input) {
+    input->gap_start          = 0;
+    input->gap_end            = input->capacity;
+    input->count              = 0;
+    input->cursor             = 0;
+    input->current_line       = 0;
+    input->current_line_start = 0;
+
+    if(input->lines.count == 0) input->lines.add({});
+    if(input->lines.count > 1) input->lines.remove_range(1, input->lines.count - 1);
+    input->lines[0] = { 0, TEXT_INPUT_WIDTH_UNKNOWN };
+
+    ++input->edit_count;
+}
+
+static
+void insert_text(Text_Input *input, string text) {
     if(text.count == 0) return;
 
     //
@@ -68,7 +242,7 @@ void insert_text(Text_Input *input, string text) {
         if(found_invalid) return;
     } else if(input->mode == TEXT_INPUT_Floating_Point) {
         b8 found_invalid = false;
-        b8 found_dot = search_string(text_input_string_view(input), '.') != -1;
+        b8 found_dot = text_input_contains(input, '.');
         
         for(s64 i = 0; i < text.count; ++i) {
             char c = text[i];
@@ -81,22 +255,74 @@ void insert_text(Text_Input *input, string text) {
     }
     
     //
-    // Actually insert the text.
+    // Actually insert the text into the gap.
     //
-    memmove(&input->buffer[input->cursor + text.count], &input->buffer[input->cursor], input->count - input->cursor);
-    memcpy(&input->buffer[input->cursor], text.data, text.count);
-    input->count  += text.count;
-    input->cursor += text.count;
+    reserve_gap(input, text.count);
+    move_gap(input, input->cursor);
+    insert_lines(input, input->cursor, text);
+    memcpy(&input->buffer[input->gap_start], text.data, text.count);
+    input->gap_start += text.count;
+    input->count     += text.count;
+    input->cursor    += text.count;
+    ++input->edit_count;
 }
 
 static
 void erase_text(Text_Input *input, s64 first_to_remove, s64 last_to_remove) {
     assert(last_to_remove >= first_to_remove);
     s64 count = (last_to_remove - first_to_remove) + 1;
-    assert(count <= input->count);
-    memmove(&input->buffer[first_to_remove], &input->buffer[last_to_remove + 1], input->count - (last_to_remove + 1));
-    input->count -= count;
-    input->cursor = first_to_remove;
+    assert(first_to_remove >= 0 && last_to_remove < input->count);
+
+    // Move the gap in front of the removed text, which then just becomes part of the gap.
+    move_gap(input, first_to_remove);
+    remove_lines(input, first_to_remove, string_view(&input->buffer[input->gap_end], count));
+    input->gap_end += count;
+    input->count   -= count;
+    input->cursor   = first_to_remove;
+    ++input->edit_count;
+}
+
+static
+void invalidate_line_widths(Text_Input *input, Font *font) {
+    for(s64 i = 0; i < input->lines.count; ++i) input->lines[i].width = TEXT_INPUT_WIDTH_UNKNOWN;
+    input->measured_font       = font;
+    input->measured_edit_count = -1;
+}
+
+// Returns the width from the start of the position's line up to the position.
+static
+s32 get_text_input_width_until(Text_Input *input, Font *font, s64 position) {
+    s64 line_start;
+    s64 line = find_line(input, position, &line_start);
+    if(position == line_start + input->lines[line].count) return get_text_input_line_width_in_pixels(input, font, line);
+
+    return get_string_width_in_pixels(font, text_input_view(input, line_start, position));
+}
+
+//
+// The text is UTF-8, and the cursor must never end up inside of a sequence. Stepping over a character skips
+// all continuation bytes, but never more than a sequence can have, so that malformed text does not make the
+// cursor jump over whole runs of garbage.
+//
+static inline
+b8 is_utf8_continuation_byte(u8 character) {
+    return (character & 0xC0) == 0x80;
+}
+
+static
+s64 get_previous_character_start(Text_Input *input, s64 position) {
+    s64 limit = MAX(position - 4, 0);
+    --position;
+    while(position > limit && is_utf8_continuation_byte(text_input_character(input, position))) --position;
+    return position;
+}
+
+static
+s64 get_next_character_start(Text_Input *input, s64 position) {
+    s64 limit = MIN(position + 4, input->count);
+    ++position;
+    while(position < limit && is_utf8_continuation_byte(text_input_character(input, position))) ++position;
+    return position;
 }
 
 static
@@ -106,14 +332,14 @@ s64 get_start_of_current_word_towards_the_left(Text_Input *input) {
     //
     // Skip all leading characters until a word has been found.
     //
-    while(position > 0 && is_empty_character(input->buffer[position - 1])) --position;
+    while(position > 0 && is_empty_character(text_input_character(input, position - 1))) --position;
 
     //
     // Skip this word until the next empty character.
     //
     if(position > 0) {
-        Word_Mode word_mode = get_word_mode_for_character(input->buffer[position - 1]);
-        while(position > 0 && is_word_character(word_mode, input->buffer[position - 1])) --position;
+        Word_Mode word_mode = get_word_mode_for_character(text_input_character(input, position - 1));
+        while(position > 0 && is_word_character(word_mode, text_input_character(input, position - 1))) --position;
     }
 
     return position;
@@ -126,7 +352,7 @@ s64 get_end_of_next_word_towards_the_left(Text_Input *input) {
     //
     // Skip the empty characters until the start of the next word.
     //
-    while(position > 0 && is_empty_character(input->buffer[position - 1])) --position;
+    while(position > 0 && is_empty_character(text_input_character(input, position - 1))) --position;
 
     return position;
 }
@@ -138,18 +364,20 @@ s64 get_start_of_next_word_towards_the_right(Text_Input *input) {
     //
     // Skip all leading characters until a word has been found.
     //
-    while(position < input->count && is_empty_character(input->buffer[position])) ++position;
+    while(position < input->count && is_empty_character(text_input_character(input, position))) ++position;
 
     //
     // Skip this word until the next empty character.
     //
-    Word_Mode word_mode = get_word_mode_for_character(input->buffer[position]);
-    while(position < input->count && is_word_character(word_mode, input->buffer[position])) ++position;
+    if(position < input->count) {
+        Word_Mode word_mode = get_word_mode_for_character(text_input_character(input, position));
+        while(position < input->count && is_word_character(word_mode, text_input_character(input, position))) ++position;
+    }
 
     //
     // Skip the empty characters until the start of the next word.
     //
-    while(position < input->count && is_empty_character(input->buffer[position])) ++position;
+    while(position < input->count && is_empty_character(text_input_character(input, position))) ++position;
 
     return position;
 }
@@ -182,12 +410,28 @@ void maybe_start_or_end_selection(Text_Input *input, Text_Input_Event *event) {
 }
 
 
-void create_text_input(Text_Input *input, Text_Input_Mode mode) {
-    input->mode              = mode;
-    input->active_this_frame = false;
+void create_text_input(Text_Input *input, Text_Input_Mode mode, Allocator *allocator) {
+    input->mode                = mode;
+    input->allocator           = allocator;
+    input->buffer              = null;
+    input->capacity            = 0;
+    input->lines               = Resizable_Array<Text_Input_Line>();
+    input->lines.allocator     = allocator;
+    input->measured_font       = null;
+    input->edit_count          = 0;
+    input->measured_edit_count = -1;
+    input->active_this_frame   = false;
     clear_text_input(input);
 }
 
+void destroy_text_input(Text_Input *input) {
+    if(input->buffer) input->allocator->deallocate(input->buffer);
+    input->lines.clear();
+    input->buffer   = null;
+    input->capacity = 0;
+    input->count    = 0;
+}
+
 b8 update_text_input(Text_Input *input, Window *window, Font *font) {
     b8 anything_changed = false;
 
@@ -198,7 +442,7 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
     // Handle the text input events from the window.
     //
     if(input->active_this_frame) {
-        for(s64 i = 0; i < window->text_input_event_count; ++i) {
+        for(s64 i = 0; i < window->text_input_events.count; ++i) {
             Text_Input_Event *event = &window->text_input_events[i];
 
             if(event->type == TEXT_INPUT_EVENT_Control) {               
@@ -214,7 +458,7 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
                         erase_text(input, get_start_of_current_word_towards_the_left(input), input->cursor - 1);
                         anything_changed = true;
                     } else if(input->cursor > 0) {
-                        erase_text(input, input->cursor - 1, input->cursor - 1); 
+                        erase_text(input, get_previous_character_start(input, input->cursor), input->cursor - 1);
                         anything_changed = true;
                     }
                     break;
@@ -227,7 +471,7 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
                         erase_text(input, input->cursor, get_start_of_next_word_towards_the_right(input) - 1);
                         anything_changed = true;
                     } else if(input->cursor < input->count) {
-                        erase_text(input, input->cursor, input->cursor);
+                        erase_text(input, input->cursor, get_next_character_start(input, input->cursor) - 1);
                         anything_changed = true;
                     }
                     break;
@@ -239,7 +483,7 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
                         input->cursor = get_start_of_current_word_towards_the_left(input);
                         anything_changed = true;
                     } else if(input->cursor > 0) {
-                        --input->cursor;
+                        input->cursor = get_previous_character_start(input, input->cursor);
                         anything_changed = true;
                     }
                     break;
@@ -251,7 +495,7 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
                         input->cursor = get_start_of_next_word_towards_the_right(input);
                         anything_changed = true;
                     } else if(input->cursor < input->count) {
-                        ++input->cursor;
+                        input->cursor = get_next_character_start(input, input->cursor);
                         anything_changed = true;
                     }
                     break;
@@ -311,10 +555,8 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
                 if(input->selection_active) erase_selection(input);
                 clear_selection(input);
 
-                string _string;
-                _string.count = 1;
-                _string.data = (u8 *) &event->utf32;
-                insert_text(input, _string);
+                u8 sequence[4];
+                insert_text(input, string_view(sequence, utf8_encode(event->utf32, sequence)));
                 anything_changed = true;
             }
             
@@ -326,18 +568,29 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
     // Update the rendering data
     //
     if(font) {
-        f32 interpolation             = min(window->frame_time * 20.f, 1.f);
-        string string_to_cursor       = string_view(input->buffer, input->cursor);
-        input->target_cursor_x        = (f32) get_string_width_in_pixels(font, string_to_cursor);
+        if(font != input->measured_font) invalidate_line_widths(input, font);
+
+        // Only measure the text again if anything about it changed since the last frame.
+        s64 selection_pivot_to_measure = input->selection_active ? input->selection_pivot : -1;
+        if(input->measured_edit_count != input->edit_count || input->measured_cursor != input->cursor || input->measured_selection_pivot != selection_pivot_to_measure) {
+            input->target_cursor_x = (f32) get_text_input_width_until(input, font, input->cursor);
+            if(input->selection_active) input->target_selection_pivot_x = (f32) get_text_input_width_until(input, font, input->selection_pivot);
+
+            input->measured_edit_count      = input->edit_count;
+            input->measured_cursor          = input->cursor;
+            input->measured_selection_pivot = selection_pivot_to_measure;
+        }
+
+        f32 interpolation             = MIN(window->frame_time * 20.f, 1.f);
         input->interpolated_cursor_x += (input->target_cursor_x - input->interpolated_cursor_x) * interpolation;
         input->cursor_x               = roundf(input->interpolated_cursor_x);
 
         if(input->selection_active) {
             if(input->cursor <= input->selection_pivot) {
                 input->selection_start_x = input->cursor_x;
-                input->selection_end_x   = (f32) get_string_width_in_pixels(font, string_view(input->buffer, input->selection_pivot));
+                input->selection_end_x   = input->target_selection_pivot_x;
             } else {
-                input->selection_start_x = (f32) get_string_width_in_pixels(font, string_view(input->buffer, input->selection_pivot));
+                input->selection_start_x = input->target_selection_pivot_x;
                 input->selection_end_x   = input->cursor_x;
             }
         } else {
@@ -357,12 +610,12 @@ b8 update_text_input(Text_Input *input, Window *window, Font *font) {
 }
 
 void clear_text_input(Text_Input *input) {
-    input->count                    = 0;
-    input->cursor                   = 0;
+    reset_text(input);
     input->selection_pivot          = 0;
     input->selection_active         = false;
     input->entered_this_frame       = false;
     input->target_cursor_x          = 0.f;
+    input->target_selection_pivot_x = 0.f;
     input->interpolated_cursor_x    = 0.f;
     input->cursor_x                 = 0.f;
     input->cursor_alpha_zero_to_one = 1.f;
@@ -378,8 +631,7 @@ void toggle_text_input_activeness(Text_Input *input, b8 active) {
 
 void set_text_input_string(Text_Input *input, string string) {
     // Don't clear out the rendering data here, that seems to look better.
-    input->count              = 0;
-    input->cursor             = 0;
+    reset_text(input);
     input->time_of_last_input = os_get_cpu_time();
     clear_selection(input);
     insert_text(input, string);
@@ -394,26 +646,42 @@ void remove_text_input_range(Text_Input *input, s64 first_to_remove, s64 last_to
 }
 
 string text_input_string_view(Text_Input *input) {
-    return string_view(input->buffer, input->count);
+    return text_input_view(input, 0, input->count);
 }
 
 string text_input_selected_string_view(Text_Input *input) {
     if(input->cursor <= input->selection_pivot) {
-        return string_view(&input->buffer[input->cursor], input->selection_pivot - input->cursor);
+        return text_input_view(input, input->cursor, input->selection_pivot);
     } else {
-        return string_view(&input->buffer[input->selection_pivot], input->cursor - input->selection_pivot);
+        return text_input_view(input, input->selection_pivot, input->cursor);
     }
 }
 
 string text_input_string_view_until_cursor(Text_Input *input) {
-    return string_view(input->buffer, input->cursor);
+    return text_input_view(input, 0, input->cursor);
 }
 
 string text_input_string_view_until_selection(Text_Input *input) {
-    return string_view(input->buffer, min(input->cursor, input->selection_pivot));
+    return text_input_view(input, 0, MIN(input->cursor, input->selection_pivot));
 }
 
 string text_input_string_view_after_selection(Text_Input *input) {
-    s64 start = max(input->cursor, input->selection_pivot);
-    return string_view(&input->buffer[start], input->count - start);
+    s64 start = MAX(input->cursor, input->selection_pivot);
+    return text_input_view(input, start, input->count);
+}
+
+s64 text_input_line_count(Text_Input *input) {
+    return input->lines.count;
+}
+
+string text_input_line_view(Text_Input *input, s64 line) {
+    s64 line_start = find_line_start(input, line);
+    return text_input_view(input, line_start, line_start + input->lines[line].count);
+}
+
+s32 get_text_input_line_width_in_pixels(Text_Input *input, Font *font, s64 line) {
+    if(font != input->measured_font) invalidate_line_widths(input, font);
+
+    if(input->lines[line].width == TEXT_INPUT_WIDTH_UNKNOWN) input->lines[line].width = get_string_width_in_pixels(font, text_input_line_view(input, line));
+    return input->lines[line].width;
 }
\ No newline at end of file
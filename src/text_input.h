@@ -1,9 +1,11 @@
 #pragma once
 
 #include "foundation.h"
+#include "memutils.h"
 #include "string_type.h"
 
-#define TEXT_INPUT_BUFFER_SIZE 512
+#define TEXT_INPUT_INITIAL_CAPACITY 512
+#define TEXT_INPUT_WIDTH_UNKNOWN    -1
 
 struct Window;
 struct Font;
@@ -14,16 +16,47 @@ enum Text_Input_Mode {
     TEXT_INPUT_Floating_Point,
 };
 
+struct Text_Input_Line {
+    s64 count; // In bytes, without the newline.
+    s32 width; // In pixels, or TEXT_INPUT_WIDTH_UNKNOWN if the line changed since it was last measured.
+};
+
+//
+// The text is stored in a gap buffer: The bytes before the gap live at the start of the buffer, the bytes
+// after the gap at its end, and the free space in between is the gap. Edits move the gap to the edit position
+// first, which only copies the bytes between the old and the new position. Since almost all edits happen at
+// the cursor, inserting or removing text costs as much as the edit itself, no matter how long the text is.
+// Views into the text (see text_input_string_view...) must be contiguous, so they move the gap out of the
+// viewed range if necessary. For views that end at the cursor or start after it, that is free.
+//     Next to the text, every line stores its byte count and its width in pixels. Widths are only measured
+// again after the line was edited (or the font changed), so that the cursor position in a long text does
+// not require measuring everything before it every frame. The line containing the last looked-up position
+// is remembered, so that finding the line of a position near the cursor is O(1) as well.
+//
 struct Text_Input {
     //
     // Internal state.
     //
     Text_Input_Mode mode;
-    u8 buffer[TEXT_INPUT_BUFFER_SIZE];
+    Allocator *allocator;
+    u8 *buffer;
+    s64 capacity;
+    s64 gap_start;
+    s64 gap_end;
     s64 count;
     s64 cursor;
     s64 selection_pivot; // The cursor position in which the selection originally started. The selection is currently between this and the cursor position. Note that this isn't sorted, meaning the cursor can be bigger or smaller than this pivot.
 
+    Resizable_Array<Text_Input_Line> lines; // There is always at least one (possibly empty) line.
+    s64 current_line; // The line containing the last looked-up position.
+    s64 current_line_start; // The offset of current_line in the text.
+
+    Font *measured_font; // The font the line widths have been measured with.
+    s64 measured_cursor; // The cursor and selection pivot for which the rendering data has last been computed, to skip measuring the same text over and over.
+    s64 measured_selection_pivot;
+    s64 measured_edit_count;
+    s64 edit_count; // Incremented on every change to the text.
+
     //
     // Immediate mode exposed data.
     //
@@ -37,6 +70,7 @@ struct Text_Input {
     // Rendering data.
     //
     f32 target_cursor_x;
+    f32 target_selection_pivot_x;
     f32 interpolated_cursor_x;
     f32 cursor_x; // This is the rounded interpolated_cursor_x, use this for rendering!
     f32 cursor_alpha_zero_to_one;
@@ -45,7 +79,8 @@ struct Text_Input {
     s64 time_of_last_input; // Hardware_Time
 };
 
-void create_text_input(Text_Input *input, Text_Input_Mode mode);
+void create_text_input(Text_Input *input, Text_Input_Mode mode, Allocator *allocator = Default_Allocator);
+void destroy_text_input(Text_Input *input);
 b8 update_text_input(Text_Input *input, Window *window, Font *font); // The font is used for rendering data (e.g. the cursor position requires knowledge of the string width in pixels...). This procedure returns true if the text input has been modified in any way.
 void clear_text_input(Text_Input *input);
 void toggle_text_input_activeness(Text_Input *input, b8 active);
@@ -57,3 +92,6 @@ string text_input_selected_string_view(Text_Input *input);
 string text_input_string_view_until_cursor(Text_Input *input);
 string text_input_string_view_until_selection(Text_Input *input);
 string text_input_string_view_after_selection(Text_Input *input);
+s64 text_input_line_count(Text_Input *input);
+string text_input_line_view(Text_Input *input, s64 line);
+s32 get_text_input_line_width_in_pixels(Text_Input *input, Font *font, s64 line); // Cached until the line is edited.
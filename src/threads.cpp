@@ -459,7 +459,7 @@ u64 atomic_compare_exchange(u64 volatile *dst, u64 desired, u64 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange64((LONG64 volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
@@ -467,7 +467,7 @@ u32 atomic_compare_exchange(u32 volatile *dst, u32 desired, u32 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange((LONG volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
@@ -475,7 +475,7 @@ u16 atomic_compare_exchange(u16 volatile *dst, u16 desired, u16 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange16((SHORT volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
@@ -483,7 +483,7 @@ u8 atomic_compare_exchange(u8 volatile *dst, u8 desired, u8 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange8((CHAR volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
@@ -491,7 +491,7 @@ s64 atomic_compare_exchange(s64 volatile *dst, s64 desired, s64 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange64((LONG64 volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
@@ -499,7 +499,7 @@ s32 atomic_compare_exchange(s32 volatile *dst, s32 desired, s32 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange((LONG volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
@@ -507,7 +507,7 @@ s16 atomic_compare_exchange(s16 volatile *dst, s16 desired, s16 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange16((SHORT volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
@@ -515,7 +515,7 @@ s8 atomic_compare_exchange(s8 volatile *dst, s8 desired, s8 expected) {
 #if FOUNDATION_WIN32
     return _InterlockedCompareExchange8((CHAR volatile *) dst, desired, expected);
 #elif FOUNDATION_LINUX
-    return __sync_val_compare_and_swap(dst, desired, expected);
+    return __sync_val_compare_and_swap(dst, expected, desired);
 #endif
 }
 
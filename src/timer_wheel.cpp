@@ -0,0 +1,215 @@
+#include "timer_wheel.h"
+#include "os_specific.h"
+
+#define TIMER_WHEEL_OVERFLOW_SLOT (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+#define TIMER_WHEEL_SLOT_MASK     (TIMER_WHEEL_SLOTS - 1)
+
+static inline
+Timer_Handle make_timer_handle(u32 index, u32 generation) {
+    return ((u64) generation << 32) | index;
+}
+
+void Timer_Wheel::create(Allocator *allocator, u64 current_tick) {
+    this->allocator        = allocator;
+    this->current_tick     = current_tick;
+    this->count            = 0;
+    this->timers           = Resizable_Array<Timer_Wheel_Timer>();
+    this->timers.allocator = allocator;
+    this->first_free_timer = TIMER_WHEEL_NONE;
+
+    for(s64 i = 0; i < (s64) ARRAY_COUNT(this->slots); ++i) this->slots[i] = TIMER_WHEEL_NONE;
+    memset(this->occupied_slots, 0, sizeof(this->occupied_slots));
+}
+
+void Timer_Wheel::destroy() {
+    this->timers.clear();
+    this->count = 0;
+    this->first_free_timer = TIMER_WHEEL_NONE;
+}
+
+Timer_Handle Timer_Wheel::add(u64 deadline, Timer_Procedure procedure, void *user_pointer) {
+    u32 index;
+
+    if(this->first_free_timer != TIMER_WHEEL_NONE) {
+        index = this->first_free_timer;
+        this->first_free_timer = this->timers[index].next;
+    } else {
+        assert(this->timers.count < TIMER_WHEEL_NONE, "Timer Wheel ran out of timer indices.");
+        index = (u32) this->timers.count;
+        this->timers.push();
+    }
+
+    Timer_Wheel_Timer *timer = &this->timers[index];
+    timer->deadline     = MAX(deadline, this->current_tick + 1);
+    timer->procedure    = procedure;
+    timer->user_pointer = user_pointer;
+
+    this->insert(index);
+    ++this->count;
+
+    return make_timer_handle(index, timer->generation);
+}
+
+b8 Timer_Wheel::cancel(Timer_Handle handle) {
+    u32 index      = (u32) handle;
+    u32 generation = (u32) (handle >> 32);
+
+    if(index >= this->timers.count) return false;
+
+    Timer_Wheel_Timer *timer = &this->timers[index];
+    if(timer->generation != generation || timer->slot == -1) return false;
+
+    this->unlink(index);
+    ++timer->generation;
+    timer->next = this->first_free_timer;
+    this->first_free_timer = index;
+    --this->count;
+
+    return true;
+}
+
+s64 Timer_Wheel::advance(u64 now) {
+    s64 fired_count = 0;
+
+    while(this->current_tick < now) {
+        u64 tick = this->next_event_tick();
+
+        if(tick > now) {
+            this->current_tick = now;
+            break;
+        }
+
+        this->current_tick = tick;
+
+        if((tick & TIMER_WHEEL_SLOT_MASK) == 0) {
+            // The levels need to be cascaded from the top, since cascading a level may move timers into the
+            // slot of the level below which is also due in this tick.
+            if((tick & ((1ULL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1)) == 0) this->cascade(TIMER_WHEEL_OVERFLOW_SLOT);
+
+            for(s64 level = TIMER_WHEEL_LEVELS - 1; level > 0; --level) {
+                u64 level_mask = (1ULL << (level * TIMER_WHEEL_SLOT_BITS)) - 1;
+                if(tick & level_mask) continue;
+
+                this->cascade(level * TIMER_WHEEL_SLOTS + ((tick >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK));
+            }
+        }
+
+        fired_count += this->expire(tick & TIMER_WHEEL_SLOT_MASK);
+    }
+
+    return fired_count;
+}
+
+u64 Timer_Wheel::next_event_tick() {
+    if(this->count == 0) return MAX_U64;
+
+    u64 tick = this->current_tick + 1;
+
+    //
+    // The slots of a level are processed at ticks where all lower digits are zero, and they only hold timers
+    // for the current rotation of that level. Every event on a level therefore happens before the next event
+    // of the level above, so the first occupied slot found from the bottom up is the next event.
+    //
+    for(s64 level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        s64 shift = level * TIMER_WHEEL_SLOT_BITS;
+        u64 boundary = ((tick + (1ULL << shift) - 1) >> shift) << shift; // The first tick >= 'tick' at which this level is processed.
+        if((boundary >> (shift + TIMER_WHEEL_SLOT_BITS)) != (this->current_tick >> (shift + TIMER_WHEEL_SLOT_BITS))) continue; // Already in the next rotation.
+
+        s64 slot = (boundary >> shift) & TIMER_WHEEL_SLOT_MASK;
+        s64 word = slot / 64;
+        u64 bits = this->occupied_slots[level][word] & (~0ULL << (slot % 64));
+
+        while(!bits && ++word < TIMER_WHEEL_SLOTS / 64) bits = this->occupied_slots[level][word];
+
+        if(bits) {
+            slot = word * 64 + os_lowest_bit_set(bits);
+            return (boundary & ~((u64) TIMER_WHEEL_SLOT_MASK << shift)) | ((u64) slot << shift);
+        }
+    }
+
+    // Only the overflow list is left, which gets cascaded at the next rotation of the top level.
+    s64 shift = TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS;
+    return ((tick + (1ULL << shift) - 1) >> shift) << shift;
+}
+
+void Timer_Wheel::insert(u32 index) {
+    Timer_Wheel_Timer *timer = &this->timers[index];
+
+    //
+    // The timer goes into the lowest level on which its deadline only differs from the current tick in that
+    // level's digit, since that level's slot for the deadline will come around before the digit of the next
+    // level changes.
+    //
+    u64 difference = timer->deadline ^ this->current_tick;
+
+    s64 level = difference ? os_highest_bit_set(difference) / TIMER_WHEEL_SLOT_BITS : 0;
+    s64 slot;
+
+    if(level < TIMER_WHEEL_LEVELS) {
+        s64 slot_in_level = (timer->deadline >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+        this->occupied_slots[level][slot_in_level / 64] |= 1ULL << (slot_in_level % 64);
+        slot = level * TIMER_WHEEL_SLOTS + slot_in_level;
+    } else {
+        slot = TIMER_WHEEL_OVERFLOW_SLOT;
+    }
+
+    timer->slot     = (s32) slot;
+    timer->previous = TIMER_WHEEL_NONE;
+    timer->next     = this->slots[slot];
+    if(timer->next != TIMER_WHEEL_NONE) this->timers[timer->next].previous = index;
+    this->slots[slot] = index;
+}
+
+void Timer_Wheel::unlink(u32 index) {
+    Timer_Wheel_Timer *timer = &this->timers[index];
+
+    if(timer->previous != TIMER_WHEEL_NONE) {
+        this->timers[timer->previous].next = timer->next;
+    } else {
+        this->slots[timer->slot] = timer->next;
+        if(timer->next == TIMER_WHEEL_NONE) this->clear_occupied_slot(timer->slot);
+    }
+
+    if(timer->next != TIMER_WHEEL_NONE) this->timers[timer->next].previous = timer->previous;
+
+    timer->slot = -1;
+}
+
+void Timer_Wheel::clear_occupied_slot(s64 slot) {
+    if(slot == TIMER_WHEEL_OVERFLOW_SLOT) return;
+
+    s64 level = slot / TIMER_WHEEL_SLOTS, slot_in_level = slot % TIMER_WHEEL_SLOTS;
+    this->occupied_slots[level][slot_in_level / 64] &= ~(1ULL << (slot_in_level % 64));
+}
+
+void Timer_Wheel::cascade(s64 slot) {
+    // Take the whole list out of the slot first, since timers in the overflow list may go right back into it.
+    u32 index = this->slots[slot];
+    this->slots[slot] = TIMER_WHEEL_NONE;
+    this->clear_occupied_slot(slot);
+
+    while(index != TIMER_WHEEL_NONE) {
+        u32 next = this->timers[index].next;
+        this->insert(index);
+        index = next;
+    }
+}
+
+s64 Timer_Wheel::expire(s64 slot) {
+    s64 fired_count = 0;
+
+    // Timers fired here may add or cancel other timers, so take them out of the slot one at a time. New
+    // timers are always scheduled after the current tick, so they never end up in this slot.
+    while(this->slots[slot] != TIMER_WHEEL_NONE) {
+        u32 index = this->slots[slot];
+        Timer_Wheel_Timer *timer = &this->timers[index];
+        Timer_Procedure procedure = timer->procedure;
+        void *user_pointer = timer->user_pointer;
+
+        this->cancel(make_timer_handle(index, timer->generation));
+        procedure(user_pointer);
+        ++fired_count;
+    }
+
+    return fired_count;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "foundation.h"
+#include "memutils.h"
+
+//
+// A hierarchical timer wheel, for scheduling huge numbers of timers (e.g. retransmission deadlines) of which
+// most are cancelled before they ever fire. Adding and cancelling a timer is O(1), and advancing the wheel is
+// O(1) per fired (or cascaded) timer, no matter how many ticks pass, since every level keeps a bitmask of its
+// occupied slots to skip over the empty ones.
+//     Time is measured in abstract ticks, the user decides what a tick is (e.g. a millisecond). The first
+// level has one slot per tick, every further level has one slot per full rotation of the level below. A timer
+// is stored on the lowest level where its deadline is still within the current rotation, and is moved down
+// the levels ("cascaded") once the time comes closer. Timers too far in the future for all levels wait in an
+// overflow list, which is cascaded whenever the top level completes a rotation.
+//     All timers live in a single array, linked together per slot through indices, so that growing the array
+// does not invalidate any links.
+//
+
+typedef void(*Timer_Procedure)(void *user_pointer);
+typedef u64 Timer_Handle; // The index of the timer in the lower 32 bits, its generation in the upper.
+
+#define INVALID_TIMER_HANDLE ((Timer_Handle) -1)
+
+#define TIMER_WHEEL_SLOT_BITS 8
+#define TIMER_WHEEL_SLOTS     (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_LEVELS    4
+#define TIMER_WHEEL_NONE      ((u32) -1)
+
+struct Timer_Wheel_Timer {
+    u64 deadline;
+    Timer_Procedure procedure;
+    void *user_pointer;
+    u32 previous; // The previous timer in the same slot.
+    u32 next;     // The next timer in the same slot, or the next free timer.
+    u32 generation; // Incremented whenever this timer is released, so that stale handles can be detected.
+    s32 slot; // The index into Timer_Wheel::slots, or -1 if this timer is not scheduled.
+};
+
+struct Timer_Wheel {
+    Allocator *allocator = Default_Allocator;
+    u64 current_tick; // All timers with deadlines up to and including this tick have fired.
+    s64 count; // The number of scheduled timers.
+
+    Resizable_Array<Timer_Wheel_Timer> timers;
+    u32 first_free_timer;
+
+    u32 slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1]; // The head of every slot's timer list, the last one is the overflow list.
+    u64 occupied_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS / 64]; // One bit per non-empty slot.
+
+    void create(Allocator *allocator, u64 current_tick = 0);
+    void destroy();
+
+    Timer_Handle add(u64 deadline, Timer_Procedure procedure, void *user_pointer); // Deadlines in the past fire on the next advance.
+    b8 cancel(Timer_Handle handle); // Returns false if the timer already fired or was cancelled.
+    s64 advance(u64 now); // Fires all timers with a deadline up to and including now. Returns the number of fired timers.
+
+    u64 next_event_tick(); // The next tick at which a slot needs to be expired or cascaded.
+    void insert(u32 index);
+    void unlink(u32 index);
+    void clear_occupied_slot(s64 slot);
+    void cascade(s64 slot);
+    s64 expire(s64 slot); // Fires all timers in this first level slot.
+};
@@ -154,13 +154,10 @@ void print_tweak_variable_value(Ascii_Writer *writer, Tweak_Variable *variable)
 }
 
 static
-string read_tweak_line(string *file_data, s64 *line_number) {
-    while(true) {
-        if(!file_data->count) return ""_s;
-
-        string line = read_next_line(file_data);
-        ++(*line_number);
+string read_tweak_line(Line_Iterator *lines) {
+    string line;
 
+    while(lines->next(&line)) {
         s64 pound_index = search_string(line, '#');
         if(pound_index != -1) line = substring_view(line, 0, pound_index);
 
@@ -227,18 +224,18 @@ b8 read_tweak_file(Tweak_File *file) {
         return false;
     }
 
-    string original_file_data = file_data;
-    defer { os_free_file_content(Default_Allocator, &original_file_data); };
+    defer { os_free_file_content(Default_Allocator, &file_data); };
 
-    s64 line_number;
+    Line_Iterator lines;
+    lines.create(file_data);
 
     //
     // Parse the version number.
     //
-    string line = read_tweak_line(&file_data, &line_number);
+    string line = read_tweak_line(&lines);
 
     if(!line.count || line[0] != '[' || line[line.count - 1] != ']') {
-        report_tweak_error(file, line_number, "The version number was expected in the first line.");
+        report_tweak_error(file, lines.line_number, "The version number was expected in the first line.");
         return false;
     }
 
@@ -247,7 +244,7 @@ b8 read_tweak_file(Tweak_File *file) {
     file->version = (u32) string_to_int(version_string, &version_valid);
 
     if(!version_valid) {
-        report_tweak_error(file, line_number, "The version number '%.*s' is invalid.", (u32) version_string.count, version_string.data);
+        report_tweak_error(file, lines.line_number, "The version number '%.*s' is invalid.", (u32) version_string.count, version_string.data);
         return false;
     }
 
@@ -260,7 +257,7 @@ b8 read_tweak_file(Tweak_File *file) {
     b8 global_success = true;
     
     while(true) {
-        line = read_tweak_line(&file_data, &line_number);
+        line = read_tweak_line(&lines);
         if(!line.count) break;
 
         if(line.count >= 2 && line[0] == ':' && line[1] == '/') {
@@ -268,14 +265,14 @@ b8 read_tweak_file(Tweak_File *file) {
             // Declaration of a new service
             //
             string service_name = substring_view(line, 2, line.count);
-            current_service = find_tweak_service(file, service_name, line_number);
+            current_service = find_tweak_service(file, service_name, lines.line_number);
             inside_global_service = false;
         } else {
             //
             // Declaration of a variable
             //
             if(!current_service && inside_global_service) {
-                current_service = find_tweak_service(file, "."_s, line_number);
+                current_service = find_tweak_service(file, "."_s, lines.line_number);
                 inside_global_service = false;
             }
 
@@ -286,7 +283,7 @@ b8 read_tweak_file(Tweak_File *file) {
 
             s64 space = search_string(line, ' ');
             if(space == -1) {
-                report_tweak_error(file, line_number, "Expected a 'key value' set, seperated by a space, in this line.");
+                report_tweak_error(file, lines.line_number, "Expected a 'key value' set, seperated by a space, in this line.");
                 global_success = false;
                 continue;
             }
@@ -294,7 +291,7 @@ b8 read_tweak_file(Tweak_File *file) {
             // Make sure there is only one space character in the current line
             s64 reverse_space = search_string_reverse(line, ' ');
             if(reverse_space != space) {
-                report_tweak_error(file, line_number, "Multiple values have been found in this line, expected only a single one.");
+                report_tweak_error(file, lines.line_number, "Multiple values have been found in this line, expected only a single one.");
                 global_success = false;
                 continue;
             }
@@ -302,13 +299,13 @@ b8 read_tweak_file(Tweak_File *file) {
             string name = substring_view(line, 0, space);
             string value = substring_view(line, space + 1, line.count);
 
-            Tweak_Variable *variable = find_tweak_variable(file, current_service, name, line_number);
+            Tweak_Variable *variable = find_tweak_variable(file, current_service, name, lines.line_number);
             if(!variable) {
                 global_success = false;
                 continue;
             }
 
-            set_tweak_variable_from_string(file, variable, value, line_number);
+            set_tweak_variable_from_string(file, variable, value, lines.line_number);
         }
     }
 
@@ -323,10 +320,8 @@ b8 read_tweak_file(Tweak_File *file) {
 }
 
 void write_tweak_file(Tweak_File *file) {
-    os_delete_file(file->file_path);
-
     Ascii_Writer writer;
-    writer.create(file->file_path, 4096);
+    if(!writer.create(file->file_path, 4096)) return;
 
     writer.write_char('[');
     writer.write_u32(file->version);
@@ -348,7 +343,6 @@ void write_tweak_file(Tweak_File *file) {
         writer.write_string("\n"_s);
     }
 
-    writer.flush();
     writer.destroy();
 }
 
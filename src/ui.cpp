@@ -2,8 +2,6 @@
 #include "window.h"
 #include "font.h"
 
-#include <stdarg.h>
-
 
 UI_Theme UI_Dark_Theme = {
     {  20,  20,  20, 255 }, // Default
@@ -151,13 +149,10 @@ string ui_concat_strings(UI *ui, string lhs, string rhs) {
     return concatenate_strings(&ui->allocator, lhs, rhs);
 }
 
+template<typename... Args>
 static inline
-string ui_format_string(UI *ui, string format, ...) {
-    va_list args;
-    va_start(args, format);
-    string result = mprint(&ui->allocator, format, args);
-    va_end(args);
-    return result;
+string ui_format_string(UI *ui, string format_string, Args const &... args) {
+    return format(&ui->arena, format_string, args...);
 }
 
 static inline
@@ -982,10 +977,6 @@ void draw_text_input(UI *ui, Text_Input *text_input, UI_Vector2 screen_position,
     // Query the complete text to render
     string text = text_input_string_view(text_input);
     
-    // Query the text until the cursor for rendering alignment
-    string text_until_cursor = text_input_string_view_until_cursor(text_input);
-    f32 width_until_cursor   = (f32) get_string_width_in_pixels(ui->font, text_until_cursor);
-    
     UI_Color text_color = ui->theme.text_color;
     if(ui->deactivated) text_color.a /= UI_DEACTIVE_ALPHA_DENOMINATOR;
     
@@ -1197,6 +1188,7 @@ void create_ui(UI *ui, UI_Callbacks callbacks, UI_Theme theme, Window *window, F
 void destroy_ui(UI *ui) {
     for(u64 i = 0; i < ui->element_count; ++i) {
         if(ui->elements[i].custom_state) Default_Allocator->deallocate(ui->elements[i].custom_state);
+        if(ui->elements[i].text_input) destroy_text_input(ui->elements[i].text_input);
     }
 
     ui->text_input_pool.clear();
@@ -1255,6 +1247,7 @@ void draw_ui_frame(UI *ui) {
             // Remove from the element array
             if(element.text_input) {
                 if(ui->active_text_input == element.text_input) ui->active_text_input = null;
+                destroy_text_input(element.text_input);
                 ui->text_input_pool.remove_value_pointer(element.text_input);
             }
 
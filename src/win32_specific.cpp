@@ -331,6 +331,38 @@ void os_free_file_content(Allocator *allocator, string *file_content) {
 	file_content->data  = 0;
 }
 
+string os_map_file(string file_path) {
+	string file_content = { 0 };
+	char *cstring = to_cstring(Default_Allocator, file_path);
+
+	HANDLE file_handle = CreateFileA(cstring, GENERIC_READ, FILE_SHARE_READ, null, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, null);
+	if(file_handle != INVALID_HANDLE_VALUE) {
+		LARGE_INTEGER file_size;
+
+		if(GetFileSizeEx(file_handle, &file_size) && file_size.QuadPart > 0) {
+			HANDLE mapping_handle = CreateFileMappingA(file_handle, null, PAGE_WRITECOPY, 0, 0, null);
+
+			if(mapping_handle) {
+				// The view keeps the mapping alive, so the handles can be closed right away.
+				file_content.data = (u8 *) MapViewOfFile(mapping_handle, FILE_MAP_COPY, 0, 0, 0);
+				if(file_content.data) file_content.count = file_size.QuadPart;
+				CloseHandle(mapping_handle);
+			}
+		}
+
+		CloseHandle(file_handle);
+	}
+
+	free_cstring(Default_Allocator, cstring);
+	return file_content;
+}
+
+void os_unmap_file(string *file_content) {
+	if(file_content->data) UnmapViewOfFile(file_content->data);
+	file_content->count = 0;
+	file_content->data  = 0;
+}
+
 b8 os_write_file(string file_path, string file_content, b8 append) {
 	b8 success = false;
 	char *cstring = to_cstring(Default_Allocator, file_path);
@@ -350,6 +382,31 @@ b8 os_write_file(string file_path, string file_content, b8 append) {
 	return success;
 }
 
+File_Handle os_open_file_for_writing(string file_path, b8 append) {
+	char *cstring = to_cstring(Default_Allocator, file_path);
+
+	HANDLE file_handle = CreateFileA(cstring, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, null, append ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, null);
+	if(file_handle != INVALID_HANDLE_VALUE && append) SetFilePointer(file_handle, 0, null, FILE_END);
+
+	free_cstring(Default_Allocator, cstring);
+	return file_handle != INVALID_HANDLE_VALUE ? (File_Handle) file_handle : INVALID_FILE_HANDLE;
+}
+
+b8 os_write_file_chunks(File_Handle file, string *chunks, s64 count) {
+	// WriteFileGather only works on unbuffered files with page-aligned chunks, so just write them one after
+	// the other.
+	for(s64 i = 0; i < count; ++i) {
+		DWORD written = 0;
+		if(!WriteFile((HANDLE) file, chunks[i].data, (DWORD) chunks[i].count, &written, null) || written != (DWORD) chunks[i].count) return false;
+	}
+
+	return true;
+}
+
+void os_close_file(File_Handle file) {
+	CloseHandle((HANDLE) file);
+}
+
 b8 os_create_directory(string file_path) {
     s64 parent_folder_end = os_search_path_for_directory_slash_reverse(file_path);
     if(parent_folder_end != -1) {
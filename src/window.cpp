@@ -67,28 +67,22 @@ Key_Code win32_key_map(WPARAM vk) {
 
 static
 void win32_add_character_text_input_event(Window *window, u32 utf32) {
-    if(window->text_input_event_count >= ARRAY_COUNT(window->text_input_events)) return; // If the user somehow maanges to do more text inputs than that in one single frame, then just ignore those inputs.
-
-    Text_Input_Event *event = &window->text_input_events[window->text_input_event_count];
+    Text_Input_Event *event = window->text_input_events.push();
     event->type         = TEXT_INPUT_EVENT_Character;
     event->utf32        = utf32;
     event->shift_held   = window->keys[KEY_Shift]   & KEY_Down;
     event->control_held = window->keys[KEY_Control] & KEY_Down;
     event->menu_held    = window->keys[KEY_Menu]    & KEY_Down;
-    ++window->text_input_event_count;
 }
 
 static
 void win32_add_control_text_input_event(Window *window, Key_Code key) {
-    if(window->text_input_event_count >= ARRAY_COUNT(window->text_input_events)) return; // If the user somehow maanges to do more text inputs than that in one single frame, then just ignore those inputs.
-
-    Text_Input_Event *event = &window->text_input_events[window->text_input_event_count];
+    Text_Input_Event *event = window->text_input_events.push();
     event->type         = TEXT_INPUT_EVENT_Control;
     event->control      = key;
     event->shift_held   = window->keys[KEY_Shift]   & KEY_Down;
     event->control_held = window->keys[KEY_Control] & KEY_Down;
     event->menu_held    = window->keys[KEY_Menu]    & KEY_Down;
-    ++window->text_input_event_count;
 }
 
 static
@@ -904,8 +898,8 @@ b8 create_window(Window *window, string title, s32 x, s32 y, s32 w, s32 h, Windo
     window->raw_mouse_delta_x      = 0;
     window->raw_mouse_delta_y      = 0;
     window->mouse_wheel_turns      = 0;
-    window->text_input_event_count = 0;
     window->time_of_last_update    = os_get_cpu_time();
+    window->text_input_events      = {};
 
 #if FOUNDATION_WIN32
     return win32_create_window(window, title, x, y, w, h, flags);
@@ -932,7 +926,7 @@ void update_window(Window *window) {
     window->raw_mouse_delta_x      = 0;
     window->raw_mouse_delta_y      = 0;
     window->mouse_wheel_turns      = 0;
-    window->text_input_event_count = 0;
+    window->text_input_events.clear();
 
     for(s64 i = 0; i < KEY_COUNT; ++i) window->keys[i] = window->keys[i] & KEY_STATUS_PERSISTENT_MASK;
     for(s64 i = 0; i < BUTTON_COUNT; ++i) window->buttons[i] = window->buttons[i] & BUTTON_STATUS_PERSISTENT_MASK;
@@ -966,6 +960,8 @@ void update_window(Window *window) {
 }
 
 void destroy_window(Window *window) {
+    window->text_input_events.clear();
+
 #if FOUNDATION_WIN32
     win32_destroy_window(window);
 #elif FOUNDATION_LINUX
@@ -172,8 +172,7 @@ struct Window {
     Key_Status keys[KEY_COUNT];
     Button_Status buttons[BUTTON_COUNT];
     
-    Text_Input_Event text_input_events[16];
-    u32 text_input_event_count;
+    Small_Array<Text_Input_Event, 16> text_input_events; // Only spills to the heap if the user somehow manages to do that many text inputs in a single frame.
     
     f32 frame_time; // Seconds elapsed since the last time the window was updated
     s64 time_of_last_update; // Hardware time of the last call to update_window